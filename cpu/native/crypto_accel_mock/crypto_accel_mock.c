@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     cpu_native_crypto_accel_mock
+ * @{
+ *
+ * @file
+ * @brief       Mock crypto accelerator forwarding to the software
+ *              implementations
+ *
+ * @}
+ */
+
+#include "crypto/accel.h"
+#include "crypto/aes.h"
+#include "crypto/ciphers.h"
+#include "crypto_accel_mock.h"
+#include "hashes/sha256.h"
+
+crypto_accel_mock_calls_t crypto_accel_mock_calls;
+
+static int _aes_init(cipher_context_t *ctx, const uint8_t *key,
+                     uint8_t key_size)
+{
+    crypto_accel_mock_calls.aes_128_init++;
+    return aes_init(ctx, key, key_size);
+}
+
+static int _aes_encrypt(const cipher_context_t *ctx, const uint8_t *plain_block,
+                        uint8_t *cipher_block)
+{
+    crypto_accel_mock_calls.aes_128_blocks++;
+    return aes_encrypt(ctx, plain_block, cipher_block);
+}
+
+static int _aes_decrypt(const cipher_context_t *ctx, const uint8_t *cipher_block,
+                        uint8_t *plain_block)
+{
+    crypto_accel_mock_calls.aes_128_blocks++;
+    return aes_decrypt(ctx, cipher_block, plain_block);
+}
+
+static int _aes_encrypt_blocks(const cipher_context_t *ctx,
+                               const uint8_t *input, uint8_t *output,
+                               size_t numof)
+{
+    crypto_accel_mock_calls.aes_128_blocks += numof;
+    return aes_encrypt_blocks(ctx, input, output, numof);
+}
+
+static int _aes_decrypt_blocks(const cipher_context_t *ctx,
+                               const uint8_t *input, uint8_t *output,
+                               size_t numof)
+{
+    crypto_accel_mock_calls.aes_128_blocks += numof;
+    return aes_decrypt_blocks(ctx, input, output, numof);
+}
+
+static const cipher_interface_t _aes_128 = {
+    AES_BLOCK_SIZE,
+    AES_KEY_SIZE,
+    _aes_init,
+    _aes_encrypt,
+    _aes_decrypt,
+    _aes_encrypt_blocks,
+    _aes_decrypt_blocks
+};
+
+static void _sha256(uint32_t *state, const void *blocks, size_t numof)
+{
+    crypto_accel_mock_calls.sha256_blocks += numof;
+    sha256_blocks_sw(state, blocks, numof);
+}
+
+const crypto_accel_t crypto_accel_mock = {
+    .name = "mock",
+    .priority = CRYPTO_ACCEL_MOCK_PRIORITY,
+    .aes_128 = &_aes_128,
+    .sha256 = _sha256,
+};
+
+void crypto_accel_mock_init(void)
+{
+    crypto_accel_register(&crypto_accel_mock);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto_accel
+ * @defgroup    cpu_native_crypto_accel_mock Mock crypto accelerator
+ * @{
+ * @brief       Software crypto accelerator for testing the dispatch on native
+ *
+ * Registers the software implementations of AES-128 and SHA-256 as an
+ * accelerator with @ref CRYPTO_ACCEL_MOCK_PRIORITY from auto_init, and counts
+ * how often they are called.
+ *
+ * @file
+ */
+
+#ifndef CRYPTO_ACCEL_MOCK_H
+#define CRYPTO_ACCEL_MOCK_H
+
+#include "crypto/accel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Priority of the mock accelerator
+ */
+#ifndef CRYPTO_ACCEL_MOCK_PRIORITY
+#define CRYPTO_ACCEL_MOCK_PRIORITY  (1U)
+#endif
+
+/**
+ * @brief   Calls of the mock accelerator
+ */
+typedef struct {
+    unsigned aes_128_init;      /**< number of AES-128 key setups */
+    unsigned aes_128_blocks;    /**< number of AES-128 blocks processed */
+    unsigned sha256_blocks;     /**< number of SHA-256 blocks compressed */
+} crypto_accel_mock_calls_t;
+
+/**
+ * @brief   Calls of the mock accelerator since boot
+ */
+extern crypto_accel_mock_calls_t crypto_accel_mock_calls;
+
+/**
+ * @brief   The mock accelerator
+ */
+extern const crypto_accel_t crypto_accel_mock;
+
+/**
+ * @brief   Registers the mock accelerator, called by auto_init
+ */
+void crypto_accel_mock_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRYPTO_ACCEL_MOCK_H */
+/** @} */
@@ -28,6 +28,11 @@
 
 void auto_init(void)
 {
+    if (IS_USED(MODULE_CRYPTO_ACCEL_MOCK)) {
+        LOG_DEBUG("Auto init mock crypto accelerator.\n");
+        extern void crypto_accel_mock_init(void);
+        crypto_accel_mock_init();
+    }
     if (IS_USED(MODULE_AUTO_INIT_RANDOM)) {
         LOG_DEBUG("Auto init random.\n");
         extern void auto_init_random(void);
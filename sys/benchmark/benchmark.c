@@ -21,6 +21,7 @@
 #include <stdio.h>
 
 #include "benchmark.h"
+#include "periph_conf.h"
 
 void benchmark_print_time(uint32_t time, unsigned long runs, const char *name)
 {
@@ -34,3 +35,21 @@ void benchmark_print_time(uint32_t time, unsigned long runs, const char *name)
            "  ---  %9" PRIu32 " calls per sec\n",
            name, time, full, div, per_sec);
 }
+
+void benchmark_print_bytes(uint32_t time, unsigned long runs, size_t bytes,
+                           const char *name)
+{
+    uint64_t total = (uint64_t)bytes * runs;
+    uint32_t ns = (uint32_t)(((uint64_t)time * 1000) / total);
+
+    printf("%30s: %6" PRIu32 " ns/byte", name, ns);
+#ifdef CLOCK_CORECLOCK
+    /* in tenths of a cycle */
+    uint32_t cycles = (uint32_t)(((uint64_t)time * (CLOCK_CORECLOCK / 100000UL))
+                                 / total);
+
+    printf("  ---  %4" PRIu32 ".%" PRIu32 " cycles/byte",
+           cycles / 10, cycles % 10);
+#endif
+    puts("");
+}
@@ -32,16 +32,43 @@ void fletcher16_init(fletcher16_ctx_t *ctx)
     ctx->sum2 = 0xff;
 }
 
+/*
+ * Number of bytes summed up before reducing the sums. Starting from reduced
+ * sums, sum2 stays below 511 * (n + 1) + 255 * n * (n + 1) / 2, which fits
+ * into 32 bit for this n.
+ */
+#define FLETCHER16_BLOCK    (4096U)
+
+/* returns a smaller sum congruent modulo 255 */
+static inline uint32_t _fold(uint32_t sum)
+{
+    return (sum & 0xff) + (sum >> 8);
+}
+
 void fletcher16_update(fletcher16_ctx_t *ctx, const uint8_t *data, size_t len)
 {
+    uint32_t sum1 = ctx->sum1;
+    uint32_t sum2 = ctx->sum2;
+
     while (len) {
-        size_t tlen = len > 20 ? 20 : len;
+        size_t tlen = len > FLETCHER16_BLOCK ? FLETCHER16_BLOCK : len;
         len -= tlen;
-        do {
-            ctx->sum2 += ctx->sum1 += *data++;
-        } while (--tlen);
-        _reduce(ctx);
+        /* four bytes at once: sum1 is added four times to sum2, the first
+         * byte four times, the second three times and so on */
+        for (; tlen >= 4; tlen -= 4, data += 4) {
+            sum2 += 4 * sum1 + 4 * data[0] + 3 * data[1] + 2 * data[2] +
+                    data[3];
+            sum1 += data[0] + data[1] + data[2] + data[3];
+        }
+        for (; tlen; tlen--) {
+            sum2 += sum1 += *data++;
+        }
+        /* three folds reduce 32 bit sums to at most 0x1ff */
+        sum1 = _fold(_fold(_fold(sum1)));
+        sum2 = _fold(_fold(_fold(sum2)));
     }
+    ctx->sum1 = sum1;
+    ctx->sum2 = sum2;
 }
 
 uint16_t fletcher16_finish(fletcher16_ctx_t *ctx)
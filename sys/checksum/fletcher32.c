@@ -28,9 +28,18 @@ uint32_t fletcher32(const uint16_t *data, size_t words)
     while (words) {
         unsigned tlen = words > 359 ? 359 : words;
         words -= tlen;
-        do {
+        /* four words at once, see fletcher16_update() */
+        for (; tlen >= 4; tlen -= 4, data += 4) {
+            uint32_t w0 = unaligned_get_u16(&data[0]);
+            uint32_t w1 = unaligned_get_u16(&data[1]);
+            uint32_t w2 = unaligned_get_u16(&data[2]);
+            uint32_t w3 = unaligned_get_u16(&data[3]);
+            sum2 += 4 * sum1 + 4 * w0 + 3 * w1 + 2 * w2 + w3;
+            sum1 += w0 + w1 + w2 + w3;
+        }
+        for (; tlen; tlen--) {
             sum2 += sum1 += unaligned_get_u16(data++);
-        } while (--tlen);
+        }
         sum1 = (sum1 & 0xffff) + (sum1 >> 16);
         sum2 = (sum2 & 0xffff) + (sum2 >> 16);
     }
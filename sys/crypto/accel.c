@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto_accel
+ * @{
+ *
+ * @file
+ * @brief       Selection of the crypto accelerator backends
+ *
+ * @}
+ */
+
+#ifdef MODULE_CRYPTO_ACCEL
+#include <stddef.h>
+
+#include "crypto/accel.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static const crypto_accel_t *_aes_128;
+static const crypto_accel_t *_sha256;
+
+/* selects accel for an algorithm if it is preferred over the current one */
+static void _select(const crypto_accel_t **selected,
+                    const crypto_accel_t *accel, const char *algorithm)
+{
+    if ((*selected == NULL) || (accel->priority > (*selected)->priority)) {
+        DEBUG("crypto_accel: %s selected for %s\n", accel->name, algorithm);
+        *selected = accel;
+    }
+}
+
+void crypto_accel_register(const crypto_accel_t *accel)
+{
+    if (accel->aes_128) {
+        _select(&_aes_128, accel, "AES-128");
+    }
+    if (accel->sha256) {
+        _select(&_sha256, accel, "SHA-256");
+    }
+}
+
+cipher_id_t crypto_accel_cipher(cipher_id_t cipher_id)
+{
+#ifdef MODULE_CRYPTO_AES
+    if ((cipher_id == CIPHER_AES_128) && _aes_128) {
+        return _aes_128->aes_128;
+    }
+#endif
+    return cipher_id;
+}
+
+crypto_accel_sha256_t crypto_accel_sha256(void)
+{
+    return _sha256 ? _sha256->sha256 : NULL;
+}
+#else
+typedef int dont_be_pedantic;
+#endif
@@ -39,6 +39,7 @@
 #include <stdint.h>
 #include "crypto/aes.h"
 #include "crypto/ciphers.h"
+#include "aes_bitslice.h"
 
 /**
  * Interface to the aes cipher
@@ -48,10 +49,14 @@ static const cipher_interface_t aes_interface = {
     AES_KEY_SIZE,
     aes_init,
     aes_encrypt,
-    aes_decrypt
+    aes_decrypt,
+    aes_encrypt_blocks,
+    aes_decrypt_blocks
 };
 const cipher_id_t CIPHER_AES_128 = &aes_interface;
 
+/* the bitsliced implementation needs neither tables nor key schedule */
+#ifndef MODULE_CRYPTO_AES_BITSLICE
 static const u32 Te0[256] = {
     0xc66363a5U, 0xf87c7c84U, 0xee777799U, 0xf67b7b8dU,
     0xfff2f20dU, 0xd66b6bbdU, 0xde6f6fb1U, 0x91c5c554U,
@@ -794,17 +799,25 @@ static const u32 rcon[] = {
     0x10000000, 0x20000000, 0x40000000, 0x80000000,
     0x1B000000, 0x36000000,
 };
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
 
 
 int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize)
 {
-    uint8_t i;
-
     /* This implementation only supports a single key size (defined in AES_KEY_SIZE) */
     if (keySize != AES_KEY_SIZE) {
         return CIPHER_ERR_INVALID_KEY_SIZE;
     }
 
+#ifdef MODULE_CRYPTO_AES_BITSLICE
+    /* the round keys are expanded once and kept in the context */
+    if (CIPHER_MAX_CONTEXT_SIZE < AES_BITSLICE_KEY_SCHED_SIZE) {
+        return CIPHER_ERR_BAD_CONTEXT_SIZE;
+    }
+    aes_bitslice_expand_key(key, context->context);
+#else
+    uint8_t i;
+
     /* Make sure that context is large enough. If this is not the case,
        you should build with -DAES */
     if (CIPHER_MAX_CONTEXT_SIZE < AES_KEY_SIZE) {
@@ -823,10 +836,12 @@ int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize)
             context->context[i] = key[i];
         }
     }
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
 
     return CIPHER_INIT_SUCCESS;
 }
 
+#ifndef MODULE_CRYPTO_AES_BITSLICE
 /**
  * Expand the cipher key into the encryption key schedule.
  */
@@ -1022,26 +1037,17 @@ static int aes_set_decrypt_key(const unsigned char *userKey, const int bits,
 
     return 0;
 }
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
 
 #ifndef AES_ASM
+#ifndef MODULE_CRYPTO_AES_BITSLICE
 /*
  * Encrypt a single block
  * in and out can overlap
  */
-int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
-                uint8_t *cipherBlock)
+static void _encrypt_block(const AES_KEY *key, const uint8_t *plainBlock,
+                           uint8_t *cipherBlock)
 {
-    /* setup AES_KEY */
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-
-    res = aes_set_encrypt_key((unsigned char *)context->context,
-                              AES_KEY_SIZE * 8, &aeskey);
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef MODULE_CRYPTO_AES_UNROLL
@@ -1289,28 +1295,15 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
         (Te4((t2) & 0xff)       & 0x000000ff) ^
         rk[3];
     PUTU32(cipherBlock + 12, s3);
-    return 1;
 }
 
 /*
  * Decrypt a single block
  * in and out can overlap
  */
-int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
-                uint8_t *plainBlock)
+static void _decrypt_block(const AES_KEY *key, const uint8_t *cipherBlock,
+                           uint8_t *plainBlock)
 {
-    /* setup AES_KEY */
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-
-    res = aes_set_decrypt_key((unsigned char *)context->context,
-                              AES_KEY_SIZE * 8, &aeskey);
-
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef MODULE_CRYPTO_AES_UNROLL
@@ -1550,6 +1543,70 @@ int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
         (Td4((t0) & 0xff)       & 0x000000ff) ^
         rk[3];
     PUTU32(plainBlock + 12, s3);
+}
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
+
+int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
+                uint8_t *cipherBlock)
+{
+    return aes_encrypt_blocks(context, plainBlock, cipherBlock, 1);
+}
+
+int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
+                uint8_t *plainBlock)
+{
+    return aes_decrypt_blocks(context, cipherBlock, plainBlock, 1);
+}
+
+/*
+ * The T-table implementation expands the key schedule once per call instead of
+ * once per block, the bitsliced one uses the round keys from aes_init()
+ */
+int aes_encrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t numof)
+{
+#ifdef MODULE_CRYPTO_AES_BITSLICE
+    aes_bitslice_encrypt(context->context, input, output, numof);
+#else
+    int res;
+    AES_KEY aeskey;
+
+    res = aes_set_encrypt_key((unsigned char *)context->context,
+                              AES_KEY_SIZE * 8, &aeskey);
+    if (res < 0) {
+        return res;
+    }
+
+    for (; numof > 0; numof--) {
+        _encrypt_block(&aeskey, input, output);
+        input += AES_BLOCK_SIZE;
+        output += AES_BLOCK_SIZE;
+    }
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
+    return 1;
+}
+
+int aes_decrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t numof)
+{
+#ifdef MODULE_CRYPTO_AES_BITSLICE
+    aes_bitslice_decrypt(context->context, input, output, numof);
+#else
+    int res;
+    AES_KEY aeskey;
+
+    res = aes_set_decrypt_key((unsigned char *)context->context,
+                              AES_KEY_SIZE * 8, &aeskey);
+    if (res < 0) {
+        return res;
+    }
+
+    for (; numof > 0; numof--) {
+        _decrypt_block(&aeskey, input, output);
+        input += AES_BLOCK_SIZE;
+        output += AES_BLOCK_SIZE;
+    }
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
     return 1;
 }
 
@@ -0,0 +1,476 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Bitsliced constant-time AES-128
+ *
+ * The S-box is the circuit of Boyar and Peralta, "A depth-16 circuit for the
+ * AES S-box", 2011.
+ *
+ * @}
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "crypto/aes.h"
+#include "crypto/helper.h"
+#include "aes_bitslice.h"
+
+#ifdef MODULE_CRYPTO_AES_BITSLICE
+
+#if defined(__SIZEOF_POINTER__) && (__SIZEOF_POINTER__ >= 8)
+typedef uint64_t word_t;
+#else
+typedef uint32_t word_t;
+#endif
+
+/* Word q[j] holds bit j of every byte of the state. Each block takes a lane of
+ * 16 bits, in which the byte of row r and column c is bit 4 * c + r, the
+ * position of the byte in the input block. */
+#define LANES           (sizeof(word_t) * 8 / 16)
+#define ROUNDS          (10U)
+
+/* 16 bit pattern repeated for every lane */
+#define REP(x)          ((word_t)0x0001000100010001ULL * (x))
+#define ROW(r)          REP(0x1111U << (r))
+
+static void _sub_bytes(word_t *q)
+{
+    word_t x0, x1, x2, x3, x4, x5, x6, x7;
+    word_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15,
+           y16, y17, y18, y19, y20, y21;
+    word_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14,
+           z15, z16, z17;
+    word_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14,
+           t15, t16, t17, t18, t19, t20, t21, t22, t23, t24, t25, t26, t27,
+           t28, t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39, t40,
+           t41, t42, t43, t44, t45, t46, t47, t48, t49, t50, t51, t52, t53,
+           t54, t55, t56, t57, t58, t59, t60, t61, t62, t63, t64, t65, t66,
+           t67;
+
+    /* the circuit numbers bits starting with the most significant one */
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    /* top linear transformation */
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    /* non-linear section */
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    /* bottom linear transformation */
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    t67 = t64 ^ t65;
+
+    q[7] = t59 ^ t63;
+    q[1] = t56 ^ ~t62;
+    q[0] = t48 ^ ~t60;
+    q[4] = t53 ^ t66;
+    q[3] = t51 ^ t66;
+    q[2] = t47 ^ t65;
+    q[6] = t64 ^ ~q[4];
+    q[5] = t55 ^ ~t67;
+}
+
+/* inverse of the affine transformation of the S-box, see FIPS 197,
+ * section 5.3.2 */
+static void _inv_affine(word_t *q)
+{
+    word_t x[8];
+
+    for (unsigned i = 0; i < 8; i++) {
+        x[i] = q[(i + 2) % 8] ^ q[(i + 5) % 8] ^ q[(i + 7) % 8];
+    }
+    /* constant 0x05 */
+    q[0] = ~x[0];
+    q[1] = x[1];
+    q[2] = ~x[2];
+    for (unsigned i = 3; i < 8; i++) {
+        q[i] = x[i];
+    }
+}
+
+/* InvSubBytes(y) = InvAffine(SubBytes(InvAffine(y))), as SubBytes is the
+ * affine transformation of the inverse in GF(2^8) */
+static void _inv_sub_bytes(word_t *q)
+{
+    _inv_affine(q);
+    _sub_bytes(q);
+    _inv_affine(q);
+}
+
+/* moves column c + n to column c */
+static inline word_t _rot_cols(word_t x, unsigned n)
+{
+    word_t low = REP(0xffffU >> (4 * n));
+
+    return ((x >> (4 * n)) & low) | ((x << (16 - (4 * n))) & ~low);
+}
+
+/* row r is rotated left by r columns */
+static void _shift_rows(word_t *q)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] = (q[i] & ROW(0)) | (_rot_cols(q[i], 1) & ROW(1)) |
+               (_rot_cols(q[i], 2) & ROW(2)) | (_rot_cols(q[i], 3) & ROW(3));
+    }
+}
+
+static void _inv_shift_rows(word_t *q)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] = (q[i] & ROW(0)) | (_rot_cols(q[i], 3) & ROW(1)) |
+               (_rot_cols(q[i], 2) & ROW(2)) | (_rot_cols(q[i], 1) & ROW(3));
+    }
+}
+
+/* moves row r + 1 to row r of every column */
+static inline word_t _rot_row1(word_t x)
+{
+    return ((x >> 1) & REP(0x7777U)) | ((x << 3) & REP(0x8888U));
+}
+
+/* moves row r + 2 to row r of every column */
+static inline word_t _rot_row2(word_t x)
+{
+    return ((x >> 2) & REP(0x3333U)) | ((x << 2) & REP(0xccccU));
+}
+
+/* multiplication by x in GF(2^8) */
+static void _xtime(word_t *q)
+{
+    word_t hi = q[7];
+
+    q[7] = q[6];
+    q[6] = q[5];
+    q[5] = q[4];
+    q[4] = q[3] ^ hi;
+    q[3] = q[2] ^ hi;
+    q[2] = q[1];
+    q[1] = q[0] ^ hi;
+    q[0] = hi;
+}
+
+static void _mix_columns(word_t *q)
+{
+    word_t s[8], a1[8];
+
+    /* a'_r = 2 (a_r + a_r+1) + a_r+1 + (a_r+2 + a_r+3) */
+    for (unsigned i = 0; i < 8; i++) {
+        a1[i] = _rot_row1(q[i]);
+        s[i] = q[i] ^ a1[i];
+    }
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] = a1[i] ^ _rot_row2(s[i]);
+    }
+    _xtime(s);
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] ^= s[i];
+    }
+}
+
+static void _inv_mix_columns(word_t *q)
+{
+    word_t u[8];
+
+    /* the inverse is MixColumns after adding 4 (a_r + a_r+2) to each a_r,
+     * see "The Design of Rijndael", section 4.1.3 */
+    for (unsigned i = 0; i < 8; i++) {
+        u[i] = q[i] ^ _rot_row2(q[i]);
+    }
+    _xtime(u);
+    _xtime(u);
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] ^= u[i];
+    }
+    _mix_columns(q);
+}
+
+/* the round keys are kept in the byte array of the cipher context, which
+ * may not be aligned for uint16_t */
+static void _add_round_key(word_t *q, const uint8_t *sched, unsigned round)
+{
+    uint16_t rk[8];
+
+    memcpy(rk, &sched[round * sizeof(rk)], sizeof(rk));
+    for (unsigned i = 0; i < 8; i++) {
+        word_t k = rk[i];
+
+        /* repeat the round key for every lane */
+        for (unsigned shift = 16; shift < (sizeof(word_t) * 8); shift *= 2) {
+            k |= k << shift;
+        }
+        q[i] ^= k;
+    }
+}
+
+/* transposes the 8x8 bit matrix in which byte k holds row k, see
+ * Hacker's Delight, section 7-3 */
+static uint64_t _transpose(uint64_t x)
+{
+    uint64_t t;
+
+    t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+static void _load(word_t *q, const uint8_t *in, size_t numof)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] = 0;
+    }
+    for (unsigned pos = 0; pos < (16 * numof); pos += 8) {
+        uint64_t x = 0;
+
+        /* afterwards byte i holds bit i of the 8 input bytes */
+        for (unsigned k = 0; k < 8; k++) {
+            x |= (uint64_t)in[pos + k] << (8 * k);
+        }
+        x = _transpose(x);
+        for (unsigned i = 0; i < 8; i++) {
+            q[i] |= (word_t)((x >> (8 * i)) & 0xff) << pos;
+        }
+    }
+}
+
+static void _store(const word_t *q, uint8_t *out, size_t numof)
+{
+    for (unsigned pos = 0; pos < (16 * numof); pos += 8) {
+        uint64_t x = 0;
+
+        for (unsigned i = 0; i < 8; i++) {
+            x |= (uint64_t)((q[i] >> pos) & 0xff) << (8 * i);
+        }
+        x = _transpose(x);
+        for (unsigned k = 0; k < 8; k++) {
+            out[pos + k] = (uint8_t)(x >> (8 * k));
+        }
+    }
+}
+
+/* FIPS 197, section 5.2, with the round keys bitsliced for a single lane */
+void aes_bitslice_expand_key(const uint8_t *key, uint8_t *sched)
+{
+    uint16_t rk[8];
+    uint8_t w[4 * (ROUNDS + 1)][4];
+    uint8_t rcon = 0x01;
+    word_t q[8];
+
+    memcpy(w, key, AES_KEY_SIZE);
+    for (unsigned i = 4; i < 4 * (ROUNDS + 1); i++) {
+        uint8_t t[4];
+
+        memcpy(t, w[i - 1], 4);
+        if ((i % 4) == 0) {
+            /* SubWord(RotWord(t)), bitsliced to keep the key out of any
+             * table index */
+            uint8_t rot[AES_BLOCK_SIZE] = { t[1], t[2], t[3], t[0] };
+
+            _load(q, rot, 1);
+            _sub_bytes(q);
+            _store(q, rot, 1);
+            memcpy(t, rot, 4);
+            t[0] ^= rcon;
+            rcon = (rcon << 1) ^ (0x1b & -(rcon >> 7));
+        }
+        for (unsigned j = 0; j < 4; j++) {
+            w[i][j] = w[i - 4][j] ^ t[j];
+        }
+    }
+    for (unsigned r = 0; r <= ROUNDS; r++) {
+        _load(q, w[4 * r], 1);
+        for (unsigned i = 0; i < 8; i++) {
+            rk[i] = (uint16_t)q[i];
+        }
+        memcpy(&sched[r * sizeof(rk)], rk, sizeof(rk));
+    }
+    crypto_secure_wipe(rk, sizeof(rk));
+    crypto_secure_wipe(w, sizeof(w));
+    crypto_secure_wipe(q, sizeof(q));
+}
+
+void aes_bitslice_encrypt(const uint8_t *sched, const uint8_t *input,
+                          uint8_t *output, size_t numof)
+{
+    word_t q[8];
+
+    while (numof > 0) {
+        size_t n = (numof < LANES) ? numof : LANES;
+
+        _load(q, input, n);
+        _add_round_key(q, sched, 0);
+        for (unsigned r = 1; r < ROUNDS; r++) {
+            _sub_bytes(q);
+            _shift_rows(q);
+            _mix_columns(q);
+            _add_round_key(q, sched, r);
+        }
+        _sub_bytes(q);
+        _shift_rows(q);
+        _add_round_key(q, sched, ROUNDS);
+        _store(q, output, n);
+
+        input += n * AES_BLOCK_SIZE;
+        output += n * AES_BLOCK_SIZE;
+        numof -= n;
+    }
+    crypto_secure_wipe(q, sizeof(q));
+}
+
+void aes_bitslice_decrypt(const uint8_t *sched, const uint8_t *input,
+                          uint8_t *output, size_t numof)
+{
+    word_t q[8];
+
+    while (numof > 0) {
+        size_t n = (numof < LANES) ? numof : LANES;
+
+        _load(q, input, n);
+        _add_round_key(q, sched, ROUNDS);
+        for (unsigned r = ROUNDS - 1; r > 0; r--) {
+            _inv_shift_rows(q);
+            _inv_sub_bytes(q);
+            _add_round_key(q, sched, r);
+            _inv_mix_columns(q);
+        }
+        _inv_shift_rows(q);
+        _inv_sub_bytes(q);
+        _add_round_key(q, sched, 0);
+        _store(q, output, n);
+
+        input += n * AES_BLOCK_SIZE;
+        output += n * AES_BLOCK_SIZE;
+        numof -= n;
+    }
+    crypto_secure_wipe(q, sizeof(q));
+}
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_CRYPTO_AES_BITSLICE */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @internal
+ * @{
+ *
+ * @file
+ * @brief       Bitsliced constant-time AES-128, used by the AES cipher when
+ *              the `crypto_aes_bitslice` pseudomodule is used
+ *
+ * Neither the key nor the data select a memory address or a branch, so the
+ * runtime does not depend on them. All blocks processed in parallel share a
+ * machine word: 2 blocks on 32-bit platforms and 4 blocks on 64-bit platforms.
+ */
+#ifndef AES_BITSLICE_H
+#define AES_BITSLICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of the expanded key in bytes: 11 round keys of 16 bytes
+ */
+#define AES_BITSLICE_KEY_SCHED_SIZE     (176U)
+
+/**
+ * @brief   Expands a key into the round keys used by the bitsliced AES
+ *
+ * @param[in] key       16 byte AES-128 key
+ * @param[out] sched    @ref AES_BITSLICE_KEY_SCHED_SIZE bytes for the round
+ *                      keys
+ */
+void aes_bitslice_expand_key(const uint8_t *key, uint8_t *sched);
+
+/**
+ * @brief   Encrypts consecutive blocks
+ *
+ * @param[in] sched     round keys from aes_bitslice_expand_key()
+ * @param[in] input     @p numof plaintext blocks
+ * @param[out] output   @p numof ciphertext blocks, may be @p input
+ * @param[in] numof     number of blocks
+ */
+void aes_bitslice_encrypt(const uint8_t *sched, const uint8_t *input,
+                          uint8_t *output, size_t numof);
+
+/**
+ * @brief   Decrypts consecutive blocks
+ *
+ * @param[in] sched     round keys from aes_bitslice_expand_key()
+ * @param[in] input     @p numof ciphertext blocks
+ * @param[out] output   @p numof plaintext blocks, may be @p input
+ * @param[in] numof     number of blocks
+ */
+void aes_bitslice_decrypt(const uint8_t *sched, const uint8_t *input,
+                          uint8_t *output, size_t numof);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AES_BITSLICE_H */
+/** @} */
@@ -28,9 +28,12 @@
  *  - It is implemented for little code and data size, but will likely be
  *    slower than the refenrence implementation. Optimized implementation will
  *    out-perform the code even more.
+ *  - With CHACHA_VECTORIZE, chacha_keystream_blocks() computes four blocks at
+ *    once with the vector extensions of GCC.
  */
 
 #include "crypto/chacha.h"
+#include "crypto/helper.h"
 #include "byteorder.h"
 
 #if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
@@ -74,6 +77,83 @@ static void _doubleround(void *output_, const uint32_t input[16],
     }
 }
 
+/* increments the block counter in state[13]:state[12] */
+static void _inc_counter(chacha_ctx *ctx, uint32_t n)
+{
+    uint32_t old = ctx->state[12];
+
+    ctx->state[12] += n;
+    if (ctx->state[12] < old) {
+        ++ctx->state[13];
+    }
+}
+
+#if CHACHA_VECTORIZE
+/* number of blocks computed at once */
+#define CHACHA_PARALLEL     (4U)
+
+/* lane i of a vector holds a word of block i */
+typedef uint32_t _v4u32 __attribute__((vector_size(16)));
+
+static inline _v4u32 _rotl4(_v4u32 x, unsigned c)
+{
+    return (x << c) | (x >> (32 - c));
+}
+
+static inline void _qr4(_v4u32 *x, unsigned a, unsigned b, unsigned c,
+                        unsigned d)
+{
+    x[a] += x[b];
+    x[d] = _rotl4(x[d] ^ x[a], 16);
+    x[c] += x[d];
+    x[b] = _rotl4(x[b] ^ x[c], 12);
+    x[a] += x[b];
+    x[d] = _rotl4(x[d] ^ x[a], 8);
+    x[c] += x[d];
+    x[b] = _rotl4(x[b] ^ x[c], 7);
+}
+
+/* computes the next four blocks without incrementing the counter */
+static void _blocks4(uint8_t *output, const chacha_ctx *ctx)
+{
+    const uint32_t *s = ctx->state;
+    _v4u32 x[16], in[16];
+
+    for (unsigned j = 0; j < 16; ++j) {
+        in[j] = (_v4u32){ s[j], s[j], s[j], s[j] };
+    }
+    for (unsigned i = 0; i < CHACHA_PARALLEL; ++i) {
+        uint32_t lo = s[12] + i;
+
+        in[12][i] = lo;
+        in[13][i] = s[13] + (lo < s[12]);
+    }
+    memcpy(x, in, sizeof(x));
+
+    for (unsigned i = 0; i < ctx->rounds; i += 2) {
+        _qr4(x, 0, 4,  8, 12);
+        _qr4(x, 1, 5,  9, 13);
+        _qr4(x, 2, 6, 10, 14);
+        _qr4(x, 3, 7, 11, 15);
+        _qr4(x, 0, 5, 10, 15);
+        _qr4(x, 1, 6, 11, 12);
+        _qr4(x, 2, 7,  8, 13);
+        _qr4(x, 3, 4,  9, 14);
+    }
+
+    for (unsigned j = 0; j < 16; ++j) {
+        x[j] += in[j];
+        for (unsigned i = 0; i < CHACHA_PARALLEL; ++i) {
+            uint32_t word = x[j][i];
+
+            memcpy(&output[i * CHACHA_BLOCK_SIZE + j * 4], &word, 4);
+        }
+    }
+}
+#else
+#define CHACHA_PARALLEL     (1U)
+#endif
+
 int chacha_init(chacha_ctx *ctx,
                 unsigned rounds,
                 const uint8_t *key, uint32_t keylen,
@@ -108,10 +188,30 @@ int chacha_init(chacha_ctx *ctx,
 void chacha_keystream_bytes(chacha_ctx *ctx, void *x)
 {
     _doubleround(x, ctx->state, ctx->rounds);
+    _inc_counter(ctx, 1);
+}
 
-    ++ctx->state[12];
-    if (ctx->state[12] == 0) {
-        ++ctx->state[13];
+void chacha_keystream_blocks(chacha_ctx *ctx, void *x, size_t numof)
+{
+    uint8_t *out = x;
+
+#if CHACHA_VECTORIZE
+    for (; numof >= CHACHA_PARALLEL; numof -= CHACHA_PARALLEL) {
+        _blocks4(out, ctx);
+        _inc_counter(ctx, CHACHA_PARALLEL);
+        out += CHACHA_PARALLEL * CHACHA_BLOCK_SIZE;
+    }
+#endif
+    if (numof > 0) {
+        /* chacha_keystream_bytes() needs an aligned buffer */
+        uint32_t block[16];
+
+        do {
+            chacha_keystream_bytes(ctx, block);
+            memcpy(out, block, sizeof(block));
+            out += sizeof(block);
+        } while (--numof > 0);
+        crypto_secure_wipe(block, sizeof(block));
     }
 }
 
@@ -124,3 +224,31 @@ void chacha_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c)
         c[i] = m[i] ^ x[i];
     }
 }
+
+void chacha_encrypt_buf(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
+                        size_t len)
+{
+    uint32_t stream[CHACHA_PARALLEL * 16];
+
+    while (len > 0) {
+        size_t numof = (len + CHACHA_BLOCK_SIZE - 1) / CHACHA_BLOCK_SIZE;
+        size_t n;
+
+        if (numof > CHACHA_PARALLEL) {
+            numof = CHACHA_PARALLEL;
+        }
+        chacha_keystream_blocks(ctx, stream, numof);
+
+        n = numof * CHACHA_BLOCK_SIZE;
+        if (n > len) {
+            n = len;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            c[i] = m[i] ^ ((uint8_t *)stream)[i];
+        }
+        m += n;
+        c += n;
+        len -= n;
+    }
+    crypto_secure_wipe(stream, sizeof(stream));
+}
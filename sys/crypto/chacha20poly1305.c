@@ -24,6 +24,7 @@
 #include <string.h>
 
 #include "crypto/helper.h"
+#include "crypto/chacha.h"
 #include "crypto/chacha20poly1305.h"
 #include "crypto/poly1305.h"
 
@@ -33,12 +34,6 @@
 #   error "This code is implementented in a way that it will only work for little-endian systems!"
 #endif
 
-/* Nothing to hide here, Literally "expand 32-byte k" */
-static const uint32_t constant[] = {0x61707865,
-                                    0x3320646e,
-                                    0x79622d32,
-                                    0x6b206574};
-
 /* Padding to add to the poly1305 authentication tag */
 static const uint8_t padding[15] = {0};
 
@@ -51,71 +46,46 @@ static uint32_t u8to32(const uint8_t *p)
         ((uint32_t)p[3] << 24));
 }
 
-/* Single round */
-void _r(uint32_t *a, uint32_t *b, uint32_t *d, unsigned c)
-{
-    *a += *b;
-    uint32_t tmp = *a ^ *d;
-    *d = (tmp << c) | (tmp >> (32 - c));
-}
-
-void _add_initial(chacha20poly1305_ctx_t *ctx, const uint8_t *key,
-                  const uint8_t *nonce, uint32_t blk)
+/* Sets up the ChaCha20 state of RFC 8439, which uses a 32 bit block counter
+ * and a 96 bit nonce */
+static void _chacha_init(chacha_ctx *cctx, const uint8_t *key,
+                         const uint8_t *nonce, uint32_t blk)
 {
-    for (unsigned i = 0; i < 4; i++) {
-        ctx->state[i] += constant[i];
-    }
+    /* Nothing to hide here, Literally "expand 32-byte k" */
+    cctx->state[0] = 0x61707865;
+    cctx->state[1] = 0x3320646e;
+    cctx->state[2] = 0x79622d32;
+    cctx->state[3] = 0x6b206574;
     for (unsigned i = 0; i < 8; i++) {
-        ctx->state[i+4] += u8to32(key + 4*i);
+        cctx->state[i+4] = u8to32(key + 4*i);
     }
-    ctx->state[12] += u8to32((uint8_t*)&blk);
-    ctx->state[13] += u8to32(nonce);
-    ctx->state[14] += u8to32(nonce+4);
-    ctx->state[15] += u8to32(nonce+8);
+    cctx->state[12] = blk;
+    cctx->state[13] = u8to32(nonce);
+    cctx->state[14] = u8to32(nonce+4);
+    cctx->state[15] = u8to32(nonce+8);
+    cctx->rounds = 20;
 }
 
 void _keystream(chacha20poly1305_ctx_t *ctx, const uint8_t *key,
                 const uint8_t *nonce, uint32_t blk)
 {
-    /* Initialize block state */
-    memset(ctx->state, 0, sizeof(ctx->state));
-    _add_initial(ctx, key, nonce, blk);
+    chacha_ctx cctx;
 
-    /* perform rounds */
-    for (unsigned i = 0; i < 80; ++i) {
-        uint32_t *a = &ctx->state[((i                    ) & 3)          ];
-        uint32_t *b = &ctx->state[((i + ((i & 4) ? 1 : 0)) & 3) + (4 * 1)];
-        uint32_t *c = &ctx->state[((i + ((i & 4) ? 2 : 0)) & 3) + (4 * 2)];
-        uint32_t *d = &ctx->state[((i + ((i & 4) ? 3 : 0)) & 3) + (4 * 3)];
-        _r(a, b, d, 16);
-        _r(c, d, b, 12);
-        _r(a, b, d, 8);
-        _r(c, d, b, 7);
-    }
-    /* add initial state */
-    _add_initial(ctx, key, nonce, blk);
+    _chacha_init(&cctx, key, nonce, blk);
+    chacha_keystream_bytes(&cctx, ctx->state);
+    crypto_secure_wipe(&cctx, sizeof(cctx));
 }
 
-void _xcrypt(chacha20poly1305_ctx_t *ctx, const uint8_t *key,
-              const uint8_t *nonce, const uint8_t *in, uint8_t *out, size_t len)
+/* RFC 8439 limits messages to 2^32 - 1 blocks, so the block counter does not
+ * overflow into the nonce */
+void _xcrypt(const uint8_t *key, const uint8_t *nonce,
+             const uint8_t *in, uint8_t *out, size_t len)
 {
-    /* Number of full 64 byte blocks */
-    const size_t num_blocks = len >> 6;
-    size_t pos = 0;
-    /* xcrypt full blocks */
-    for (size_t i = 0; i < num_blocks; i++, pos += 64) {
-        _keystream(ctx, key, nonce, i+1);
-        for (size_t j = 0; j < 64; j++) {
-            out[pos+j] = in[pos+j] ^ ((uint8_t*)ctx->state)[j];
-        }
-    }
-    /* xcrypt remaining bytes */
-    if (len - pos) {
-        _keystream(ctx, key, nonce, num_blocks+1);
-        for (size_t j = 0; j < len - pos; j++) {
-            out[pos+j] = in[pos+j] ^ ((uint8_t*)ctx->state)[j];
-        }
-    }
+    chacha_ctx cctx;
+
+    _chacha_init(&cctx, key, nonce, 1);
+    chacha_encrypt_buf(&cctx, in, out, len);
+    crypto_secure_wipe(&cctx, sizeof(cctx));
 }
 
 void _poly1305_padded(poly1305_ctx_t *pctx, const uint8_t *data, size_t len)
@@ -149,13 +119,10 @@ void chacha20poly1305_encrypt(uint8_t *cipher, const uint8_t *msg,
                               size_t msglen, const uint8_t *aad, size_t aadlen,
                               const uint8_t *key, const uint8_t *nonce)
 {
-    chacha20poly1305_ctx_t ctx;
-    _xcrypt(&ctx, key, nonce, msg, cipher, msglen);
-    crypto_secure_wipe(&ctx, sizeof(ctx));
+    _xcrypt(key, nonce, msg, cipher, msglen);
     /* Generate tag */
     _poly1305_gentag(&cipher[msglen], key, nonce,
                     cipher, msglen, aad, aadlen);
-    /* Wipe structures */
 }
 
 int chacha20poly1305_decrypt(const uint8_t *cipher, size_t cipherlen,
@@ -170,8 +137,6 @@ int chacha20poly1305_decrypt(const uint8_t *cipher, size_t cipherlen,
     if (crypto_equals(cipher+*msglen, mac, CHACHA20POLY1305_TAG_BYTES) == 0) {
         return 0;
     }
-    chacha20poly1305_ctx_t ctx;
-    /* Number of full blocks */
-    _xcrypt(&ctx, key, nonce, cipher, msg, *msglen);
+    _xcrypt(key, nonce, cipher, msg, *msglen);
     return 1;
 }
@@ -27,6 +27,7 @@
  */
 
 #include "crypto/chacha.h"
+#include "kernel_defines.h"
 #include "mutex.h"
 
 #include <string.h>
@@ -54,8 +55,9 @@ uint32_t chacha_prng_next(void)
     mutex_lock(&_chacha_prng_mutex);
 
     if (--_chacha_prng_pos < 0) {
-        _chacha_prng_pos = 15;
-        chacha_keystream_bytes(&_chacha_prng_ctx, _chacha_prng_data);
+        _chacha_prng_pos = ARRAY_SIZE(_chacha_prng_data) - 1;
+        chacha_keystream_blocks(&_chacha_prng_ctx, _chacha_prng_data,
+                                sizeof(_chacha_prng_data) / CHACHA_BLOCK_SIZE);
     }
     uint32_t result = _chacha_prng_data[_chacha_prng_pos];
 
@@ -17,11 +17,17 @@
 #include <string.h>
 #include <stdio.h>
 #include "crypto/ciphers.h"
+#ifdef MODULE_CRYPTO_ACCEL
+#include "crypto/accel.h"
+#endif
 
 
 int cipher_init(cipher_t *cipher, cipher_id_t cipher_id, const uint8_t *key,
                 uint8_t key_size)
 {
+#ifdef MODULE_CRYPTO_ACCEL
+    cipher_id = crypto_accel_cipher(cipher_id);
+#endif
     if (key_size > cipher_id->max_key_size) {
         return CIPHER_ERR_INVALID_KEY_SIZE;
     }
@@ -46,6 +52,48 @@ int cipher_decrypt(const cipher_t *cipher, const uint8_t *input,
 }
 
 
+int cipher_encrypt_blocks(const cipher_t *cipher, const uint8_t *input,
+                          uint8_t *output, size_t numof)
+{
+    const cipher_interface_t *interface = cipher->interface;
+
+    if (interface->encrypt_blocks) {
+        return interface->encrypt_blocks(&cipher->context, input, output,
+                                         numof);
+    }
+    for (; numof > 0; numof--) {
+        int res = interface->encrypt(&cipher->context, input, output);
+        if (res != 1) {
+            return res;
+        }
+        input += interface->block_size;
+        output += interface->block_size;
+    }
+    return 1;
+}
+
+
+int cipher_decrypt_blocks(const cipher_t *cipher, const uint8_t *input,
+                          uint8_t *output, size_t numof)
+{
+    const cipher_interface_t *interface = cipher->interface;
+
+    if (interface->decrypt_blocks) {
+        return interface->decrypt_blocks(&cipher->context, input, output,
+                                         numof);
+    }
+    for (; numof > 0; numof--) {
+        int res = interface->decrypt(&cipher->context, input, output);
+        if (res != 1) {
+            return res;
+        }
+        input += interface->block_size;
+        output += interface->block_size;
+    }
+    return 1;
+}
+
+
 int cipher_get_block_size(const cipher_t *cipher)
 {
     return cipher->interface->block_size;
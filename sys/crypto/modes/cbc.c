@@ -58,8 +58,8 @@ int cipher_decrypt_cbc(cipher_t *cipher, uint8_t iv[16],
                        const uint8_t *input, size_t length, uint8_t *output)
 {
     size_t offset = 0;
-    const uint8_t *input_block, *input_block_last;
-    uint8_t block_size;
+    uint8_t block_size, input_block_last[CIPHER_MAX_BLOCK_SIZE],
+            plain[CIPHER_BLOCKS_PER_CALL * CIPHER_MAX_BLOCK_SIZE];
 
 
     block_size = cipher_get_block_size(cipher);
@@ -67,22 +67,35 @@ int cipher_decrypt_cbc(cipher_t *cipher, uint8_t iv[16],
         return CIPHER_ERR_INVALID_LENGTH;
     }
 
-    input_block_last = iv;
+    /* the blocks decrypt independently, only the XOR is chained */
+    memcpy(input_block_last, iv, block_size);
     do {
-        input_block = input + offset;
-        uint8_t *output_block = output + offset;
+        size_t len = length - offset;
+        const uint8_t *input_blocks = input + offset;
+        uint8_t *output_blocks = output + offset;
 
-        if (cipher_decrypt(cipher, input_block, output_block) != 1) {
+        if (len > (CIPHER_BLOCKS_PER_CALL * block_size)) {
+            len = CIPHER_BLOCKS_PER_CALL * block_size;
+        }
+        if (cipher_decrypt_blocks(cipher, input_blocks, plain,
+                                  len / block_size) != 1) {
             return CIPHER_ERR_DEC_FAILED;
         }
 
-        /* CBC-Mode: XOR plaintext with ciphertext of (n-1)-th block */
+        /* CBC-Mode: XOR plaintext with ciphertext of (n-1)-th block. Going
+         * backwards keeps the ciphertext intact until it was used, if output
+         * and input are the same buffer. */
+        uint8_t last[CIPHER_MAX_BLOCK_SIZE];
+        memcpy(last, input_blocks + len - block_size, block_size);
+        for (size_t i = len; i-- > block_size;) {
+            output_blocks[i] = plain[i] ^ input_blocks[i - block_size];
+        }
         for (uint8_t i = 0; i < block_size; ++i) {
-            output_block[i] ^= input_block_last[i];
+            output_blocks[i] = plain[i] ^ input_block_last[i];
         }
 
-        input_block_last = input_block;
-        offset += block_size;
+        memcpy(input_block_last, last, block_size);
+        offset += len;
     } while (offset < length);
 
     return offset;
@@ -18,6 +18,8 @@
  * @}
  */
 
+#include <string.h>
+
 #include "crypto/helper.h"
 #include "crypto/modes/ctr.h"
 
@@ -26,24 +28,34 @@ int cipher_encrypt_ctr(cipher_t *cipher, uint8_t nonce_counter[16],
                        uint8_t *output)
 {
     size_t offset = 0;
-    uint8_t stream_block[16] = { 0 }, block_size;
+    uint8_t stream[CIPHER_BLOCKS_PER_CALL * CIPHER_MAX_BLOCK_SIZE],
+            block_size;
 
     block_size = cipher_get_block_size(cipher);
     do {
-        uint8_t block_size_input;
+        size_t len = length - offset;
+        size_t numof;
+
+        if (len > (CIPHER_BLOCKS_PER_CALL * block_size)) {
+            len = CIPHER_BLOCKS_PER_CALL * block_size;
+        }
+        /* an empty input still consumes a counter block */
+        numof = (len > 0) ? ((len + block_size - 1) / block_size) : 1;
 
-        if (cipher_encrypt(cipher, nonce_counter, stream_block) != 1) {
+        /* encrypt the counter blocks of this chunk at once */
+        for (size_t i = 0; i < numof; ++i) {
+            memcpy(&stream[i * block_size], nonce_counter, block_size);
+            crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+        }
+        if (cipher_encrypt_blocks(cipher, stream, stream, numof) != 1) {
             return CIPHER_ERR_ENC_FAILED;
         }
 
-        block_size_input = (length - offset > block_size) ?
-                           block_size : length - offset;
-        for (uint8_t i = 0; i < block_size_input; ++i) {
-            output[offset + i] = stream_block[i] ^ input[offset + i];
+        for (size_t i = 0; i < len; ++i) {
+            output[offset + i] = stream[i] ^ input[offset + i];
         }
 
-        offset += block_size_input;
-        crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+        offset += len;
     } while (offset < length);
 
     return offset;
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Crypto mode - Galois/Counter Mode
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "crypto/helper.h"
+#include "crypto/modes/gcm.h"
+
+/* SP 800-38D, section 5.2.1.1: at most 2^32 - 2 blocks of plaintext */
+#define GCM_MAX_BLOCKS      (0xfffffffeULL)
+
+typedef struct {
+    /* multiples of H by all 4-bit values, split into high and low half */
+    uint64_t hh[16];
+    uint64_t hl[16];
+    uint8_t y[GCM_BLOCK_SIZE];
+} ghash_t;
+
+/* reduction of the 4 bits shifted out of the field element, multiplied by
+ * the GCM polynomial */
+static const uint16_t last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static uint64_t get_be64(const uint8_t *buf)
+{
+    uint64_t res = 0;
+
+    for (unsigned i = 0; i < 8; ++i) {
+        res = (res << 8) | buf[i];
+    }
+    return res;
+}
+
+static void put_be64(uint8_t *buf, uint64_t val)
+{
+    for (int i = 7; i >= 0; --i) {
+        buf[i] = val & 0xff;
+        val >>= 8;
+    }
+}
+
+/* builds the 4-bit table of Shoup's method, see section 4.1 of the GCM
+ * specification by McGrew and Viega */
+static void ghash_init(ghash_t *g, const uint8_t h[GCM_BLOCK_SIZE])
+{
+    uint64_t vh = get_be64(h), vl = get_be64(&h[8]);
+
+    g->hh[0] = 0;
+    g->hl[0] = 0;
+    g->hh[8] = vh;
+    g->hl[8] = vl;
+    /* the most significant bit of a nibble is the lowest power of x */
+    for (unsigned i = 4; i > 0; i >>= 1) {
+        uint64_t reduce = (vl & 1) ? 0xe100000000000000ULL : 0;
+
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ reduce;
+        g->hh[i] = vh;
+        g->hl[i] = vl;
+    }
+    for (unsigned i = 2; i <= 8; i *= 2) {
+        for (unsigned j = 1; j < i; ++j) {
+            g->hh[i + j] = g->hh[i] ^ g->hh[j];
+            g->hl[i + j] = g->hl[i] ^ g->hl[j];
+        }
+    }
+    memset(g->y, 0, sizeof(g->y));
+}
+
+static inline void ghash_shift4(uint64_t *zh, uint64_t *zl)
+{
+    unsigned rem = *zl & 0xf;
+
+    *zl = (*zh << 60) | (*zl >> 4);
+    *zh = (*zh >> 4) ^ ((uint64_t)last4[rem] << 48);
+}
+
+/* y = y * H */
+static void ghash_mult(ghash_t *g)
+{
+    uint64_t zh, zl;
+    unsigned lo = g->y[15] & 0xf;
+
+    zh = g->hh[lo];
+    zl = g->hl[lo];
+    for (int i = 15; i >= 0; --i) {
+        lo = g->y[i] & 0xf;
+        if (i != 15) {
+            ghash_shift4(&zh, &zl);
+            zh ^= g->hh[lo];
+            zl ^= g->hl[lo];
+        }
+        ghash_shift4(&zh, &zl);
+        zh ^= g->hh[g->y[i] >> 4];
+        zl ^= g->hl[g->y[i] >> 4];
+    }
+    put_be64(g->y, zh);
+    put_be64(&g->y[8], zl);
+}
+
+/* hashes data, zero padding an incomplete last block */
+static void ghash_update(ghash_t *g, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        size_t n = (len < GCM_BLOCK_SIZE) ? len : GCM_BLOCK_SIZE;
+
+        for (size_t i = 0; i < n; ++i) {
+            g->y[i] ^= data[i];
+        }
+        ghash_mult(g);
+        data += n;
+        len -= n;
+    }
+}
+
+/* hashes the block holding the bit lengths of both inputs */
+static void ghash_lengths(ghash_t *g, uint64_t a_len, uint64_t c_len)
+{
+    uint8_t block[GCM_BLOCK_SIZE];
+
+    put_be64(block, a_len * 8);
+    put_be64(&block[8], c_len * 8);
+    ghash_update(g, block, sizeof(block));
+}
+
+static int gcm_check_params(cipher_t *cipher, uint8_t tag_len,
+                            size_t nonce_len, size_t len)
+{
+    if (cipher_get_block_size(cipher) != GCM_BLOCK_SIZE) {
+        return GCM_ERR_INVALID_BLOCK_LENGTH;
+    }
+    if ((tag_len > GCM_BLOCK_SIZE) ||
+        ((tag_len < 12) && (tag_len != 8) && (tag_len != 4))) {
+        return GCM_ERR_INVALID_TAG_LENGTH;
+    }
+    if (nonce_len == 0) {
+        return GCM_ERR_INVALID_NONCE_LENGTH;
+    }
+    if ((len > (INT32_MAX - GCM_BLOCK_SIZE)) ||
+        (((uint64_t)len / GCM_BLOCK_SIZE) >= GCM_MAX_BLOCKS)) {
+        return GCM_ERR_INVALID_DATA_LENGTH;
+    }
+    return 0;
+}
+
+/* computes the ciphertext (plaintext if decrypt is set) and the full tag.
+ * Counter mode and GHASH alternate per chunk of CIPHER_BLOCKS_PER_CALL blocks,
+ * so each chunk is hashed while still in the cache. */
+static int gcm_crypt(cipher_t *cipher,
+                     const uint8_t *auth_data, size_t auth_data_len,
+                     const uint8_t *nonce, size_t nonce_len,
+                     const uint8_t *input, size_t len, uint8_t *output,
+                     uint8_t tag[GCM_BLOCK_SIZE], bool decrypt)
+{
+    ghash_t g;
+    uint8_t counter[GCM_BLOCK_SIZE] = { 0 }, ek0[GCM_BLOCK_SIZE],
+            stream[CIPHER_BLOCKS_PER_CALL * GCM_BLOCK_SIZE];
+    size_t offset = 0;
+    int res = 0;
+
+    /* H = E(K, 0^128) */
+    if (cipher_encrypt(cipher, counter, stream) != 1) {
+        return CIPHER_ERR_ENC_FAILED;
+    }
+    ghash_init(&g, stream);
+
+    /* pre-counter block J0 */
+    if (nonce_len == 12) {
+        memcpy(counter, nonce, nonce_len);
+        counter[15] = 1;
+    }
+    else {
+        ghash_update(&g, nonce, nonce_len);
+        ghash_lengths(&g, 0, nonce_len);
+        memcpy(counter, g.y, GCM_BLOCK_SIZE);
+        memset(g.y, 0, sizeof(g.y));
+    }
+    if (cipher_encrypt(cipher, counter, ek0) != 1) {
+        res = CIPHER_ERR_ENC_FAILED;
+        goto out;
+    }
+
+    ghash_update(&g, auth_data, auth_data_len);
+
+    while (offset < len) {
+        size_t chunk = len - offset;
+        size_t numof;
+
+        if (chunk > sizeof(stream)) {
+            chunk = sizeof(stream);
+        }
+        numof = (chunk + GCM_BLOCK_SIZE - 1) / GCM_BLOCK_SIZE;
+
+        /* inc32: only the last 4 bytes are incremented */
+        for (size_t i = 0; i < numof; ++i) {
+            crypto_block_inc_ctr(counter, 4);
+            memcpy(&stream[i * GCM_BLOCK_SIZE], counter, GCM_BLOCK_SIZE);
+        }
+        if (cipher_encrypt_blocks(cipher, stream, stream, numof) != 1) {
+            res = CIPHER_ERR_ENC_FAILED;
+            goto out;
+        }
+
+        /* GHASH covers the ciphertext: hash the input before it may be
+         * overwritten when decrypting in place */
+        if (decrypt) {
+            ghash_update(&g, &input[offset], chunk);
+        }
+        for (size_t i = 0; i < chunk; ++i) {
+            output[offset + i] = input[offset + i] ^ stream[i];
+        }
+        if (!decrypt) {
+            ghash_update(&g, &output[offset], chunk);
+        }
+        offset += chunk;
+    }
+
+    ghash_lengths(&g, auth_data_len, len);
+    for (unsigned i = 0; i < GCM_BLOCK_SIZE; ++i) {
+        tag[i] = g.y[i] ^ ek0[i];
+    }
+
+out:
+    crypto_secure_wipe(&g, sizeof(g));
+    crypto_secure_wipe(ek0, sizeof(ek0));
+    crypto_secure_wipe(stream, sizeof(stream));
+    return res;
+}
+
+int cipher_encrypt_gcm(cipher_t *cipher,
+                       const uint8_t *auth_data, size_t auth_data_len,
+                       uint8_t tag_len,
+                       const uint8_t *nonce, size_t nonce_len,
+                       const uint8_t *input, size_t input_len,
+                       uint8_t *output)
+{
+    uint8_t tag[GCM_BLOCK_SIZE];
+    int res;
+
+    res = gcm_check_params(cipher, tag_len, nonce_len, input_len);
+    if (res < 0) {
+        return res;
+    }
+    res = gcm_crypt(cipher, auth_data, auth_data_len, nonce, nonce_len,
+                    input, input_len, output, tag, false);
+    if (res < 0) {
+        return res;
+    }
+    memcpy(&output[input_len], tag, tag_len);
+    return input_len + tag_len;
+}
+
+int cipher_decrypt_gcm(cipher_t *cipher,
+                       const uint8_t *auth_data, size_t auth_data_len,
+                       uint8_t tag_len,
+                       const uint8_t *nonce, size_t nonce_len,
+                       const uint8_t *input, size_t input_len,
+                       uint8_t *output)
+{
+    uint8_t tag[GCM_BLOCK_SIZE];
+    size_t plain_len;
+    int res;
+
+    if (input_len < tag_len) {
+        return GCM_ERR_INVALID_DATA_LENGTH;
+    }
+    plain_len = input_len - tag_len;
+    res = gcm_check_params(cipher, tag_len, nonce_len, plain_len);
+    if (res < 0) {
+        return res;
+    }
+    res = gcm_crypt(cipher, auth_data, auth_data_len, nonce, nonce_len,
+                    input, plain_len, output, tag, true);
+    if (res < 0) {
+        return res;
+    }
+    if (!crypto_equals(tag, &input[plain_len], tag_len)) {
+        crypto_secure_wipe(output, plain_len);
+        return GCM_ERR_INVALID_TAG;
+    }
+    return plain_len;
+}
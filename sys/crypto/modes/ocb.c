@@ -77,32 +77,41 @@ static void xor_block(uint8_t block1[16], uint8_t block2[16],
     }
 }
 
-static void processBlock(ocb_state_t *state, size_t blockNumber,
-                         uint8_t input[16], uint8_t output[16], uint8_t mode)
+static void processBlocks(ocb_state_t *state, size_t blockNumber,
+                          uint8_t *input, uint8_t *output, size_t numof,
+                          uint8_t mode)
 {
-    /* Offset_i = Offset_{i-1} xor L_{ntz(i)} */
-    uint8_t l_i[16];
-
-    calculate_l_i(state->l_zero, ntz(blockNumber + 1), l_i);
-    xor_block(state->offset, l_i, state->offset);
-    /* Sum_i = Sum_{i-1} xor ENCIPHER(K, A_i xor Offset_i) */
-    uint8_t cipher_output[16], cipher_input[16];
-    xor_block(input, state->offset, cipher_input);
-    if (mode == OCB_MODE_ENCRYPT) {
-        state->cipher->interface->encrypt(&(state->cipher->context),
-                                          cipher_input, cipher_output);
-    }
-    else if (mode == OCB_MODE_DECRYPT) {
-        state->cipher->interface->decrypt(&(state->cipher->context),
-                                          cipher_input, cipher_output);
+    uint8_t offsets[CIPHER_BLOCKS_PER_CALL][16];
+    uint8_t cipher_blocks[CIPHER_BLOCKS_PER_CALL][16];
+
+    for (size_t i = 0; i < numof; ++i) {
+        /* Offset_i = Offset_{i-1} xor L_{ntz(i)} */
+        uint8_t l_i[16];
+
+        calculate_l_i(state->l_zero, ntz(blockNumber + i + 1), l_i);
+        xor_block(state->offset, l_i, state->offset);
+        memcpy(offsets[i], state->offset, 16);
+        xor_block(input + 16 * i, state->offset, cipher_blocks[i]);
+        /* Checksum_i = Checksum_{i-1} xor P_i */
+        if (mode == OCB_MODE_ENCRYPT) {
+            xor_block(state->checksum, input + 16 * i, state->checksum);
+        }
     }
-    xor_block(state->offset, cipher_output, output);
-    /* Checksum_i = Checksum_{i-1} xor P_i */
+    /* C_i = Offset_i xor ENCIPHER(K, P_i xor Offset_i), independent of the
+     * other blocks */
     if (mode == OCB_MODE_ENCRYPT) {
-        xor_block(state->checksum, input, state->checksum);
+        cipher_encrypt_blocks(state->cipher, cipher_blocks[0],
+                              cipher_blocks[0], numof);
     }
     else if (mode == OCB_MODE_DECRYPT) {
-        xor_block(state->checksum, output, state->checksum);
+        cipher_decrypt_blocks(state->cipher, cipher_blocks[0],
+                              cipher_blocks[0], numof);
+    }
+    for (size_t i = 0; i < numof; ++i) {
+        xor_block(offsets[i], cipher_blocks[i], output + 16 * i);
+        if (mode == OCB_MODE_DECRYPT) {
+            xor_block(state->checksum, output + 16 * i, state->checksum);
+        }
     }
 }
 
@@ -235,10 +244,13 @@ static int32_t run_ocb(cipher_t *cipher, uint8_t *auth_data,
 
     /* Process any whole blocks */
     size_t output_pos = 0;
-    for (size_t i = 0; i < m; ++i) {
-        processBlock(&state, i, input, output + output_pos, mode);
-        output_pos += 16;
-        input += 16;
+    for (size_t i = 0; i < m; i += CIPHER_BLOCKS_PER_CALL) {
+        size_t numof = ((m - i) < CIPHER_BLOCKS_PER_CALL) ?
+                       (m - i) : CIPHER_BLOCKS_PER_CALL;
+
+        processBlocks(&state, i, input, output + output_pos, numof, mode);
+        output_pos += 16 * numof;
+        input += 16 * numof;
     }
 
     /* Process any final partial block and compute raw tag */
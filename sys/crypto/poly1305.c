@@ -14,6 +14,9 @@
  * @brief   Implementation of Poly1305. Based on Floodberry's and Loup
  *          Valliant's implementation. Optimized for small flash size.
  *
+ *          With POLY1305_WIDE, the 64 bit variant of Floodberry's
+ *          implementation is used instead.
+ *
  * @author  Koen Zandberg <koen@bergzand.net>
  * @}
  */
@@ -21,7 +24,18 @@
 #include <string.h>
 #include "crypto/poly1305.h"
 
-static void poly1305_block(poly1305_ctx_t *ctx, uint8_t c4);
+#if POLY1305_WIDE
+/* padding bit of a full block, at 2^128 */
+#define HIBIT               ((uint64_t)1 << 40)
+
+#define MASK42              ((uint64_t)0x3ffffffffff)
+#define MASK44              ((uint64_t)0xfffffffffff)
+
+__extension__ typedef unsigned __int128 uint128_t;
+#else
+/* padding bit of a full block, at 2^128 */
+#define HIBIT               (1)
+#endif
 
 static uint32_t u8to32(const uint8_t *p)
 {
@@ -40,16 +54,74 @@ static void u32to8(uint8_t *p, uint32_t v)
     p[3] = (uint8_t)(v >> 24);
 }
 
-static void _clear_c(poly1305_ctx_t *ctx)
+#if POLY1305_WIDE
+static uint64_t u8to64(const uint8_t *p)
 {
-    ctx->c[0] = 0;
-    ctx->c[1] = 0;
-    ctx->c[2] = 0;
-    ctx->c[3] = 0;
-    ctx->c_idx = 0;
+    return (uint64_t)u8to32(p) | ((uint64_t)u8to32(p + 4) << 32);
 }
 
-static void poly1305_block(poly1305_ctx_t *ctx, uint8_t c4)
+static void u64to8(uint8_t *p, uint64_t v)
+{
+    u32to8(p, (uint32_t)v);
+    u32to8(p + 4, (uint32_t)(v >> 32));
+}
+
+static void poly1305_blocks(poly1305_ctx_t *ctx, const uint8_t *data,
+                            size_t numof, uint64_t hibit)
+{
+    /* Local copies */
+    const uint64_t r0 = ctx->r[0];
+    const uint64_t r1 = ctx->r[1];
+    const uint64_t r2 = ctx->r[2];
+
+    /* 2^132 = 20 mod 2^130 - 5 */
+    const uint64_t s1 = r1 * (5 << 2);
+    const uint64_t s2 = r2 * (5 << 2);
+
+    uint64_t h0 = ctx->h[0];
+    uint64_t h1 = ctx->h[1];
+    uint64_t h2 = ctx->h[2];
+
+    for (; numof > 0; numof--, data += POLY1305_BLOCK_SIZE) {
+        const uint64_t t0 = u8to64(data);
+        const uint64_t t1 = u8to64(data + 8);
+
+        /* h += c */
+        h0 += t0 & MASK44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & MASK44;
+        h2 += ((t1 >> 24) & MASK42) | hibit;
+
+        /* h * r, without carry propagation */
+        uint128_t d0 = (uint128_t)h0 * r0 + (uint128_t)h1 * s2 +
+                       (uint128_t)h2 * s1;
+        uint128_t d1 = (uint128_t)h0 * r1 + (uint128_t)h1 * r0 +
+                       (uint128_t)h2 * s2;
+        uint128_t d2 = (uint128_t)h0 * r2 + (uint128_t)h1 * r1 +
+                       (uint128_t)h2 * r0;
+
+        /* partial reduction modulo 2^130 - 5 */
+        uint64_t c = (uint64_t)(d0 >> 44);
+        h0 = (uint64_t)d0 & MASK44;
+        d1 += c;
+        c = (uint64_t)(d1 >> 44);
+        h1 = (uint64_t)d1 & MASK44;
+        d2 += c;
+        c = (uint64_t)(d2 >> 42);
+        h2 = (uint64_t)d2 & MASK42;
+        h0 += c * 5;
+        c = h0 >> 44;
+        h0 &= MASK44;
+        h1 += c;
+    }
+
+    /* Update the hash */
+    ctx->h[0] = h0;
+    ctx->h[1] = h1;
+    ctx->h[2] = h2;
+}
+#else
+static void poly1305_blocks(poly1305_ctx_t *ctx, const uint8_t *data,
+                            size_t numof, uint32_t c4)
 {
     /* Local copies */
     const uint32_t r0 = ctx->r[0];
@@ -62,70 +134,118 @@ static void poly1305_block(poly1305_ctx_t *ctx, uint8_t c4)
     const uint32_t rr2 = (r2 >> 2) + r2;
     const uint32_t rr3 = (r3 >> 2) + r3;
 
-    /* s = h + c, without carry propagation */
-    const uint64_t s0 = ctx->h[0] + (uint64_t)ctx->c[0];
-    const uint64_t s1 = ctx->h[1] + (uint64_t)ctx->c[1];
-    const uint64_t s2 = ctx->h[2] + (uint64_t)ctx->c[2];
-    const uint64_t s3 = ctx->h[3] + (uint64_t)ctx->c[3];
-    const uint32_t s4 = ctx->h[4] + c4;
-
-    /* (h + c) * r, without carry propagation */
-    const uint64_t x0 = s0 * r0 + s1 * rr3 + s2 * rr2 + s3 * rr1 + s4 * rr0;
-    const uint64_t x1 = s0 * r1 + s1 * r0  + s2 * rr3 + s3 * rr2 + s4 * rr1;
-    const uint64_t x2 = s0 * r2 + s1 * r1  + s2 * r0  + s3 * rr3 + s4 * rr2;
-    const uint64_t x3 = s0 * r3 + s1 * r2  + s2 * r1  + s3 * r0  + s4 * rr3;
-    const uint32_t x4 = s4 * (r0 & 3);
-
-    /* partial reduction modulo 2^130 - 5 */
-    const uint32_t u5 = x4 + (x3 >> 32); // u5 <= 7ffffff5
-    const uint64_t u0 = (u5 >>  2) * 5 + (x0 & 0xffffffff);
-    const uint64_t u1 = (u0 >> 32)     + (x1 & 0xffffffff) + (x0 >> 32);
-    const uint64_t u2 = (u1 >> 32)     + (x2 & 0xffffffff) + (x1 >> 32);
-    const uint64_t u3 = (u2 >> 32)     + (x3 & 0xffffffff) + (x2 >> 32);
-    const uint64_t u4 = (u3 >> 32)     + (u5 & 3);
+    uint32_t h0 = ctx->h[0];
+    uint32_t h1 = ctx->h[1];
+    uint32_t h2 = ctx->h[2];
+    uint32_t h3 = ctx->h[3];
+    uint32_t h4 = ctx->h[4];
 
-    /* Update the hash */
-    ctx->h[0] = (uint32_t)u0;
-    ctx->h[1] = (uint32_t)u1;
-    ctx->h[2] = (uint32_t)u2;
-    ctx->h[3] = (uint32_t)u3;
-    ctx->h[4] = (uint32_t)u4;
-}
+    for (; numof > 0; numof--, data += POLY1305_BLOCK_SIZE) {
+        /* s = h + c, without carry propagation */
+        const uint64_t s0 = h0 + (uint64_t)u8to32(data);
+        const uint64_t s1 = h1 + (uint64_t)u8to32(data + 4);
+        const uint64_t s2 = h2 + (uint64_t)u8to32(data + 8);
+        const uint64_t s3 = h3 + (uint64_t)u8to32(data + 12);
+        const uint32_t s4 = h4 + c4;
 
-static void _take_input(poly1305_ctx_t *ctx, uint8_t input)
-{
-    size_t word = ctx->c_idx >> 2;
-    size_t byte = ctx->c_idx & 3;
+        /* (h + c) * r, without carry propagation */
+        const uint64_t x0 = s0 * r0 + s1 * rr3 + s2 * rr2 + s3 * rr1 + s4 * rr0;
+        const uint64_t x1 = s0 * r1 + s1 * r0  + s2 * rr3 + s3 * rr2 + s4 * rr1;
+        const uint64_t x2 = s0 * r2 + s1 * r1  + s2 * r0  + s3 * rr3 + s4 * rr2;
+        const uint64_t x3 = s0 * r3 + s1 * r2  + s2 * r1  + s3 * r0  + s4 * rr3;
+        const uint32_t x4 = s4 * (r0 & 3);
 
-    ctx->c[word] |= (uint32_t)input << (byte * 8);
-    ctx->c_idx++;
+        /* partial reduction modulo 2^130 - 5 */
+        const uint32_t u5 = x4 + (x3 >> 32); // u5 <= 7ffffff5
+        const uint64_t u0 = (u5 >>  2) * 5 + (x0 & 0xffffffff);
+        const uint64_t u1 = (u0 >> 32)     + (x1 & 0xffffffff) + (x0 >> 32);
+        const uint64_t u2 = (u1 >> 32)     + (x2 & 0xffffffff) + (x1 >> 32);
+        const uint64_t u3 = (u2 >> 32)     + (x3 & 0xffffffff) + (x2 >> 32);
+        const uint64_t u4 = (u3 >> 32)     + (u5 & 3);
+
+        h0 = (uint32_t)u0;
+        h1 = (uint32_t)u1;
+        h2 = (uint32_t)u2;
+        h3 = (uint32_t)u3;
+        h4 = (uint32_t)u4;
+    }
+
+    /* Update the hash */
+    ctx->h[0] = h0;
+    ctx->h[1] = h1;
+    ctx->h[2] = h2;
+    ctx->h[3] = h3;
+    ctx->h[4] = h4;
 }
+#endif
 
 void poly1305_update(poly1305_ctx_t *ctx, const uint8_t *data, size_t len)
 {
-    for (size_t i = 0; i < len; i++) {
-        _take_input(ctx, data[i]);
-        if (ctx->c_idx == 16) {
-            poly1305_block(ctx, 1);
-            _clear_c(ctx);
+    /* complete a buffered chunk first */
+    if (ctx->c_idx) {
+        size_t n = POLY1305_BLOCK_SIZE - ctx->c_idx;
+
+        if (n > len) {
+            n = len;
         }
+        memcpy(&ctx->c[ctx->c_idx], data, n);
+        ctx->c_idx += n;
+        data += n;
+        len -= n;
+        if (ctx->c_idx < POLY1305_BLOCK_SIZE) {
+            return;
+        }
+        poly1305_blocks(ctx, ctx->c, 1, HIBIT);
+        ctx->c_idx = 0;
     }
+
+    /* full blocks are processed in place */
+    if (len >= POLY1305_BLOCK_SIZE) {
+        size_t numof = len / POLY1305_BLOCK_SIZE;
+
+        poly1305_blocks(ctx, data, numof, HIBIT);
+        data += numof * POLY1305_BLOCK_SIZE;
+        len -= numof * POLY1305_BLOCK_SIZE;
+    }
+
+    memcpy(ctx->c, data, len);
+    ctx->c_idx = len;
 }
 
 void poly1305_init(poly1305_ctx_t *ctx, const uint8_t *key)
 {
+    /* the key may overlap with the context, read it completely first */
+#if POLY1305_WIDE
+    const uint64_t t0 = u8to64(key);
+    const uint64_t t1 = u8to64(&key[8]);
+    const uint64_t pad0 = u8to64(&key[16]);
+    const uint64_t pad1 = u8to64(&key[24]);
+
+    /* clamp and split the key into 44 bit limbs */
+    ctx->r[0] = t0 & 0xffc0fffffff;
+    ctx->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+    ctx->r[2] = (t1 >> 24) & 0x00ffffffc0f;
+    ctx->pad[0] = pad0;
+    ctx->pad[1] = pad1;
+#else
+    uint32_t k[8];
+
+    for (size_t i = 0; i < 8; i++) {
+        k[i] = u8to32(&key[4 * i]);
+    }
     /* load and clamp key */
-    ctx->r[0] = u8to32(key) & 0x0fffffff;
+    ctx->r[0] = k[0] & 0x0fffffff;
     for (size_t i = 1; i < 4; i++) {
-        ctx->r[i] = u8to32(&key[4 * i]) & 0x0ffffffc;
+        ctx->r[i] = k[i] & 0x0ffffffc;
     }
     for (size_t i = 0; i < 4; i++) {
-        ctx->pad[i] = u8to32(&key[16 + i * 4]);
+        ctx->pad[i] = k[4 + i];
     }
+#endif
 
     /* Zero the hash */
     memset(ctx->h, 0, sizeof(ctx->h));
-    _clear_c(ctx);
+    ctx->c_idx = 0;
 }
 
 void poly1305_finish(poly1305_ctx_t *ctx, uint8_t *mac)
@@ -134,11 +254,68 @@ void poly1305_finish(poly1305_ctx_t *ctx, uint8_t *mac)
     if (ctx->c_idx) {
         /* move the final 1 according to remaining input length */
         /* (We may add less than 2^130 to the last input block) */
-        _take_input(ctx, 1);
+        ctx->c[ctx->c_idx++] = 1;
+        memset(&ctx->c[ctx->c_idx], 0, POLY1305_BLOCK_SIZE - ctx->c_idx);
         /* And update hash */
-        poly1305_block(ctx, 0);
+        poly1305_blocks(ctx, ctx->c, 1, 0);
     }
 
+#if POLY1305_WIDE
+    uint64_t h0 = ctx->h[0];
+    uint64_t h1 = ctx->h[1];
+    uint64_t h2 = ctx->h[2];
+    uint64_t c;
+
+    /* fully carry h */
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= MASK42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += c;
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= MASK42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += c;
+
+    /* g = h - (2^130 - 5) */
+    uint64_t g0 = h0 + 5;
+    c = g0 >> 44;
+    g0 &= MASK44;
+    uint64_t g1 = h1 + c;
+    c = g1 >> 44;
+    g1 &= MASK44;
+    uint64_t g2 = h2 + c - ((uint64_t)1 << 42);
+
+    /* select g if it did not underflow, without branching */
+    c = (g2 >> 63) - 1;
+    h0 = (h0 & ~c) | (g0 & c);
+    h1 = (h1 & ~c) | (g1 & c);
+    h2 = (h2 & ~c) | (g2 & c);
+
+    /* h + pad, modulo 2^128 */
+    const uint64_t t0 = ctx->pad[0];
+    const uint64_t t1 = ctx->pad[1];
+
+    h0 += t0 & MASK44;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & MASK44) + c;
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += ((t1 >> 24) & MASK42) + c;
+
+    u64to8(mac, h0 | (h1 << 44));
+    u64to8(mac + 8, (h1 >> 20) | (h2 << 24));
+#else
     /* check if we should subtract 2^130-5 by performing the
      * corresponding carry propagation. */
     const uint64_t u0 = (uint64_t)5 + ctx->h[0];    // <= 1_00000004
@@ -160,7 +337,7 @@ void poly1305_finish(poly1305_ctx_t *ctx, uint8_t *mac)
 
     const uint64_t uu3 = (uu2 >> 32)   + ctx->h[3] + ctx->pad[3];
     u32to8(mac + 12, uu3);
-
+#endif
 }
 
 void poly1305_auth(uint8_t *mac, const uint8_t *data, size_t len,
@@ -49,6 +49,7 @@
 #include <assert.h>
 
 #include "hashes/sha256.h"
+#include "crypto/accel.h"
 
 #ifdef __BIG_ENDIAN__
 /* Copy a vector of big-endian uint32_t into a vector of bytes */
@@ -122,43 +123,141 @@ static const uint32_t K[64] = {
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
 };
 
+static const uint32_t IV[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+/*
+ * Round i + k, k being a constant from 0 to 15.  The working variables a to h
+ * rotate through S, so that no round has to move them: a is S[(16 - k) % 8],
+ * b is S[(17 - k) % 8] and so on.
+ */
+#define ROUND(S, W, i, k) do {                                              \
+        uint32_t t0 = S[(23 - (k)) % 8] + S1(S[(20 - (k)) % 8]) +           \
+                      Ch(S[(20 - (k)) % 8], S[(21 - (k)) % 8],              \
+                         S[(22 - (k)) % 8]) + K[(i) + (k)] + W[k];          \
+        uint32_t t1 = S0(S[(16 - (k)) % 8]) +                               \
+                      Maj(S[(16 - (k)) % 8], S[(17 - (k)) % 8],             \
+                          S[(18 - (k)) % 8]);                               \
+        S[(19 - (k)) % 8] += t0;                                            \
+        S[(23 - (k)) % 8] = t0 + t1;                                        \
+} while (0)
+
+/* Applies macro ROUND_M to the rounds i to i + 15 */
+#define ROUNDS16(ROUND_M, i) do {                                           \
+        ROUND_M(i, 0); ROUND_M(i, 1); ROUND_M(i, 2); ROUND_M(i, 3);         \
+        ROUND_M(i, 4); ROUND_M(i, 5); ROUND_M(i, 6); ROUND_M(i, 7);         \
+        ROUND_M(i, 8); ROUND_M(i, 9); ROUND_M(i, 10); ROUND_M(i, 11);       \
+        ROUND_M(i, 12); ROUND_M(i, 13); ROUND_M(i, 14); ROUND_M(i, 15);     \
+} while (0)
+
+/*
+ * Replaces the 16 words of the message schedule with the next 16 ones.  Only
+ * the last 16 words are ever needed, W[k] is word i + k of round i.
+ */
+static inline void sha256_schedule(uint32_t *W)
+{
+    for (unsigned k = 0; k < 16; k++) {
+        W[k] += s1(W[(k + 14) % 16]) + W[(k + 9) % 16] + s0(W[(k + 1) % 16]);
+    }
+}
+
 /*
  * SHA256 block compression function.  The 256-bit state is transformed via
  * the 512-bit input block to produce a new state.
  */
 static void sha256_transform(uint32_t *state, const unsigned char block[64])
 {
-    uint32_t W[64];
+    uint32_t W[16];
     uint32_t S[8];
 
-    /* 1. Prepare message schedule W. */
     be32dec_vect(W, block, 64);
-    for (int i = 16; i < 64; i++) {
-        W[i] = s1(W[i - 2]) + W[i - 7] + s0(W[i - 15]) + W[i - 16];
+    memcpy(S, state, 32);
+
+#define ROUND_1(i, k)   ROUND(S, W, i, k)
+    for (unsigned i = 0; i < 64; i += 16) {
+        if (i > 0) {
+            sha256_schedule(W);
+        }
+        ROUNDS16(ROUND_1, i);
     }
+#undef ROUND_1
 
-    /* 2. Initialize working variables. */
-    memcpy(S, state, 32);
+    for (int i = 0; i < 8; i++) {
+        state[i] += S[i];
+    }
+}
 
-    /* 3. Mix. */
-    for (int i = 0; i < 64; ++i) {
-        uint32_t e = S[(68 - i) % 8], f = S[(69 - i) % 8];
-        uint32_t g = S[(70 - i) % 8], h = S[(71 - i) % 8];
-        uint32_t t0 = h + S1(e) + Ch(e, f, g) + W[i] + K[i];
+void sha256_blocks_sw(uint32_t *state, const void *blocks, size_t numof)
+{
+    const unsigned char *block = blocks;
 
-        uint32_t a = S[(64 - i) % 8], b = S[(65 - i) % 8];
-        uint32_t c = S[(66 - i) % 8], d = S[(67 - i) % 8];
-        uint32_t t1 = S0(a) + Maj(a, b, c);
+    for (; numof > 0; numof--) {
+        sha256_transform(state, block);
+        block += SHA256_INTERNAL_BLOCK_SIZE;
+    }
+}
 
-        S[(67 - i) % 8] = d + t0;
-        S[(71 - i) % 8] = t0 + t1;
+/* Returns the SHA-256 accelerator to use, if any */
+static inline crypto_accel_sha256_t sha256_accel(void)
+{
+#ifdef MODULE_CRYPTO_ACCEL
+    return crypto_accel_sha256();
+#else
+    return NULL;
+#endif
+}
+
+/* Compresses consecutive blocks, with the accelerator if there is one */
+static inline void sha256_blocks(uint32_t *state, const unsigned char *blocks,
+                                 size_t numof)
+{
+    crypto_accel_sha256_t accel = sha256_accel();
+
+    if (accel) {
+        accel(state, blocks, numof);
+    }
+    else {
+        sha256_blocks_sw(state, blocks, numof);
+    }
+}
+
+#if SHA256_MULTI_INTERLEAVE
+/*
+ * Compresses a block of two independent hashes.  Interleaving the rounds of
+ * both gives CPUs able to issue more than one instruction per cycle
+ * independent instructions to work on.
+ */
+static void sha256_transform_x2(uint32_t *state_a,
+                                const unsigned char block_a[64],
+                                uint32_t *state_b,
+                                const unsigned char block_b[64])
+{
+    uint32_t Wa[16], Wb[16];
+    uint32_t Sa[8], Sb[8];
+
+    be32dec_vect(Wa, block_a, 64);
+    be32dec_vect(Wb, block_b, 64);
+    memcpy(Sa, state_a, 32);
+    memcpy(Sb, state_b, 32);
+
+#define ROUND_2(i, k)   ROUND(Sa, Wa, i, k); ROUND(Sb, Wb, i, k)
+    for (unsigned i = 0; i < 64; i += 16) {
+        if (i > 0) {
+            sha256_schedule(Wa);
+            sha256_schedule(Wb);
+        }
+        ROUNDS16(ROUND_2, i);
     }
+#undef ROUND_2
 
-    /* 4. Mix local working variables into global state */
     for (int i = 0; i < 8; i++) {
-        state[i] += S[i];
+        state_a[i] += Sa[i];
+        state_b[i] += Sb[i];
     }
 }
+#endif /* SHA256_MULTI_INTERLEAVE */
 
 static unsigned char PAD[64] = {
     0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -194,22 +293,12 @@ void sha256_init(sha256_context_t *ctx)
     ctx->count[0] = ctx->count[1] = 0;
 
     /* Magic initialization constants */
-    ctx->state[0] = 0x6A09E667;
-    ctx->state[1] = 0xBB67AE85;
-    ctx->state[2] = 0x3C6EF372;
-    ctx->state[3] = 0xA54FF53A;
-    ctx->state[4] = 0x510E527F;
-    ctx->state[5] = 0x9B05688C;
-    ctx->state[6] = 0x1F83D9AB;
-    ctx->state[7] = 0x5BE0CD19;
+    memcpy(ctx->state, IV, sizeof(IV));
 }
 
-/* Add bytes into the hash */
-void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
+/* Add len bytes to the number of bits processed */
+static void sha256_count(sha256_context_t *ctx, size_t len)
 {
-    /* Number of bytes left in the buffer from previous updates */
-    uint32_t r = (ctx->count[1] >> 3) & 0x3f;
-
     /* Convert the length into a number of bits */
     uint32_t bitlen1 = ((uint32_t) len) << 3;
     uint32_t bitlen0 = ((uint32_t) len) >> 29;
@@ -220,6 +309,15 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
     }
 
     ctx->count[0] += bitlen0;
+}
+
+/* Add bytes into the hash */
+void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
+{
+    /* Number of bytes left in the buffer from previous updates */
+    uint32_t r = (ctx->count[1] >> 3) & 0x3f;
+
+    sha256_count(ctx, len);
 
     /* Handle the case where we don't need to perform any transforms */
     if (len < 64 - r) {
@@ -233,21 +331,85 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
     const unsigned char *src = data;
 
     memcpy(&ctx->buf[r], src, 64 - r);
-    sha256_transform(ctx->state, ctx->buf);
+    sha256_blocks(ctx->state, ctx->buf, 1);
     src += 64 - r;
     len -= 64 - r;
 
     /* Perform complete blocks */
-    while (len >= 64) {
-        sha256_transform(ctx->state, src);
-        src += 64;
-        len -= 64;
+    if (len >= 64) {
+        sha256_blocks(ctx->state, src, len / 64);
+        src += len & ~(size_t)63;
+        len &= 63;
     }
 
     /* Copy left over data into buffer */
     memcpy(ctx->buf, src, len);
 }
 
+#if SHA256_MULTI_INTERLEAVE
+/* Add the same number of bytes into two hashes at the same block offset */
+static void sha256_update_x2(sha256_context_t *ctx_a, const unsigned char *src_a,
+                             sha256_context_t *ctx_b, const unsigned char *src_b,
+                             size_t len)
+{
+    uint32_t r = (ctx_a->count[1] >> 3) & 0x3f;
+
+    sha256_count(ctx_a, len);
+    sha256_count(ctx_b, len);
+
+    if (len < 64 - r) {
+        if (len > 0) {
+            memcpy(&ctx_a->buf[r], src_a, len);
+            memcpy(&ctx_b->buf[r], src_b, len);
+        }
+        return;
+    }
+
+    memcpy(&ctx_a->buf[r], src_a, 64 - r);
+    memcpy(&ctx_b->buf[r], src_b, 64 - r);
+    sha256_transform_x2(ctx_a->state, ctx_a->buf, ctx_b->state, ctx_b->buf);
+    src_a += 64 - r;
+    src_b += 64 - r;
+    len -= 64 - r;
+
+    while (len >= 64) {
+        sha256_transform_x2(ctx_a->state, src_a, ctx_b->state, src_b);
+        src_a += 64;
+        src_b += 64;
+        len -= 64;
+    }
+
+    memcpy(ctx_a->buf, src_a, len);
+    memcpy(ctx_b->buf, src_b, len);
+}
+#endif /* SHA256_MULTI_INTERLEAVE */
+
+void sha256_update_multi(sha256_context_t *const ctx[],
+                         const void *const data[], size_t numof, size_t len)
+{
+    size_t i = 0;
+
+#if SHA256_MULTI_INTERLEAVE
+    /* an accelerator processes one hash after the other */
+    size_t numof_x2 = sha256_accel() ? 0 : numof;
+
+    for (; (i + 1) < numof_x2; i += 2) {
+        /* only hashes at the same offset in their block process their blocks
+         * at the same time */
+        if (((ctx[i]->count[1] ^ ctx[i + 1]->count[1]) & 0x1ff) == 0) {
+            sha256_update_x2(ctx[i], data[i], ctx[i + 1], data[i + 1], len);
+        }
+        else {
+            sha256_update(ctx[i], data[i], len);
+            sha256_update(ctx[i + 1], data[i + 1], len);
+        }
+    }
+#endif
+    for (; i < numof; i++) {
+        sha256_update(ctx[i], data[i], len);
+    }
+}
+
 /*
  * SHA-256 finalization.  Pads the input data, exports the hash value,
  * and clears the context state.
@@ -310,16 +472,15 @@ void hmac_sha256_init(hmac_context_t *ctx, const void *key, size_t key_length)
     /*
      * Initiate calculation of the inner hash
      * tmp = hash(i_key_pad CONCAT message)
-     */
-    sha256_init(&ctx->c_in);
-    sha256_update(&ctx->c_in, i_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
-
-    /*
-     * Initiate calculation of the outer hash
+     * and of the outer hash
      * result = hash(o_key_pad CONCAT tmp)
      */
+    sha256_context_t *const c[] = { &ctx->c_in, &ctx->c_out };
+    const void *const pads[] = { i_key_pad, o_key_pad };
+
+    sha256_init(&ctx->c_in);
     sha256_init(&ctx->c_out);
-    sha256_update(&ctx->c_out, o_key_pad, SHA256_INTERNAL_BLOCK_SIZE);
+    sha256_update_multi(c, pads, 2, SHA256_INTERNAL_BLOCK_SIZE);
 
 }
 
@@ -356,6 +517,24 @@ const void *hmac_sha256(const void *key, size_t key_length,
     return digest;
 }
 
+/*
+ * Hashes a single digest.  Its padding fits into the same block, so this needs
+ * no context and exactly one transform.
+ */
+static void sha256_digest_of_digest(const unsigned char *in, unsigned char *out)
+{
+    uint32_t state[8];
+    unsigned char block[SHA256_INTERNAL_BLOCK_SIZE] = { 0 };
+
+    memcpy(block, in, SHA256_DIGEST_LENGTH);
+    block[SHA256_DIGEST_LENGTH] = 0x80;
+    /* length in bits, big endian */
+    block[SHA256_INTERNAL_BLOCK_SIZE - 2] = (SHA256_DIGEST_LENGTH * 8) >> 8;
+    memcpy(state, IV, sizeof(IV));
+    sha256_blocks(state, block, 1);
+    be32enc_vect(out, state, SHA256_DIGEST_LENGTH);
+}
+
 /**
  * @brief helper to compute sha256 inplace for the given buffer
  *
@@ -364,11 +543,7 @@ const void *hmac_sha256(const void *key, size_t key_length,
  */
 static inline void sha256_inplace(unsigned char element[SHA256_DIGEST_LENGTH])
 {
-    sha256_context_t ctx;
-
-    sha256_init(&ctx);
-    sha256_update(&ctx, element, SHA256_DIGEST_LENGTH);
-    sha256_final(&ctx, element);
+    sha256_digest_of_digest(element, element);
 }
 
 void *sha256_chain(const void *seed, size_t seed_length,
@@ -417,10 +592,8 @@ void *sha256_chain_with_waypoints(const void *seed,
 
         /* perform consecutive iterations starting at index 1*/
         for (size_t i = 1; i < elements; ++i) {
-            sha256_context_t ctx;
-            sha256_init(&ctx);
-            sha256_update(&ctx, waypoints[(i - 1)].element, SHA256_DIGEST_LENGTH);
-            sha256_final(&ctx, waypoints[i].element);
+            sha256_digest_of_digest(waypoints[(i - 1)].element,
+                                    waypoints[i].element);
             waypoints[i].index = i;
         }
 
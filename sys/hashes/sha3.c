@@ -22,28 +22,21 @@
 
 /*
    ================================================================
-   The purpose of this source file is to demonstrate a readable and compact
-   implementation of all the Keccak instances approved in the FIPS 202 standard,
-   including the hash functions and the extendable-output functions (XOFs).
-
-   We focused on clarity and on source-code compactness,
-   rather than on the performance.
-
-   The advantages of this implementation are:
- + The source code is compact, after removing the comments, that is. :-)
- + There are no tables with arbitrary constants.
- + For clarity, the comments link the operations to the specifications using
-        the same notation as much as possible.
- + There is no restriction in cryptographic features. In particular,
-        the SHAKE128 and SHAKE256 XOFs can produce any output length.
- + The code does not use much RAM, as all operations are done in place.
-
-   The drawbacks of this implementation are:
-    - There is no message queue. The whole message must be ready in a buffer.
-    - It is not optimized for performance.
-
-   The implementation is even simpler on a little endian platform. Just define the
-   LITTLE_ENDIAN symbol in that case.
+   This implementation started as the readable and compact implementation of
+   all the Keccak instances approved in the FIPS 202 standard, including the
+   hash functions and the extendable-output functions (XOFs).
+
+   The Keccak-f[1600] permutation has since been replaced by the unrolled form
+   of the optimized 64 bit implementation of the Keccak Code Package:
+ + Each round is unrolled, with the ρ and π steps folded into the lane
+        indices and rotation constants.
+ + The lanes 1, 2, 8, 12, 17 and 20 are kept complemented during the
+        permutation ("lane complementing"), which saves most of the NOT
+        operations of the χ step.
+ + The input is absorbed and the output squeezed in 64 bit lanes.
+
+   The state is kept as 64 bit lanes, so the byte order of the platform does
+   not matter.
 
    For a more complete set of implementations, please refer to
    the Keccak Code Package at https://github.com/gvanas/KeccakCodePackage
@@ -56,112 +49,12 @@
    ================================================================
  */
 
-#include <hashes/sha3.h>
 #include <stdint.h>
+#include <string.h>
 
-/**
- * Function to compute the Keccak[r, c] sponge function over a given input.
- * @param  rate            The value of the rate r.
- * @param  capacity        The value of the capacity c.
- * @param  input           Pointer to the input message.
- * @param  inputByteLen    The number of input bytes provided in the input message.
- * @param  delimitedSuffix Bits that will be automatically appended to the end
- *                         of the input message, as in domain separation.
- *                         This is a byte containing from 0 to 7 bits
- *                         These <i>n</i> bits must be in the least significant bit positions
- *                         and must be delimited with a bit 1 at position <i>n</i>
- *                         (counting from 0=LSB to 7=MSB) and followed by bits 0
- *                         from position <i>n</i>+1 to position 7.
- *                         Some examples:
- *                           - If no bits are to be appended, then @a delimitedSuffix must be 0x01.
- *                           - If the 2-bit sequence 0,1 is to be appended (as for SHA3-*),
- *                              @a delimitedSuffix must be 0x06.
- *                           - If the 4-bit sequence 1,1,1,1 is to be appended (as for SHAKE*),
- *                              @a delimitedSuffix must be 0x1F.
- *                           - If the 7-bit sequence 1,1,0,1,0,0,0 is to be absorbed,
- *                              @a delimitedSuffix must be 0x8B.
- * @param  output          Pointer to the buffer where to store the output.
- * @param  outputByteLen   The number of output bytes desired.
- * @pre    One must have r+c=1600 and the rate a multiple of 8 bits in this implementation.
- */
-static void Keccak(unsigned int rate, unsigned int capacity, const unsigned char *input,
-                   unsigned long long int inputByteLen, unsigned char delimitedSuffix, unsigned char *output,
-                   unsigned long long int outputByteLen);
-
-/**
- *  Function to compute SHA3-256 on the input message. The output length is fixed to 32 bytes.
- */
-static void FIPS202_SHA3_256(const unsigned char *input, unsigned int inputByteLen, unsigned char *output)
-{
-    Keccak(1088, 512, input, inputByteLen, 0x06, output, SHA3_256_DIGEST_LENGTH);
-}
-
-void sha3_256(void *digest, const void *data, size_t len)
-{
-    FIPS202_SHA3_256(data, len, digest);
-}
-
-void sha3_256_init(keccak_state_t *ctx)
-{
-    Keccak_init(ctx, 1088, 512, 0x06);
-}
-
-void sha3_update(keccak_state_t *ctx, const void *data, size_t len)
-{
-    Keccak_update(ctx, data, len);
-}
-
-void sha3_256_final(keccak_state_t *ctx, void *digest)
-{
-    Keccak_final(ctx, digest, SHA3_256_DIGEST_LENGTH);
-}
-
-
-/**
- *  Function to compute SHA3-384 on the input message. The output length is fixed to 48 bytes.
- */
-static void FIPS202_SHA3_384(const unsigned char *input, unsigned int inputByteLen, unsigned char *output)
-{
-    Keccak(832, 768, input, inputByteLen, 0x06, output, 48);
-}
-
-void sha3_384(void *digest, const void *data, size_t len)
-{
-    FIPS202_SHA3_384(data, len, digest);
-}
-
-void sha3_384_init(keccak_state_t *ctx)
-{
-    Keccak_init(ctx, 832, 768, 0x06);
-}
-
-void sha3_384_final(keccak_state_t *ctx, void *digest)
-{
-    Keccak_final(ctx, digest, SHA3_384_DIGEST_LENGTH);
-}
-
-/**
- *  Function to compute SHA3-512 on the input message. The output length is fixed to 64 bytes.
- */
-static void FIPS202_SHA3_512(const unsigned char *input, unsigned int inputByteLen, unsigned char *output)
-{
-    Keccak(576, 1024, input, inputByteLen, 0x06, output, 64);
-}
-
-void sha3_512(void *digest, const void *data, size_t len)
-{
-    FIPS202_SHA3_512(data, len, digest);
-}
-
-void sha3_512_init(keccak_state_t *ctx)
-{
-    Keccak_init(ctx, 576, 1024, 0x06);
-}
+#include <hashes/sha3.h>
 
-void sha3_512_final(keccak_state_t *ctx, void *digest)
-{
-    Keccak_final(ctx, digest, SHA3_512_DIGEST_LENGTH);
-}
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 /*
    ================================================================
@@ -169,24 +62,13 @@ void sha3_512_final(keccak_state_t *ctx, void *digest)
    ================================================================
  */
 
-typedef uint8_t UINT8;
-typedef uint64_t UINT64;
-typedef UINT64 tKeccakLane;
-
-#if __BYTE_ORDER__ == __ORDER__LITTLE_ENDIAN__
-#define LITTLE_ENDIAN
-#endif
-
-#ifndef LITTLE_ENDIAN
 /** Function to load a 64-bit value using the little-endian (LE) convention.
- * On a LE platform, this could be greatly simplified using a cast.
  */
-static UINT64 load64(const UINT8 *x)
+static uint64_t load64(const uint8_t *x)
 {
-    int i;
-    UINT64 u = 0;
+    uint64_t u = 0;
 
-    for (i = 7; i >= 0; --i) {
+    for (int i = 7; i >= 0; --i) {
         u <<= 8;
         u |= x[i];
     }
@@ -194,201 +76,194 @@ static UINT64 load64(const UINT8 *x)
 }
 
 /** Function to store a 64-bit value using the little-endian (LE) convention.
- * On a LE platform, this could be greatly simplified using a cast.
  */
-static void store64(UINT8 *x, UINT64 u)
+static void store64(uint8_t *x, uint64_t u)
 {
-    unsigned int i;
-
-    for (i = 0; i < 8; ++i) {
+    for (unsigned i = 0; i < 8; ++i) {
         x[i] = u;
         u >>= 8;
     }
 }
 
-/** Function to XOR into a 64-bit value using the little-endian (LE) convention.
- * On a LE platform, this could be greatly simplified using a cast.
- */
-static void xor64(UINT8 *x, UINT64 u)
-{
-    unsigned int i;
-
-    for (i = 0; i < 8; ++i) {
-        x[i] ^= u;
-        u >>= 8;
-    }
-}
-#endif
-
 /*
    ================================================================
-   A readable and compact implementation of the Keccak-f[1600] permutation.
+   An unrolled, lane complementing implementation of the Keccak-f[1600]
+   permutation.
    ================================================================
  */
 
-#define ROL64(a, offset) ((((UINT64)a) << offset) ^ (((UINT64)a) >> (64 - offset)))
-#define i(x, y) ((x) + 5 * (y))
+#define ROL64(a, offset) ((((uint64_t)(a)) << (offset)) ^ (((uint64_t)(a)) >> (64 - (offset))))
 
-#ifdef LITTLE_ENDIAN
-    #define readLane(x, y)          (((tKeccakLane *)state)[i(x, y)])
-    #define writeLane(x, y, lane)   (((tKeccakLane *)state)[i(x, y)]) = (lane)
-    #define XORLane(x, y, lane)     (((tKeccakLane *)state)[i(x, y)]) ^= (lane)
-#else
-    #define readLane(x, y)          load64((UINT8 *)state + sizeof(tKeccakLane) * i(x, y))
-    #define writeLane(x, y, lane)   store64((UINT8 *)state + sizeof(tKeccakLane) * i(x, y), lane)
-    #define XORLane(x, y, lane)     xor64((UINT8 *)state + sizeof(tKeccakLane) * i(x, y), lane)
-#endif
+/** The round constants of the ι step (see [Keccak Reference, Section 1.2]) */
+static const uint64_t KeccakF1600RoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
 
 /**
- * Function that computes the linear feedback shift register (LFSR) used to
- * define the round constants (see [Keccak Reference, Section 1.2]).
+ * Function that complements the lanes 1, 2, 8, 12, 17 and 20, which converts
+ * the state from and to the lane complementing representation.
  */
-static int LFSR86540(UINT8 *LFSR)
+static void KeccakF1600_ComplementLanes(uint64_t *A)
 {
-    int result = ((*LFSR) & 0x01) != 0;
+    A[1] = ~A[1];
+    A[2] = ~A[2];
+    A[8] = ~A[8];
+    A[12] = ~A[12];
+    A[17] = ~A[17];
+    A[20] = ~A[20];
+}
 
-    if (((*LFSR) & 0x80) != 0) {
-        /* Primitive polynomial over GF(2): x^8+x^6+x^5+x^4+1 */
-        (*LFSR) = ((*LFSR) << 1) ^ 0x71;
-    }
-    else {
-        (*LFSR) <<= 1;
-    }
-    return result;
+/**
+ * Function that computes one round from the state A into the state E, both
+ * in the lane complementing representation. Lane (x, y) is at index x + 5 * y.
+ */
+static inline void KeccakF1600_Round(uint64_t *E, const uint64_t *A,
+                                     uint64_t rc)
+{
+    uint64_t C0, C1, C2, C3, C4, D0, D1, D2, D3, D4, B0, B1, B2, B3, B4;
+
+    /* === θ step (see [Keccak Reference, Section 2.3.2]) === */
+    C0 = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];
+    C1 = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];
+    C2 = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];
+    C3 = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];
+    C4 = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];
+    D0 = C4 ^ ROL64(C1, 1);
+    D1 = C0 ^ ROL64(C2, 1);
+    D2 = C1 ^ ROL64(C3, 1);
+    D3 = C2 ^ ROL64(C4, 1);
+    D4 = C3 ^ ROL64(C0, 1);
+
+    /* === ρ and π steps (see [Keccak Reference, Sections 2.3.3 and 2.3.4]),
+     * followed by the χ step (see [Keccak Reference, Section 2.3.1]) on
+     * one plane after the other === */
+    B0 = A[0] ^ D0;
+    B1 = ROL64(A[6] ^ D1, 44);
+    B2 = ROL64(A[12] ^ D2, 43);
+    B3 = ROL64(A[18] ^ D3, 21);
+    B4 = ROL64(A[24] ^ D4, 14);
+    /* === ι step (see [Keccak Reference, Section 2.3.5]) === */
+    E[0] = B0 ^ (B1 | B2) ^ rc;
+    E[1] = B1 ^ (~B2 | B3);
+    E[2] = B2 ^ (B3 & B4);
+    E[3] = B3 ^ (B4 | B0);
+    E[4] = B4 ^ (B0 & B1);
+
+    B0 = ROL64(A[3] ^ D3, 28);
+    B1 = ROL64(A[9] ^ D4, 20);
+    B2 = ROL64(A[10] ^ D0, 3);
+    B3 = ROL64(A[16] ^ D1, 45);
+    B4 = ROL64(A[22] ^ D2, 61);
+    E[5] = B0 ^ (B1 | B2);
+    E[6] = B1 ^ (B2 & B3);
+    E[7] = B2 ^ (B3 | ~B4);
+    E[8] = B3 ^ (B4 | B0);
+    E[9] = B4 ^ (B0 & B1);
+
+    B0 = ROL64(A[1] ^ D1, 1);
+    B1 = ROL64(A[7] ^ D2, 6);
+    B2 = ROL64(A[13] ^ D3, 25);
+    B3 = ROL64(A[19] ^ D4, 8);
+    B4 = ROL64(A[20] ^ D0, 18);
+    E[10] = B0 ^ (B1 | B2);
+    E[11] = B1 ^ (B2 & B3);
+    E[12] = B2 ^ (~B3 & B4);
+    E[13] = ~B3 ^ (B4 | B0);
+    E[14] = B4 ^ (B0 & B1);
+
+    B0 = ROL64(A[4] ^ D4, 27);
+    B1 = ROL64(A[5] ^ D0, 36);
+    B2 = ROL64(A[11] ^ D1, 10);
+    B3 = ROL64(A[17] ^ D2, 15);
+    B4 = ROL64(A[23] ^ D3, 56);
+    E[15] = B0 ^ (B1 & B2);
+    E[16] = B1 ^ (B2 | B3);
+    E[17] = B2 ^ (~B3 | B4);
+    E[18] = ~B3 ^ (B4 & B0);
+    E[19] = B4 ^ (B0 | B1);
+
+    B0 = ROL64(A[2] ^ D2, 62);
+    B1 = ROL64(A[8] ^ D3, 55);
+    B2 = ROL64(A[14] ^ D4, 39);
+    B3 = ROL64(A[15] ^ D0, 41);
+    B4 = ROL64(A[21] ^ D1, 2);
+    E[20] = B0 ^ (~B1 & B2);
+    E[21] = ~B1 ^ (B2 | B3);
+    E[22] = B2 ^ (B3 & B4);
+    E[23] = B3 ^ (B4 | B0);
+    E[24] = B4 ^ (B0 & B1);
 }
 
 /**
  * Function that computes the Keccak-f[1600] permutation on the given state.
  */
-static void KeccakF1600_StatePermute(void *state)
+static void KeccakF1600_StatePermute(uint64_t *state)
 {
-    unsigned int round, x, y, j, t;
-    UINT8 LFSRstate = 0x01;
-
-    for (round = 0; round < 24; round++) {
-        {   /* === θ step (see [Keccak Reference, Section 2.3.2]) === */
-            tKeccakLane C[5];
-
-            /* Compute the parity of the columns */
-            for (x = 0; x < 5; x++)
-                C[x] = readLane(x, 0) ^ readLane(x, 1) ^ readLane(x, 2) ^ readLane(x, 3) ^
-                       readLane(x, 4);
-            for (x = 0; x < 5; x++) {
-                /* Compute the θ effect for a given column */
-                tKeccakLane D = C[(x + 4) % 5] ^ ROL64(C[(x + 1) % 5], 1);
-                /* Add the θ effect to the whole column */
-                for (y = 0; y < 5; y++)
-                    XORLane(x, y, D);
-            }
-        }
-
-        {   /* === ρ and π steps (see [Keccak Reference, Sections 2.3.3 and 2.3.4]) === */
-            tKeccakLane current;
-            /* Start at coordinates (1 0) */
-            x = 1; y = 0;
-            current = readLane(x, y);
-            /* Iterate over ((0 1)(2 3))^t * (1 0) for 0 ≤ t ≤ 23 */
-            for (t = 0; t < 24; t++) {
-                /* Compute the rotation constant r = (t+1)(t+2)/2 */
-                unsigned int r = ((t + 1) * (t + 2) / 2) % 64;
-                /* Compute ((0 1)(2 3)) * (x y) */
-                unsigned int Y = (2 * x + 3 * y) % 5; x = y; y = Y;
-                /* Swap current and state(x,y), and rotate */
-                tKeccakLane temp = readLane(x, y);
-                writeLane(x, y, ROL64(current, r));
-                current = temp;
-            }
-        }
+    uint64_t E[25];
 
-        {   /* === χ step (see [Keccak Reference, Section 2.3.1]) === */
-            tKeccakLane temp[5];
-            for (y = 0; y < 5; y++) {
-                /* Take a copy of the plane */
-                for (x = 0; x < 5; x++)
-                    temp[x] = readLane(x, y);
-                /* Compute χ on the plane */
-                for (x = 0; x < 5; x++)
-                    writeLane(x, y, temp[x] ^ ((~temp[(x + 1) % 5]) & temp[(x + 2) % 5]));
-            }
-        }
-
-        {
-            /* === ι step (see [Keccak Reference, Section 2.3.5]) === */
-            for (j = 0; j < 7; j++) {
-                unsigned int bitPosition = (1 << j) - 1;    /* 2^j-1 */
-                if (LFSR86540(&LFSRstate)) {
-                    XORLane(0, 0, (tKeccakLane)1 << bitPosition);
-                }
-            }
-        }
+    KeccakF1600_ComplementLanes(state);
+    for (unsigned round = 0; round < 24; round += 2) {
+        KeccakF1600_Round(E, state, KeccakF1600RoundConstants[round]);
+        KeccakF1600_Round(state, E, KeccakF1600RoundConstants[round + 1]);
     }
+    KeccakF1600_ComplementLanes(state);
 }
 
 /*
    ================================================================
-   A readable and compact implementation of the Keccak sponge functions
-   that use the Keccak-f[1600] permutation.
+   The Keccak sponge functions that use the Keccak-f[1600] permutation.
    ================================================================
  */
 
-#include <string.h>
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
+/** XORs a byte into the state at the given byte position */
+static void XORByte(uint64_t *state, unsigned int pos, uint8_t byte)
+{
+    state[pos / 8] ^= (uint64_t)byte << (8 * (pos % 8));
+}
 
-static void Keccak(unsigned int rate, unsigned int capacity, const unsigned char *input,
-                   unsigned long long int inputByteLen, unsigned char delimitedSuffix,
-                   unsigned char *output, unsigned long long int outputByteLen)
+/** XORs @p len bytes into the rate at the current position, lane-wise where
+ * possible. The bytes must fit into the rate. */
+static void Keccak_absorb(keccak_state_t *ctx, const uint8_t *input,
+                          unsigned int len)
 {
-    UINT8 state[200];
-    unsigned int rateInBytes = rate / 8;
-    unsigned int blockSize = 0;
-    unsigned int i;
+    unsigned int pos = ctx->i;
 
-    if (((rate + capacity) != 1600) || ((rate % 8) != 0)) {
-        return;
+    for (; (len > 0) && (pos % 8); len--, pos++) {
+        XORByte(ctx->state, pos, *input++);
     }
-
-    /* === Initialize the state === */
-    memset(state, 0, sizeof(state));
-
-    /* === Absorb all the input blocks === */
-    while (inputByteLen > 0) {
-        blockSize = MIN(inputByteLen, rateInBytes);
-        for (i = 0; i < blockSize; i++)
-            state[i] ^= input[i];
-        input += blockSize;
-        inputByteLen -= blockSize;
-
-        if (blockSize == rateInBytes) {
-            KeccakF1600_StatePermute(state);
-            blockSize = 0;
-        }
+    for (; len >= 8; len -= 8, pos += 8, input += 8) {
+        ctx->state[pos / 8] ^= load64(input);
     }
-
-    /* === Do the padding and switch to the squeezing phase === */
-    /* Absorb the last few bits and add the first bit of padding (which coincides with the
-       delimiter in delimitedSuffix) */
-    state[blockSize] ^= delimitedSuffix;
-    /* If the first bit of padding is at position rate-1, we need a whole new block for the
-       second bit of padding */
-    if (((delimitedSuffix & 0x80) != 0) && (blockSize == (rateInBytes - 1))) {
-        KeccakF1600_StatePermute(state);
+    for (; len > 0; len--, pos++) {
+        XORByte(ctx->state, pos, *input++);
     }
-    /* Add the second bit of padding */
-    state[rateInBytes - 1] ^= 0x80;
-    /* Switch to the squeezing phase */
-    KeccakF1600_StatePermute(state);
+    ctx->i = pos;
+}
 
-    /* === Squeeze out all the output blocks === */
-    while (outputByteLen > 0) {
-        blockSize = MIN(outputByteLen, rateInBytes);
-        memcpy(output, state, blockSize);
-        output += blockSize;
-        outputByteLen -= blockSize;
+/** Extracts @p len bytes from the rate at the current position, lane-wise
+ * where possible. The bytes must be available in the rate. */
+static void Keccak_extract(keccak_state_t *ctx, uint8_t *output,
+                           unsigned int len)
+{
+    unsigned int pos = ctx->i;
 
-        if (outputByteLen > 0) {
-            KeccakF1600_StatePermute(state);
-        }
+    for (; (len > 0) && (pos % 8); len--, pos++) {
+        *output++ = ctx->state[pos / 8] >> (8 * (pos % 8));
     }
+    for (; len >= 8; len -= 8, pos += 8, output += 8) {
+        store64(output, ctx->state[pos / 8]);
+    }
+    for (; len > 0; len--, pos++) {
+        *output++ = ctx->state[pos / 8] >> (8 * (pos % 8));
+    }
+    ctx->i = pos;
 }
 
 void Keccak_init(keccak_state_t *ctx, unsigned int rate, unsigned int capacity,
@@ -403,6 +278,7 @@ void Keccak_init(keccak_state_t *ctx, unsigned int rate, unsigned int capacity,
     /* === Initialize the state === */
     memset(ctx->state, 0, sizeof(ctx->state));
     ctx->i = 0;
+    ctx->squeezing = 0;
 
     ctx->rate = rate;
     ctx->capacity = capacity;
@@ -414,47 +290,152 @@ void Keccak_update(keccak_state_t *ctx, const unsigned char *input,
 {
     /* === Absorb all the input blocks === */
     while (inputByteLen > 0) {
-        unsigned int blockSize = MIN(inputByteLen + ctx->i, ctx->rateInBytes);
-        while (ctx->i < blockSize) {
-            ctx->state[ctx->i] ^= *input;
-            ++(ctx->i);
-            input++;
-            --inputByteLen;
-        }
+        unsigned int blockSize = MIN(inputByteLen, ctx->rateInBytes - ctx->i);
 
-        if (blockSize == ctx->rateInBytes) {
+        Keccak_absorb(ctx, input, blockSize);
+        input += blockSize;
+        inputByteLen -= blockSize;
+
+        if (ctx->i == ctx->rateInBytes) {
             KeccakF1600_StatePermute(ctx->state);
             ctx->i = 0;
         }
     }
 }
 
-void Keccak_final(keccak_state_t *ctx, unsigned char *output, unsigned long long int outputByteLen)
+void Keccak_squeeze(keccak_state_t *ctx, unsigned char *output,
+                    size_t outputByteLen)
 {
-
-    /* === Do the padding and switch to the squeezing phase === */
-    /* Absorb the last few bits and add the first bit of padding (which coincides with the
-       delimiter in delimitedSuffix) */
-    ctx->state[ctx->i] ^= ctx->delimitedSuffix;
-    /* If the first bit of padding is at position rate-1, we need a whole new block for the
-       second bit of padding */
-    if (((ctx->delimitedSuffix & 0x80) != 0) && (ctx->i == (ctx->rateInBytes - 1))) {
+    if (!ctx->squeezing) {
+        /* === Do the padding and switch to the squeezing phase === */
+        /* Absorb the last few bits and add the first bit of padding (which coincides with the
+           delimiter in delimitedSuffix) */
+        XORByte(ctx->state, ctx->i, ctx->delimitedSuffix);
+        /* If the first bit of padding is at position rate-1, we need a whole new block for the
+           second bit of padding */
+        if (((ctx->delimitedSuffix & 0x80) != 0) && (ctx->i == (ctx->rateInBytes - 1))) {
+            KeccakF1600_StatePermute(ctx->state);
+        }
+        /* Add the second bit of padding */
+        XORByte(ctx->state, ctx->rateInBytes - 1, 0x80);
+        /* Switch to the squeezing phase */
         KeccakF1600_StatePermute(ctx->state);
+        ctx->i = 0;
+        ctx->squeezing = 1;
     }
-    /* Add the second bit of padding */
-    ctx->state[ctx->rateInBytes - 1] ^= 0x80;
-    /* Switch to the squeezing phase */
-    KeccakF1600_StatePermute(ctx->state);
 
     /* === Squeeze out all the output blocks === */
     while (outputByteLen > 0) {
-        unsigned int blockSize = MIN(outputByteLen, ctx->rateInBytes);
-        memcpy(output, ctx->state, blockSize);
-        output += blockSize;
-        outputByteLen -= blockSize;
-
-        if (outputByteLen > 0) {
+        if (ctx->i == ctx->rateInBytes) {
             KeccakF1600_StatePermute(ctx->state);
+            ctx->i = 0;
         }
+
+        unsigned int blockSize = MIN(outputByteLen, ctx->rateInBytes - ctx->i);
+
+        Keccak_extract(ctx, output, blockSize);
+        output += blockSize;
+        outputByteLen -= blockSize;
     }
 }
+
+void Keccak_final(keccak_state_t *ctx, unsigned char *output, unsigned long long int outputByteLen)
+{
+    Keccak_squeeze(ctx, output, outputByteLen);
+}
+
+/*
+   ================================================================
+   The FIPS 202 instances.
+   ================================================================
+ */
+
+void sha3_update(keccak_state_t *ctx, const void *data, size_t len)
+{
+    Keccak_update(ctx, data, len);
+}
+
+void sha3_256_init(keccak_state_t *ctx)
+{
+    Keccak_init(ctx, 1088, 512, 0x06);
+}
+
+void sha3_256_final(keccak_state_t *ctx, void *digest)
+{
+    Keccak_final(ctx, digest, SHA3_256_DIGEST_LENGTH);
+}
+
+void sha3_256(void *digest, const void *data, size_t len)
+{
+    keccak_state_t ctx;
+
+    sha3_256_init(&ctx);
+    sha3_update(&ctx, data, len);
+    sha3_256_final(&ctx, digest);
+}
+
+void sha3_384_init(keccak_state_t *ctx)
+{
+    Keccak_init(ctx, 832, 768, 0x06);
+}
+
+void sha3_384_final(keccak_state_t *ctx, void *digest)
+{
+    Keccak_final(ctx, digest, SHA3_384_DIGEST_LENGTH);
+}
+
+void sha3_384(void *digest, const void *data, size_t len)
+{
+    keccak_state_t ctx;
+
+    sha3_384_init(&ctx);
+    sha3_update(&ctx, data, len);
+    sha3_384_final(&ctx, digest);
+}
+
+void sha3_512_init(keccak_state_t *ctx)
+{
+    Keccak_init(ctx, 576, 1024, 0x06);
+}
+
+void sha3_512_final(keccak_state_t *ctx, void *digest)
+{
+    Keccak_final(ctx, digest, SHA3_512_DIGEST_LENGTH);
+}
+
+void sha3_512(void *digest, const void *data, size_t len)
+{
+    keccak_state_t ctx;
+
+    sha3_512_init(&ctx);
+    sha3_update(&ctx, data, len);
+    sha3_512_final(&ctx, digest);
+}
+
+void shake128_init(keccak_state_t *ctx)
+{
+    Keccak_init(ctx, 1344, 256, 0x1F);
+}
+
+void shake256_init(keccak_state_t *ctx)
+{
+    Keccak_init(ctx, 1088, 512, 0x1F);
+}
+
+void shake128(void *output, size_t output_len, const void *data, size_t len)
+{
+    keccak_state_t ctx;
+
+    shake128_init(&ctx);
+    shake_update(&ctx, data, len);
+    shake_squeeze(&ctx, output, output_len);
+}
+
+void shake256(void *output, size_t output_len, const void *data, size_t len)
+{
+    keccak_state_t ctx;
+
+    shake256_init(&ctx);
+    shake_update(&ctx, data, len);
+    shake_squeeze(&ctx, output, output_len);
+}
@@ -21,6 +21,7 @@
 #ifndef BENCHMARK_H
 #define BENCHMARK_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "irq.h"
@@ -53,6 +54,51 @@ extern "C" {
         benchmark_print_time(_benchmark_time, runs, name);      \
     }
 
+/**
+ * @brief   Measure the throughput of a given function call
+ *
+ * Like BENCHMARK_FUNC(), but prints the runtime per processed byte, e.g. of
+ * a hash or checksum.
+ *
+ * @param[in] name      name for labeling the output
+ * @param[in] runs      number of times to run @p func
+ * @param[in] bytes     number of bytes @p func processes per run
+ * @param[in] func      function call to benchmark
+ */
+#define BENCHMARK_FUNC_BYTES(name, runs, bytes, func)           \
+    {                                                           \
+        unsigned _benchmark_irqstate = irq_disable();           \
+        uint32_t _benchmark_time = xtimer_now_usec();           \
+        for (unsigned long i = 0; i < runs; i++) {              \
+            func;                                               \
+        }                                                       \
+        _benchmark_time = (xtimer_now_usec() - _benchmark_time);\
+        irq_restore(_benchmark_irqstate);                       \
+        benchmark_print_bytes(_benchmark_time, runs, bytes, name);\
+    }
+
+/**
+ * @brief   Measure the throughput of a function call that may block
+ *
+ * Like BENCHMARK_FUNC_BYTES(), but keeps interrupts enabled, so @p func may
+ * e.g. lock a mutex. Interrupts that occur during the measurement are
+ * included in the result.
+ *
+ * @param[in] name      name for labeling the output
+ * @param[in] runs      number of times to run @p func
+ * @param[in] bytes     number of bytes @p func processes per run
+ * @param[in] func      function call to benchmark
+ */
+#define BENCHMARK_FUNC_BYTES_BLOCKING(name, runs, bytes, func)  \
+    {                                                           \
+        uint32_t _benchmark_time = xtimer_now_usec();           \
+        for (unsigned long i = 0; i < runs; i++) {              \
+            func;                                               \
+        }                                                       \
+        _benchmark_time = (xtimer_now_usec() - _benchmark_time);\
+        benchmark_print_bytes(_benchmark_time, runs, bytes, name);\
+    }
+
 /**
  * @brief   Output the given time as well as the time per run on STDIO
  *
@@ -62,6 +108,20 @@ extern "C" {
  */
 void benchmark_print_time(uint32_t time, unsigned long runs, const char *name);
 
+/**
+ * @brief   Output the given time per processed byte on STDIO
+ *
+ * Prints nanoseconds per byte and, if the board defines `CLOCK_CORECLOCK`,
+ * CPU cycles per byte.
+ *
+ * @param[in] time      overall runtime in us
+ * @param[in] runs      number of runs
+ * @param[in] bytes     number of bytes processed per run
+ * @param[in] name      name to label the output
+ */
+void benchmark_print_bytes(uint32_t time, unsigned long runs, size_t bytes,
+                           const char *name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -37,6 +37,21 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Number of bytes processed per table lookup round
+ *
+ * Trades flash for speed:
+ * - 0: a table of 16 entries (32 bytes), processes half a byte per lookup
+ * - 1: a table of 256 entries (512 bytes), processes a byte per lookup
+ * - 4: slicing-by-4, four tables (2 KiB) processing four bytes per round
+ * - 8: slicing-by-8, eight tables (4 KiB) processing eight bytes per round
+ *
+ * See tests/bench_checksum for the throughput on a given board.
+ */
+#ifndef CRC16_CCITT_SLICES
+#define CRC16_CCITT_SLICES  (1)
+#endif
+
 /**
  * @brief           Update CRC16-CCITT
  *
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_checksum_crc32 CRC32
+ * @ingroup     sys_checksum
+ *
+ * @brief       CRC32 checksum algorithm of IEEE 802.3
+ * @details     This is the CRC32 of Ethernet, zlib and PNG: the reflected
+ *              polynomial 0xEDB88320, start value 0xFFFFFFFF and an inverted
+ *              result.
+ *
+ *              crc32_ieee_update() works on the CRC register, i.e. without
+ *              the final inversion. This is the same as littlefs' lfs_crc(),
+ *              so file systems and bootloaders can share one table.
+ *
+ * @{
+ * @file
+ */
+
+#ifndef CHECKSUM_CRC32_H
+#define CHECKSUM_CRC32_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of bytes processed per table lookup round
+ *
+ * Trades flash for speed:
+ * - 0: a table of 16 entries (64 bytes), processes half a byte per lookup
+ * - 1: a table of 256 entries (1 KiB), processes a byte per lookup
+ * - 4: slicing-by-4, four tables (4 KiB) processing four bytes per round
+ * - 8: slicing-by-8, eight tables (8 KiB) processing eight bytes per round
+ *
+ * See tests/bench_checksum for the throughput on a given board.
+ */
+#ifndef CRC32_IEEE_SLICES
+#define CRC32_IEEE_SLICES   (1)
+#endif
+
+/**
+ * @brief           Update the CRC32 register
+ *
+ * To continue a checksum returned by crc32_ieee_calc(), pass its inverse as
+ * @p crc and invert the result.
+ *
+ * @param[in]  crc  The CRC register, 0xFFFFFFFF to start a new checksum
+ * @param[in]  buf  Start of the memory area to checksum
+ * @param[in]  len  Number of bytes to checksum
+ *
+ * @return          The updated CRC register
+ */
+uint32_t crc32_ieee_update(uint32_t crc, const void *buf, size_t len);
+
+/**
+ * @brief           Calculate CRC32
+ *
+ * @param[in]  buf  Start of the memory area to checksum
+ * @param[in]  len  Number of bytes to checksum
+ *
+ * @return          Checksum of the specified memory area
+ */
+uint32_t crc32_ieee_calc(const void *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHECKSUM_CRC32_H */
+
+/** @} */
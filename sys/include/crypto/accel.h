@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_crypto_accel Crypto accelerator dispatch
+ * @ingroup     sys_crypto
+ * @brief       Dispatch of AES-128 and SHA-256 to accelerated backends
+ *
+ * CPUs and boards with cryptographic hardware describe it with a
+ * @ref crypto_accel_t and register it with crypto_accel_register(). For each
+ * algorithm, the registered backend with the highest priority is selected.
+ * Without a backend, the software implementation is used.
+ *
+ * Callers need no changes:
+ * - cipher_init() with @ref CIPHER_AES_128 initializes the cipher with the
+ *   selected AES-128 backend. The backend is bound to the cipher at this
+ *   point, so backends have to be registered before the first cipher is
+ *   initialized, e.g. from cpu_init(), board_init() or auto_init.
+ * - SHA-256, and everything built on it like hmac_sha256() or
+ *   sha256_chain(), compresses its blocks with the selected SHA-256 backend.
+ *
+ * Backends have to serialize access to the hardware themselves. The
+ * `crypto_accel_mock` module registers a software backend on native that
+ * counts its calls, to test the dispatch.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Crypto accelerator dispatch interface
+ */
+
+#ifndef CRYPTO_ACCEL_H
+#define CRYPTO_ACCEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto/ciphers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Compresses consecutive SHA-256 blocks
+ *
+ * @param[in,out] state     the eight state words of the hash, in host byte
+ *                          order
+ * @param[in] blocks        @p numof blocks of 64 bytes, not necessarily
+ *                          aligned
+ * @param[in] numof         number of blocks in @p blocks
+ *
+ * A backend that cannot process some input (e.g. while the hardware is
+ * busy) may fall back to sha256_blocks_sw().
+ */
+typedef void (*crypto_accel_sha256_t)(uint32_t *state, const void *blocks,
+                                      size_t numof);
+
+/**
+ * @brief   Description of a crypto accelerator
+ */
+typedef struct {
+    const char *name;                   /**< name for debug output */
+    uint8_t priority;                   /**< higher values are preferred */
+    /**
+     * @brief   AES-128 implementation, or NULL
+     *
+     * Its context has to fit into @ref cipher_context_t.
+     */
+    const cipher_interface_t *aes_128;
+    crypto_accel_sha256_t sha256;       /**< SHA-256 implementation, or NULL */
+} crypto_accel_t;
+
+/**
+ * @brief   Registers a crypto accelerator
+ *
+ * The accelerator replaces the selected backend of every algorithm it
+ * implements, if its priority is higher. Not thread safe, register all
+ * accelerators during initialization.
+ *
+ * @param[in] accel     the accelerator, must stay valid forever
+ */
+void crypto_accel_register(const crypto_accel_t *accel);
+
+/**
+ * @brief   Gets the implementation of a cipher to use
+ *
+ * @param[in] cipher_id the software implementation, e.g. @ref CIPHER_AES_128
+ *
+ * @return  the interface of the selected backend, or @p cipher_id if no
+ *          backend implements the cipher
+ */
+cipher_id_t crypto_accel_cipher(cipher_id_t cipher_id);
+
+/**
+ * @brief   Gets the selected SHA-256 backend
+ *
+ * @return  the compression function of the backend, or NULL to use the
+ *          software implementation
+ */
+crypto_accel_sha256_t crypto_accel_sha256(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRYPTO_ACCEL_H */
+/** @} */
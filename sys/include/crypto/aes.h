@@ -126,6 +126,41 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plain_block,
 int aes_decrypt(const cipher_context_t *context, const uint8_t *cipher_block,
                 uint8_t *plain_block);
 
+/**
+ * @brief   encrypts consecutive blocks, expanding the key only once
+ *
+ * With the `crypto_aes_bitslice` pseudomodule, several blocks are encrypted
+ * in parallel in constant time.
+ *
+ * @param       context       the cipher_context_t-struct to use for this
+ *                            encryption
+ * @param       input         @p numof plaintext blocks
+ * @param       output        @p numof ciphertext blocks, may be @p input
+ * @param       numof         number of blocks
+ *
+ * @return  1 on success
+ * @return  A negative value if the cipher key cannot be expanded with the
+ *          AES key schedule
+ */
+int aes_encrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t numof);
+
+/**
+ * @brief   decrypts consecutive blocks, expanding the key only once
+ *
+ * @param       context       the cipher_context_t-struct to use for this
+ *                            decryption
+ * @param       input         @p numof ciphertext blocks
+ * @param       output        @p numof plaintext blocks, may be @p input
+ * @param       numof         number of blocks
+ *
+ * @return  1 on success
+ * @return  A negative value if the cipher key cannot be expanded with the
+ *          AES key schedule
+ */
+int aes_decrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t numof);
+
 #ifdef __cplusplus
 }
 #endif
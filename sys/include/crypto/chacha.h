@@ -41,6 +41,27 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Size of a block of the keystream in bytes
+ */
+#define CHACHA_BLOCK_SIZE   (64U)
+
+#ifndef CHACHA_VECTORIZE
+/**
+ * @brief   Set to 1 to compute four blocks of the keystream at once in
+ *          chacha_keystream_blocks() and chacha_encrypt_buf()
+ *
+ * The four blocks are computed with the vector extensions of GCC, which only
+ * pays off on CPUs with 128 bit vector registers. It is enabled by default
+ * for SSE2 and NEON, see tests/bench_crypto_chacha.
+ */
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define CHACHA_VECTORIZE    (1)
+#else
+#define CHACHA_VECTORIZE    (0)
+#endif
+#endif
+
 /**
  * @brief A ChaCha cipher stream context.
  * @details Initialize with chacha_init().
@@ -81,6 +102,22 @@ int chacha_init(chacha_ctx *ctx,
  */
 void chacha_keystream_bytes(chacha_ctx *ctx, void *x);
 
+/**
+ * @brief Generate the next blocks in the keystream.
+ *
+ * @details Generates the same keystream as @p numof calls of
+ *          chacha_keystream_bytes().
+ *
+ * @warning You need to re-initialize the context with a new nonce after 2^64
+ *          encrypted blocks, or the keystream will repeat!
+ *
+ * @param[in,out] ctx   The ChaCha context
+ * @param[out]    x     The blocks of the keystream
+ *                      (`sizeof(x) == numof * CHACHA_BLOCK_SIZE`).
+ * @param[in]     numof Number of blocks to generate
+ */
+void chacha_keystream_blocks(chacha_ctx *ctx, void *x, size_t numof);
+
 /**
  * @brief Encode or decode a block of data.
  *
@@ -105,6 +142,35 @@ static inline void chacha_decrypt_bytes(chacha_ctx *ctx, const uint8_t *m,
     chacha_encrypt_bytes(ctx, m, c);
 }
 
+/**
+ * @brief Encode or decode a buffer of arbitrary length.
+ *
+ * @details @p m is always the input regardless if it is the plaintext or ciphertext,
+ *          and @p c vice verse. @p m and @p c may be the same buffer.
+ *
+ *          The keystream is used up block-wise: if @p len is not a multiple
+ *          of @ref CHACHA_BLOCK_SIZE, the rest of the last block is discarded.
+ *
+ * @warning You need to re-initialize the context with a new nonce after 2^64
+ *          encrypted blocks, or the keystream will repeat!
+ *
+ * @param[in,out] ctx The ChaCha context.
+ * @param[in]     m   The input.
+ * @param[out]    c   The output.
+ * @param[in]     len Length of @p m and @p c in bytes.
+ */
+void chacha_encrypt_buf(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
+                        size_t len);
+
+/**
+ * @copydoc chacha_encrypt_buf()
+ */
+static inline void chacha_decrypt_buf(chacha_ctx *ctx, const uint8_t *m,
+                                      uint8_t *c, size_t len)
+{
+    chacha_encrypt_buf(ctx, m, c, len);
+}
+
 /**
  * @brief Seed the pseudo-random number generator.
  *
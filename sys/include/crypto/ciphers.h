@@ -22,6 +22,7 @@
 #ifndef CRYPTO_CIPHERS_H
 #define CRYPTO_CIPHERS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -34,14 +35,27 @@ extern "C" {
 #define CIPHERS_MAX_KEY_SIZE 20
 #define CIPHER_MAX_BLOCK_SIZE 16
 
+#ifndef CIPHER_BLOCKS_PER_CALL
+/**
+ * @brief   Number of blocks the operation modes pass to a single call of
+ *          cipher_encrypt_blocks() or cipher_decrypt_blocks()
+ *
+ * The modes keep this many blocks on the stack.
+ */
+#define CIPHER_BLOCKS_PER_CALL  (4U)
+#endif
+
 /**
  * Context sizes needed for the different ciphers.
  * Always order by number of bytes descending!!! <br><br>
  *
+ * aes with crypto_aes_bitslice needs 176 bytes for the round keys <br>
  * threedes     needs 24  bytes                           <br>
  * aes          needs CIPHERS_MAX_KEY_SIZE bytes          <br>
  */
-#if defined(MODULE_CRYPTO_3DES)
+#if defined(MODULE_CRYPTO_AES_BITSLICE)
+    #define CIPHER_MAX_CONTEXT_SIZE 176
+#elif defined(MODULE_CRYPTO_3DES)
     #define CIPHER_MAX_CONTEXT_SIZE 24
 #elif defined(MODULE_CRYPTO_AES)
     #define CIPHER_MAX_CONTEXT_SIZE CIPHERS_MAX_KEY_SIZE
@@ -89,6 +103,14 @@ typedef struct cipher_interface_st {
     /** the decrypt function */
     int (*decrypt)(const cipher_context_t *ctx, const uint8_t *cipher_block,
                    uint8_t *plain_block);
+
+    /** the function encrypting consecutive blocks, may be NULL */
+    int (*encrypt_blocks)(const cipher_context_t *ctx, const uint8_t *input,
+                          uint8_t *output, size_t numof);
+
+    /** the function decrypting consecutive blocks, may be NULL */
+    int (*decrypt_blocks)(const cipher_context_t *ctx, const uint8_t *input,
+                          uint8_t *output, size_t numof);
 } cipher_interface_t;
 
 
@@ -162,6 +184,43 @@ int cipher_decrypt(const cipher_t *cipher, const uint8_t *input,
                    uint8_t *output);
 
 
+/**
+ * @brief Encrypt consecutive blocks of BLOCK_SIZE length
+ *
+ * Faster than calling cipher_encrypt() for each block, if the cipher
+ * processes several blocks at once.
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p numof blocks to encrypt
+ * @param output     pointer to allocated memory for @p numof encrypted
+ *                   blocks, may be @p input
+ * @param numof      number of blocks
+ *
+ * @return           The result of the encrypt operation of the underlying
+ *                   cipher, which is always 1 in case of success
+ * @return           A negative value for an error
+ */
+int cipher_encrypt_blocks(const cipher_t *cipher, const uint8_t *input,
+                          uint8_t *output, size_t numof);
+
+
+/**
+ * @brief Decrypt consecutive blocks of BLOCK_SIZE length
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p numof blocks to decrypt
+ * @param output     pointer to allocated memory for @p numof decrypted
+ *                   blocks, may be @p input
+ * @param numof      number of blocks
+ *
+ * @return           The result of the decrypt operation of the underlying
+ *                   cipher, which is always 1 in case of success
+ * @return           A negative value for an error
+ */
+int cipher_decrypt_blocks(const cipher_t *cipher, const uint8_t *input,
+                          uint8_t *output, size_t numof);
+
+
 /**
  * @brief Get block size of cipher
  * *
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file        gcm.h
+ * @brief       Galois/Counter Mode (GCM) AEAD mode as specified in
+ *              NIST SP 800-38D
+ *
+ * GHASH uses a 4-bit multiplication table of 256 bytes (Shoup's method),
+ * which is computed on the stack for every call.
+ *
+ * @warning GHASH is not constant-time. The table is derived from the hash key
+ *          and indexed by the data being hashed, so its access pattern leaks
+ *          through timing and the cache, like the AES T-tables do. Don't use
+ *          this mode where an attacker can measure either.
+ */
+
+#ifndef CRYPTO_MODES_GCM_H
+#define CRYPTO_MODES_GCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto/ciphers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name GCM error codes
+ * @{
+ */
+/**
+ * Returned if an empty nonce was used
+ */
+#define GCM_ERR_INVALID_NONCE_LENGTH        (-2)
+/**
+ * GCM only works with ciphers with a block size of 128 bit
+ */
+#define GCM_ERR_INVALID_BLOCK_LENGTH        (-3)
+/**
+ * Returned if the amount of input data cannot be handled by this implementation
+ */
+#define GCM_ERR_INVALID_DATA_LENGTH         (-4)
+/**
+ * Returned if a tag of bad length was requested (4, 8 or 12 to 16 bytes)
+ */
+#define GCM_ERR_INVALID_TAG_LENGTH          (-5)
+/**
+ * Returned if the authentication failed during decryption
+ */
+#define GCM_ERR_INVALID_TAG                 (-6)
+/** @} */
+
+/**
+ * @brief Block size required for the cipher. GCM is only defined for 128 bit ciphers.
+ */
+#define GCM_BLOCK_SIZE                      16
+
+/**
+ * @brief Encrypt and authenticate data of arbitrary length in GCM mode.
+ *
+ * @param cipher           Already initialized cipher struct
+ * @param auth_data        Additional data to authenticate in the tag
+ * @param auth_data_len    Length of additional data
+ * @param tag_len          Length of the appended tag (4, 8 or 12 to 16 bytes)
+ * @param nonce            Nonce for the encryption (must be unique), 12 bytes
+ *                         are recommended
+ * @param nonce_len        Length of the nonce in bytes (at least 1)
+ * @param input            pointer to input data to encrypt
+ * @param input_len        length of the input data.
+ *                         input_len + tag_len must be smaller than INT32_MAX (2^31-1)
+ * @param output           pointer to allocated memory for encrypted data, may
+ *                         be @p input. The tag will be appended to the
+ *                         ciphertext. It has to be of size input_len + tag_len.
+ * @return                 Length of the encrypted data (including the tag) or a (negative) error code
+ */
+int cipher_encrypt_gcm(cipher_t *cipher,
+                       const uint8_t *auth_data, size_t auth_data_len,
+                       uint8_t tag_len,
+                       const uint8_t *nonce, size_t nonce_len,
+                       const uint8_t *input, size_t input_len,
+                       uint8_t *output);
+
+/**
+ * @brief Decrypt and verify the authentication of GCM encrypted data.
+ *
+ * @param cipher           Already initialized cipher struct
+ * @param auth_data        Additional data to authenticate in the tag
+ * @param auth_data_len    Length of additional data
+ * @param tag_len          Length of the appended tag (4, 8 or 12 to 16 bytes)
+ * @param nonce            Nonce used for the encryption
+ * @param nonce_len        Length of the nonce in bytes (at least 1)
+ * @param input            pointer to the ciphertext with the tag appended
+ * @param input_len        length of the input data.
+ *                         input_len - tag_len must be smaller than INT32_MAX (2^31-1)
+ * @param output           pointer to allocated memory for the plaintext data,
+ *                         may be @p input. It has to be of size
+ *                         input_len - tag_len. Will contain only zeroes, if
+ *                         the authentication fails.
+ * @return                 Length of the plaintext data or a (negative) error code
+ */
+int cipher_decrypt_gcm(cipher_t *cipher,
+                       const uint8_t *auth_data, size_t auth_data_len,
+                       uint8_t tag_len,
+                       const uint8_t *nonce, size_t nonce_len,
+                       const uint8_t *input, size_t input_len,
+                       uint8_t *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRYPTO_MODES_GCM_H */
+/** @} */
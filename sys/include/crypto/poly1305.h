@@ -40,14 +40,40 @@ extern "C" {
  */
 #define POLY1305_BLOCK_SIZE 16
 
+#ifndef POLY1305_WIDE
+/**
+ * @brief   Set to 1 to compute with three 44 bit limbs in 64 bit words
+ *
+ * This needs 64 x 64 -> 128 bit multiplications and is enabled by default if
+ * the compiler provides `unsigned __int128`, i.e. on 64 bit CPUs. Otherwise,
+ * five 32 bit limbs are used, whose 32 x 32 -> 64 bit products map to single
+ * multiply-accumulate instructions, e.g. on Cortex-M3 and up.
+ *
+ * @note    None of the boards in RIOT has a 64 bit CPU, and native is built
+ *          for 32 bit, so the wide variant is not built or tested by CI. It
+ *          passes tests/sys_crypto when built for a 64 bit host.
+ */
+#if defined(__SIZEOF_INT128__)
+#define POLY1305_WIDE       (1)
+#else
+#define POLY1305_WIDE       (0)
+#endif
+#endif
+
 /**
  * @brief Poly1305 context
  */
 typedef struct {
+#if POLY1305_WIDE
+    uint64_t r[3];                          /**< first key part         */
+    uint64_t pad[2];                        /**< Second key part        */
+    uint64_t h[3];                          /**< Hash                   */
+#else
     uint32_t r[4];                          /**< first key part         */
     uint32_t pad[4];                        /**< Second key part        */
     uint32_t h[5];                          /**< Hash                   */
-    uint32_t c[4];                          /**< Message chunk          */
+#endif
+    uint8_t c[POLY1305_BLOCK_SIZE];         /**< Message chunk          */
     size_t c_idx;                           /**< Chunk length            */
 } poly1305_ctx_t;
 
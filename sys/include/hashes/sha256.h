@@ -55,6 +55,20 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Set to 1 to let sha256_update_multi() process the blocks of two
+ *          hashes interleaved
+ *
+ * This speeds up CPUs that issue several instructions per cycle and have
+ * enough registers for the working variables of both hashes, e.g. the
+ * Cortex-M7 or 64-bit hosts with optimization for speed. On other CPUs, the
+ * interleaved rounds run out of registers and are slower than hashing one
+ * after the other, see tests/bench_hashes_sha256.
+ */
+#ifndef SHA256_MULTI_INTERLEAVE
+#define SHA256_MULTI_INTERLEAVE     (0)
+#endif
+
 /**
  * @brief   Length of SHA256 digests in bytes
  */
@@ -113,6 +127,33 @@ void sha256_init(sha256_context_t *ctx);
  */
 void sha256_update(sha256_context_t *ctx, const void *data, size_t len);
 
+/**
+ * @brief Add the same number of bytes into several independent hashes
+ *
+ * Equivalent to calling sha256_update() for every context. With
+ * @ref SHA256_MULTI_INTERLEAVE, the blocks of two hashes at the same offset in
+ * their block are processed interleaved.
+ *
+ * @param ctx       array of @p numof sha256_context_t handles to use
+ * @param[in] data  array of @p numof input buffers, one per context
+ * @param[in] numof number of hashes
+ * @param[in] len   length of each buffer in @p data
+ */
+void sha256_update_multi(sha256_context_t *const ctx[],
+                         const void *const data[], size_t numof, size_t len);
+
+/**
+ * @brief Compresses consecutive blocks with the software implementation
+ *
+ * sha256_update() uses the backend selected by @ref sys_crypto_accel instead,
+ * if there is one. This allows such a backend to fall back to software.
+ *
+ * @param[in,out] state  the eight state words of the hash
+ * @param[in] blocks     @p numof blocks of SHA256_INTERNAL_BLOCK_SIZE bytes
+ * @param[in] numof      number of blocks
+ */
+void sha256_blocks_sw(uint32_t *state, const void *blocks, size_t numof);
+
 /**
  * @brief SHA-256 finalization.  Pads the input data, exports the hash value,
  * and clears the context state.
@@ -15,6 +15,10 @@
  * @defgroup    sys_hashes_sha3 SHA-3
  * @ingroup     sys_hashes_unkeyed
  * @brief       Implementation of the SHA-3 hashing function
+ *
+ * Besides the SHA-3 hash functions, the SHAKE128 and SHAKE256
+ * extendable-output functions (XOFs) of FIPS 202 are provided. Their output
+ * can be squeezed in pieces of arbitrary length.
  * @{
  *
  * @file
@@ -27,6 +31,7 @@
 #ifndef HASHES_SHA3_H
 #define HASHES_SHA3_H
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -48,16 +53,30 @@ extern "C" {
  */
 #define SHA3_512_DIGEST_LENGTH 64
 
+/**
+ * @brief   Rate of SHAKE128 in bytes, i.e. the amount of output squeezed per
+ *          permutation
+ */
+#define SHAKE128_RATE           168
+
+/**
+ * @brief   Rate of SHAKE256 in bytes, i.e. the amount of output squeezed per
+ *          permutation
+ */
+#define SHAKE256_RATE           136
+
 /**
  * @brief Context for operations on a sponge with keccak permutation
  */
 typedef struct {
-    /** State of the Keccak sponge */
-    unsigned char state[200];
+    /** State of the Keccak sponge as 25 lanes of 64 bit */
+    uint64_t state[25];
     /** Current position within the state */
     unsigned int i;
     /** The suffix used for padding */
     unsigned char delimitedSuffix;
+    /** Set once the padding was applied and output is being squeezed */
+    unsigned char squeezing;
     /** The bitrate of the sponge */
     unsigned int rate;
     /** The capacity in bits of the sponge */
@@ -87,9 +106,25 @@ void Keccak_init(keccak_state_t *ctx, unsigned int rate, unsigned int capacity,
 void Keccak_update(keccak_state_t *ctx, const unsigned char *input,
                    unsigned long long int inputByteLen);
 
+/**
+ * @brief Squeeze data from a sponge. Can be called multiple times
+ *
+ * The first call pads the absorbed data. Afterwards, no more data may be
+ * absorbed, and consecutive calls continue the output where the previous one
+ * stopped.
+ *
+ * @param[in,out] ctx        context handle of the sponge
+ * @param[out] output        the squeezed data
+ * @param[in] outputByteLen  size of the data to be squeezed.
+ */
+void Keccak_squeeze(keccak_state_t *ctx, unsigned char *output,
+                    size_t outputByteLen);
+
 /**
  * @brief Squeeze data from a sponge
  *
+ * Equivalent to a single call of Keccak_squeeze().
+ *
  * @param[in,out] ctx        context handle of the sponge
  * @param[out] output        the squeezed data
  * @param[in] outputByteLen  size of the data to be squeezed.
@@ -185,6 +220,70 @@ void sha3_384(void *digest, const void *data, size_t len);
  */
 void sha3_512(void *digest, const void *data, size_t len);
 
+/**
+ * @brief SHAKE128 initialization.  Begins a SHAKE128 operation.
+ *
+ * @param[in] ctx  keccak_state_t handle to initialise
+ */
+void shake128_init(keccak_state_t *ctx);
+
+/**
+ * @brief SHAKE256 initialization.  Begins a SHAKE256 operation.
+ *
+ * @param[in] ctx  keccak_state_t handle to initialise
+ */
+void shake256_init(keccak_state_t *ctx);
+
+/**
+ * @brief Add bytes into a SHAKE128 or SHAKE256 operation
+ *
+ * Must not be called after shake_squeeze().
+ *
+ * @param[in,out] ctx  context handle to use
+ * @param[in] data     Input data
+ * @param[in] len      Length of @p data
+ */
+static inline void shake_update(keccak_state_t *ctx, const void *data,
+                                size_t len)
+{
+    sha3_update(ctx, data, len);
+}
+
+/**
+ * @brief Squeeze output from a SHAKE128 or SHAKE256 operation
+ *
+ * Can be called multiple times to produce a continuous output stream.
+ *
+ * @param[in,out] ctx  context handle to use
+ * @param[out] output  buffer for the output
+ * @param[in] len      number of bytes to squeeze into @p output
+ */
+static inline void shake_squeeze(keccak_state_t *ctx, void *output,
+                                 size_t len)
+{
+    Keccak_squeeze(ctx, output, len);
+}
+
+/**
+ * @brief A wrapper function to compute SHAKE128 of one buffer
+ *
+ * @param[out] output     buffer for the output
+ * @param[in] output_len  number of output bytes
+ * @param[in] data        pointer to the buffer to compute SHAKE128 of
+ * @param[in] len         length of the buffer
+ */
+void shake128(void *output, size_t output_len, const void *data, size_t len);
+
+/**
+ * @brief A wrapper function to compute SHAKE256 of one buffer
+ *
+ * @param[out] output     buffer for the output
+ * @param[in] output_len  number of output bytes
+ * @param[in] data        pointer to the buffer to compute SHAKE256 of
+ * @param[in] len         length of the buffer
+ */
+void shake256(void *output, size_t output_len, const void *data, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -143,6 +143,17 @@ extern "C" {
 #define ASYMCUTE_N_RETRY            (3U)
 #endif
 
+#ifndef ASYMCUTE_PUB_WINDOW
+/**
+ * @brief   Maximum number of QoS 1 PUBLISH messages per connection that wait
+ *          for their PUBACK at the same time
+ *
+ * Every PUBLISH needs its own request context, so up to this many can be
+ * pipelined by passing different request contexts to asymcute_publish().
+ */
+#define ASYMCUTE_PUB_WINDOW         (4U)
+#endif
+
 /**
  * @brief   Return values used by public Asymcute functions
  */
@@ -263,6 +274,8 @@ struct asymcute_con {
                                          *   connection */
     uint8_t keepalive_retry_cnt;        /**< keep alive transmission counter */
     uint8_t state;                      /**< connection state */
+    uint8_t pub_inflight;               /**< QoS 1 PUBLISH messages waiting
+                                         *   for their PUBACK */
     uint8_t rxbuf[ASYMCUTE_BUFSIZE];    /**< connection specific receive buf */
     char cli_id[MQTTSN_CLI_ID_MAXLEN + 1];  /**< buffer to store client ID */
 };
@@ -500,7 +513,8 @@ int asymcute_register(asymcute_con_t *con, asymcute_req_t *req,
  * @return  ASYMCUTE_OVERFLOW if data does not fit into transmit buffer
  * @return  ASYMCUTE_REGERR if given topic is not registered
  * @return  ASYMCUTE_GWERR if not connected to a gateway
- * @return  ASYMCUTE_BUSY if the given request context is already in use
+ * @return  ASYMCUTE_BUSY if the given request context is already in use or if
+ *          @ref ASYMCUTE_PUB_WINDOW QoS 1 messages wait for their PUBACK
  */
 int asymcute_publish(asymcute_con_t *con, asymcute_req_t *req,
                      const asymcute_topic_t *topic,
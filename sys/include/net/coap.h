@@ -36,11 +36,15 @@ extern "C" {
  * @{
  */
 #define COAP_OPT_URI_HOST       (3)
+#define COAP_OPT_ETAG           (4)
 #define COAP_OPT_OBSERVE        (6)
+#define COAP_OPT_URI_PORT       (7)
 #define COAP_OPT_LOCATION_PATH  (8)
 #define COAP_OPT_URI_PATH       (11)
 #define COAP_OPT_CONTENT_FORMAT (12)
+#define COAP_OPT_MAX_AGE        (14)
 #define COAP_OPT_URI_QUERY      (15)
+#define COAP_OPT_ACCEPT         (17)
 #define COAP_OPT_LOCATION_QUERY (20)
 #define COAP_OPT_BLOCK2         (23)
 #define COAP_OPT_BLOCK1         (27)
@@ -127,6 +131,28 @@ extern "C" {
 #define COAP_CODE_PROXYING_NOT_SUPPORTED     ((5 << 5) | 5)
 /** @} */
 
+/**
+ * @name    Signaling message codes of CoAP over reliable transports (RFC 8323)
+ * @{
+ */
+#define COAP_CLASS_SIGNAL       (7)
+#define COAP_CODE_CSM           ((7 << 5) | 1)
+#define COAP_CODE_PING          ((7 << 5) | 2)
+#define COAP_CODE_PONG          ((7 << 5) | 3)
+#define COAP_CODE_RELEASE       ((7 << 5) | 4)
+#define COAP_CODE_ABORT         ((7 << 5) | 5)
+/** @} */
+
+/**
+ * @name    Signaling option numbers (RFC 8323)
+ * @{
+ */
+#define COAP_SIGNAL_OPT_MAX_MSG_SIZE    (2)     /**< CSM */
+#define COAP_SIGNAL_OPT_BLOCKWISE       (4)     /**< CSM */
+#define COAP_SIGNAL_OPT_CUSTODY         (2)     /**< Ping and Pong */
+#define COAP_SIGNAL_OPT_BAD_CSM         (2)     /**< Abort */
+/** @} */
+
 /**
  * @name    Content-Format option codes
  * @anchor  net_coap_format
@@ -59,6 +59,8 @@
  * - updating will message
  * - sending out periodic PINGREQ messages
  * - handling re-transmits
+ * - pipelining QoS 1 publish messages (see emcute_pub_async())
+ * - caching topic IDs obtained from the gateway
  *
  * The following features are however still missing (but planned):
  * @todo        Gateway discovery (so far there is no support for handling
@@ -154,6 +156,35 @@ extern "C" {
 #define EMCUTE_N_RETRY          (3U)
 #endif
 
+#ifndef EMCUTE_PUB_WINDOW
+/**
+ * @brief   Maximum number of QoS 1 publish messages sent by
+ *          emcute_pub_async() that wait for their PUBACK at the same time
+ */
+#define EMCUTE_PUB_WINDOW       (4U)
+#endif
+
+#ifndef EMCUTE_TOPIC_CACHE_SIZE
+/**
+ * @brief   Number of topic IDs remembered by emcute_reg()
+ *
+ * Registering a topic name found in the cache returns its topic ID without
+ * sending a REGISTER message to the gateway. The cache is cleared when
+ * connecting to a gateway.
+ */
+#define EMCUTE_TOPIC_CACHE_SIZE (4U)
+#endif
+
+#ifndef EMCUTE_TOPIC_CACHE_NAMELEN
+/**
+ * @brief   Buffer size for a topic name in the topic ID cache
+ *
+ * Topic names not fitting this buffer including their terminating null
+ * character are not cached.
+ */
+#define EMCUTE_TOPIC_CACHE_NAMELEN  (32U)
+#endif
+
 /**
  * @brief   MQTT-SN flags
  *
@@ -208,6 +239,23 @@ typedef struct {
  */
 typedef void(*emcute_cb_t)(const emcute_topic_t *topic, void *data, size_t len);
 
+/**
+ * @brief   Signature for callbacks fired when a publish message sent by
+ *          emcute_pub_async() is done
+ *
+ * Called from the emCute thread, or from the thread calling emcute_con() for
+ * messages left over from a failed connection attempt. emCute holds none of
+ * its locks while calling it, so it may call emcute_pub_async() or, outside
+ * of the emCute thread, emcute_con() again.
+ *
+ * @param[in] arg       the argument given to emcute_pub_async()
+ * @param[in] res       EMCUTE_OK if the gateway acknowledged the message,
+ *                      EMCUTE_REJECT if it rejected the message,
+ *                      EMCUTE_TIMEOUT if no PUBACK was received and
+ *                      EMCUTE_NOGW if we disconnected from the gateway
+ */
+typedef void(*emcute_pub_cb_t)(void *arg, int res);
+
 /**
  * @brief   Data-structure for keeping track of topics we register to
  */
@@ -254,6 +302,9 @@ int emcute_discon(void);
 /**
  * @brief   Get a topic ID for the given topic name from the gateway
  *
+ * Topic names found in the topic ID cache are not sent to the gateway again,
+ * see @ref EMCUTE_TOPIC_CACHE_SIZE.
+ *
  * @param[in,out] topic     topic to register, topic.name **must not** be NULL
  *
  * @return  EMCUTE_OK on success
@@ -270,7 +321,7 @@ int emcute_reg(emcute_topic_t *topic);
  * @param[in] topic     topic to send data to, topic **must** be registered
  *                      (topic.id **must** populated).
  * @param[in] buf       data to publish
- * @param[in] len       length of @p data in bytes
+ * @param[in] len       length of @p buf in bytes
  * @param[in] flags     flags used for publication, allowed are QoS and retain
  *
  * @return  EMCUTE_OK on success
@@ -283,6 +334,33 @@ int emcute_reg(emcute_topic_t *topic);
 int emcute_pub(emcute_topic_t *topic, const void *buf, size_t len,
                unsigned flags);
 
+/**
+ * @brief   Publish data on the given topic without waiting for the PUBACK
+ *
+ * Up to @ref EMCUTE_PUB_WINDOW QoS 1 messages can wait for their PUBACK at the
+ * same time, each with its own message ID. emCute retransmits them with the
+ * DUP flag set on its own and calls @p cb once a message is done.
+ *
+ * QoS 0 messages are sent right away and @p cb is not called for them.
+ *
+ * @param[in] topic     topic to send data to, topic **must** be registered
+ *                      (topic.id **must** populated).
+ * @param[in] buf       data to publish, **must** stay valid until @p cb is
+ *                      called for QoS 1 messages
+ * @param[in] len       length of @p buf in bytes
+ * @param[in] flags     flags used for publication, allowed are QoS and retain
+ * @param[in] cb        called when a QoS 1 message is done, may be NULL
+ * @param[in] arg       argument passed to @p cb
+ *
+ * @return  EMCUTE_OK on success
+ * @return  EMCUTE_NOGW if not connected to a gateway
+ * @return  EMCUTE_OVERFLOW if length of data exceeds @ref EMCUTE_BUFSIZE or
+ *          if @ref EMCUTE_PUB_WINDOW QoS 1 messages wait for their PUBACK
+ * @return  EMCUTE_NOTSUP on unsupported flag values
+ */
+int emcute_pub_async(emcute_topic_t *topic, const void *buf, size_t len,
+                     unsigned flags, emcute_pub_cb_t cb, void *arg);
+
 /**
  * @brief   Subscribe to the given topic
  *
@@ -315,6 +315,79 @@
  * times out. We track the response with an entry in the
  * `_coap_state.open_reqs` array.
  *
+ * ### Table sizes ###
+ *
+ * Open requests are looked up by token and remote endpoint, observe
+ * registrations by client, token and resource, all through hash tables over
+ * the respective arrays. So the time to match an incoming packet does not
+ * grow with @ref CONFIG_GCOAP_REQ_WAITING_MAX,
+ * @ref CONFIG_GCOAP_OBS_CLIENTS_MAX or @ref CONFIG_GCOAP_OBS_REGISTRATIONS_MAX,
+ * which may be raised to hundreds of entries, e.g. for a proxy. The hash
+ * tables add 4 to 8 bytes of RAM per entry.
+ *
+ * ### Congestion control ###
+ *
+ * At most @ref CONFIG_GCOAP_NSTART confirmable requests to the same remote
+ * endpoint may await a response at the same time; gcoap_req_send() drops any
+ * further one. The default is the NSTART of RFC 7252. To pipeline requests to
+ * a server, raise it together with @ref CONFIG_GCOAP_RESEND_BUFS_MAX, which
+ * limits the number of confirmable requests in flight to all servers.
+ *
+ * By default, retransmissions of confirmable requests use the fixed
+ * exponential backoff of RFC 7252. Module `gcoap_cocoa` replaces it with the
+ * CoCoA congestion control of
+ * [draft-ietf-core-cocoa](https://tools.ietf.org/html/draft-ietf-core-cocoa):
+ * gcoap keeps a retransmission timeout (RTO) per remote endpoint, estimated
+ * from the round-trip times of past requests. Strong estimates come from
+ * requests answered without a retransmission, weak ones from requests which
+ * needed retransmissions, measured from the first transmission. Retransmission
+ * timeouts back off by a factor that depends on the RTO. The estimates of up
+ * to @ref CONFIG_GCOAP_COCOA_ENDPOINTS_MAX endpoints are kept, the least
+ * recently updated one is replaced.
+ *
+ * ### Response cache ###
+ *
+ * Module `gcoap_cache` keeps responses to GET requests, so that repeated
+ * requests, e.g. from many clients reading the same sensor, are answered
+ * without calling the resource handler again. Caching is opt-in: a response is
+ * cached only if its handler added a Max-Age option other than 0, and it has
+ * code 2.05 (Content) and no Observe option. It stays fresh for its Max-Age.
+ * The default Max-Age of 60 seconds does not apply. The cache key consists of
+ * the options of the request except for ETag, Observe and the options marked
+ * NoCacheKey in RFC 7252, so it covers the URI, Accept and Block2. A request
+ * which carries the ETag of the cached response is answered with 2.03 (Valid)
+ * without payload. The Max-Age of a response taken from the cache counts down
+ * its remaining freshness.
+ *
+ * A successful POST, PUT or DELETE request removes all cached responses for
+ * the URI of the request. If the options of such a request don't fit the
+ * cache key, the whole cache is flushed. Otherwise, a handler whose resource
+ * may change before the Max-Age of its response passed must set a shorter
+ * Max-Age. GET requests with an Observe option always reach the handler.
+ *
+ * The cache holds @ref CONFIG_GCOAP_CACHE_ENTRIES_MAX responses in entries of
+ * @ref CONFIG_GCOAP_CACHE_ENTRY_SIZE bytes, each for the cache key and the
+ * response. Larger responses are not cached. If all entries are used, the
+ * least recently used one is replaced.
+ *
+ * ### CoAP over TCP ###
+ *
+ * Module `gcoap_tcp` lets the server also accept CoAP over TCP connections as
+ * specified in [RFC 8323](https://tools.ietf.org/html/rfc8323), on port
+ * @ref CONFIG_GCOAP_TCP_PORT. It requires an implementation of @ref net_sock_tcp,
+ * e.g. `lwip_sock_tcp`. Requests are handled by the same resource handlers as
+ * requests over UDP. gcoap sends a Capabilities and Settings Message (CSM)
+ * announcing a Max-Message-Size of the size of the PDU buffer, answers Ping
+ * with Pong, and closes a connection on Release, Abort or a malformed
+ * message. A message larger than the PDU buffer is answered with Abort. The
+ * payload of a message is not limited by block-wise transfers, only by
+ * @ref CONFIG_GCOAP_PDU_BUF_SIZE, so raise that to stream large payloads.
+ *
+ * Up to @ref CONFIG_GCOAP_TCP_CONNS_MAX connections are served at the same
+ * time, each with a receive buffer of the size of the PDU buffer. Requests
+ * over TCP can't register for Observe notifications, and gcoap can't send
+ * requests over TCP.
+ *
  * ## Implementation Status ##
  * gcoap includes server and client capability. Available features include:
  *
@@ -584,6 +657,69 @@ extern "C" {
 #define CONFIG_GCOAP_RESEND_BUFS_MAX      (1)
 #endif
 
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Maximum number of confirmable requests awaiting a response from the
+ *          same remote endpoint
+ */
+#ifndef CONFIG_GCOAP_NSTART
+#define CONFIG_GCOAP_NSTART               (COAP_NSTART)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of remote endpoints to keep a CoCoA RTO estimate for
+ *
+ * Only used with module `gcoap_cocoa`.
+ */
+#ifndef CONFIG_GCOAP_COCOA_ENDPOINTS_MAX
+#define CONFIG_GCOAP_COCOA_ENDPOINTS_MAX  (4)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Server port for CoAP over TCP
+ *
+ * Only used with module `gcoap_tcp`. The default is the one specified in
+ * RFC 8323.
+ */
+#ifndef CONFIG_GCOAP_TCP_PORT
+#define CONFIG_GCOAP_TCP_PORT             (5683)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Maximum number of CoAP over TCP connections
+ *
+ * Only used with module `gcoap_tcp`.
+ */
+#ifndef CONFIG_GCOAP_TCP_CONNS_MAX
+#define CONFIG_GCOAP_TCP_CONNS_MAX        (2)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of responses kept in the response cache
+ *
+ * Only used with module `gcoap_cache`.
+ */
+#ifndef CONFIG_GCOAP_CACHE_ENTRIES_MAX
+#define CONFIG_GCOAP_CACHE_ENTRIES_MAX    (4)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Size of an entry in the response cache
+ *
+ * An entry holds the cache key, which takes two bytes per option plus the
+ * length of the option values, and the response PDU.
+ *
+ * Only used with module `gcoap_cache`.
+ */
+#ifndef CONFIG_GCOAP_CACHE_ENTRY_SIZE
+#define CONFIG_GCOAP_CACHE_ENTRY_SIZE     (CONFIG_GCOAP_PDU_BUF_SIZE)
+#endif
+
 /**
  * @name Bitwise positional flags for encoding resource links
  * @{
@@ -668,6 +804,12 @@ struct gcoap_request_memo {
     void *context;                      /**< ptr to user defined context data */
     event_timeout_t resp_evt_tmout;     /**< Limits wait for response */
     event_callback_t resp_tmout_cb;     /**< Callback for response timeout */
+#if defined(MODULE_GCOAP_COCOA) || defined(DOXYGEN)
+    uint32_t send_time;                 /**< Time of the first transmission of a
+                                             confirmable request [in usec] */
+    uint32_t rto;                       /**< RTO of the remote endpoint at the
+                                             first transmission [in usec] */
+#endif
 };
 
 /**
@@ -68,15 +68,33 @@ extern "C" {
 #endif
 
 /**
- * @brief   The number of total allocatable @ref gnrc_ipv6_ext_frag_limits_t objects
+ * @brief   Maximum length of the fragmentable part of a datagram in the
+ *          reassembly buffer in bytes
  *
- * This is the maximum number of receivable fragments, shared between all
- * fragmented datagrams
+ * Fragments reaching beyond this length are dropped. This also dimensions the
+ * bitmap that tracks the received parts of a datagram in each reassembly
+ * buffer entry (one bit per 8 bytes).
  *
  * @note    Only applicable with [gnrc_ipv6_ext_frag](@ref net_gnrc_ipv6_ext_frag) module
  */
-#ifndef CONFIG_GNRC_IPV6_EXT_FRAG_LIMITS_POOL_SIZE
-#define CONFIG_GNRC_IPV6_EXT_FRAG_LIMITS_POOL_SIZE (CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE * 2U)
+#ifndef CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_MAX_LEN
+#define CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_MAX_LEN     (2048U)
+#endif
+
+/**
+ * @brief   Maximum number of bytes datagrams from a single source may occupy
+ *          in the reassembly buffer
+ *
+ * When a fragment would exceed this quota, the datagram it belongs to is
+ * dropped. This prevents a single source from exhausting the packet buffer
+ * with incomplete datagrams. When increasing
+ * @ref CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE, about half of the datagrams it
+ * allows for is a sensible quota.
+ *
+ * @note    Only applicable with [gnrc_ipv6_ext_frag](@ref net_gnrc_ipv6_ext_frag) module
+ */
+#ifndef CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SRC_QUOTA
+#define CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SRC_QUOTA   (2048U)
 #endif
 
 /**
@@ -93,9 +111,10 @@ extern "C" {
  *
  * @note    Only applicable with [gnrc_ipv6_ext_frag](@ref net_gnrc_ipv6_ext_frag) module
  *
- * When not set, it will cause the reassembly buffer to override the oldest
- * entry when a fragment for a new datagram is received. When set to 1, no entry
- * will be overwritten (they will still timeout normally)
+ * When not set, it will cause the reassembly buffer to override the least
+ * recently used entry (preferably one of the same source) when a fragment for
+ * a new datagram is received or the packet buffer is exhausted. When set to 1,
+ * no entry will be overwritten (they will still timeout normally)
  */
 #ifdef DOXYGEN
 #define CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_DO_NOT_OVERRIDE
@@ -23,7 +23,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "clist.h"
+#include "bitfield.h"
+#include "net/gnrc/ipv6/ext.h"
 #include "net/gnrc/pkt.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/ipv6/hdr.h"
@@ -53,15 +54,9 @@ extern "C" {
 #define GNRC_IPV6_EXT_FRAG_SEND         (0xfe02U)
 
 /**
- * @brief   Data type to describe limits of a single fragment in the reassembly
- *          buffer
+ * @brief   Number of 8-byte units a reassembly buffer entry can track
  */
-typedef struct gnrc_ipv6_ext_frag_limits {
-    struct gnrc_ipv6_ext_frag_limits *next; /**< limits of next fragment */
-    uint16_t start;                         /**< the start (= offset) of the fragment */
-    uint16_t end;                           /**< the exclusive end (= offset + length) of the
-                                             *   fragment */
-} gnrc_ipv6_ext_frag_limits_t;
+#define GNRC_IPV6_EXT_FRAG_RBUF_UNITS   ((CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_MAX_LEN + 7U) / 8U)
 
 /**
  * @brief   Fragmentation send buffer type
@@ -81,16 +76,28 @@ typedef struct {
 typedef struct {
     gnrc_pktsnip_t *pkt;    /**< the (partly) reassembled packet */
     ipv6_hdr_t *ipv6;       /**< the IPv6 header of gnrc_ipv6_ext_frag_rbuf_t::pkt */
-    /**
-     * @brief   The limits of the fragments in the reassembled packet
-     *
-     * @note    Members of this list can be cast to gnrc_ipv6_ext_frag_limits_t.
-     */
-    clist_node_t limits;
     uint32_t id;            /**< the identification from the fragment headers */
     uint32_t arrival;       /**< arrival time of last received fragment */
     uint16_t pkt_len;       /**< length of gnrc_ipv6_ext_frag_rbuf_t::pkt */
+    /**
+     * @brief   Number of units set in gnrc_ipv6_ext_frag_rbuf_t::received
+     */
+    uint16_t received_units;
+    /**
+     * @brief   Number of units of the complete datagram
+     *
+     * Only valid when gnrc_ipv6_ext_frag_rbuf_t::last is set.
+     */
+    uint16_t total_units;
+    uint16_t frags;         /**< number of fragments received */
     uint8_t last;           /**< received last fragment */
+    /**
+     * @brief   The 8-byte units of the datagram that were already received
+     *
+     * Bit `n` (as numbered by @ref sys_bitfield) is set when the bytes
+     * `8 * n` to `8 * n + 7` of the fragmentable part were received.
+     */
+    BITFIELD(received, GNRC_IPV6_EXT_FRAG_RBUF_UNITS);
 } gnrc_ipv6_ext_frag_rbuf_t;
 
 /**
@@ -103,6 +110,11 @@ typedef struct {
                              *   no @ref gnrc_sixlowpan_frag_fb_t available */
     unsigned datagrams;     /**< reassembled datagrams */
     unsigned fragments;     /**< total fragments of reassembled fragments */
+    unsigned overlaps;      /**< datagrams dropped due to overlapping
+                             *   fragments */
+    unsigned quota_exceeded;    /**< datagrams dropped since their source
+                                 *   exceeded
+                                 *   @ref CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SRC_QUOTA */
 } gnrc_ipv6_ext_frag_stats_t;
 
 /**
@@ -160,7 +172,7 @@ gnrc_pktsnip_t *gnrc_ipv6_ext_frag_reass(gnrc_pktsnip_t *pkt);
  *          of @p hdr or first free reassembly buffer. Will never be NULL, as
  *          in the case of the reassembly buffer being full, the entry with the
  *          lowest gnrc_ipv6_ext_frag_rbuf_t::arrival (serial-number-like) is
- *          removed.
+ *          removed. Entries of the same source as @p hdr are removed first.
  */
 gnrc_ipv6_ext_frag_rbuf_t *gnrc_ipv6_ext_frag_rbuf_get(ipv6_hdr_t *ipv6,
                                                        uint32_t id);
@@ -266,6 +266,17 @@ extern "C" {
 #define GNRC_IPV6_NIB_OFFL_NUMOF            (8)
 #endif
 
+/**
+ * @brief   Number of entries in the send-path destination cache
+ *
+ * @note    Only used with module `gnrc_ipv6_nib_dst_cache`.
+ *
+ * @attention   Must be a power of 2
+ */
+#ifndef GNRC_IPV6_NIB_DST_CACHE_NUMOF
+#define GNRC_IPV6_NIB_DST_CACHE_NUMOF       (8)
+#endif
+
 #if GNRC_IPV6_NIB_CONF_MULTIHOP_P6C || defined(DOXYGEN)
 /**
  * @brief   Number of authoritative border router entries in NIB
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_ipv6_nib_dst_cache Send-path destination cache
+ * @ingroup     net_gnrc_ipv6_nib
+ * @brief       Caches the outcome of next-hop determination and source
+ *              address selection per destination
+ *
+ * Unicast packets sent by @ref net_gnrc_ipv6 normally go through source
+ * address selection and a full NIB lookup (route lookup and address
+ * resolution) each. This cache remembers the result of both for a
+ * destination address, so that subsequent packets of the same flow can skip
+ * them.
+ *
+ * Entries are only stored for neighbors that do not need to be tracked by
+ * neighbor unreachability detection on use (i.e. neighbors in state
+ * @ref GNRC_IPV6_NIB_NC_INFO_NUD_STATE_REACHABLE or
+ * @ref GNRC_IPV6_NIB_NC_INFO_NUD_STATE_UNMANAGED). Any change to the NIB or
+ * to the addresses of an interface invalidates all entries.
+ *
+ * Use module `gnrc_ipv6_nib_dst_cache` to activate it.
+ * @{
+ *
+ * @file
+ * @brief   Send-path destination cache definitions
+ */
+#ifndef NET_GNRC_IPV6_NIB_DST_CACHE_H
+#define NET_GNRC_IPV6_NIB_DST_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/nib/conf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Destination cache entry
+ */
+typedef struct {
+    ipv6_addr_t dst;        /**< destination address */
+    /**
+     * @brief   source address selected for gnrc_ipv6_nib_dst_cache_t::dst
+     *
+     * Unspecified address if no source address was selected.
+     */
+    ipv6_addr_t src;
+    /**
+     * @brief   link-layer address of the next hop
+     */
+    uint8_t l2addr[GNRC_IPV6_NIB_L2ADDR_MAX_LEN];
+    uint8_t l2addr_len;     /**< length of gnrc_ipv6_nib_dst_cache_t::l2addr */
+    kernel_pid_t iface;     /**< interface to the next hop */
+    /**
+     * @brief   NIB version the entry's information was determined in
+     *
+     * @see gnrc_ipv6_nib_dst_cache_version()
+     */
+    unsigned version;
+} gnrc_ipv6_nib_dst_cache_t;
+
+/**
+ * @brief   Destination cache statistics
+ */
+typedef struct {
+    uint32_t hits;          /**< number of successful lookups */
+    uint32_t misses;        /**< number of failed lookups */
+} gnrc_ipv6_nib_dst_cache_stats_t;
+
+#if defined(MODULE_GNRC_IPV6_NIB_DST_CACHE) || defined(DOXYGEN)
+/**
+ * @brief   Gets the current version of the NIB
+ *
+ * The version changes whenever information the destination cache is derived
+ * from changes. Fetch it *before* determining the information for a new
+ * entry, so that changes made concurrently to that determination are not
+ * missed.
+ *
+ * @return  The current version of the NIB.
+ */
+unsigned gnrc_ipv6_nib_dst_cache_version(void);
+
+/**
+ * @brief   Looks up a destination in the destination cache
+ *
+ * @pre `dst != NULL`
+ *
+ * @param[in] dst   A destination address.
+ * @param[in] iface The interface the packet is supposed to be sent over.
+ *                  0 for any interface.
+ *
+ * @return  The cache entry for @p dst. It stays valid until the next call of
+ *          gnrc_ipv6_nib_dst_cache_put().
+ * @return  NULL, if there is no valid entry for @p dst on @p iface.
+ */
+const gnrc_ipv6_nib_dst_cache_t *gnrc_ipv6_nib_dst_cache_get(const ipv6_addr_t *dst,
+                                                             unsigned iface);
+
+/**
+ * @brief   Stores an entry in the destination cache
+ *
+ * Replaces any entry that maps to the same cache slot. The entry is not
+ * stored if gnrc_ipv6_nib_dst_cache_t::version is not the current version of
+ * the NIB.
+ *
+ * @pre `(entry != NULL) && (entry->l2addr_len <= GNRC_IPV6_NIB_L2ADDR_MAX_LEN)`
+ *
+ * @param[in] entry The entry to store.
+ */
+void gnrc_ipv6_nib_dst_cache_put(const gnrc_ipv6_nib_dst_cache_t *entry);
+
+/**
+ * @brief   Invalidates all entries of the destination cache
+ *
+ * @note    Does not acquire any locks, so it can be called from within the
+ *          NIB and while an interface is acquired.
+ */
+void gnrc_ipv6_nib_dst_cache_invalidate(void);
+
+/**
+ * @brief   Iterates over all valid entries in the destination cache
+ *
+ * @pre `(state != NULL) && (entry != NULL)`
+ *
+ * @param[in,out] state Iteration state of the destination cache. Must point
+ *                      to a NULL pointer to start iteration.
+ * @param[out] entry    The next valid entry.
+ *
+ * @return  true, if iteration can be continued.
+ * @return  false, if there are no more valid entries.
+ */
+bool gnrc_ipv6_nib_dst_cache_iter(void **state,
+                                  gnrc_ipv6_nib_dst_cache_t *entry);
+
+/**
+ * @brief   Gets the lookup statistics of the destination cache
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[out] stats    The statistics.
+ */
+void gnrc_ipv6_nib_dst_cache_get_stats(gnrc_ipv6_nib_dst_cache_stats_t *stats);
+
+/**
+ * @brief   Prints a destination cache entry
+ *
+ * @pre `entry != NULL`
+ *
+ * @param[in] entry A destination cache entry.
+ */
+void gnrc_ipv6_nib_dst_cache_print(const gnrc_ipv6_nib_dst_cache_t *entry);
+#else   /* MODULE_GNRC_IPV6_NIB_DST_CACHE || defined(DOXYGEN) */
+#define gnrc_ipv6_nib_dst_cache_version()           (0U)
+#define gnrc_ipv6_nib_dst_cache_get(dst, iface)     (NULL)
+#define gnrc_ipv6_nib_dst_cache_put(entry)          (void)(entry)
+#define gnrc_ipv6_nib_dst_cache_invalidate()        (void)0
+#define gnrc_ipv6_nib_dst_cache_iter(state, entry)  (false)
+#define gnrc_ipv6_nib_dst_cache_get_stats(stats)    (void)(stats)
+#define gnrc_ipv6_nib_dst_cache_print(entry)        (void)(entry)
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE || defined(DOXYGEN) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_IPV6_NIB_DST_CACHE_H */
+/** @} */
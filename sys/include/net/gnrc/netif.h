@@ -44,6 +44,9 @@
 #include "net/gnrc/netif/dedup.h"
 #endif
 #include "net/gnrc/netif/flags.h"
+#if defined(MODULE_GNRC_NETIF_TX_FEEDBACK) && (GNRC_NETIF_L2ADDR_MAXLEN > 0)
+#include "net/gnrc/netif/tx_feedback.h"
+#endif
 #ifdef MODULE_GNRC_IPV6
 #include "net/gnrc/netif/ipv6.h"
 #endif
@@ -117,6 +120,14 @@ typedef struct {
      */
     gnrc_netif_dedup_t last_pkt;
 #endif
+#if defined(MODULE_GNRC_NETIF_TX_FEEDBACK) || DOXYGEN
+    /**
+     * @brief   Attribution of the device's TX feedback
+     *
+     * @note    Only available with @ref net_gnrc_netif_tx_feedback.
+     */
+    gnrc_netif_tx_feedback_t tx_feedback;
+#endif
 #endif
 #if defined(MODULE_GNRC_SIXLOWPAN) || DOXYGEN
     gnrc_netif_6lo_t sixlo;                 /**< 6Lo component */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_netif_tx_feedback  Link-layer TX feedback
+ * @ingroup     net_gnrc_netif
+ * @brief       Reports the outcome of unicast transmissions per neighbor
+ *
+ * The interface reports the outcome of a unicast transmission, i.e. whether
+ * the device signaled @ref NETDEV_EVENT_TX_COMPLETE or
+ * @ref NETDEV_EVENT_TX_NOACK for it, together with the link-layer destination
+ * of the frame to the callback set with gnrc_netif_tx_feedback_set_cb().
+ *
+ * The outcome is only reported when it can be attributed to a frame: if the
+ * device is handed another frame before it signaled the completion of the
+ * previous one, no outcome is reported until all pending frames are
+ * completed.
+ *
+ * To activate, use `USEMODULE += gnrc_netif_tx_feedback` in your
+ * application's Makefile.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Link-layer TX feedback definitions
+ */
+#ifndef NET_GNRC_NETIF_TX_FEEDBACK_H
+#define NET_GNRC_NETIF_TX_FEEDBACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "net/gnrc/netif/conf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   State to attribute the TX feedback of a device to a frame
+ */
+typedef struct {
+    uint8_t dst[GNRC_NETIF_L2ADDR_MAXLEN];  /**< link-layer destination */
+    uint8_t dst_len;        /**< length of gnrc_netif_tx_feedback_t::dst,
+                             *   0 if the outcome can not be attributed */
+    uint8_t pending;        /**< frames without signaled completion */
+} gnrc_netif_tx_feedback_t;
+
+/**
+ * @brief   Callback for the outcome of a unicast transmission
+ *
+ * @note    Called in the context of the interface's thread.
+ *
+ * @param[in] iface     Identifier of the interface the frame was sent over.
+ * @param[in] dst       Link-layer destination address of the frame.
+ * @param[in] dst_len   Length of @p dst.
+ * @param[in] num_tx    Number of transmissions (including retransmissions)
+ *                      of the frame. Devices that do not report their
+ *                      retransmissions count as one transmission.
+ * @param[in] acked     The frame was acknowledged.
+ */
+typedef void (*gnrc_netif_tx_feedback_cb_t)(kernel_pid_t iface,
+                                            const uint8_t *dst,
+                                            size_t dst_len,
+                                            unsigned num_tx, bool acked);
+
+/**
+ * @brief   Sets the callback for the outcome of unicast transmissions on all
+ *          interfaces
+ *
+ * @param[in] cb    The callback. NULL to not report any outcomes.
+ */
+void gnrc_netif_tx_feedback_set_cb(gnrc_netif_tx_feedback_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_NETIF_TX_FEEDBACK_H */
+/** @} */
@@ -50,6 +50,8 @@
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
  *   CFLAGS += -DGNRC_RPL_WITHOUT_PIO
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *   Nodes learn the global address of their parent from its PIOs, so in
+ *   non-storing mode nodes below a parent without PIOs do not send DAOs.
  *
  * - Modify trickle parameters
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
@@ -74,6 +76,15 @@
  *   CFLAGS += -DGNRC_RPL_DEFAULT_NETIF=6
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  *
+ * - Use the Minimum Rank with Hysteresis Objective Function (MRHOF, RFC 6719)
+ *   with ETX as metric for DODAGs started by this node.
+ *   See @ref net_gnrc_rpl_mrhof on how to feed ETX into it.
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ *   USEMODULE += gnrc_rpl_mrhof
+ *   CFLAGS += -DGNRC_RPL_DEFAULT_OCP=1
+ *   CFLAGS += -DGNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE=128
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
  * - By default, all incoming control messages get checked for validation.
  *   This validation can be disabled in case the involved RPL implementations
  *   are known to produce valid messages.
@@ -193,12 +204,18 @@ extern "C" {
 /**
  * @brief   Number of implemented Objective Functions
  */
+#ifdef MODULE_GNRC_RPL_MRHOF
+#define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (2)
+#else
 #define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (1)
+#endif
 
 /**
  * @brief   Default Objective Code Point (OF0)
  */
+#ifndef GNRC_RPL_DEFAULT_OCP
 #define GNRC_RPL_DEFAULT_OCP (0)
+#endif
 
 /**
  * @brief   Default Instance ID
@@ -329,8 +346,20 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
 #define GNRC_RPL_DAO_SEND_RETRIES   (4)
 #endif
 #ifndef GNRC_RPL_DAO_ACK_DELAY
+/**
+ * @brief Initial time to wait for a DAO-ACK in milli seconds
+ *
+ * Doubled with every retransmission of the DAO, up to
+ * @ref GNRC_RPL_DAO_ACK_DELAY_MAX.
+ */
 #define GNRC_RPL_DAO_ACK_DELAY      (3000UL)
 #endif
+#ifndef GNRC_RPL_DAO_ACK_DELAY_MAX
+/**
+ * @brief Maximum time to wait for a DAO-ACK in milli seconds
+ */
+#define GNRC_RPL_DAO_ACK_DELAY_MAX  (24000UL)
+#endif
 #ifndef GNRC_RPL_DAO_DELAY_LONG
 /**
  * @brief Long delay for DAOs in milli seconds
@@ -349,6 +378,17 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
  */
 #define GNRC_RPL_DAO_DELAY_JITTER   (1000UL)
 #endif
+#ifndef GNRC_RPL_DAO_TARGETS_NUMOF
+/**
+ * @brief Maximum number of targets aggregated into a single DAO
+ *
+ * If a node advertises more targets, they are split over multiple DAOs that
+ * each request a DAO-ACK. Only the DAOs that were not acknowledged are
+ * retransmitted. DAOs beyond the 32nd of a set request no DAO-ACK and are
+ * not retransmitted.
+ */
+#define GNRC_RPL_DAO_TARGETS_NUMOF  (8U)
+#endif
 /** @} */
 
 /**
@@ -387,6 +427,14 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
 #define GNRC_RPL_OPT_TARGET_DESC          (9)
 /** @} */
 
+/**
+ * @brief   Divisor of the fixed-point representation of ETX
+ * @see <a href="https://tools.ietf.org/html/rfc6551#section-4.3.2">
+ *          RFC 6551, section 4.3.2
+ *      </a>
+ */
+#define GNRC_RPL_ETX_DIVISOR (128U)
+
 /**
  * @brief Rank of the root node
  */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_rpl_mrhof Minimum Rank with Hysteresis Objective Function
+ * @ingroup     net_gnrc_rpl
+ * @brief       MRHOF with the ETX metric for @ref net_gnrc_rpl
+ * @see <a href="https://tools.ietf.org/html/rfc6719">
+ *          RFC 6719
+ *      </a>
+ *
+ * The path cost via a parent is its advertised rank plus the ETX of the link
+ * to it. The preferred parent is only switched when another parent offers a
+ * path cost that is lower by at least
+ * @ref GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD.
+ *
+ * The ETX of a link is estimated from transmission outcomes reported with
+ * gnrc_rpl_mrhof_etx_update(). MRHOF subscribes to the
+ * @ref net_gnrc_netif_tx_feedback of the network interfaces for this. Links
+ * without any reported outcome are assumed to have an ETX of
+ * @ref GNRC_RPL_MRHOF_ETX_INIT.
+ *
+ * Use module `gnrc_rpl_mrhof` to activate it.
+ * @{
+ *
+ * @file
+ * @brief   MRHOF definitions
+ */
+#ifndef NET_GNRC_RPL_MRHOF_H
+#define NET_GNRC_RPL_MRHOF_H
+
+#include <stdbool.h>
+
+#include "net/ipv6/addr.h"
+#include "net/gnrc/rpl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Objective code point of MRHOF
+ */
+#define GNRC_RPL_MRHOF_OCP                      (0x1)
+
+/**
+ * @name    MRHOF compile configurations
+ * @{
+ */
+/**
+ * @brief   Maximum ETX of a link to a usable parent
+ *          (in units of 1/@ref GNRC_RPL_ETX_DIVISOR)
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_LINK_METRIC
+#define GNRC_RPL_MRHOF_MAX_LINK_METRIC          (4U * GNRC_RPL_ETX_DIVISOR)
+#endif
+
+/**
+ * @brief   Maximum path cost via a usable parent
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_PATH_COST
+#define GNRC_RPL_MRHOF_MAX_PATH_COST            (32768U)
+#endif
+
+/**
+ * @brief   Minimum improvement in path cost to switch the preferred parent
+ */
+#ifndef GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD
+#define GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD  (192U)
+#endif
+
+/**
+ * @brief   ETX assumed for links without any reported transmission outcome
+ *          (in units of 1/@ref GNRC_RPL_ETX_DIVISOR)
+ */
+#ifndef GNRC_RPL_MRHOF_ETX_INIT
+#define GNRC_RPL_MRHOF_ETX_INIT                 (2U * GNRC_RPL_ETX_DIVISOR)
+#endif
+
+/**
+ * @brief   ETX sample for a transmission that was not acknowledged
+ *          (in units of 1/@ref GNRC_RPL_ETX_DIVISOR)
+ */
+#ifndef GNRC_RPL_MRHOF_ETX_NOACK_PENALTY
+#define GNRC_RPL_MRHOF_ETX_NOACK_PENALTY        (8U * GNRC_RPL_ETX_DIVISOR)
+#endif
+/** @} */
+
+/**
+ * @brief   Reports the outcome of a transmission to a neighbor
+ *
+ * Updates the ETX estimate (an exponentially weighted moving average with a
+ * weight of 7/8 for the previous estimate) of the links to all parents with
+ * address @p addr. The new estimate is taken into account on the next
+ * preferred parent selection, so this function may be called from any
+ * thread.
+ *
+ * @param[in] addr      Link-local address of the neighbor.
+ * @param[in] num_tx    Number of transmissions (including retransmissions)
+ *                      of the frame.
+ * @param[in] acked     The frame was acknowledged.
+ */
+void gnrc_rpl_mrhof_etx_update(const ipv6_addr_t *addr, unsigned num_tx,
+                               bool acked);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_RPL_MRHOF_H */
+/** @} */
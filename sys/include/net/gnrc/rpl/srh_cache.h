@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_rpl_srh_cache Source routing header cache
+ * @ingroup     net_gnrc_rpl_srh
+ * @brief       Source routes of a non-storing mode DODAG root
+ *
+ * The root of a DODAG in non-storing mode (@ref GNRC_RPL_MOP_NON_STORING_MODE)
+ * learns the parent of every node from the transit information of the DAOs it
+ * receives. Packets sent by the root to a node deeper in the DODAG carry a RPL
+ * source routing header with the path to that node.
+ *
+ * The compressed source routing header for a destination is built once from
+ * the learned parents and then kept in a cache, so that subsequent packets to
+ * the same destination only need to copy it. Any change of a learned parent
+ * invalidates all cached headers.
+ *
+ * Use module `gnrc_rpl_srh_cache` to activate it.
+ * @{
+ *
+ * @file
+ * @brief   Source routing header cache definitions
+ */
+#ifndef NET_GNRC_RPL_SRH_CACHE_H
+#define NET_GNRC_RPL_SRH_CACHE_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "net/gnrc/pkt.h"
+#include "net/ipv6/addr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name    Source routing header cache compile configurations
+ * @{
+ */
+/**
+ * @brief   Maximum number of nodes the root learns a parent for
+ */
+#ifndef GNRC_RPL_SRH_CACHE_ROUTES_NUMOF
+#define GNRC_RPL_SRH_CACHE_ROUTES_NUMOF     (32U)
+#endif
+
+/**
+ * @brief   Number of cached source routing headers
+ *
+ * @note    Must be a power of 2.
+ */
+#ifndef GNRC_RPL_SRH_CACHE_NUMOF
+#define GNRC_RPL_SRH_CACHE_NUMOF            (8U)
+#endif
+
+/**
+ * @brief   Maximum number of addresses in a source routing header
+ *
+ * Destinations further away from the root are considered unreachable.
+ */
+#ifndef GNRC_RPL_SRH_CACHE_MAX_HOPS
+#define GNRC_RPL_SRH_CACHE_MAX_HOPS         (8U)
+#endif
+/** @} */
+
+/**
+ * @brief   Lifetime value for routes that never expire
+ */
+#define GNRC_RPL_SRH_CACHE_LIFETIME_INF     (UINT32_MAX)
+
+/**
+ * @brief   Source routing header cache statistics
+ */
+typedef struct {
+    uint32_t hits;          /**< number of headers taken from the cache */
+    uint32_t misses;        /**< number of headers that needed to be built */
+} gnrc_rpl_srh_cache_stats_t;
+
+#if defined(MODULE_GNRC_RPL_SRH_CACHE) || defined(DOXYGEN)
+/**
+ * @brief   Sets the parent of a node
+ *
+ * Invalidates all cached source routing headers if the parent of @p target
+ * changed.
+ *
+ * @pre `(target != NULL) && (parent != NULL)`
+ *
+ * @param[in] target    Global address of a node in the DODAG.
+ * @param[in] parent    Global address of the parent of @p target.
+ * @param[in] lifetime  Lifetime of the relation in seconds.
+ *                      @ref GNRC_RPL_SRH_CACHE_LIFETIME_INF for infinite.
+ *
+ * @return  0, on success.
+ * @return  -ENOMEM, if there is no space left to store the relation.
+ */
+int gnrc_rpl_srh_cache_route_add(const ipv6_addr_t *target,
+                                 const ipv6_addr_t *parent,
+                                 uint32_t lifetime);
+
+/**
+ * @brief   Removes the parent of a node
+ *
+ * Invalidates all cached source routing headers if @p target had a parent.
+ *
+ * @pre `target != NULL`
+ *
+ * @param[in] target    Global address of a node in the DODAG.
+ */
+void gnrc_rpl_srh_cache_route_del(const ipv6_addr_t *target);
+
+/**
+ * @brief   Removes the parents of all nodes
+ */
+void gnrc_rpl_srh_cache_route_clear(void);
+
+/**
+ * @brief   Checks if this node needs source routes for the packets it sends
+ *
+ * @return  true, if this node is the root of a DODAG in non-storing mode.
+ * @return  false, otherwise.
+ */
+bool gnrc_rpl_srh_cache_is_root(void);
+
+/**
+ * @brief   Gets the source routing header for a destination
+ *
+ * @pre `(dst != NULL) && (first_hop != NULL)`
+ *
+ * @param[in] dst           Final destination of a packet sent by this node.
+ * @param[out] first_hop    The destination address to put in the IPv6 header
+ *                          of the packet. Only set when the return value is
+ *                          not NULL.
+ *
+ * @return  A new packet snip containing the source routing header.
+ *          gnrc_rpl_srh_t::nh is not set. It is up to the caller to release
+ *          it.
+ * @return  NULL, if no source route to @p dst is known, @p dst is a child of
+ *          this node, or there is no space left in the packet buffer.
+ */
+gnrc_pktsnip_t *gnrc_rpl_srh_cache_get(const ipv6_addr_t *dst,
+                                       ipv6_addr_t *first_hop);
+
+/**
+ * @brief   Gets the statistics of the source routing header cache
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[out] stats    The statistics.
+ */
+void gnrc_rpl_srh_cache_get_stats(gnrc_rpl_srh_cache_stats_t *stats);
+#else   /* MODULE_GNRC_RPL_SRH_CACHE || defined(DOXYGEN) */
+#define gnrc_rpl_srh_cache_route_add(target, parent, lifetime)  (-ENOTSUP)
+#define gnrc_rpl_srh_cache_route_del(target)        (void)(target)
+#define gnrc_rpl_srh_cache_route_clear()            (void)0
+#define gnrc_rpl_srh_cache_is_root()                (false)
+#define gnrc_rpl_srh_cache_get(dst, first_hop)      (NULL)
+#define gnrc_rpl_srh_cache_get_stats(stats)         (void)(stats)
+#endif  /* MODULE_GNRC_RPL_SRH_CACHE || defined(DOXYGEN) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_RPL_SRH_CACHE_H */
+/** @} */
@@ -240,10 +240,23 @@ struct gnrc_rpl_parent {
     gnrc_rpl_parent_t *next;        /**< pointer to the next parent */
     uint8_t state;                  /**< see @ref gnrc_rpl_parent_states */
     ipv6_addr_t addr;               /**< link-local IPv6 address of this parent */
+    /**
+     * @brief   global IPv6 address of this parent, as advertised in the
+     *          Prefix Information option of its DIOs
+     *
+     * Unspecified if the parent did not advertise it.
+     */
+    ipv6_addr_t global_addr;
     uint8_t dtsn;                   /**< last seen dtsn of this parent */
     uint16_t rank;                  /**< rank of the parent */
     gnrc_rpl_dodag_t *dodag;        /**< DODAG the parent belongs to */
-    double link_metric;             /**< metric of the link */
+    /**
+     * @brief   metric of the link
+     *
+     * For ETX in units of 1/@ref GNRC_RPL_ETX_DIVISOR, 0 if not determined
+     * yet
+     */
+    uint16_t link_metric;
     uint8_t link_metric_type;       /**< type of the metric */
     /**
      * @brief Parent timeout events (see @ref GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT)
@@ -304,6 +317,21 @@ typedef struct {
      */
     void (*init)(gnrc_rpl_dodag_t *dodag);
     void (*process_dio)(void);  /**< DIO processing callback (acc. to OF0 spec, chpt 5) */
+
+    /**
+     * @brief   Decide if the preferred parent should be switched (optional)
+     *
+     * Allows the objective function to apply hysteresis to parent selection.
+     * If NULL, the preferred parent is always switched to the best parent
+     * according to gnrc_rpl_of_t::parent_cmp.
+     *
+     * @param[in] cur       The current preferred parent.
+     * @param[in] best      The parent preferred by gnrc_rpl_of_t::parent_cmp.
+     *
+     * @return  true, if @p best should become the preferred parent.
+     * @return  false, if @p cur should stay the preferred parent.
+     */
+    bool (*parent_switch)(gnrc_rpl_parent_t *cur, gnrc_rpl_parent_t *best);
 } gnrc_rpl_of_t;
 
 /**
@@ -327,7 +355,26 @@ struct gnrc_rpl_dodag {
     uint8_t node_status;            /**< leaf, normal, or root node */
     uint8_t dao_seq;                /**< dao sequence number */
     uint8_t dao_counter;            /**< amount of retried DAOs */
+    uint8_t dao_ack_seq;            /**< sequence of the first DAO of the set */
+    /**
+     * @brief   DAOs of the set still to be acknowledged
+     *
+     * Bit i stands for the DAO with sequence @ref dao_ack_seq + i.
+     */
+    uint32_t dao_acks_pending;
     bool dao_ack_received;          /**< flag to check for DAO-ACK */
+    /**
+     * @brief   A DAO is scheduled to be sent after the (short) DAO delay
+     *
+     * Further changes while it is set are sent with that DAO.
+     */
+    bool dao_delayed;
+    /**
+     * @brief   Parent set or its metrics changed since the last preferred
+     *          parent selection
+     */
+    bool parents_changed;
+    uint16_t parent_switches;       /**< number of preferred parent changes */
     uint8_t dio_opts;               /**< options in the next DIO
                                          (see @ref GNRC_RPL_REQ_DIO_OPTS "DIO Options") */
     evtimer_msg_event_t dao_event;  /**< DAO TX events (see @ref GNRC_RPL_MSG_TYPE_DODAG_DAO_TX) */
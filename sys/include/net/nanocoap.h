@@ -64,6 +64,11 @@
  * and exact matching should be register, and then a second one with the path
  * `/resource01/` and subtree matching.
  *
+ * Resources must be sorted by path, as compared by strcmp(). Requests are then
+ * dispatched with coap_find_resource(), which uses the sorted resources as a
+ * trie, so large numbers of resources can be served without scanning all of
+ * them for each request.
+ *
  * @{
  *
  * @file
@@ -160,6 +165,12 @@ extern "C" {
 #define COAP_OPT_FINISH_PAYLOAD  (0x0001)
 /** @} */
 
+/**
+ * @brief   Bytes a buffer must provide in front of a CoAP over TCP message
+ *          for coap_tcp_parse()
+ */
+#define COAP_TCP_HEADROOM        (2U)
+
 /**
  * @brief   Raw CoAP PDU header structure
  */
@@ -581,6 +592,31 @@ static inline ssize_t coap_get_uri_query(const coap_pkt_t *pkt, uint8_t *target)
 ssize_t coap_opt_get_next(const coap_pkt_t *pkt, coap_optpos_t *opt,
                           uint8_t **value, bool init_opt);
 
+/**
+ * @brief   Iterate over the instances of an option
+ *
+ * Like coap_opt_get_next(), but only yields the values of option @p opt_num,
+ * in the order they appear in @p pkt. The first instance is looked up in the
+ * option index built by coap_parse(), so there is no need to walk the
+ * preceding options. The values are not copied; @p value points into the
+ * packet buffer.
+ *
+ * @param[in]     pkt         packet to read from
+ * @param[in,out] opt         iteration state; read on input if @p init_opt
+ *                            is false
+ * @param[in]     opt_num     option number to retrieve
+ * @param[out]    value       start of the option value
+ * @param[in]     init_opt    true to retrieve the first instance; false to
+ *                            retrieve the instance following @p opt
+ *
+ * @return        length of option value
+ * @return        -ENOENT if there is no (further) instance of the option
+ * @return        -EBADMSG if the option is malformed
+ */
+ssize_t coap_opt_get_next_by_num(const coap_pkt_t *pkt, coap_optpos_t *opt,
+                                 unsigned opt_num, uint8_t **value,
+                                 bool init_opt);
+
 /**
  * @brief   Retrieve the value for an option as an opaque array of bytes
  *
@@ -1402,6 +1438,35 @@ ssize_t coap_build_reply(coap_pkt_t *pkt, unsigned code,
  */
 ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_len);
 
+/**
+ * @brief   Find the resource for the URI path of an incoming CoAP request
+ *
+ * Matches the Uri-Path options of @p pkt directly, without reassembling the
+ * URI path into a string. The sorted @p resources array is used as a trie:
+ * for each byte of the URI path, the range of resources sharing the path
+ * matched so far is narrowed down by binary search. So the number of
+ * comparisons grows with the length of the URI path, but only logarithmically
+ * with the number of resources.
+ *
+ * If several resources match, the first one in @p resources that allows the
+ * method of the request is taken, like a linear scan over @p resources would.
+ *
+ * @pre @p resources is sorted by coap_resource_t::path in ascending order,
+ *      as compared by strcmp()
+ *
+ * @param[in]   pkt             pointer to (parsed) CoAP request
+ * @param[in]   resources       sorted array of resources
+ * @param[in]   resources_numof number of entries in @p resources
+ * @param[out]  resource        the matching resource, if found
+ *
+ * @returns     0 if a resource was found
+ * @returns     -EPERM if a resource matches the URI path, but none of the
+ *              matching resources allows the method of the request
+ * @returns     -ENOENT if no resource matches the URI path
+ */
+int coap_find_resource(coap_pkt_t *pkt, const coap_resource_t *resources,
+                       size_t resources_numof, const coap_resource_t **resource);
+
 /**
  * @brief   Convert message code (request method) into a corresponding bit field
  *
@@ -1500,6 +1565,66 @@ extern ssize_t coap_well_known_core_default_handler(coap_pkt_t *pkt, \
  */
 int coap_match_path(const coap_resource_t *resource, uint8_t *uri);
 
+/**
+ * @name    Functions -- CoAP over TCP
+ *
+ * Framing of CoAP messages on reliable transports as specified in RFC 8323.
+ * A message is converted in place between this framing and the header of
+ * CoAP over UDP, so that the parser, the option functions and the request
+ * handlers can be used as is. Type and message ID of a converted message
+ * have no meaning.
+ */
+/**@{*/
+/**
+ * @brief   Gets the length of a CoAP over TCP message from its first bytes
+ *
+ * @param[in]   buf     start of the message
+ * @param[in]   len     number of bytes of the message available in @p buf
+ *
+ * @returns     length of the complete message, including its framing
+ * @returns     0 if @p len is too short to tell
+ * @returns     -EMSGSIZE if the message is larger than can be handled
+ */
+ssize_t coap_tcp_get_len(const uint8_t *buf, size_t len);
+
+/**
+ * @brief   Parses a CoAP over TCP message
+ *
+ * Overwrites the framing of the message with a CoAP over UDP header, so
+ * pkt::hdr points up to @ref COAP_TCP_HEADROOM bytes in front of @p buf
+ * afterwards.
+ *
+ * @pre @p buf is preceded by at least @ref COAP_TCP_HEADROOM bytes of the
+ *      same buffer
+ *
+ * @param[out]  pkt     structure to parse into
+ * @param[in]   buf     start of the message
+ * @param[in]   len     length of the message, as returned by
+ *                      coap_tcp_get_len()
+ *
+ * @returns     0 on success
+ * @returns     -EBADMSG if the message is malformed
+ * @returns     <0 on other errors of coap_parse()
+ */
+int coap_tcp_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len);
+
+/**
+ * @brief   Converts a message built with the header of CoAP over UDP to the
+ *          framing of CoAP over TCP
+ *
+ * The framing is never longer than the header it replaces, so the message
+ * does not move but starts up to @ref COAP_TCP_HEADROOM bytes later.
+ *
+ * @param[in]   pkt     message to convert; invalid afterwards
+ * @param[in]   len     length of the message at pkt::hdr
+ * @param[out]  msg     start of the converted message
+ *
+ * @returns     length of the converted message
+ * @returns     -EMSGSIZE if the message is too large to convert in place
+ */
+ssize_t coap_tcp_frame(coap_pkt_t *pkt, size_t len, uint8_t **msg);
+/**@}*/
+
 #if defined(MODULE_GCOAP) || defined(DOXYGEN)
 /**
  * @name    Functions -- gcoap specific
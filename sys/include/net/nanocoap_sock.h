@@ -118,6 +118,21 @@
  * finalizes the packet and calls coap_block2_finish() internally to update
  * the block2 option.
  *
+ * # Block-wise Transfers
+ *
+ * A client fetches a resource block-wise with nanocoap_get_blockwise(). It
+ * keeps up to @ref NANOCOAP_BLOCKWISE_WINDOW requests for consecutive blocks
+ * in flight, so a transfer does not take one round trip per block. The blocks
+ * are passed to a ::coap_blockwise_cb_t callback in order, whatever the order
+ * of the responses.
+ *
+ * A server receives a block-wise request payload (Block1) by calling
+ * nanocoap_block1_sink() from the handler of the resource. It passes the
+ * blocks to a ::coap_blockwise_cb_t callback in order and writes the
+ * response. A client must send the blocks of a request payload in order, as
+ * nanocoap_put_blockwise() and nanocoap_post_blockwise() do. They send one
+ * block at a time.
+ *
  * @{
  *
  * @file
@@ -139,6 +154,55 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Maximum number of block requests in flight in a block-wise
+ *          transfer
+ *
+ * A block-wise transfer keeps a buffer of the block size for each of them on
+ * the stack.
+ */
+#ifndef NANOCOAP_BLOCKWISE_WINDOW
+#define NANOCOAP_BLOCKWISE_WINDOW   (4U)
+#endif
+
+/**
+ * @brief Coap block-wise-transfer size SZX
+ */
+typedef enum {
+    COAP_BLOCKSIZE_32 = 1,
+    COAP_BLOCKSIZE_64,
+    COAP_BLOCKSIZE_128,
+    COAP_BLOCKSIZE_256,
+    COAP_BLOCKSIZE_512,
+    COAP_BLOCKSIZE_1024,
+} coap_blksize_t;
+
+/**
+ * @brief   Coap blockwise request callback descriptor
+ *
+ * @param[in] arg      Pointer to be passed as arguments to the callback
+ * @param[in] offset   Offset of received data
+ * @param[in] buf      Pointer to the received data
+ * @param[in] len      Length of the received data
+ * @param[in] more     -1 for no option, 0 for last block, 1 for more blocks
+ *
+ * @returns    0       on success
+ * @returns   -1       on error
+ */
+typedef int (*coap_blockwise_cb_t)(void *arg, size_t offset, uint8_t *buf, size_t len, int more);
+
+/**
+ * @brief   State of a block-wise request payload received by a server
+ *
+ * Keep one per resource that accepts block-wise request payloads, e.g. as
+ * the context of the resource.
+ */
+typedef struct {
+    coap_blockwise_cb_t callback;   /**< called for each block in order */
+    void *arg;                      /**< argument for callback */
+    size_t offset;                  /**< offset of the next expected block */
+} nanocoap_block1_sink_t;
+
 /**
  * @brief   Start a nanocoap server instance
  *
@@ -183,6 +247,96 @@ ssize_t nanocoap_get(sock_udp_ep_t *remote, const char *path, uint8_t *buf,
 ssize_t nanocoap_request(coap_pkt_t *pkt, sock_udp_ep_t *local,
                          sock_udp_ep_t *remote, size_t len);
 
+/**
+ * @brief   Synchronous block-wise CoAP (confirmable) get
+ *
+ * Requests up to @ref NANOCOAP_BLOCKWISE_WINDOW blocks at the same time, once
+ * the first block has been received. The server may answer with a smaller
+ * block size than @p blksize, which is then used for the whole transfer.
+ *
+ * @param[in]   remote      remote UDP endpoint
+ * @param[in]   path        remote path
+ * @param[in]   blksize     block size to request
+ * @param[in]   callback    called for each received block, in order
+ * @param[in]   arg         argument for @p callback
+ *
+ * @returns     0 on success
+ * @returns     -ECANCELED if @p callback returned an error
+ * @returns     -ETIMEDOUT if the server did not answer a block request
+ * @returns     -EBADMSG if the server sent an invalid response
+ * @returns     the negative response code if the server sent an error
+ * @returns     <0 on other errors
+ */
+int nanocoap_get_blockwise(sock_udp_ep_t *remote, const char *path,
+                           coap_blksize_t blksize,
+                           coap_blockwise_cb_t callback, void *arg);
+
+/**
+ * @brief   Synchronous block-wise CoAP (confirmable) put
+ *
+ * Sends @p data in blocks (Block1), one at a time. If the server asks for a
+ * smaller block size, the remaining blocks are sent with that one.
+ *
+ * @param[in]   remote      remote UDP endpoint
+ * @param[in]   path        remote path
+ * @param[in]   blksize     block size to send
+ * @param[in]   data        request payload
+ * @param[in]   len         length of @p data
+ *
+ * @returns     0 on success
+ * @returns     -ETIMEDOUT if the server did not answer a block
+ * @returns     -EBADMSG if the server sent an invalid response
+ * @returns     the negative response code if the server sent an error
+ * @returns     <0 on other errors
+ */
+int nanocoap_put_blockwise(sock_udp_ep_t *remote, const char *path,
+                           coap_blksize_t blksize, const void *data,
+                           size_t len);
+
+/**
+ * @brief   Synchronous block-wise CoAP (confirmable) post
+ *
+ * Like nanocoap_put_blockwise(), but with method POST.
+ *
+ * @param[in]   remote      remote UDP endpoint
+ * @param[in]   path        remote path
+ * @param[in]   blksize     block size to send
+ * @param[in]   data        request payload
+ * @param[in]   len         length of @p data
+ *
+ * @returns     0 on success
+ * @returns     -ETIMEDOUT if the server did not answer a block
+ * @returns     -EBADMSG if the server sent an invalid response
+ * @returns     the negative response code if the server sent an error
+ * @returns     <0 on other errors
+ */
+int nanocoap_post_blockwise(sock_udp_ep_t *remote, const char *path,
+                            coap_blksize_t blksize, const void *data,
+                            size_t len);
+
+/**
+ * @brief   Passes the block of a request payload to a sink and writes the
+ *          response
+ *
+ * To be called from a ::coap_handler_t. Requests without a Block1 option are
+ * taken as a payload of one block. The blocks of a payload must arrive in
+ * order, starting at offset zero. Retransmitted blocks are acknowledged again
+ * but not passed to the sink. Any other block is answered with 4.08 (Request
+ * Entity Incomplete) and discards the payload received so far, so the client
+ * has to start over with block zero. The sink learns about a new payload from
+ * a block at offset zero.
+ *
+ * @param[in,out]   sink    state of the payload transfer
+ * @param[in]       pkt     the request
+ * @param[out]      buf     buffer for the response
+ * @param[in]       len     length of @p buf
+ *
+ * @returns     length of the response on success
+ * @returns     <0 on error
+ */
+ssize_t nanocoap_block1_sink(nanocoap_block1_sink_t *sink, coap_pkt_t *pkt,
+                             uint8_t *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -58,6 +58,10 @@ typedef struct {
     uint32_t dao_tx_ucast_bytes;        /**< unicast dao sent in bytes */
     uint32_t dao_tx_mcast_count;        /**< multicast dao sent in packets */
     uint32_t dao_tx_mcast_bytes;        /**< multicast dao sent in bytes*/
+    uint32_t dao_tx_retrans_count;      /**< dao retransmitted for missing dao_ack */
+    uint32_t dao_tx_coalesced_count;    /**< dao triggers merged into a scheduled dao */
+    uint32_t dao_tx_drop_count;         /**< dao given up without dao_ack */
+    uint32_t dao_rx_drop_count;         /**< dao received but dropped */
     /* DAO-ACK */
     uint32_t dao_ack_rx_ucast_count;    /**< unicast dao_ack received in packets */
     uint32_t dao_ack_rx_ucast_bytes;    /**< unicast dao_ack received in bytes */
@@ -28,6 +28,11 @@
 #include <unistd.h>
 
 #include "net/sock/udp.h"
+#if defined(MODULE_SOCK_DNS_ASYNC) || defined(DOXYGEN)
+#include "event.h"
+#include "event/timeout.h"
+#include "net/sock/async/event.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,21 +56,82 @@ typedef struct {
  * @{
  */
 #define DNS_TYPE_A              (1)
+#define DNS_TYPE_SOA            (6)
 #define DNS_TYPE_AAAA           (28)
 #define DNS_CLASS_IN            (1)
 
 #define SOCK_DNS_PORT           (53)
 #define SOCK_DNS_RETRIES        (2)
+#define SOCK_DNS_TIMEOUT        (1000000LU) /* per try, in microseconds */
 
 #define SOCK_DNS_BUF_LEN        (128)       /* we're in embedded context. */
 #define SOCK_DNS_MAX_NAME_LEN   (SOCK_DNS_BUF_LEN - sizeof(sock_dns_hdr_t) - 4)
 /** @} */
 
+/**
+ * @brief   Number of DNS servers queried in parallel
+ *
+ * All servers in @ref sock_dns_servers need to be of the same address family.
+ */
+#ifndef SOCK_DNS_SERVERS_NUMOF
+#define SOCK_DNS_SERVERS_NUMOF  (1)
+#endif
+
+/**
+ * @name    DNS cache configuration
+ *
+ * Only used with module `sock_dns_cache`.
+ * @{
+ */
+/**
+ * @brief   Number of cached answers
+ */
+#ifndef SOCK_DNS_CACHE_SIZE
+#define SOCK_DNS_CACHE_SIZE     (4)
+#endif
+
+/**
+ * @brief   Maximum length of a cached domain name
+ *
+ * Answers for longer names are not cached.
+ */
+#ifndef SOCK_DNS_CACHE_NAME_LEN
+#define SOCK_DNS_CACHE_NAME_LEN (32)
+#endif
+
+/**
+ * @brief   Maximum time in seconds an answer is cached
+ *
+ * Answers with a longer TTL are cached for this time only. Must not exceed
+ * 2^31 - 1.
+ */
+#ifndef SOCK_DNS_CACHE_TTL_MAX
+#define SOCK_DNS_CACHE_TTL_MAX  (86400UL)
+#endif
+/** @} */
+
+/**
+ * @brief   Statistics of the DNS cache
+ */
+typedef struct {
+    uint32_t hits;          /**< lookups answered with a cached address */
+    uint32_t neg_hits;      /**< lookups answered with a cached negative
+                             *   answer */
+    uint32_t misses;        /**< lookups sent to the DNS servers */
+} sock_dns_cache_stats_t;
+
 /**
  * @brief Get IP address for DNS name
  *
  * This function will synchronously try to resolve a DNS A or AAAA record by contacting
- * the DNS server specified in the global variable @ref sock_dns_server.
+ * the DNS servers specified in the global array @ref sock_dns_servers. The
+ * query is sent to all configured servers at once and the first answer of
+ * any of them is used. Replies that do not carry the random transaction ID
+ * and the question of the query are ignored.
+ *
+ * With module `sock_dns_cache`, answers are cached for their time to live.
+ * Negative answers are cached for the time given by the SOA record of the
+ * answer, as specified in RFC 2308.
  *
  * By supplying AF_INET, AF_INET6 or AF_UNSPEC in @p family requesting of A
  * records (IPv4), AAAA records (IPv6) or both can be selected.
@@ -81,14 +147,112 @@ typedef struct {
  * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
  *
  * @return      the size of the resolved address on success
+ * @return      -EHOSTUNREACH, if @p domain_name has no address of @p family
  * @return      < 0 otherwise
  */
 int sock_dns_query(const char *domain_name, void *addr_out, int family);
 
+#if defined(MODULE_SOCK_DNS_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Asynchronous DNS query
+ */
+typedef struct sock_dns_req sock_dns_req_t;
+
+/**
+ * @brief   Callback for the completion of an asynchronous DNS query
+ *
+ * @param[in] req   the query
+ * @param[in] res   the size of the resolved address in
+ *                  sock_dns_req_t::addr_out on success, < 0 otherwise as
+ *                  for @ref sock_dns_query()
+ */
+typedef void (*sock_dns_cb_t)(sock_dns_req_t *req, int res);
+
+/**
+ * @brief   Asynchronous DNS query
+ *
+ * @note    All members are private, except for sock_dns_req_t::addr_out and
+ *          sock_dns_req_t::domain_name which can be read in the callback.
+ */
+struct sock_dns_req {
+    sock_udp_t sock;            /**< sock for the query */
+    event_t event;              /**< timeout or completion from the cache */
+    event_timeout_t timeout;    /**< timeout of the current try */
+    event_queue_t *queue;       /**< event queue, NULL if not in flight */
+    sock_dns_cb_t cb;           /**< completion callback */
+    const char *domain_name;    /**< DNS name to resolve */
+    void *addr_out;             /**< buffer for the result */
+    int res;                    /**< result from the cache */
+    uint8_t family;             /**< address family of the query */
+    uint8_t tries;              /**< number of times the query was sent */
+    uint8_t pending;            /**< servers that did not reply yet */
+    uint16_t id;                /**< transaction ID of the query */
+};
+
+/**
+ * @brief   Resolve a DNS name asynchronously
+ *
+ * Like @ref sock_dns_query(), but returns as soon as the query is sent. Once
+ * the query completed, @p cb is called from the thread handling @p queue.
+ * Every query has its own sock, so any number of queries can be in flight at
+ * the same time. Must be called from the thread handling @p queue, e.g. from
+ * an event handler.
+ *
+ * @param[out]  req             the query, must stay valid until @p cb is
+ *                              called or the query is canceled
+ * @param[in]   queue           event queue to handle the query
+ * @param[in]   domain_name     DNS name to resolve, must stay valid until
+ *                              @p cb is called or the query is canceled
+ * @param[out]  addr_out        buffer to write the result into, see
+ *                              @ref sock_dns_query()
+ * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
+ * @param[in]   cb              callback for the completion of the query
+ *
+ * @return      0 if the query is in flight
+ * @return      < 0 if the query could not be sent, @p cb is not called
+ */
+int sock_dns_query_async(sock_dns_req_t *req, event_queue_t *queue,
+                         const char *domain_name, void *addr_out, int family,
+                         sock_dns_cb_t cb);
+
+/**
+ * @brief   Cancel an asynchronous DNS query
+ *
+ * The callback of the query is not called anymore. Must be called from the
+ * thread handling the event queue of the query.
+ *
+ * @param[in]   req     the query
+ */
+void sock_dns_query_cancel(sock_dns_req_t *req);
+#endif
+
+#if defined(MODULE_SOCK_DNS_CACHE) || defined(DOXYGEN)
+/**
+ * @brief   Get the statistics of the DNS cache
+ *
+ * @param[out]  stats   the statistics
+ */
+void sock_dns_cache_stats(sock_dns_cache_stats_t *stats);
+
+/**
+ * @brief   Remove all answers from the DNS cache
+ *
+ * E.g. when the DNS servers changed.
+ */
+void sock_dns_cache_flush(void);
+#endif
+
+/**
+ * @brief global DNS server endpoints
+ *
+ * Endpoints with a port of 0 are not configured.
+ */
+extern sock_udp_ep_t sock_dns_servers[SOCK_DNS_SERVERS_NUMOF];
+
 /**
- * @brief global DNS server endpoint
+ * @brief global DNS server endpoint, the first one of @ref sock_dns_servers
  */
-extern sock_udp_ep_t sock_dns_server;
+#define sock_dns_server         (sock_dns_servers[0])
 
 #ifdef __cplusplus
 }
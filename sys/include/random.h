@@ -22,6 +22,15 @@
  *  - Simple Park-Miller PRNG
  *  - Musl C PRNG
  *  - Fortuna (CS)PRNG
+ *  - ChaCha (CS)PRNG (`prng_chacha`)
+ *
+ * The ChaCha PRNG generates its output in bulk and erases its key right after
+ * every refill (fast key erasure), so past output cannot be reconstructed from
+ * its state. Each thread takes small requests from a private buffer without
+ * locking, only refilling it from the shared generator takes a mutex.
+ * Interrupt handlers are served by a second generator with interrupts
+ * disabled. With `periph_hwrng` the key is seeded with 256 bits of entropy
+ * and regularly reseeded.
  */
 
 #ifndef RANDOM_H
@@ -49,6 +58,42 @@ extern "C" {
 #  define PRNG_FLOAT (0)
 #endif
 
+#ifndef RANDOM_CHACHA_ROUNDS
+/**
+ * @brief   Number of rounds of the ChaCha PRNG: 8, 12 or 20
+ */
+#define RANDOM_CHACHA_ROUNDS            (20)
+#endif
+
+#ifndef RANDOM_CHACHA_REFILL_BLOCKS
+/**
+ * @brief   Number of 64 byte blocks the ChaCha PRNG generates at once
+ *
+ * The first 32 bytes of every refill become the next key.
+ */
+#define RANDOM_CHACHA_REFILL_BLOCKS     (4)
+#endif
+
+#ifndef RANDOM_CHACHA_THREAD_BUF
+/**
+ * @brief   Bytes of output the ChaCha PRNG buffers for each thread
+ *
+ * Requests up to this size are served from the buffer of the calling thread
+ * without locking, larger requests are generated under the mutex. Uses
+ * @ref MAXTHREADS times this size of RAM, set to 0 to disable the buffers.
+ * Must not exceed 255.
+ */
+#define RANDOM_CHACHA_THREAD_BUF        (16)
+#endif
+
+#ifndef RANDOM_CHACHA_RESEED_INTERVAL
+/**
+ * @brief   Number of refills after which the ChaCha PRNG mixes fresh
+ *          entropy from `periph_hwrng` into its key, 0 disables reseeding
+ */
+#define RANDOM_CHACHA_RESEED_INTERVAL   (64)
+#endif
+
 /**
  * @brief initializes PRNG with a seed
  *
@@ -73,12 +118,19 @@ void random_init_by_array(uint32_t init_key[], int key_length);
 
 /**
  * @brief generates a random number on [0,0xffffffff]-interval
+ *
+ * Can be called from interrupt context. With `prng_chacha`, a thread that
+ * calls it with interrupts disabled may block on the mutex of the generator.
+ *
  * @return a random number on [0,0xffffffff]-interval
  */
 uint32_t random_uint32(void);
 
 /**
  * @brief writes random bytes in the [0,0xff]-interval to memory
+ *
+ * Can be called from interrupt context. With `prng_chacha`, a thread that
+ * calls it with interrupts disabled may block on the mutex of the generator.
  */
 void random_bytes(uint8_t *buf, size_t size);
 
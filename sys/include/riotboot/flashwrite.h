@@ -33,6 +33,17 @@
  * If the data is not correctly written, riotboot_put_bytes() will
  * return -1.
  *
+ * With the `riotboot_flashwrite_verify_sha256` module, the SHA-256 digest of
+ * the image is computed while the image is written. Call
+ * riotboot_flashwrite_verify_sha256_streamed() before
+ * riotboot_flashwrite_finish() to check it, without reading the image back
+ * from flash.
+ *
+ * With the `riotboot_flashwrite_verify_pages` module, every flash page is
+ * additionally checked against a list of page digests before it is written,
+ * see riotboot_flashwrite_set_page_digests(). A corrupted page then stops the
+ * update right away instead of after the whole image has been downloaded.
+ *
  * The module makes sure that at no point in time an invalid image is bootable.
  * The algorithm for that makes use of the bootloader verifying checksum and
  * works as follows:
@@ -56,6 +67,10 @@ extern "C" {
 
 #include "riotboot/slot.h"
 #include "periph/flashpage.h"
+#if defined(MODULE_RIOTBOOT_FLASHWRITE_VERIFY_SHA256) || \
+    defined(MODULE_RIOTBOOT_FLASHWRITE_VERIFY_PAGES)
+#include "hashes/sha256.h"
+#endif
 
 /**
  * @brief   firmware update state structure
@@ -65,6 +80,14 @@ typedef struct {
     size_t offset;                          /**< update is at this position   */
     unsigned flashpage;                     /**< update is at this flashpage  */
     uint8_t flashpage_buf[FLASHPAGE_SIZE];  /**< flash writing buffer         */
+#if defined(MODULE_RIOTBOOT_FLASHWRITE_VERIFY_SHA256) || defined(DOXYGEN)
+    sha256_context_t sha256;                /**< digest of the written image  */
+#endif
+#if defined(MODULE_RIOTBOOT_FLASHWRITE_VERIFY_PAGES) || defined(DOXYGEN)
+    sha256_context_t page_sha256;           /**< digest of the current page   */
+    const uint8_t *page_digests;            /**< expected digest of each page */
+    size_t page_digests_numof;              /**< number of page digests       */
+#endif
 } riotboot_flashwrite_t;
 
 /**
@@ -82,6 +105,10 @@ typedef struct {
  * @note offset *should* be <= FLASHPAGE_SIZE, otherwise the results are
  *       undefined.
  *
+ * With the `riotboot_flashwrite_verify_sha256` module, the digest of the
+ * image only covers the bytes passed in via
+ * @ref riotboot_flashwrite_putbytes().
+ *
  * @param[in,out]   state       ptr to preallocated state structure
  * @param[in]       target_slot slot to write update into
  * @param[in]       offset      Bytes offset to start write at
@@ -109,8 +136,15 @@ static inline int riotboot_flashwrite_init(riotboot_flashwrite_t *state,
                                            int target_slot)
 {
     /* initialize state, but skip "RIOT" */
-    return riotboot_flashwrite_init_raw(state, target_slot,
-                                        RIOTBOOT_FLASHWRITE_SKIPLEN);
+    int res = riotboot_flashwrite_init_raw(state, target_slot,
+                                           RIOTBOOT_FLASHWRITE_SKIPLEN);
+
+#ifdef MODULE_RIOTBOOT_FLASHWRITE_VERIFY_SHA256
+    /* the image digest covers the magic number written by
+     * riotboot_flashwrite_finish() */
+    sha256_update(&state->sha256, "RIOT", RIOTBOOT_FLASHWRITE_SKIPLEN);
+#endif
+    return res;
 }
 
 /**
@@ -125,7 +159,8 @@ static inline int riotboot_flashwrite_init(riotboot_flashwrite_t *state,
  * @param[in]       len     len of data
  * @param[in]       more    whether more data is coming
  *
- * @returns         0 on success, <0 otherwise
+ * @returns         0 on success, <0 otherwise, also if a page does not match
+ *                  its digest set by @ref riotboot_flashwrite_set_page_digests()
  */
 int riotboot_flashwrite_putbytes(riotboot_flashwrite_t *state,
                                  const uint8_t *bytes, size_t len, bool more);
@@ -183,6 +218,49 @@ size_t riotboot_flashwrite_slotsize(const riotboot_flashwrite_t *state);
 int riotboot_flashwrite_verify_sha256(const uint8_t *sha256_digest,
                                       size_t img_size, int target_slot);
 
+/**
+ * @brief       Verify the digest of the image written through @p state
+ *
+ * Unlike riotboot_flashwrite_verify_sha256(), this uses the digest computed
+ * while the image was written, so the image is not read back from flash.
+ * The digest of @p state is consumed by this call.
+ *
+ * @param[in,out] state         ptr to previously used state structure
+ * @param[in]   sha256_digest   content of the image digest
+ * @param[in]   img_size        the size of the image
+ *
+ * @returns     -1 when not exactly @p img_size bytes have been written
+ * @returns     0 if the digest is valid
+ * @returns     1 if the digest is invalid
+ */
+int riotboot_flashwrite_verify_sha256_streamed(riotboot_flashwrite_t *state,
+                                               const uint8_t *sha256_digest,
+                                               size_t img_size);
+
+/**
+ * @brief       Set the digests to check the flash pages against
+ *
+ * Page i of the slot is checked against the SHA-256 digest at
+ * `digests[i * SHA256_DIGEST_LENGTH]` before it is written. The digest covers
+ * the bytes of the page passed in via @ref riotboot_flashwrite_putbytes(), so
+ * for the first page not the bytes skipped by the initial offset.
+ *
+ * The list itself is authenticated by @p root, the SHA-256 digest of all page
+ * digests concatenated, which is supposed to be part of a signed manifest.
+ *
+ * @param[in,out] state     ptr to state structure, initialized before
+ * @param[in]   digests     @p numof page digests, must stay valid until the
+ *                          update is finished
+ * @param[in]   numof       number of page digests
+ * @param[in]   root        SHA-256 digest of @p digests
+ *
+ * @returns     0 on success
+ * @returns     -1 if @p digests does not match @p root
+ */
+int riotboot_flashwrite_set_page_digests(riotboot_flashwrite_t *state,
+                                         const uint8_t *digests, size_t numof,
+                                         const uint8_t *root);
+
 #ifdef __cplusplus
 }
 #endif
@@ -92,6 +92,19 @@ static size_t _len_get(uint8_t *buf, size_t *len)
     }
 }
 
+static uint8_t _req_type(const asymcute_req_t *req)
+{
+    return req->data[(req->data[0] == 0x01) ? 3 : 1];
+}
+
+/* @pre con is locked */
+static void _req_dequeued(asymcute_con_t *con, asymcute_req_t *req)
+{
+    if ((_req_type(req) == MQTTSN_PUBLISH) && (con->pub_inflight > 0)) {
+        con->pub_inflight--;
+    }
+}
+
 /* @pre con is locked */
 static uint16_t _msg_id_next(asymcute_con_t *con)
 {
@@ -131,6 +144,7 @@ static asymcute_req_t *_req_preprocess(asymcute_con_t *con,
     }
 
     if (res) {
+        _req_dequeued(con, res);
         res->con = NULL;
         event_timeout_clear(&res->to_timer);
     }
@@ -148,6 +162,7 @@ static void _req_remove(asymcute_con_t *con, asymcute_req_t *req)
             cur->next = cur->next->next;
         }
     }
+    _req_dequeued(con, req);
     req->con = NULL;
 }
 
@@ -222,6 +237,7 @@ static void _disconnect(asymcute_con_t *con, uint8_t state)
             _req_cancel(req);
         }
         con->pending = NULL;
+        con->pub_inflight = 0;
         for (asymcute_sub_t *sub = con->subscriptions; sub; sub = sub->next) {
             _sub_cancel(sub);
         }
@@ -240,7 +256,11 @@ static void _on_req_timeout(void *arg)
     }
 
     if (req->retry_cnt--) {
-        /* resend the packet */
+        /* resend the packet, marking a PUBLISH as duplicate, see spec v1.2,
+         * section 5.3.4 */
+        if (_req_type(req) == MQTTSN_PUBLISH) {
+            req->data[(req->data[0] == 0x01) ? 4 : 2] |= MQTTSN_DUP;
+        }
         _req_resend(req, req->con);
         return;
     }
@@ -871,6 +891,11 @@ int asymcute_publish(asymcute_con_t *con, asymcute_req_t *req,
         ret = ASYMCUTE_GWERR;
         goto end;
     }
+    /* limit the number of messages waiting for their PUBACK */
+    if ((flags & MQTTSN_QOS_1) && (con->pub_inflight >= ASYMCUTE_PUB_WINDOW)) {
+        ret = ASYMCUTE_BUSY;
+        goto end;
+    }
     /* make sure request context is clear to be used */
     if (mutex_trylock(&req->lock) != 1) {
         ret = ASYMCUTE_BUSY;
@@ -891,6 +916,7 @@ int asymcute_publish(asymcute_con_t *con, asymcute_req_t *req,
 
     /* publish selected data */
     if (flags & MQTTSN_QOS_1) {
+        con->pub_inflight++;
         _req_send(req, con, NULL);
     }
     else {
@@ -16,12 +16,18 @@
  */
 
 #include <arpa/inet.h>
+#include <ctype.h>
+#include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
 
 #include "net/dns.h"
 #include "net/sock/udp.h"
 #include "net/sock/dns.h"
+#include "net/sock/util.h"
+#include "random.h"
+#include "xtimer.h"
+#include "dns_cache.h"
 
 #ifdef RIOT_VERSION
 #include "byteorder.h"
@@ -30,8 +36,22 @@
 /* min domain name length is 1, so minimum record length is 7 */
 #define DNS_MIN_REPLY_LEN   (unsigned)(sizeof(sock_dns_hdr_t ) + 7)
 
-/* global DNS server UDP endpoint */
-sock_udp_ep_t sock_dns_server;
+/* header flags and response codes, RFC 1035, section 4.1.1 */
+#define DNS_FLAG_QR         (0x8000)
+#define DNS_RCODE_MASK      (0x000f)
+#define DNS_RCODE_NO_ERROR  (0)
+#define DNS_RCODE_NAME_ERR  (3)
+
+/* fixed fields of a resource record after its name */
+#define RR_FIXED_LENGTH     (RR_TYPE_LENGTH + RR_CLASS_LENGTH + \
+                             RR_TTL_LENGTH + RR_RDLENGTH_LENGTH)
+/* RFC 2181, section 8: larger TTLs are treated as 0 */
+#define RR_TTL_MAX          (0x7fffffffUL)
+/* limits the compression pointers followed in a name */
+#define NAME_PTR_MAX        (8U)
+
+/* global DNS server UDP endpoints */
+sock_udp_ep_t sock_dns_servers[SOCK_DNS_SERVERS_NUMOF];
 
 static ssize_t _enc_domain_name(uint8_t *out, const char *domain_name)
 {
@@ -75,6 +95,14 @@ static unsigned _get_short(uint8_t *buf)
     return _tmp;
 }
 
+static uint32_t _get_ttl(uint8_t *buf)
+{
+    uint32_t _tmp;
+    memcpy(&_tmp, buf, 4);
+    _tmp = ntohl(_tmp);
+    return (_tmp > RR_TTL_MAX) ? 0 : _tmp;
+}
+
 static ssize_t _skip_hostname(const uint8_t *buf, size_t len, uint8_t *bufpos)
 {
     const uint8_t *buflim = buf + len;
@@ -102,11 +130,97 @@ static ssize_t _skip_hostname(const uint8_t *buf, size_t len, uint8_t *bufpos)
     return res + 1;
 }
 
-static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family)
+/* compares the name at @p pos with @p domain_name, ignoring case */
+static bool _name_equal(const uint8_t *buf, size_t len, size_t pos,
+                        const char *domain_name)
+{
+    unsigned ptrs = 0;
+
+    while (pos < len) {
+        unsigned label = buf[pos];
+
+        /* follow DNS Message Compression */
+        if (label >= 192) {
+            if (((pos + 1) >= len) || (++ptrs > NAME_PTR_MAX)) {
+                return false;
+            }
+            pos = ((label & 0x3f) << 8) | buf[pos + 1];
+            continue;
+        }
+        if (label == 0) {
+            return *domain_name == '\0';
+        }
+        if ((pos + 1 + label) >= len) {
+            return false;
+        }
+        for (unsigned i = 1; i <= label; i++, domain_name++) {
+            if ((*domain_name == '\0') || (*domain_name == '.') ||
+                (tolower((unsigned char)*domain_name) !=
+                 tolower(buf[pos + i]))) {
+                return false;
+            }
+        }
+        if (*domain_name == '.') {
+            domain_name++;
+        }
+        else if (*domain_name != '\0') {
+            return false;
+        }
+        pos += 1 + label;
+    }
+    return false;
+}
+
+/*
+ * Returns the TTL of a negative answer: the minimum of the TTL and the MINIMUM
+ * field of the SOA record in the authority section (RFC 2308, section 5), or
+ * 0 if there is none.
+ */
+static uint32_t _parse_neg_ttl(uint8_t *buf, size_t len, uint8_t *bufpos)
+{
+    const uint8_t *buflim = buf + len;
+    sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
+
+    for (unsigned n = 0; n < ntohs(hdr->nscount); n++) {
+        ssize_t tmp = _skip_hostname(buf, len, bufpos);
+        if (tmp < 0) {
+            return 0;
+        }
+        bufpos += tmp;
+        if ((bufpos + RR_FIXED_LENGTH) > buflim) {
+            return 0;
+        }
+        uint16_t _type = ntohs(_get_short(bufpos));
+        bufpos += RR_TYPE_LENGTH + RR_CLASS_LENGTH;
+        uint32_t ttl = _get_ttl(bufpos);
+        bufpos += RR_TTL_LENGTH;
+        unsigned rdlen = ntohs(_get_short(bufpos));
+        bufpos += RR_RDLENGTH_LENGTH;
+        if ((bufpos + rdlen) > buflim) {
+            return 0;
+        }
+        if ((_type == DNS_TYPE_SOA) && (rdlen >= RR_TTL_LENGTH)) {
+            /* MINIMUM is the last field of the SOA record */
+            uint32_t minimum = _get_ttl(bufpos + rdlen - RR_TTL_LENGTH);
+            return (ttl < minimum) ? ttl : minimum;
+        }
+        bufpos += rdlen;
+    }
+    return 0;
+}
+
+static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out,
+                            int family, uint32_t *ttl)
 {
     const uint8_t *buflim = buf + len;
     sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
     uint8_t *bufpos = buf + sizeof(*hdr);
+    unsigned rcode = ntohs(hdr->flags) & DNS_RCODE_MASK;
+
+    if ((rcode != DNS_RCODE_NO_ERROR) && (rcode != DNS_RCODE_NAME_ERR)) {
+        /* server failure, not an answer */
+        return -EAGAIN;
+    }
 
     /* skip all queries that are part of the reply */
     for (unsigned n = 0; n < ntohs(hdr->qdcount); n++) {
@@ -119,35 +233,39 @@ static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family
         bufpos += (RR_TYPE_LENGTH + RR_CLASS_LENGTH);
     }
 
+    /* the address is valid no longer than the CNAME records leading to it */
+    *ttl = RR_TTL_MAX;
     for (unsigned n = 0; n < ntohs(hdr->ancount); n++) {
         ssize_t tmp = _skip_hostname(buf, len, bufpos);
         if (tmp < 0) {
             return tmp;
         }
         bufpos += tmp;
-        if ((bufpos + RR_TYPE_LENGTH + RR_CLASS_LENGTH + RR_TTL_LENGTH) >= buflim) {
+        if ((bufpos + RR_FIXED_LENGTH) > buflim) {
             return -EBADMSG;
         }
         uint16_t _type = ntohs(_get_short(bufpos));
         bufpos += RR_TYPE_LENGTH;
         uint16_t class = ntohs(_get_short(bufpos));
         bufpos += RR_CLASS_LENGTH;
-        bufpos += RR_TTL_LENGTH; /* skip ttl */
+        uint32_t rr_ttl = _get_ttl(bufpos);
+        bufpos += RR_TTL_LENGTH;
 
         unsigned addrlen = ntohs(_get_short(bufpos));
+        bufpos += RR_RDLENGTH_LENGTH;
+        if ((bufpos + addrlen) > buflim) {
+            return -EBADMSG;
+        }
+        if (rr_ttl < *ttl) {
+            *ttl = rr_ttl;
+        }
         /* skip unwanted answers */
         if ((class != DNS_CLASS_IN) ||
                 ((_type == DNS_TYPE_A) && (family == AF_INET6)) ||
                 ((_type == DNS_TYPE_AAAA) && (family == AF_INET)) ||
                 ! ((_type == DNS_TYPE_A) || ((_type == DNS_TYPE_AAAA))
                     )) {
-            if (addrlen > len) {
-                /* buffer wraps around memory space */
-                return -EBADMSG;
-            }
             bufpos += addrlen;
-            /* other out-of-bound is checked in `_skip_hostname()` at start of
-             * loop */
             continue;
         }
         if (((addrlen != INADDRSZ) && (family == AF_INET)) ||
@@ -156,82 +274,214 @@ static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family
              (family == AF_UNSPEC))) {
             return -EBADMSG;
         }
-        bufpos += RR_RDLENGTH_LENGTH;
-        if ((bufpos + addrlen) > buflim) {
-            return -EBADMSG;
-        }
 
         memcpy(addr_out, bufpos, addrlen);
         return addrlen;
     }
 
-    return -1;
+    /* name does not exist or has no address of the family */
+    *ttl = _parse_neg_ttl(buf, len, bufpos);
+    return (rcode == DNS_RCODE_NAME_ERR) ? -ENOENT : -EHOSTUNREACH;
 }
 
-int sock_dns_query(const char *domain_name, void *addr_out, int family)
+static bool _is_server(const sock_udp_ep_t *remote)
 {
-    static uint8_t dns_buf[SOCK_DNS_BUF_LEN];
+    for (unsigned i = 0; i < SOCK_DNS_SERVERS_NUMOF; i++) {
+        if ((sock_dns_servers[i].port != 0) &&
+            sock_udp_ep_equal(&sock_dns_servers[i], remote)) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    if (sock_dns_server.port == 0) {
+static int _check_query(const char *domain_name)
+{
+    unsigned servers = 0;
+
+    for (unsigned i = 0; i < SOCK_DNS_SERVERS_NUMOF; i++) {
+        servers += (sock_dns_servers[i].port != 0);
+    }
+    if (servers == 0) {
         return -ECONNREFUSED;
     }
 
     if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
         return -ENOSPC;
     }
+    return 0;
+}
 
-    sock_udp_t sock_dns;
-
-    ssize_t res = sock_udp_create(&sock_dns, NULL, &sock_dns_server, 0);
-    if (res) {
-        goto out;
-    }
-
-    uint16_t id = 0; /* random? */
-    for (int i = 0; i < SOCK_DNS_RETRIES; i++) {
-        uint8_t *buf = dns_buf;
+static size_t _build_query(uint8_t *buf, const char *domain_name, int family,
+                           uint16_t id)
+{
+    sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->id = id;
+    hdr->flags = htons(0x0120);
+    hdr->qdcount = htons(1 + (family == AF_UNSPEC));
 
-        sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
-        memset(hdr, 0, sizeof(*hdr));
-        hdr->id = id;
-        hdr->flags = htons(0x0120);
-        hdr->qdcount = htons(1 + (family == AF_UNSPEC));
+    uint8_t *bufpos = buf + sizeof(*hdr);
 
-        uint8_t *bufpos = buf + sizeof(*hdr);
+    unsigned _name_ptr;
+    if ((family == AF_INET6) || (family == AF_UNSPEC)) {
+        _name_ptr = (bufpos - buf);
+        bufpos += _enc_domain_name(bufpos, domain_name);
+        bufpos += _put_short(bufpos, htons(DNS_TYPE_AAAA));
+        bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+    }
 
-        unsigned _name_ptr;
-        if ((family == AF_INET6) || (family == AF_UNSPEC)) {
-            _name_ptr = (bufpos - buf);
+    if ((family == AF_INET) || (family == AF_UNSPEC)) {
+        if (family == AF_UNSPEC) {
+            bufpos += _put_short(bufpos, htons((0xc000) | (_name_ptr)));
+        }
+        else {
             bufpos += _enc_domain_name(bufpos, domain_name);
-            bufpos += _put_short(bufpos, htons(DNS_TYPE_AAAA));
-            bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
         }
+        bufpos += _put_short(bufpos, htons(DNS_TYPE_A));
+        bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+    }
+    return bufpos - buf;
+}
 
-        if ((family == AF_INET) || (family == AF_UNSPEC)) {
-            if (family == AF_UNSPEC) {
-                bufpos += _put_short(bufpos, htons((0xc000) | (_name_ptr)));
-            }
-            else {
-                bufpos += _enc_domain_name(bufpos, domain_name);
-            }
-            bufpos += _put_short(bufpos, htons(DNS_TYPE_A));
-            bufpos += _put_short(bufpos, htons(DNS_CLASS_IN));
+/* sends the query to all servers, returns the number of servers reached */
+static unsigned _send_query(sock_udp_t *sock, const uint8_t *buf, size_t len,
+                            ssize_t *res)
+{
+    unsigned sent = 0;
+
+    for (unsigned j = 0; j < SOCK_DNS_SERVERS_NUMOF; j++) {
+        if ((sock_dns_servers[j].port != 0) &&
+            ((*res = sock_udp_send(sock, buf, len,
+                                   &sock_dns_servers[j])) > 0)) {
+            sent++;
         }
+    }
+    return sent;
+}
 
-        res = sock_udp_send(&sock_dns, buf, (bufpos-buf), NULL);
-        if (res <= 0) {
-            continue;
+/*
+ * Checks if a packet received from @p remote is a reply to the query with
+ * transaction ID @p id: it has to come from a server and carry the questions
+ * of the query. Anything else must not end the query.
+ */
+static bool _is_reply(uint8_t *buf, ssize_t len, const sock_udp_ep_t *remote,
+                      uint16_t id, const char *domain_name, int family)
+{
+    const uint8_t *buflim = buf + len;
+    sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
+    uint8_t *bufpos = buf + sizeof(*hdr);
+    /* the questions in the order of _build_query() */
+    uint16_t types[] = { DNS_TYPE_AAAA, DNS_TYPE_A };
+    unsigned first = (family == AF_INET);
+    unsigned qdcount = (family == AF_UNSPEC) ? 2 : 1;
+
+    if (!_is_server(remote) || (len <= (int)DNS_MIN_REPLY_LEN) ||
+        (hdr->id != id) || !(ntohs(hdr->flags) & DNS_FLAG_QR) ||
+        (ntohs(hdr->qdcount) != qdcount)) {
+        return false;
+    }
+    for (unsigned n = 0; n < qdcount; n++) {
+        ssize_t tmp = _skip_hostname(buf, len, bufpos);
+        if ((tmp < 0) ||
+            !_name_equal(buf, len, bufpos - buf, domain_name)) {
+            return false;
         }
-        res = sock_udp_recv(&sock_dns, dns_buf, sizeof(dns_buf), 1000000LU, NULL);
-        if (res > 0) {
-            if (res > (int)DNS_MIN_REPLY_LEN) {
-                if ((res = _parse_dns_reply(dns_buf, res, addr_out,
-                                            family)) > 0) {
-                    goto out;
-                }
+        bufpos += tmp;
+        if (((bufpos + RR_TYPE_LENGTH + RR_CLASS_LENGTH) > buflim) ||
+            (ntohs(_get_short(bufpos)) != types[first + n]) ||
+            (ntohs(_get_short(bufpos + RR_TYPE_LENGTH)) != DNS_CLASS_IN)) {
+            return false;
+        }
+        bufpos += RR_TYPE_LENGTH + RR_CLASS_LENGTH;
+    }
+    return true;
+}
+
+/*
+ * Handles a reply accepted by _is_reply(). Returns the size of the address or
+ * -EHOSTUNREACH for an answer, other negative values if the reply does not
+ * answer the query.
+ */
+static int _handle_reply(uint8_t *buf, ssize_t len, const char *domain_name,
+                         void *addr_out, int family)
+{
+    uint32_t ttl;
+    int res;
+
+    res = _parse_dns_reply(buf, len, addr_out, family, &ttl);
+    if (res > 0) {
+#ifdef MODULE_SOCK_DNS_CACHE
+        dns_cache_put(domain_name, family, addr_out, res, ttl);
+#endif
+    }
+    else if ((res == -ENOENT) || (res == -EHOSTUNREACH)) {
+#ifdef MODULE_SOCK_DNS_CACHE
+        /* a name that does not exist has no address at all */
+        dns_cache_put(domain_name, (res == -ENOENT) ? AF_UNSPEC : family,
+                      NULL, 0, ttl);
+#endif
+        res = -EHOSTUNREACH;
+    }
+    (void)domain_name;
+    return res;
+}
+
+int sock_dns_query(const char *domain_name, void *addr_out, int family)
+{
+    static uint8_t dns_buf[SOCK_DNS_BUF_LEN];
+
+    ssize_t res = _check_query(domain_name);
+    if (res < 0) {
+        return res;
+    }
+
+#ifdef MODULE_SOCK_DNS_CACHE
+    int cached = dns_cache_get(domain_name, addr_out, family);
+    if (cached != 0) {
+        return cached;
+    }
+#endif
+
+    sock_udp_t sock_dns;
+
+    /* not connected, so the query can go to all servers */
+    res = sock_udp_create(&sock_dns, NULL, NULL, 0);
+    if (res) {
+        goto out;
+    }
+
+    /* one ID for all tries, so a late reply to an earlier try still counts */
+    uint16_t id = random_uint32();
+
+    for (int i = 0; i < SOCK_DNS_RETRIES; i++) {
+        size_t len = _build_query(dns_buf, domain_name, family, id);
+        unsigned sent = _send_query(&sock_dns, dns_buf, len, &res);
+        uint32_t start = xtimer_now_usec();
+
+        /* the first answer of any server wins, the query is repeated when
+         * all servers failed or one timed out */
+        while (sent > 0) {
+            sock_udp_ep_t remote;
+            uint32_t elapsed = xtimer_now_usec() - start;
+
+            if (elapsed >= SOCK_DNS_TIMEOUT) {
+                res = -ETIMEDOUT;
+                break;
+            }
+            res = sock_udp_recv(&sock_dns, dns_buf, sizeof(dns_buf),
+                                SOCK_DNS_TIMEOUT - elapsed, &remote);
+            if (res <= 0) {
+                break;
             }
-            else {
+            if (!_is_reply(dns_buf, res, &remote, id, domain_name, family)) {
                 res = -EBADMSG;
+                continue;
+            }
+            sent--;
+            res = _handle_reply(dns_buf, res, domain_name, addr_out, family);
+            if ((res > 0) || (res == -EHOSTUNREACH)) {
+                goto out;
             }
         }
     }
@@ -240,3 +490,137 @@ out:
     sock_udp_close(&sock_dns);
     return res;
 }
+
+#ifdef MODULE_SOCK_DNS_ASYNC
+static void _async_stop(sock_dns_req_t *req)
+{
+    event_queue_t *queue = req->queue;
+
+    event_timeout_clear(&req->timeout);
+    event_cancel(queue, &req->event);
+    sock_udp_close(&req->sock);
+    /* drop a receive event posted before the sock was closed */
+    event_cancel(queue, &sock_udp_get_async_ctx(&req->sock)->event.super);
+    req->queue = NULL;
+}
+
+static void _async_finish(sock_dns_req_t *req, int res)
+{
+    _async_stop(req);
+    req->cb(req, res);
+}
+
+/* sends the query (again), returns false if no server was reached */
+static bool _async_send(sock_dns_req_t *req)
+{
+    uint8_t buf[SOCK_DNS_BUF_LEN];
+    size_t len = _build_query(buf, req->domain_name, req->family, req->id);
+    ssize_t res;
+
+    req->tries++;
+    req->pending = _send_query(&req->sock, buf, len, &res);
+    if (req->pending == 0) {
+        return false;
+    }
+    event_timeout_set(&req->timeout, SOCK_DNS_TIMEOUT);
+    return true;
+}
+
+/* retries the query, or gives up with @p res */
+static void _async_retry(sock_dns_req_t *req, int res)
+{
+    if ((req->tries >= SOCK_DNS_RETRIES) || !_async_send(req)) {
+        _async_finish(req, res);
+    }
+}
+
+static void _on_async_event(event_t *event)
+{
+    sock_dns_req_t *req = container_of(event, sock_dns_req_t, event);
+
+    if (req->tries == 0) {
+        /* answered from the cache */
+        _async_finish(req, req->res);
+    }
+    else {
+        _async_retry(req, -ETIMEDOUT);
+    }
+}
+
+static void _on_async_sock_evt(sock_udp_t *sock, sock_async_flags_t type)
+{
+    sock_dns_req_t *req = container_of(sock, sock_dns_req_t, sock);
+    uint8_t buf[SOCK_DNS_BUF_LEN];
+    sock_udp_ep_t remote;
+    ssize_t res;
+
+    if (!(type & SOCK_ASYNC_MSG_RECV) || (req->queue == NULL)) {
+        return;
+    }
+    while ((res = sock_udp_recv(sock, buf, sizeof(buf), 0, &remote)) > 0) {
+        if (!_is_reply(buf, res, &remote, req->id, req->domain_name,
+                       req->family)) {
+            continue;
+        }
+        res = _handle_reply(buf, res, req->domain_name, req->addr_out,
+                            req->family);
+        if ((res > 0) || (res == -EHOSTUNREACH)) {
+            _async_finish(req, res);
+            return;
+        }
+        if ((req->pending > 0) && (--req->pending == 0)) {
+            /* all servers failed */
+            _async_retry(req, res);
+            return;
+        }
+    }
+}
+
+int sock_dns_query_async(sock_dns_req_t *req, event_queue_t *queue,
+                         const char *domain_name, void *addr_out, int family,
+                         sock_dns_cb_t cb)
+{
+    int res = _check_query(domain_name);
+    if (res < 0) {
+        return res;
+    }
+
+    memset(req, 0, sizeof(*req));
+    req->queue = queue;
+    req->cb = cb;
+    req->domain_name = domain_name;
+    req->addr_out = addr_out;
+    req->family = family;
+    req->id = random_uint32();
+    req->event.handler = _on_async_event;
+    event_timeout_init(&req->timeout, queue, &req->event);
+
+    /* not connected, so the query can go to all servers */
+    res = sock_udp_create(&req->sock, NULL, NULL, 0);
+    if (res < 0) {
+        return res;
+    }
+    sock_udp_event_init(&req->sock, queue, _on_async_sock_evt);
+
+#ifdef MODULE_SOCK_DNS_CACHE
+    req->res = dns_cache_get(domain_name, addr_out, family);
+    if (req->res != 0) {
+        event_post(queue, &req->event);
+        return 0;
+    }
+#endif
+    if (!_async_send(req)) {
+        sock_udp_close(&req->sock);
+        req->queue = NULL;
+        return -ENETUNREACH;
+    }
+    return 0;
+}
+
+void sock_dns_query_cancel(sock_dns_req_t *req)
+{
+    if (req->queue != NULL) {
+        _async_stop(req);
+    }
+}
+#endif /* MODULE_SOCK_DNS_ASYNC */
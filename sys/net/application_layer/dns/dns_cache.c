@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_dns
+ * @{
+ * @file
+ * @brief   DNS cache implementation
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/af.h"
+#include "net/sock/dns.h"
+#include "xtimer.h"
+#include "dns_cache.h"
+
+#ifdef MODULE_SOCK_DNS_CACHE
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+typedef struct {
+    char name[SOCK_DNS_CACHE_NAME_LEN + 1]; /* empty if entry is unused */
+    uint32_t expires;                       /* in seconds */
+    uint8_t addr[16];
+    uint8_t addr_len;                       /* 0 for a negative answer */
+    uint8_t family;                         /* queried family of an address,
+                                             * covered families of a negative
+                                             * answer */
+} _entry_t;
+
+static mutex_t _mutex = MUTEX_INIT;
+static _entry_t _entries[SOCK_DNS_CACHE_SIZE];
+static sock_dns_cache_stats_t _stats;
+
+static inline uint32_t _now_sec(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static inline bool _expired(const _entry_t *entry, uint32_t now)
+{
+    return (int32_t)(entry->expires - now) <= 0;
+}
+
+/* An address found with AF_UNSPEC also answers a query for its family. As
+ * AF_UNSPEC prefers AAAA records, an IPv6 address also answers AF_UNSPEC. */
+static bool _match(const _entry_t *entry, int family)
+{
+    if (entry->addr_len == 0) {
+        return (entry->family == AF_UNSPEC) || (entry->family == family);
+    }
+    if ((entry->family == family) ||
+        ((family == AF_UNSPEC) && (entry->addr_len == 16))) {
+        return true;
+    }
+    return (entry->family == AF_UNSPEC) &&
+           (((family == AF_INET6) && (entry->addr_len == 16)) ||
+            ((family == AF_INET) && (entry->addr_len == 4)));
+}
+
+/* checks if a new answer for @p family makes a cached one for the same name
+ * obsolete */
+static bool _replaces(const _entry_t *entry, int family, size_t addr_len)
+{
+    /* a name that does not exist has no address at all, and the other way
+     * around */
+    if (((addr_len == 0) && (family == AF_UNSPEC)) ||
+        ((entry->addr_len == 0) && (entry->family == AF_UNSPEC))) {
+        return true;
+    }
+    return (entry->family == family) || _match(entry, family);
+}
+
+int dns_cache_get(const char *domain_name, void *addr_out, int family)
+{
+    uint32_t now = _now_sec();
+    int res = 0;
+
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _entry_t *entry = &_entries[i];
+
+        if ((entry->name[0] == '\0') || !_match(entry, family) ||
+            (strcmp(entry->name, domain_name) != 0)) {
+            continue;
+        }
+        if (_expired(entry, now)) {
+            DEBUG("dns_cache: entry %u expired\n", i);
+            entry->name[0] = '\0';
+            continue;
+        }
+        if (entry->addr_len == 0) {
+            res = -EHOSTUNREACH;
+            _stats.neg_hits++;
+        }
+        else {
+            memcpy(addr_out, entry->addr, entry->addr_len);
+            res = entry->addr_len;
+            _stats.hits++;
+        }
+        break;
+    }
+    if (res == 0) {
+        _stats.misses++;
+    }
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+void dns_cache_put(const char *domain_name, int family, const void *addr,
+                   size_t addr_len, uint32_t ttl)
+{
+    uint32_t now = _now_sec();
+    _entry_t *entry = &_entries[0];
+
+    if ((ttl == 0) || (strlen(domain_name) > SOCK_DNS_CACHE_NAME_LEN) ||
+        (addr_len > sizeof(entry->addr))) {
+        return;
+    }
+    if (ttl > SOCK_DNS_CACHE_TTL_MAX) {
+        ttl = SOCK_DNS_CACHE_TTL_MAX;
+    }
+    mutex_lock(&_mutex);
+    /* drop the answers for the name that the new one makes obsolete, so no
+     * stale answer shadows it */
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _entry_t *tmp = &_entries[i];
+
+        if ((tmp->name[0] != '\0') && _replaces(tmp, family, addr_len) &&
+            (strcmp(tmp->name, domain_name) == 0)) {
+            tmp->name[0] = '\0';
+        }
+    }
+    /* take an unused or expired entry, or the one that expires first */
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _entry_t *tmp = &_entries[i];
+
+        if ((entry->name[0] == '\0') || _expired(entry, now)) {
+            continue;
+        }
+        if ((tmp->name[0] == '\0') || _expired(tmp, now) ||
+            ((int32_t)(tmp->expires - entry->expires) < 0)) {
+            entry = tmp;
+        }
+    }
+    strcpy(entry->name, domain_name);
+    entry->expires = now + ttl;
+    entry->family = family;
+    entry->addr_len = addr_len;
+    if (addr_len > 0) {
+        memcpy(entry->addr, addr, addr_len);
+    }
+    DEBUG("dns_cache: cached %s for %u s\n", domain_name, (unsigned)ttl);
+    mutex_unlock(&_mutex);
+}
+
+void sock_dns_cache_stats(sock_dns_cache_stats_t *stats)
+{
+    mutex_lock(&_mutex);
+    *stats = _stats;
+    mutex_unlock(&_mutex);
+}
+
+void sock_dns_cache_flush(void)
+{
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _entries[i].name[0] = '\0';
+    }
+    mutex_unlock(&_mutex);
+}
+#else
+typedef int dont_be_pedantic;
+#endif  /* MODULE_SOCK_DNS_CACHE */
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_sock_dns
+ * @internal
+ * @{
+ *
+ * @file
+ * @brief       DNS cache
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc2308">RFC 2308</a>
+ */
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Looks up the answer to a query in the cache
+ *
+ * @param[in]   domain_name     DNS name to resolve
+ * @param[out]  addr_out        buffer for the address
+ * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
+ *
+ * @return  the size of the cached address
+ * @return  -EHOSTUNREACH, for a cached negative answer
+ * @return  0, if the answer is not cached
+ */
+int dns_cache_get(const char *domain_name, void *addr_out, int family);
+
+/**
+ * @brief   Adds the answer to a query to the cache
+ *
+ * @param[in]   domain_name     DNS name of the query
+ * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC. For a
+ *                              negative answer, the families it applies to.
+ * @param[in]   addr            the address, NULL for a negative answer
+ * @param[in]   addr_len        size of @p addr, 0 for a negative answer
+ * @param[in]   ttl             time to live of the answer in seconds
+ */
+void dns_cache_put(const char *domain_name, int family, const void *addr,
+                   size_t addr_len, uint32_t ttl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DNS_CACHE_H */
+/** @} */
@@ -20,6 +20,7 @@
 
 #include <string.h>
 
+#include "irq.h"
 #include "log.h"
 #include "mutex.h"
 #include "sched.h"
@@ -43,6 +44,29 @@
 #define TFLAGS_TIMEOUT      (0x0002)
 #define TFLAGS_ANY          (TFLAGS_RESP | TFLAGS_TIMEOUT)
 
+#define T_RETRY_US          (EMCUTE_T_RETRY * US_PER_SEC)
+
+typedef struct {
+    emcute_pub_cb_t cb;
+    void *arg;
+    const void *data;
+    uint32_t sent;          /* time of the last transmission */
+    uint16_t len;
+    uint16_t msg_id;
+    uint16_t topic_id;
+    uint8_t flags;
+    uint8_t tx;             /* number of transmissions, 0 if slot is unused */
+} pub_slot_t;
+
+typedef struct {
+    emcute_pub_cb_t cb;
+    void *arg;
+} pub_cb_t;
+
+typedef struct {
+    char name[EMCUTE_TOPIC_CACHE_NAMELEN];
+    uint16_t id;            /* 0 if entry is unused */
+} topic_entry_t;
 
 static const char *cli_id;
 static sock_udp_t sock;
@@ -50,10 +74,19 @@ static sock_udp_ep_t gateway;
 
 static uint8_t rbuf[EMCUTE_BUFSIZE];
 static uint8_t tbuf[EMCUTE_BUFSIZE];
+/* transmit buffer for emcute_pub_async(), as syncsend() holds txlock while
+ * waiting for a response */
+static uint8_t pbuf[EMCUTE_BUFSIZE];
 
 static emcute_sub_t *subs = NULL;
 
 static mutex_t txlock;
+/* protects pbuf, the publish window and the topic ID cache */
+static mutex_t publock;
+
+static pub_slot_t pubs[EMCUTE_PUB_WINDOW];
+static topic_entry_t topics[EMCUTE_TOPIC_CACHE_SIZE];
+static unsigned topic_next = 0;
 
 static xtimer_t timer;
 static uint16_t id_next = 0x1234;
@@ -71,7 +104,7 @@ static size_t set_len(uint8_t *buf, size_t len)
     }
     else {
         buf[0] = 0x01;
-        byteorder_htobebufs(&tbuf[1], (uint16_t)(len + 3));
+        byteorder_htobebufs(&buf[1], (uint16_t)(len + 3));
         return 3;
     }
 }
@@ -88,6 +121,151 @@ static size_t get_len(uint8_t *buf, uint16_t *len)
     }
 }
 
+static uint16_t msg_id_next(void)
+{
+    /* shared by the txlock and the publock users */
+    unsigned state = irq_disable();
+    uint16_t id = id_next++;
+    irq_restore(state);
+    return id;
+}
+
+static uint16_t topic_cache_get(const char *name)
+{
+    uint16_t id = 0;
+
+    mutex_lock(&publock);
+    for (unsigned i = 0; i < EMCUTE_TOPIC_CACHE_SIZE; i++) {
+        if ((topics[i].id != 0) && (strcmp(topics[i].name, name) == 0)) {
+            id = topics[i].id;
+            break;
+        }
+    }
+    mutex_unlock(&publock);
+    return id;
+}
+
+static void topic_cache_put(const char *name, uint16_t id)
+{
+    size_t len = strlen(name);
+
+    if (len >= EMCUTE_TOPIC_CACHE_NAMELEN) {
+        return;
+    }
+    mutex_lock(&publock);
+    /* replace the entries round robin */
+    topic_entry_t *entry = &topics[topic_next];
+    topic_next = (topic_next + 1) % EMCUTE_TOPIC_CACHE_SIZE;
+    memcpy(entry->name, name, len + 1);
+    entry->id = id;
+    mutex_unlock(&publock);
+}
+
+/* @pre publock is locked */
+static void topic_cache_drop(uint16_t id)
+{
+    for (unsigned i = 0; i < EMCUTE_TOPIC_CACHE_SIZE; i++) {
+        if (topics[i].id == id) {
+            DEBUG("[emcute] topic cache: drop topic id %u\n", (unsigned)id);
+            topics[i].id = 0;
+        }
+    }
+}
+
+/* @pre publock is locked */
+static void pub_send(const pub_slot_t *pub)
+{
+    size_t pos = set_len(pbuf, (pub->len + 6));
+    pbuf[pos++] = PUBLISH;
+    pbuf[pos++] = pub->flags;
+    byteorder_htobebufs(&pbuf[pos], pub->topic_id);
+    pos += 2;
+    byteorder_htobebufs(&pbuf[pos], pub->msg_id);
+    pos += 2;
+    memcpy(&pbuf[pos], pub->data, pub->len);
+    sock_udp_send(&sock, pbuf, pos + pub->len, &gateway);
+}
+
+/* ends the publish message in the given slot and calls its callback with
+ * publock released
+ * @pre publock is locked */
+static void pub_done(pub_slot_t *pub, int res)
+{
+    emcute_pub_cb_t cb = pub->cb;
+    void *arg = pub->arg;
+
+    pub->tx = 0;
+    if (cb) {
+        mutex_unlock(&publock);
+        cb(arg, res);
+        mutex_lock(&publock);
+    }
+}
+
+/* ends all publish messages in the window and appends their callbacks to
+ * @p done, so the caller can call them once it released txlock. Returns the
+ * number of callbacks in @p done */
+static unsigned pub_abort(pub_cb_t *done, unsigned num)
+{
+    mutex_lock(&publock);
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        if (pubs[i].tx != 0) {
+            pubs[i].tx = 0;
+            if (pubs[i].cb) {
+                done[num].cb = pubs[i].cb;
+                done[num].arg = pubs[i].arg;
+                num++;
+            }
+        }
+    }
+    mutex_unlock(&publock);
+    return num;
+}
+
+static void pub_notify(const pub_cb_t *done, unsigned num, int res)
+{
+    for (unsigned i = 0; i < num; i++) {
+        done[i].cb(done[i].arg, res);
+    }
+}
+
+/* retransmits the publish messages due and returns the time until the next
+ * one is due */
+static uint32_t pub_retry(uint32_t now)
+{
+    /* messages put into the window while the emCute thread is waiting for a
+     * packet are not noticed before that returns, so wait at most T_RETRY */
+    uint32_t t_next = T_RETRY_US;
+
+    mutex_lock(&publock);
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        pub_slot_t *pub = &pubs[i];
+
+        if (pub->tx == 0) {
+            continue;
+        }
+        uint32_t elapsed = now - pub->sent;
+        if (elapsed < T_RETRY_US) {
+            if ((T_RETRY_US - elapsed) < t_next) {
+                t_next = T_RETRY_US - elapsed;
+            }
+            continue;
+        }
+        if (pub->tx > EMCUTE_N_RETRY) {
+            DEBUG("[emcute] pub: no PUBACK for msg id %u\n",
+                  (unsigned)pub->msg_id);
+            pub_done(pub, EMCUTE_TIMEOUT);
+            continue;
+        }
+        pub->flags |= EMCUTE_DUP;
+        pub->sent = now;
+        pub->tx++;
+        pub_send(pub);
+    }
+    mutex_unlock(&publock);
+    return t_next;
+}
+
 static void time_evt(void *arg)
 {
     thread_flags_set((thread_t *)arg, TFLAGS_TIMEOUT);
@@ -124,13 +302,32 @@ static int syncsend(uint8_t resp, size_t len, bool unlock)
     return res;
 }
 
-static void on_disconnect(void)
+/* drops the connection to the gateway, publish messages waiting for their
+ * PUBACK are done, see pub_abort() */
+static unsigned disconnected(pub_cb_t *done, unsigned num)
+{
+    gateway.port = 0;
+    return pub_abort(done, num);
+}
+
+static void on_disconnect(const sock_udp_ep_t *remote)
 {
+    pub_cb_t done[EMCUTE_PUB_WINDOW];
+    unsigned num = 0;
+
     if (waiton == DISCONNECT) {
-        gateway.port = 0;
+        num = disconnected(done, num);
         result = EMCUTE_OK;
+        /* the thread in emcute_discon() holds txlock until it got this */
         thread_flags_set((thread_t *)timer.arg, TFLAGS_RESP);
     }
+    else if ((gateway.port != 0) && (remote->port == gateway.port) &&
+             (memcmp(&remote->addr, &gateway.addr, sizeof(gateway.addr)) == 0)) {
+        /* the gateway closed the connection on its own */
+        LOG_DEBUG("[emcute] gateway disconnected\n");
+        num = disconnected(done, num);
+    }
+    pub_notify(done, num, EMCUTE_NOGW);
 }
 
 static void on_ack(uint8_t type, int id_pos, int ret_pos, int res_pos)
@@ -150,6 +347,27 @@ static void on_ack(uint8_t type, int id_pos, int ret_pos, int res_pos)
     }
 }
 
+static void on_puback(void)
+{
+    uint16_t id = byteorder_bebuftohs(&rbuf[4]);
+
+    mutex_lock(&publock);
+    if (rbuf[6] == REJ_INVTID) {
+        topic_cache_drop(byteorder_bebuftohs(&rbuf[2]));
+    }
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        if ((pubs[i].tx != 0) && (pubs[i].msg_id == id)) {
+            pub_done(&pubs[i], (rbuf[6] == ACCEPT) ? EMCUTE_OK
+                                                   : EMCUTE_REJECT);
+            mutex_unlock(&publock);
+            return;
+        }
+    }
+    mutex_unlock(&publock);
+    /* not a message of the window, so it may be the one of emcute_pub() */
+    on_ack(PUBACK, 4, 6, 0);
+}
+
 static void on_publish(size_t len, size_t pos)
 {
     /* make sure packet length is valid - if not, drop packet silently */
@@ -217,6 +435,9 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
 {
     int res;
     size_t len;
+    /* the window may fill up again while we wait for the gateway */
+    pub_cb_t done[2 * EMCUTE_PUB_WINDOW];
+    unsigned num;
 
     assert(!will_topic || (will_topic && will_msg && !(will_flags & ~PUB_FLAGS)));
 
@@ -224,10 +445,18 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
 
     /* check for existing connections and copy given UDP endpoint */
     if (gateway.port != 0) {
+        mutex_unlock(&txlock);
         return EMCUTE_NOGW;
     }
+    /* nothing of a previous connection must leak into the new one */
+    num = pub_abort(done, 0);
     memcpy(&gateway, remote, sizeof(sock_udp_ep_t));
 
+    /* topic IDs are only valid within a connection */
+    mutex_lock(&publock);
+    memset(topics, 0, sizeof(topics));
+    mutex_unlock(&publock);
+
     /* figure out which flags to set */
     uint8_t flags = (clean) ? EMCUTE_CS : 0;
     if (will_topic) {
@@ -248,14 +477,13 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
         size_t topic_len = strlen(will_topic);
         if ((topic_len > EMCUTE_TOPIC_MAXLEN) ||
             ((will_msg_len + 4) > EMCUTE_BUFSIZE)) {
-            gateway.port = 0;
-            return EMCUTE_OVERFLOW;
+            res = EMCUTE_OVERFLOW;
+            goto out;
         }
 
         res = syncsend(WILLTOPICREQ, len, false);
         if (res != EMCUTE_OK) {
-            gateway.port = 0;
-            return res;
+            goto out;
         }
 
         /* now send WILLTOPIC */
@@ -267,8 +495,7 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
 
         res = syncsend(WILLMSGREQ, len, false);
         if (res != EMCUTE_OK) {
-            gateway.port = 0;
-            return res;
+            goto out;
         }
 
         /* and WILLMSG afterwards */
@@ -278,10 +505,15 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
         memcpy(&tbuf[pos], will_msg, will_msg_len);
     }
 
-    res = syncsend(CONNACK, len, true);
+    res = syncsend(CONNACK, len, false);
+
+out:
     if (res != EMCUTE_OK) {
-        gateway.port = 0;
+        num = disconnected(done, num);
     }
+    mutex_unlock(&txlock);
+    /* the callbacks may publish again, which needs txlock */
+    pub_notify(done, num, EMCUTE_NOGW);
     return res;
 }
 
@@ -310,18 +542,25 @@ int emcute_reg(emcute_topic_t *topic)
         return EMCUTE_OVERFLOW;
     }
 
+    uint16_t id = topic_cache_get(topic->name);
+    if (id != 0) {
+        topic->id = id;
+        return EMCUTE_OK;
+    }
+
     mutex_lock(&txlock);
 
     tbuf[0] = (strlen(topic->name) + 6);
     tbuf[1] = REGISTER;
     byteorder_htobebufs(&tbuf[2], 0);
-    byteorder_htobebufs(&tbuf[4], id_next);
-    waitonid = id_next++;
+    waitonid = msg_id_next();
+    byteorder_htobebufs(&tbuf[4], waitonid);
     memcpy(&tbuf[6], topic->name, strlen(topic->name));
 
     int res = syncsend(REGACK, (size_t)tbuf[0], true);
     if (res > 0) {
         topic->id = (uint16_t)res;
+        topic_cache_put(topic->name, topic->id);
         res = EMCUTE_OK;
     }
     return res;
@@ -351,8 +590,8 @@ int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
     tbuf[pos++] = flags;
     byteorder_htobebufs(&tbuf[pos], topic->id);
     pos += 2;
-    byteorder_htobebufs(&tbuf[pos], id_next);
-    waitonid = id_next++;
+    waitonid = msg_id_next();
+    byteorder_htobebufs(&tbuf[pos], waitonid);
     pos += 2;
     memcpy(&tbuf[pos], data, len);
 
@@ -367,6 +606,49 @@ int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
     return res;
 }
 
+int emcute_pub_async(emcute_topic_t *topic, const void *data, size_t len,
+                     unsigned flags, emcute_pub_cb_t cb, void *arg)
+{
+    pub_slot_t tmp;
+    pub_slot_t *pub = &tmp;
+
+    assert((topic->id != 0) && data && (len > 0) && !(flags & ~PUB_FLAGS));
+
+    if (gateway.port == 0) {
+        return EMCUTE_NOGW;
+    }
+    if (len >= (EMCUTE_BUFSIZE - 9)) {
+        return EMCUTE_OVERFLOW;
+    }
+    if (flags & EMCUTE_QOS_2) {
+        return EMCUTE_NOTSUP;
+    }
+
+    mutex_lock(&publock);
+
+    if (flags & EMCUTE_QOS_1) {
+        for (pub = pubs; (pub < &pubs[EMCUTE_PUB_WINDOW]) && (pub->tx != 0);
+             pub++) {}
+        if (pub == &pubs[EMCUTE_PUB_WINDOW]) {
+            mutex_unlock(&publock);
+            return EMCUTE_OVERFLOW;
+        }
+    }
+    pub->cb = cb;
+    pub->arg = arg;
+    pub->data = data;
+    pub->len = (uint16_t)len;
+    pub->msg_id = msg_id_next();
+    pub->topic_id = topic->id;
+    pub->flags = (uint8_t)flags;
+    pub->sent = xtimer_now_usec();
+    pub->tx = 1;
+    pub_send(pub);
+
+    mutex_unlock(&publock);
+    return EMCUTE_OK;
+}
+
 int emcute_sub(emcute_sub_t *sub, unsigned flags)
 {
     assert(sub && (sub->cb) && (sub->topic.name) && !(flags & ~SUB_FLAGS));
@@ -383,8 +665,8 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = SUBSCRIBE;
     tbuf[2] = flags;
-    byteorder_htobebufs(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = msg_id_next();
+    byteorder_htobebufs(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(SUBACK, (size_t)tbuf[0], false);
@@ -419,8 +701,8 @@ int emcute_unsub(emcute_sub_t *sub)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = UNSUBSCRIBE;
     tbuf[2] = 0;
-    byteorder_htobebufs(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = msg_id_next();
+    byteorder_htobebufs(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(UNSUBACK, (size_t)tbuf[0], false);
@@ -502,6 +784,7 @@ void emcute_run(uint16_t port, const char *id)
     timer.callback = time_evt;
     timer.arg = NULL;
     mutex_init(&txlock);
+    mutex_init(&publock);
 
     if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
         LOG_ERROR("[emcute] unable to open UDP socket on port %i\n", (int)port);
@@ -541,12 +824,12 @@ void emcute_run(uint16_t port, const char *id)
                 case WILLMSGREQ:    on_ack(type, 0, 0, 0);              break;
                 case REGACK:        on_ack(type, 4, 6, 2);              break;
                 case PUBLISH:       on_publish((size_t)pkt_len, pos);   break;
-                case PUBACK:        on_ack(type, 4, 6, 0);              break;
+                case PUBACK:        on_puback();                        break;
                 case SUBACK:        on_ack(type, 5, 7, 3);              break;
                 case UNSUBACK:      on_ack(type, 2, 0, 0);              break;
                 case PINGREQ:       on_pingreq(&remote);                break;
                 case PINGRESP:      on_pingresp();                      break;
-                case DISCONNECT:    on_disconnect();                    break;
+                case DISCONNECT:    on_disconnect(&remote);             break;
                 case WILLTOPICRESP: on_ack(type, 0, 0, 0);              break;
                 case WILLMSGRESP:   on_ack(type, 0, 0, 0);              break;
                 default:
@@ -564,5 +847,9 @@ void emcute_run(uint16_t port, const char *id)
         else {
             t_out = (EMCUTE_KEEPALIVE * US_PER_SEC) - (now - start);
         }
+        uint32_t t_retry = pub_retry(now);
+        if (t_retry < t_out) {
+            t_out = t_retry;
+        }
     }
 }
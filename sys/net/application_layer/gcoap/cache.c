@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       Response cache for the gcoap server
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+#include "xtimer.h"
+#include "cache.h"
+
+#ifdef MODULE_GCOAP_CACHE
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* keeps expiry times comparable across a wrap around of the clock */
+#define MAX_AGE_MAX         ((uint32_t)INT32_MAX)
+/* bytes the options of a cached response may grow by when replacing its
+ * Max-Age: the option itself and the extended delta of the next option */
+#define MAX_AGE_GROWTH      (8U)
+
+enum {
+    PENDING_NONE = 0,
+    PENDING_STORE,          /* response to a GET request missing the cache */
+    PENDING_INVALIDATE,     /* response to an unsafe request */
+    PENDING_FLUSH,          /* response to an unsafe request without key */
+};
+
+typedef struct {
+    uint32_t expires;       /* in seconds */
+    uint32_t used;          /* time of last use for LRU, 0 if entry is unused */
+    uint16_t key_len;
+    uint16_t resp_len;
+    uint8_t data[CONFIG_GCOAP_CACHE_ENTRY_SIZE];    /* key, then response */
+} _entry_t;
+
+static _entry_t _entries[CONFIG_GCOAP_CACHE_ENTRIES_MAX];
+/* key of the request of the last call to gcoap_cache_get() */
+static uint8_t _key[CONFIG_GCOAP_CACHE_ENTRY_SIZE];
+static uint16_t _key_len;
+static uint8_t _pending;
+static uint32_t _clock;
+/* parsed response of an entry; static to spare the stack of the gcoap
+ * thread */
+static coap_pkt_t _resp;
+
+static inline uint32_t _now_sec(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static inline void _touch(_entry_t *entry)
+{
+    if (++_clock == 0) {
+        /* keep 0 for unused entries */
+        _clock++;
+    }
+    entry->used = _clock;
+}
+
+static inline bool _is_uri(unsigned opt_num)
+{
+    return (opt_num == COAP_OPT_URI_HOST) || (opt_num == COAP_OPT_URI_PORT) ||
+           (opt_num == COAP_OPT_URI_PATH) || (opt_num == COAP_OPT_URI_QUERY);
+}
+
+/* RFC 7252, section 5.4.6: options with bits 1-4 set to 0b1110 are
+ * NoCacheKey. ETag and Observe don't select a different response either */
+static inline bool _is_key(unsigned opt_num)
+{
+    return (opt_num != COAP_OPT_ETAG) && (opt_num != COAP_OPT_OBSERVE) &&
+           ((opt_num & 0x1e) != 0x1c);
+}
+
+/* writes the option number, length and value of each key option of a request
+ * to _key */
+static int _make_key(coap_pkt_t *pdu)
+{
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t optlen;
+
+    _key_len = 0;
+    for (bool init = true;
+         (optlen = coap_opt_get_next(pdu, &opt, &value, init)) >= 0;
+         init = false) {
+        if (!_is_key(opt.opt_num)) {
+            continue;
+        }
+        if ((opt.opt_num > UINT8_MAX) || (optlen > UINT8_MAX) ||
+            ((_key_len + 2U + (size_t)optlen) > sizeof(_key))) {
+            DEBUG("gcoap_cache: key too long\n");
+            return -ENOSPC;
+        }
+        _key[_key_len++] = opt.opt_num;
+        _key[_key_len++] = optlen;
+        memcpy(&_key[_key_len], value, optlen);
+        _key_len += optlen;
+    }
+    return 0;
+}
+
+/* compares the URI options of two keys */
+static bool _uri_equal(const uint8_t *a, size_t a_len,
+                       const uint8_t *b, size_t b_len)
+{
+    size_t i = 0, j = 0;
+
+    while (1) {
+        while ((i < a_len) && !_is_uri(a[i])) {
+            i += 2 + a[i + 1];
+        }
+        while ((j < b_len) && !_is_uri(b[j])) {
+            j += 2 + b[j + 1];
+        }
+        if ((i >= a_len) || (j >= b_len)) {
+            return (i >= a_len) && (j >= b_len);
+        }
+        if ((a[i] != b[j]) || (a[i + 1] != b[j + 1]) ||
+            (memcmp(&a[i + 2], &b[j + 2], a[i + 1]) != 0)) {
+            return false;
+        }
+        i += 2 + a[i + 1];
+        j += 2 + b[j + 1];
+    }
+}
+
+static _entry_t *_find(uint32_t now)
+{
+    for (unsigned i = 0; i < CONFIG_GCOAP_CACHE_ENTRIES_MAX; i++) {
+        _entry_t *entry = &_entries[i];
+
+        if ((entry->used != 0) && (entry->key_len == _key_len) &&
+            (memcmp(entry->data, _key, _key_len) == 0)) {
+            if ((int32_t)(entry->expires - now) <= 0) {
+                DEBUG("gcoap_cache: entry %u expired\n", i);
+                entry->used = 0;
+                return NULL;
+            }
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/* checks if the request carries the ETag of _resp */
+static bool _etag_match(const coap_pkt_t *pdu)
+{
+    coap_optpos_t opt;
+    uint8_t *etag, *value;
+    ssize_t etag_len, len;
+
+    etag_len = coap_opt_get_next_by_num(&_resp, &opt, COAP_OPT_ETAG, &etag,
+                                        true);
+    if (etag_len < 0) {
+        return false;
+    }
+    for (bool init = true;
+         (len = coap_opt_get_next_by_num(pdu, &opt, COAP_OPT_ETAG, &value,
+                                         init)) >= 0;
+         init = false) {
+        if ((len == etag_len) && (memcmp(value, etag, len) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ssize_t gcoap_cache_get(coap_pkt_t *pdu, uint8_t *buf, size_t len)
+{
+    uint32_t now = _now_sec();
+    unsigned hdr_len = coap_get_total_hdr_len(pdu);
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t optlen, res;
+    _entry_t *entry;
+    bool valid, max_age_added = false;
+
+    _pending = PENDING_NONE;
+    if (coap_get_code_raw(pdu) != COAP_METHOD_GET) {
+        /* without the URI of the request, any cached response may be stale
+         * after it */
+        _pending = (_make_key(pdu) < 0) ? PENDING_FLUSH : PENDING_INVALIDATE;
+        return 0;
+    }
+    if (coap_has_observe(pdu) || (_make_key(pdu) < 0)) {
+        return 0;
+    }
+    if ((entry = _find(now)) == NULL) {
+        _pending = PENDING_STORE;
+        return 0;
+    }
+    if (coap_parse(&_resp, &entry->data[entry->key_len], entry->resp_len) < 0) {
+        entry->used = 0;
+        return 0;
+    }
+    if (((hdr_len + entry->resp_len - coap_get_total_hdr_len(&_resp) +
+          MAX_AGE_GROWTH) > len) || (_resp.options_len >= NANOCOAP_NOPTS_MAX)) {
+        DEBUG("gcoap_cache: cached response does not fit\n");
+        return 0;
+    }
+    _touch(entry);
+
+    /* overwrites the request from here on, so check its ETags first */
+    valid = _etag_match(pdu);
+    if (coap_get_type(pdu) == COAP_TYPE_CON) {
+        coap_hdr_set_type(pdu->hdr, COAP_TYPE_ACK);
+    }
+    coap_hdr_set_code(pdu->hdr, valid ? COAP_CODE_VALID
+                                      : coap_get_code_raw(&_resp));
+    pdu->options_len = 0;
+    pdu->payload = buf + hdr_len;
+    pdu->payload_len = len - hdr_len;
+
+    /* Max-Age counts down the remaining freshness */
+    for (bool init = true;
+         (optlen = coap_opt_get_next(&_resp, &opt, &value, init)) >= 0;
+         init = false) {
+        if (!max_age_added && (opt.opt_num >= COAP_OPT_MAX_AGE)) {
+            coap_opt_add_uint(pdu, COAP_OPT_MAX_AGE, entry->expires - now);
+            max_age_added = true;
+        }
+        if ((opt.opt_num == COAP_OPT_MAX_AGE) ||
+            (valid && (opt.opt_num != COAP_OPT_ETAG))) {
+            continue;
+        }
+        coap_opt_add_opaque(pdu, opt.opt_num, value, optlen);
+    }
+    if (!max_age_added) {
+        coap_opt_add_uint(pdu, COAP_OPT_MAX_AGE, entry->expires - now);
+    }
+    DEBUG("gcoap_cache: hit, %s\n", valid ? "valid" : "content");
+    if (valid || (_resp.payload_len == 0)) {
+        return coap_opt_finish(pdu, COAP_OPT_FINISH_NONE);
+    }
+    res = coap_opt_finish(pdu, COAP_OPT_FINISH_PAYLOAD);
+    memcpy(pdu->payload, _resp.payload, _resp.payload_len);
+    return res + _resp.payload_len;
+}
+
+void gcoap_cache_put(uint8_t *buf, size_t len)
+{
+    uint8_t pending = _pending;
+    uint32_t max_age = 0;
+    _entry_t *entry = &_entries[0];
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t optlen;
+
+    _pending = PENDING_NONE;
+    if ((pending == PENDING_NONE) || (coap_parse(&_resp, buf, len) < 0)) {
+        return;
+    }
+    if (pending != PENDING_STORE) {
+        /* RFC 7252, section 5.9.1 */
+        if (coap_get_code_class(&_resp) != COAP_CLASS_SUCCESS) {
+            return;
+        }
+        for (unsigned i = 0; i < CONFIG_GCOAP_CACHE_ENTRIES_MAX; i++) {
+            if ((_entries[i].used != 0) &&
+                ((pending == PENDING_FLUSH) ||
+                 _uri_equal(_entries[i].data, _entries[i].key_len,
+                            _key, _key_len))) {
+                DEBUG("gcoap_cache: invalidate entry %u\n", i);
+                _entries[i].used = 0;
+            }
+        }
+        return;
+    }
+    if ((coap_get_code_raw(&_resp) != COAP_CODE_CONTENT) ||
+        coap_has_observe(&_resp) || ((_key_len + len) > sizeof(entry->data))) {
+        return;
+    }
+    /* only responses the handler gave a Max-Age are cached, the default
+     * Max-Age of 60 s is too long for many resources */
+    optlen = coap_opt_get_next_by_num(&_resp, &opt, COAP_OPT_MAX_AGE, &value,
+                                      true);
+    if ((optlen < 0) || (optlen > 4)) {
+        return;
+    }
+    for (ssize_t i = 0; i < optlen; i++) {
+        max_age = (max_age << 8) | value[i];
+    }
+    if (max_age == 0) {
+        return;
+    }
+    if (max_age > MAX_AGE_MAX) {
+        max_age = MAX_AGE_MAX;
+    }
+
+    /* take an unused entry or replace the least recently used one */
+    for (unsigned i = 1; i < CONFIG_GCOAP_CACHE_ENTRIES_MAX; i++) {
+        if (_entries[i].used < entry->used) {
+            entry = &_entries[i];
+        }
+    }
+    memcpy(entry->data, _key, _key_len);
+    memcpy(&entry->data[_key_len], buf, len);
+    entry->key_len = _key_len;
+    entry->resp_len = len;
+    entry->expires = _now_sec() + max_age;
+    _touch(entry);
+    DEBUG("gcoap_cache: stored %u bytes for %" PRIu32 " s\n", (unsigned)len,
+          max_age);
+}
+#else
+typedef int dont_be_pedantic;
+#endif  /* MODULE_GCOAP_CACHE */
+
+/** @} */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @internal
+ * @{
+ *
+ * @file
+ * @brief       Response cache for the gcoap server
+ *
+ * Only to be used from the gcoap thread: the cache remembers the request
+ * passed to gcoap_cache_get() until the response to it is passed to
+ * gcoap_cache_put().
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc7252#section-5.6">
+ *          RFC 7252, section 5.6
+ *      </a>
+ */
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "net/nanocoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Answers a request from the cache
+ *
+ * @param[in,out] pdu   A request, parsed from @p buf. Overwritten with the
+ *                      response on a cache hit.
+ * @param[out] buf      Buffer holding @p pdu, to write the response to.
+ * @param[in] len       Length of @p buf.
+ *
+ * @return  Length of the response written to @p buf, on a cache hit.
+ * @return  0, if the request must be passed to the resource handler.
+ */
+ssize_t gcoap_cache_get(coap_pkt_t *pdu, uint8_t *buf, size_t len);
+
+/**
+ * @brief   Takes note of the response to the request of the last call to
+ *          gcoap_cache_get()
+ *
+ * Caches the response to a GET request or removes the cached responses for
+ * the URI of an unsafe request, as appropriate.
+ *
+ * @param[in] buf   The response PDU.
+ * @param[in] len   Length of the response PDU.
+ */
+void gcoap_cache_put(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_H */
+/** @} */
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @{
+ *
+ * @file
+ * @brief       CoCoA retransmission timeout estimation for gcoap
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/gcoap.h"
+#include "net/sock/util.h"
+#include "xtimer.h"
+#include "cocoa.h"
+
+#ifdef MODULE_GCOAP_COCOA
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define RTO_INIT        ((uint32_t)COAP_ACK_TIMEOUT * US_PER_SEC)
+/* upper bound for RTO and backed off timeouts */
+#define RTO_MAX         (60U * US_PER_SEC)
+/* bounds of the RTO for backoff factors and aging */
+#define RTO_SHORT       (1U * US_PER_SEC)
+#define RTO_LONG        (3U * US_PER_SEC)
+/* RTT samples of requests with more transmissions are ambiguous */
+#define WEAK_TX_MAX     (3U)
+
+enum {
+    STRONG = 0,
+    WEAK,
+    ESTIMATORS_NUMOF,
+};
+
+typedef struct {
+    sock_udp_ep_t remote;
+    uint32_t srtt[ESTIMATORS_NUMOF];
+    uint32_t rttvar[ESTIMATORS_NUMOF];
+    uint32_t rto;               /* overall RTO, 0 if entry is unused */
+    uint64_t updated;           /* time of last update or aging */
+    uint8_t valid;              /* estimators with a sample, bit per estimator */
+} _estimate_t;
+
+static mutex_t _mutex = MUTEX_INIT;
+static _estimate_t _estimates[CONFIG_GCOAP_COCOA_ENDPOINTS_MAX];
+
+static _estimate_t *_get(const sock_udp_ep_t *remote)
+{
+    for (unsigned i = 0; i < CONFIG_GCOAP_COCOA_ENDPOINTS_MAX; i++) {
+        if ((_estimates[i].rto != 0) &&
+            sock_udp_ep_equal(&_estimates[i].remote, remote)) {
+            return &_estimates[i];
+        }
+    }
+    return NULL;
+}
+
+static _estimate_t *_add(const sock_udp_ep_t *remote, uint64_t now)
+{
+    _estimate_t *res = &_estimates[0];
+
+    /* take an unused entry or replace the least recently updated one */
+    for (unsigned i = 0; (i < CONFIG_GCOAP_COCOA_ENDPOINTS_MAX) &&
+                         (res->rto != 0); i++) {
+        if ((_estimates[i].rto == 0) ||
+            (_estimates[i].updated < res->updated)) {
+            res = &_estimates[i];
+        }
+    }
+    memset(res, 0, sizeof(*res));
+    memcpy(&res->remote, remote, sizeof(res->remote));
+    res->rto = RTO_INIT;
+    res->updated = now;
+    return res;
+}
+
+/* lets an RTO not updated for a while move back towards RTO_INIT */
+static void _age(_estimate_t *estimate, uint64_t now)
+{
+    uint64_t idle = now - estimate->updated;
+
+    if ((estimate->rto < RTO_SHORT) && (idle > (16ULL * estimate->rto))) {
+        estimate->rto *= 2;
+        estimate->updated = now;
+    }
+    else if ((estimate->rto > RTO_LONG) && (idle > (4ULL * estimate->rto))) {
+        estimate->rto = (RTO_INIT + estimate->rto) / 2;
+        estimate->updated = now;
+    }
+}
+
+/* RFC 6298, section 2, with K = 4 for the strong and K = 1 for the weak
+ * estimator */
+static uint32_t _estimate(_estimate_t *estimate, unsigned estimator,
+                          uint32_t rtt)
+{
+    uint32_t *srtt = &estimate->srtt[estimator];
+    uint32_t *rttvar = &estimate->rttvar[estimator];
+
+    if (estimate->valid & (1U << estimator)) {
+        uint32_t delta = (*srtt > rtt) ? (*srtt - rtt) : (rtt - *srtt);
+
+        *rttvar = ((3 * *rttvar) + delta) / 4;
+        *srtt = ((7 * *srtt) + rtt) / 8;
+    }
+    else {
+        estimate->valid |= (1U << estimator);
+        *srtt = rtt;
+        *rttvar = rtt / 2;
+    }
+    return *srtt + (((estimator == STRONG) ? 4 : 1) * *rttvar);
+}
+
+uint32_t gcoap_cocoa_rto(const sock_udp_ep_t *remote)
+{
+    uint32_t res = RTO_INIT;
+    _estimate_t *estimate;
+
+    mutex_lock(&_mutex);
+    if ((estimate = _get(remote)) != NULL) {
+        _age(estimate, xtimer_now_usec64());
+        res = estimate->rto;
+    }
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+uint32_t gcoap_cocoa_backoff(uint32_t rto, unsigned retrans)
+{
+    /* variable backoff factor in halves */
+    unsigned vbf = (rto < RTO_SHORT) ? 6 : ((rto > RTO_LONG) ? 3 : 4);
+
+    while ((retrans-- > 0) && (rto < RTO_MAX)) {
+        rto = (rto / 2) * vbf;
+    }
+    return (rto > RTO_MAX) ? RTO_MAX : rto;
+}
+
+void gcoap_cocoa_update(const sock_udp_ep_t *remote, uint32_t rtt,
+                        unsigned transmissions)
+{
+    uint64_t now = xtimer_now_usec64();
+    _estimate_t *estimate;
+    uint32_t rto;
+
+    if (transmissions > WEAK_TX_MAX) {
+        DEBUG("gcoap_cocoa: ignore RTT after %u transmissions\n",
+              transmissions);
+        return;
+    }
+    if (rtt > RTO_MAX) {
+        rtt = RTO_MAX;
+    }
+    mutex_lock(&_mutex);
+    if ((estimate = _get(remote)) == NULL) {
+        estimate = _add(remote, now);
+    }
+    if (transmissions <= 1) {
+        rto = _estimate(estimate, STRONG, rtt);
+        estimate->rto = (rto + estimate->rto) / 2;
+    }
+    else {
+        rto = _estimate(estimate, WEAK, rtt);
+        estimate->rto = (rto + (3 * estimate->rto)) / 4;
+    }
+    if (estimate->rto > RTO_MAX) {
+        estimate->rto = RTO_MAX;
+    }
+    else if (estimate->rto == 0) {
+        /* keep the entry in use */
+        estimate->rto = 1;
+    }
+    estimate->updated = now;
+    DEBUG("gcoap_cocoa: RTT %" PRIu32 " us after %u transmissions, "
+          "RTO %" PRIu32 " us\n", rtt, transmissions, estimate->rto);
+    mutex_unlock(&_mutex);
+}
+#else
+typedef int dont_be_pedantic;
+#endif  /* MODULE_GCOAP_COCOA */
+
+/** @} */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gcoap
+ * @internal
+ * @{
+ *
+ * @file
+ * @brief       CoCoA retransmission timeout estimation for gcoap
+ *
+ * @see <a href="https://tools.ietf.org/html/draft-ietf-core-cocoa-03">
+ *          draft-ietf-core-cocoa-03
+ *      </a>
+ */
+#ifndef COCOA_H
+#define COCOA_H
+
+#include <stdint.h>
+
+#include "net/sock/udp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Gets the retransmission timeout for a remote endpoint
+ *
+ * @param[in] remote    A remote endpoint.
+ *
+ * @return  The RTO estimated for @p remote in microseconds, or the initial
+ *          RTO if there is no estimate for @p remote.
+ */
+uint32_t gcoap_cocoa_rto(const sock_udp_ep_t *remote);
+
+/**
+ * @brief   Gets the timeout for a transmission of a confirmable request
+ *
+ * Applies the variable backoff factor of CoCoA @p retrans times to @p rto.
+ *
+ * @param[in] rto       RTO of the remote endpoint at the first transmission
+ *                      in microseconds, as returned by gcoap_cocoa_rto().
+ * @param[in] retrans   Number of retransmissions so far.
+ *
+ * @return  The timeout in microseconds, not dithered yet.
+ */
+uint32_t gcoap_cocoa_backoff(uint32_t rto, unsigned retrans);
+
+/**
+ * @brief   Updates the RTO estimate for a remote endpoint
+ *
+ * @param[in] remote        The remote endpoint a response came from.
+ * @param[in] rtt           Time between the first transmission of the request
+ *                          and the response in microseconds.
+ * @param[in] transmissions Number of transmissions of the request.
+ */
+void gcoap_cocoa_update(const sock_udp_ep_t *remote, uint32_t rtt,
+                        unsigned transmissions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COCOA_H */
+/** @} */
@@ -32,6 +32,13 @@
 #include "mutex.h"
 #include "random.h"
 #include "thread.h"
+#ifdef MODULE_GCOAP_CACHE
+#include "cache.h"
+#endif
+#ifdef MODULE_GCOAP_COCOA
+#include "xtimer.h"
+#include "cocoa.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -44,22 +51,52 @@
 /* End of the range to pick a random timeout */
 #define TIMEOUT_RANGE_END (COAP_ACK_TIMEOUT * COAP_RANDOM_FACTOR_1000 / 1000)
 
+/* FNV-1a parameters for the hash tables */
+#define HASH_INIT       (2166136261U)
+#define HASH_PRIME      (16777619U)
+
+#if (CONFIG_GCOAP_REQ_WAITING_MAX >= UINT16_MAX) || \
+    (CONFIG_GCOAP_OBS_CLIENTS_MAX >= UINT16_MAX) || \
+    (CONFIG_GCOAP_OBS_REGISTRATIONS_MAX >= UINT16_MAX)
+#error "gcoap: tables must have less than UINT16_MAX entries"
+#endif
+
+/* Position of an entry in one of the tables of gcoap_state_t plus one, so
+ * zero can terminate the chains of a hash table */
+typedef uint16_t gcoap_idx_t;
+
+#ifdef MODULE_GCOAP_TCP
+/* RFC 8323, section 5.3.1: default until the peer's CSM says otherwise */
+#define TCP_PEER_MSG_SIZE_DEFAULT   (1152U)
+/* largest message that fits into _listen_buf behind the headroom */
+#define TCP_MSG_SIZE_MAX            (CONFIG_GCOAP_PDU_BUF_SIZE - COAP_TCP_HEADROOM)
+#endif
+
 /* Internal functions */
 static void *_event_loop(void *arg);
 static void _on_sock_evt(sock_udp_t *sock, sock_async_flags_t type);
+#ifdef MODULE_GCOAP_TCP
+static void _on_tcp_queue_evt(sock_tcp_queue_t *queue, sock_async_flags_t type);
+static void _on_tcp_evt(sock_tcp_t *sock, sock_async_flags_t type);
+#endif
 static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                                                          sock_udp_ep_t *remote);
 static void _expire_request(gcoap_request_memo_t *memo);
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *pdu,
                            const sock_udp_ep_t *remote);
+static void _release_req_memo(gcoap_request_memo_t *memo);
 static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
                                             gcoap_listener_t **listener_ptr);
-static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote);
+static sock_udp_ep_t *_find_observer(const sock_udp_ep_t *remote);
+static sock_udp_ep_t *_add_observer(const sock_udp_ep_t *remote);
 static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu);
 static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource);
+static void _link_obs_memo(gcoap_observe_memo_t *memo);
+static void _unlink_obs_memo(gcoap_observe_memo_t *memo);
+static void _remove_obs_memo(gcoap_observe_memo_t *memo);
 
 /* Internal variables */
 const coap_resource_t _default_resources[] = {
@@ -81,12 +118,40 @@ typedef struct {
                                         /* Storage for open requests; if first
                                            byte of an entry is zero, the entry
                                            is available */
+    gcoap_idx_t open_reqs_hash[CONFIG_GCOAP_REQ_WAITING_MAX];
+                                        /* Open requests by token and remote */
+    gcoap_idx_t open_reqs_next[CONFIG_GCOAP_REQ_WAITING_MAX];
+                                        /* Next open request in the same hash
+                                           chain, or next available one */
+    gcoap_idx_t open_reqs_free;         /* First available open request */
+    gcoap_idx_t con_reqs_hash[CONFIG_GCOAP_REQ_WAITING_MAX];
+                                        /* Open confirmable requests by
+                                           remote */
+    gcoap_idx_t con_reqs_next[CONFIG_GCOAP_REQ_WAITING_MAX];
+                                        /* Next open confirmable request in
+                                           the same con_reqs_hash chain */
     atomic_uint next_message_id;        /* Next message ID to use */
     sock_udp_ep_t observers[CONFIG_GCOAP_OBS_CLIENTS_MAX];
                                         /* Observe clients; allows reuse for
                                            observe memos */
+    gcoap_idx_t observers_hash[CONFIG_GCOAP_OBS_CLIENTS_MAX];
+                                        /* Observe clients by endpoint */
+    gcoap_idx_t observers_next[CONFIG_GCOAP_OBS_CLIENTS_MAX];
+                                        /* Next client in the same hash chain */
+    gcoap_idx_t observers_memos[CONFIG_GCOAP_OBS_CLIENTS_MAX];
+                                        /* Number of observe memos per client */
     gcoap_observe_memo_t observe_memos[CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
                                         /* Observed resource registrations */
+    gcoap_idx_t observe_memos_hash[CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
+                                        /* Registrations by client and token */
+    gcoap_idx_t observe_memos_next[CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
+                                        /* Next registration in the same
+                                           observe_memos_hash chain */
+    gcoap_idx_t observe_memos_res_hash[CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
+                                        /* Registrations by resource */
+    gcoap_idx_t observe_memos_res_next[CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
+                                        /* Next registration in the same
+                                           observe_memos_res_hash chain */
     uint8_t resend_bufs[CONFIG_GCOAP_RESEND_BUFS_MAX][CONFIG_GCOAP_PDU_BUF_SIZE];
                                         /* Buffers for PDU for request resends;
                                            if first byte of an entry is zero,
@@ -103,6 +168,19 @@ static event_queue_t _queue;
 static uint8_t _listen_buf[CONFIG_GCOAP_PDU_BUF_SIZE];
 static sock_udp_t _sock;
 
+#ifdef MODULE_GCOAP_TCP
+/* State of a CoAP over TCP connection */
+typedef struct {
+    size_t len;                         /* Bytes received in buf */
+    size_t peer_msg_size;               /* Max-Message-Size of the peer */
+    uint8_t buf[TCP_MSG_SIZE_MAX];      /* Received bytes not processed yet */
+} gcoap_tcp_conn_t;
+
+static sock_tcp_queue_t _tcp_queue;
+static sock_tcp_t _tcp_socks[CONFIG_GCOAP_TCP_CONNS_MAX];
+static gcoap_tcp_conn_t _tcp_conns[CONFIG_GCOAP_TCP_CONNS_MAX];
+#endif
+
 /* Event loop for gcoap _pid thread. */
 static void *_event_loop(void *arg)
 {
@@ -122,6 +200,17 @@ static void *_event_loop(void *arg)
 
     event_queue_init(&_queue);
     sock_udp_event_init(&_sock, &_queue, _on_sock_evt);
+#ifdef MODULE_GCOAP_TCP
+    local.port = CONFIG_GCOAP_TCP_PORT;
+    res = sock_tcp_listen(&_tcp_queue, &local, _tcp_socks,
+                          CONFIG_GCOAP_TCP_CONNS_MAX, 0);
+    if (res < 0) {
+        DEBUG("gcoap: cannot listen on TCP: %d\n", res);
+    }
+    else {
+        sock_tcp_queue_event_init(&_tcp_queue, &_queue, _on_tcp_queue_evt);
+    }
+#endif
     event_loop(&_queue);
 
     return 0;
@@ -187,15 +276,19 @@ static void _on_sock_evt(sock_udp_t *sock, sock_async_flags_t type)
                     if (memo->resp_evt_tmout.queue) {
                         event_timeout_clear(&memo->resp_evt_tmout);
                     }
+#ifdef MODULE_GCOAP_COCOA
+                    if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
+                        gcoap_cocoa_update(&remote,
+                                           xtimer_now_usec() - memo->send_time,
+                                           COAP_MAX_RETRANSMIT + 1 -
+                                           memo->send_limit);
+                    }
+#endif
                     memo->state = GCOAP_MEMO_RESP;
                     if (memo->resp_handler) {
                         memo->resp_handler(memo, &pdu, &remote);
                     }
-
-                    if (memo->send_limit >= 0) {        /* if confirmable */
-                        *memo->msg.data.pdu_buf = 0;    /* clear resend PDU buffer */
-                    }
-                    memo->state = GCOAP_MEMO_UNUSED;
+                    _release_req_memo(memo);
                     break;
                 case COAP_TYPE_CON:
                     DEBUG("gcoap: separate CON response not handled yet\n");
@@ -215,6 +308,229 @@ static void _on_sock_evt(sock_udp_t *sock, sock_async_flags_t type)
     }
 }
 
+#ifdef MODULE_GCOAP_TCP
+/* Sends a message built with a CoAP over UDP header on a TCP connection. */
+static void _tcp_send(sock_tcp_t *sock, coap_pkt_t *pdu, size_t len)
+{
+    gcoap_tcp_conn_t *conn = &_tcp_conns[sock - _tcp_socks];
+    uint8_t *msg;
+    ssize_t res = coap_tcp_frame(pdu, len, &msg);
+
+    if ((res < 0) || ((size_t)res > conn->peer_msg_size)) {
+        DEBUG("gcoap: TCP message too large: %u\n", (unsigned)len);
+        return;
+    }
+    res = sock_tcp_write(sock, msg, res);
+    if (res < 0) {
+        DEBUG("gcoap: TCP send failed: %d\n", (int)res);
+    }
+}
+
+/* Sends a signaling message without token; a CSM announces the size of the
+ * messages we accept. */
+static void _tcp_signal(sock_tcp_t *sock, unsigned code)
+{
+    /* header and Max-Message-Size option */
+    uint8_t buf[sizeof(coap_hdr_t) + 5];
+    coap_pkt_t pdu;
+    size_t len = coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON, NULL, 0,
+                                code, 0);
+
+    coap_pkt_init(&pdu, buf, sizeof(buf), len);
+    if (code == COAP_CODE_CSM) {
+        coap_opt_add_uint(&pdu, COAP_SIGNAL_OPT_MAX_MSG_SIZE, TCP_MSG_SIZE_MAX);
+    }
+    _tcp_send(sock, &pdu, coap_opt_finish(&pdu, COAP_OPT_FINISH_NONE));
+}
+
+static void _tcp_close(sock_tcp_t *sock)
+{
+    DEBUG("gcoap: closing TCP connection %u\n", (unsigned)(sock - _tcp_socks));
+    _tcp_conns[sock - _tcp_socks].len = 0;
+    sock_tcp_disconnect(sock);
+}
+
+/*
+ * Handles a complete CoAP over TCP message, parsed from _listen_buf.
+ *
+ * return <0 if the connection must be closed
+ */
+static int _tcp_handle(sock_tcp_t *sock, coap_pkt_t *pdu)
+{
+    gcoap_tcp_conn_t *conn = &_tcp_conns[sock - _tcp_socks];
+    sock_tcp_ep_t remote;
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t res;
+
+    switch (coap_get_code_class(pdu)) {
+    case COAP_CLASS_REQ:
+        if (coap_get_code_raw(pdu) == COAP_CODE_EMPTY) {
+            /* RFC 8323, section 3.4: empty messages are ignored */
+            return 0;
+        }
+        /* notifications go out on the UDP sock only */
+        coap_clear_observe(pdu);
+        if (sock_tcp_get_remote(sock, &remote) < 0) {
+            return -ENOTCONN;
+        }
+        res = _handle_req(pdu, (uint8_t *)pdu->hdr,
+                          &_listen_buf[sizeof(_listen_buf)] -
+                          (uint8_t *)pdu->hdr, &remote);
+        if (res > 0) {
+            _tcp_send(sock, pdu, res);
+        }
+        return 0;
+    case COAP_CLASS_SIGNAL:
+        switch (coap_get_code_raw(pdu)) {
+        case COAP_CODE_CSM:
+            res = coap_opt_get_next_by_num(pdu, &opt,
+                                           COAP_SIGNAL_OPT_MAX_MSG_SIZE,
+                                           &value, true);
+            if ((res >= 0) && (res <= 4)) {
+                conn->peer_msg_size = 0;
+                for (ssize_t i = 0; i < res; i++) {
+                    conn->peer_msg_size = (conn->peer_msg_size << 8) | value[i];
+                }
+            }
+            return 0;
+        case COAP_CODE_PING:
+            /* Pong echoes the token, options of Ping don't apply to it */
+            coap_hdr_set_code(pdu->hdr, COAP_CODE_PONG);
+            _tcp_send(sock, pdu, coap_get_total_hdr_len(pdu));
+            return 0;
+        case COAP_CODE_RELEASE:
+        case COAP_CODE_ABORT:
+            return -ECONNRESET;
+        default:
+            DEBUG("gcoap: unhandled signal: %u\n", coap_get_code_raw(pdu));
+            return 0;
+        }
+    default:
+        DEBUG("gcoap: TCP client not supported, dropping message\n");
+        return 0;
+    }
+}
+
+/*
+ * Handles all complete messages received on a TCP connection.
+ *
+ * return <0 if the connection must be closed
+ */
+static int _tcp_process(sock_tcp_t *sock)
+{
+    gcoap_tcp_conn_t *conn = &_tcp_conns[sock - _tcp_socks];
+    uint8_t *msg = &_listen_buf[COAP_TCP_HEADROOM];
+    coap_pkt_t pdu;
+    ssize_t msg_len;
+
+    while ((msg_len = coap_tcp_get_len(conn->buf, conn->len)) > 0) {
+        if ((size_t)msg_len > sizeof(conn->buf)) {
+            DEBUG("gcoap: TCP message exceeds Max-Message-Size\n");
+            _tcp_signal(sock, COAP_CODE_ABORT);
+            return -EMSGSIZE;
+        }
+        if ((size_t)msg_len > conn->len) {
+            /* wait for the rest of the message */
+            break;
+        }
+        /* the message is handled in _listen_buf, so the response does not
+         * overwrite messages received after it */
+        memcpy(msg, conn->buf, msg_len);
+        conn->len -= msg_len;
+        memmove(conn->buf, &conn->buf[msg_len], conn->len);
+        if (coap_tcp_parse(&pdu, msg, msg_len) < 0) {
+            DEBUG("gcoap: TCP parse failure\n");
+            _tcp_signal(sock, COAP_CODE_ABORT);
+            return -EBADMSG;
+        }
+        int res = _tcp_handle(sock, &pdu);
+        if (res < 0) {
+            return res;
+        }
+    }
+    return (msg_len < 0) ? msg_len : 0;
+}
+
+/* Accepts CoAP over TCP connections. */
+static void _on_tcp_queue_evt(sock_tcp_queue_t *queue, sock_async_flags_t type)
+{
+    sock_tcp_t *sock;
+
+    if (!(type & SOCK_ASYNC_CONN_RECV)) {
+        return;
+    }
+    while (sock_tcp_accept(queue, &sock, 0) == 0) {
+        gcoap_tcp_conn_t *conn = &_tcp_conns[sock - _tcp_socks];
+
+        DEBUG("gcoap: accepted TCP connection %u\n",
+              (unsigned)(sock - _tcp_socks));
+        conn->len = 0;
+        conn->peer_msg_size = TCP_PEER_MSG_SIZE_DEFAULT;
+        sock_tcp_event_init(sock, &_queue, _on_tcp_evt);
+        /* RFC 8323, section 5.3: CSM is the first message on a connection */
+        _tcp_signal(sock, COAP_CODE_CSM);
+    }
+}
+
+/* Handles events of a CoAP over TCP connection. */
+static void _on_tcp_evt(sock_tcp_t *sock, sock_async_flags_t type)
+{
+    gcoap_tcp_conn_t *conn = &_tcp_conns[sock - _tcp_socks];
+
+    if (type & SOCK_ASYNC_MSG_RECV) {
+        ssize_t res;
+
+        /* _tcp_process() leaves space for at least the rest of an incomplete
+         * message */
+        while ((res = sock_tcp_read(sock, &conn->buf[conn->len],
+                                    sizeof(conn->buf) - conn->len, 0)) > 0) {
+            conn->len += res;
+            if (_tcp_process(sock) < 0) {
+                _tcp_close(sock);
+                return;
+            }
+        }
+        if ((res < 0) && (res != -EAGAIN)) {
+            DEBUG("gcoap: TCP recv failure: %d\n", (int)res);
+            _tcp_close(sock);
+            return;
+        }
+    }
+    if (type & SOCK_ASYNC_CONN_FIN) {
+        _tcp_close(sock);
+    }
+}
+#endif /* MODULE_GCOAP_TCP */
+
+/*
+ * Returns the timeout for the next transmission of a confirmable request,
+ * backed off by the number of transmissions so far.
+ */
+static uint32_t _con_timeout(const gcoap_request_memo_t *memo)
+{
+#ifdef CONFIG_GCOAP_NO_RETRANS_BACKOFF
+    unsigned i = 0;
+#else
+    unsigned i = COAP_MAX_RETRANSMIT - memo->send_limit;
+#endif
+#ifdef MODULE_GCOAP_COCOA
+    uint32_t timeout = gcoap_cocoa_backoff(memo->rto, i);
+#if COAP_RANDOM_FACTOR_1000 > 1000
+    timeout = random_uint32_range(timeout,
+                                  (uint32_t)(((uint64_t)timeout *
+                                              COAP_RANDOM_FACTOR_1000) / 1000));
+#endif
+#else
+    uint32_t timeout = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
+#if COAP_RANDOM_FACTOR_1000 > 1000
+    uint32_t end = ((uint32_t)TIMEOUT_RANGE_END << i) * US_PER_SEC;
+    timeout = random_uint32_range(timeout, end);
+#endif
+#endif
+    return timeout;
+}
+
 /* Handles response timeout for a request; resend confirmable if needed. */
 static void _on_resp_timeout(void *arg) {
     gcoap_request_memo_t *memo = (gcoap_request_memo_t *)arg;
@@ -223,20 +539,10 @@ static void _on_resp_timeout(void *arg) {
     if ((memo->send_limit == GCOAP_SEND_LIMIT_NON) || (memo->send_limit == 0)) {
         _expire_request(memo);
     }
-    /* reduce retries remaining, double timeout and resend */
+    /* reduce retries remaining, back off timeout and resend */
     else {
         memo->send_limit--;
-#ifdef CONFIG_GCOAP_NO_RETRANS_BACKOFF
-        unsigned i        = 0;
-#else
-        unsigned i        = COAP_MAX_RETRANSMIT - memo->send_limit;
-#endif
-        uint32_t timeout  = ((uint32_t)COAP_ACK_TIMEOUT << i) * US_PER_SEC;
-#if COAP_RANDOM_FACTOR_1000 > 1000
-        uint32_t end = ((uint32_t)TIMEOUT_RANGE_END << i) * US_PER_SEC;
-        timeout = random_uint32_range(timeout, end);
-#endif
-        event_timeout_set(&memo->resp_evt_tmout, timeout);
+        event_timeout_set(&memo->resp_evt_tmout, _con_timeout(memo));
 
         ssize_t bytes = sock_udp_send(&_sock, memo->msg.data.pdu_buf,
                                       memo->msg.data.pdu_len, &memo->remote_ep);
@@ -269,11 +575,20 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         case GCOAP_RESOURCE_NO_PATH:
             return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
         case GCOAP_RESOURCE_FOUND:
-            /* find observe registration for resource */
-            _find_obs_memo_resource(&resource_memo, resource);
             break;
     }
 
+#ifdef MODULE_GCOAP_CACHE
+    ssize_t cached_len = gcoap_cache_get(pdu, buf, len);
+    if (cached_len > 0) {
+        return cached_len;
+    }
+#endif
+
+    mutex_lock(&_coap_state.lock);
+    /* find observe registration for resource */
+    _find_obs_memo_resource(&resource_memo, resource);
+
     if (coap_get_observe(pdu) == COAP_OBS_REGISTER) {
         /* lookup remote+token */
         int empty_slot = _find_obs_memo(&memo, remote, pdu);
@@ -297,19 +612,18 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         if ((memo == NULL) && coap_has_observe(pdu)) {
             /* verify resource not already registered (for another endpoint) */
             if ((empty_slot >= 0) && (resource_memo == NULL)) {
-                int obs_slot = _find_observer(&observer, remote);
+                observer = _find_observer(remote);
                 /* cache new observer */
                 if (observer == NULL) {
-                    if (obs_slot >= 0) {
-                        observer = &_coap_state.observers[obs_slot];
-                        memcpy(observer, remote, sizeof(sock_udp_ep_t));
-                    } else {
+                    observer = _add_observer(remote);
+                    if (observer == NULL) {
                         DEBUG("gcoap: can't register observer\n");
                     }
                 }
                 if (observer != NULL) {
                     memo = &_coap_state.observe_memos[empty_slot];
                     memo->observer = observer;
+                    _coap_state.observers_memos[observer - _coap_state.observers]++;
                 }
             }
             if (memo == NULL) {
@@ -319,12 +633,15 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         }
         /* finish registration */
         if (memo != NULL) {
+            /* token and resource determine the hash chains of the memo */
+            _unlink_obs_memo(memo);
             /* resource may be assigned here if it is not already registered */
             memo->resource = resource;
             memo->token_len = coap_get_token_len(pdu);
             if (memo->token_len) {
                 memcpy(&memo->token[0], pdu->token, memo->token_len);
             }
+            _link_obs_memo(memo);
             DEBUG("gcoap: Registered observer for: %s\n", memo->resource->path);
         }
 
@@ -333,29 +650,28 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         /* clear memo, and clear observer if no other memos */
         if (memo != NULL) {
             DEBUG("gcoap: Deregistering observer for: %s\n", memo->resource->path);
-            memo->observer = NULL;
-            memo           = NULL;
-            _find_obs_memo(&memo, remote, NULL);
-            if (memo == NULL) {
-                _find_observer(&observer, remote);
-                if (observer != NULL) {
-                    observer->family = AF_UNSPEC;
-                }
-            }
+            _remove_obs_memo(memo);
         }
         coap_clear_observe(pdu);
 
     } else if (coap_has_observe(pdu)) {
+        mutex_unlock(&_coap_state.lock);
         /* bogus request; don't respond */
         DEBUG("gcoap: Observe value unexpected: %" PRIu32 "\n", coap_get_observe(pdu));
         return -1;
     }
+    mutex_unlock(&_coap_state.lock);
 
     ssize_t pdu_len = resource->handler(pdu, buf, len, resource->context);
     if (pdu_len < 0) {
         pdu_len = gcoap_response(pdu, buf, len,
                                  COAP_CODE_INTERNAL_SERVER_ERROR);
     }
+#ifdef MODULE_GCOAP_CACHE
+    if (pdu_len > 0) {
+        gcoap_cache_put(buf, pdu_len);
+    }
+#endif
     return pdu_len;
 }
 
@@ -373,41 +689,20 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
                                             gcoap_listener_t **listener_ptr)
 {
     int ret = GCOAP_RESOURCE_NO_PATH;
-    coap_method_flags_t method_flag = coap_method2flag(coap_get_code_detail(pdu));
 
     /* Find path for CoAP msg among listener resources and execute callback. */
     gcoap_listener_t *listener = _coap_state.listeners;
 
-    uint8_t uri[NANOCOAP_URI_MAX];
-    if (coap_get_uri_path(pdu, uri) <= 0) {
-        return GCOAP_RESOURCE_NO_PATH;
-    }
-
     while (listener) {
-        const coap_resource_t *resource = listener->resources;
-        for (size_t i = 0; i < listener->resources_len; i++) {
-            if (i) {
-                resource++;
-            }
+        int res = coap_find_resource(pdu, listener->resources,
+                                     listener->resources_len, resource_ptr);
 
-            int res = coap_match_path(resource, uri);
-            if (res > 0) {
-                continue;
-            }
-            else if (res < 0) {
-                /* resources expected in alphabetical order */
-                break;
-            }
-            else {
-                if (! (resource->methods & method_flag)) {
-                    ret = GCOAP_RESOURCE_WRONG_METHOD;
-                    continue;
-                }
-
-                *resource_ptr = resource;
-                *listener_ptr = listener;
-                return GCOAP_RESOURCE_FOUND;
-            }
+        if (res == 0) {
+            *listener_ptr = listener;
+            return GCOAP_RESOURCE_FOUND;
+        }
+        else if (res == -EPERM) {
+            ret = GCOAP_RESOURCE_WRONG_METHOD;
         }
         listener = listener->next;
     }
@@ -415,6 +710,166 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
     return ret;
 }
 
+/*
+ * Hash tables over the entries of a table in _coap_state. The chain heads are
+ * indexed by hash modulo the table size, the links to the next entry in a
+ * chain by entry. Both hold the position of an entry plus one; 0 ends a chain.
+ */
+static uint32_t _hash(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *bytes = data;
+
+    while (len--) {
+        hash ^= *bytes++;
+        hash *= HASH_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t _hash_ep(const sock_udp_ep_t *ep)
+{
+    /* sock_udp_ep_equal() only compares the first 4 bytes of IPv4 addresses */
+    size_t addr_len = (ep->family == AF_INET) ? 4 : sizeof(ep->addr);
+
+    return _hash(_hash(HASH_INIT, &ep->port, sizeof(ep->port)), &ep->addr,
+                 addr_len);
+}
+
+static void _hash_add(gcoap_idx_t *heads, gcoap_idx_t *next, unsigned size,
+                      uint32_t hash, unsigned pos)
+{
+    gcoap_idx_t *head = &heads[hash % size];
+
+    next[pos] = *head;
+    *head = pos + 1;
+}
+
+static void _hash_del(gcoap_idx_t *heads, gcoap_idx_t *next, unsigned size,
+                      uint32_t hash, unsigned pos)
+{
+    for (gcoap_idx_t *link = &heads[hash % size]; *link != 0;
+         link = &next[*link - 1]) {
+        if (*link == (pos + 1)) {
+            *link = next[pos];
+            return;
+        }
+    }
+}
+
+/*
+ * Gets the token of the request for a request memo.
+ *
+ * token_len[out] -- Length of the token
+ * return Token of the request
+ */
+static uint8_t *_req_memo_token(gcoap_request_memo_t *memo, unsigned *token_len)
+{
+    coap_hdr_t *hdr;
+
+    if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
+        hdr = (coap_hdr_t *)&memo->msg.hdr_buf[0];
+    }
+    else {
+        hdr = (coap_hdr_t *)memo->msg.data.pdu_buf;
+    }
+    *token_len = hdr->ver_t_tkl & 0xf;
+    return coap_hdr_data_ptr(hdr);
+}
+
+static uint32_t _req_memo_hash(gcoap_request_memo_t *memo)
+{
+    unsigned token_len;
+    uint8_t *token = _req_memo_token(memo, &token_len);
+
+    return _hash(_hash_ep(&memo->remote_ep), token, token_len);
+}
+
+/*
+ * Takes an available request memo. _coap_state.lock must be held.
+ *
+ * return Request memo, or NULL if none is available
+ */
+static gcoap_request_memo_t *_alloc_req_memo(void)
+{
+    gcoap_idx_t pos = _coap_state.open_reqs_free;
+
+    if (pos == 0) {
+        return NULL;
+    }
+    _coap_state.open_reqs_free = _coap_state.open_reqs_next[pos - 1];
+    return &_coap_state.open_reqs[pos - 1];
+}
+
+/*
+ * Makes a request memo available again. _coap_state.lock must be held.
+ */
+static void _free_req_memo(gcoap_request_memo_t *memo)
+{
+    unsigned pos = memo - _coap_state.open_reqs;
+
+    memo->state = GCOAP_MEMO_UNUSED;
+    _coap_state.open_reqs_next[pos] = _coap_state.open_reqs_free;
+    _coap_state.open_reqs_free = pos + 1;
+}
+
+/*
+ * Adds a request memo to the hash table of open requests, once the request
+ * has been copied to it. _coap_state.lock must be held.
+ */
+static void _link_req_memo(gcoap_request_memo_t *memo)
+{
+    _hash_add(_coap_state.open_reqs_hash, _coap_state.open_reqs_next,
+              CONFIG_GCOAP_REQ_WAITING_MAX, _req_memo_hash(memo),
+              memo - _coap_state.open_reqs);
+    if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
+        _hash_add(_coap_state.con_reqs_hash, _coap_state.con_reqs_next,
+                  CONFIG_GCOAP_REQ_WAITING_MAX, _hash_ep(&memo->remote_ep),
+                  memo - _coap_state.open_reqs);
+    }
+}
+
+/*
+ * Releases the memo of an open request and its resend buffer.
+ */
+static void _release_req_memo(gcoap_request_memo_t *memo)
+{
+    mutex_lock(&_coap_state.lock);
+    /* hash is taken from the request, so unlink before clearing it */
+    _hash_del(_coap_state.open_reqs_hash, _coap_state.open_reqs_next,
+              CONFIG_GCOAP_REQ_WAITING_MAX, _req_memo_hash(memo),
+              memo - _coap_state.open_reqs);
+    if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
+        _hash_del(_coap_state.con_reqs_hash, _coap_state.con_reqs_next,
+                  CONFIG_GCOAP_REQ_WAITING_MAX, _hash_ep(&memo->remote_ep),
+                  memo - _coap_state.open_reqs);
+        *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
+    }
+    _free_req_memo(memo);
+    mutex_unlock(&_coap_state.lock);
+}
+
+/*
+ * Counts the confirmable requests to remote awaiting a response.
+ *
+ * Must be called with _coap_state.lock held.
+ */
+static unsigned _count_con_memos(const sock_udp_ep_t *remote)
+{
+    uint32_t hash = _hash_ep(remote);
+    unsigned res = 0;
+
+    for (gcoap_idx_t i = _coap_state.con_reqs_hash[hash % CONFIG_GCOAP_REQ_WAITING_MAX];
+         i != 0; i = _coap_state.con_reqs_next[i - 1]) {
+        gcoap_request_memo_t *memo = &_coap_state.open_reqs[i - 1];
+
+        if ((memo->state == GCOAP_MEMO_WAIT) &&
+            sock_udp_ep_equal(&memo->remote_ep, remote)) {
+            res++;
+        }
+    }
+    return res;
+}
+
 /*
  * Finds the memo for an outstanding request within the _coap_state.open_reqs
  * array. Matches on remote endpoint and token.
@@ -426,34 +881,25 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
                            const sock_udp_ep_t *remote)
 {
-    *memo_ptr = NULL;
-    /* no need to initialize struct; we only care about buffer contents below */
-    coap_pkt_t memo_pdu_data;
-    coap_pkt_t *memo_pdu = &memo_pdu_data;
-    unsigned cmplen      = coap_get_token_len(src_pdu);
+    unsigned cmplen = coap_get_token_len(src_pdu);
+    uint32_t hash   = _hash(_hash_ep(remote), src_pdu->token, cmplen);
 
-    for (int i = 0; i < CONFIG_GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED) {
-            continue;
-        }
-
-        gcoap_request_memo_t *memo = &_coap_state.open_reqs[i];
-        if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-            memo_pdu->hdr = (coap_hdr_t *) &memo->msg.hdr_buf[0];
-        }
-        else {
-            memo_pdu->hdr = (coap_hdr_t *) memo->msg.data.pdu_buf;
-        }
-
-        if (coap_get_token_len(memo_pdu) == cmplen) {
-            memo_pdu->token = coap_hdr_data_ptr(memo_pdu->hdr);
-            if ((memcmp(src_pdu->token, memo_pdu->token, cmplen) == 0)
-                    && sock_udp_ep_equal(&memo->remote_ep, remote)) {
-                *memo_ptr = memo;
-                break;
-            }
+    *memo_ptr = NULL;
+    mutex_lock(&_coap_state.lock);
+    for (gcoap_idx_t i = _coap_state.open_reqs_hash[hash % CONFIG_GCOAP_REQ_WAITING_MAX];
+         i != 0; i = _coap_state.open_reqs_next[i - 1]) {
+        gcoap_request_memo_t *memo = &_coap_state.open_reqs[i - 1];
+        unsigned token_len;
+        uint8_t *token = _req_memo_token(memo, &token_len);
+
+        if ((token_len == cmplen)
+                && (memcmp(src_pdu->token, token, cmplen) == 0)
+                && sock_udp_ep_equal(&memo->remote_ep, remote)) {
+            *memo_ptr = memo;
+            break;
         }
     }
+    mutex_unlock(&_coap_state.lock);
 }
 
 /* Calls handler callback on receipt of a timeout message. */
@@ -473,10 +919,7 @@ static void _expire_request(gcoap_request_memo_t *memo)
             }
             memo->resp_handler(memo, &req, NULL);
         }
-        if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
-            *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
-        }
-        memo->state = GCOAP_MEMO_UNUSED;
+        _release_req_memo(memo);
     }
     else {
         /* Response already handled; timeout must have fired while response */
@@ -502,30 +945,112 @@ static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t le
     return plen;
 }
 
+/*
+ * The observe tables below must only be accessed with _coap_state.lock held.
+ */
+
 /*
  * Find registered observer for a remote address and port.
  *
- * observer[out] -- Registered observer, or NULL if not found
  * remote[in] -- Endpoint to match
  *
- * return Index of empty slot, suitable for registering new observer; or -1
- *        if no empty slots. Undefined if observer found.
+ * return Registered observer, or NULL if not found
  */
-static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote)
+static sock_udp_ep_t *_find_observer(const sock_udp_ep_t *remote)
 {
-    int empty_slot = -1;
-    *observer      = NULL;
-    for (unsigned i = 0; i < CONFIG_GCOAP_OBS_CLIENTS_MAX; i++) {
+    uint32_t hash = _hash_ep(remote);
 
-        if (_coap_state.observers[i].family == AF_UNSPEC) {
-            empty_slot = i;
+    for (gcoap_idx_t i = _coap_state.observers_hash[hash % CONFIG_GCOAP_OBS_CLIENTS_MAX];
+         i != 0; i = _coap_state.observers_next[i - 1]) {
+        if (sock_udp_ep_equal(&_coap_state.observers[i - 1], remote)) {
+            return &_coap_state.observers[i - 1];
         }
-        else if (sock_udp_ep_equal(&_coap_state.observers[i], remote)) {
-            *observer = &_coap_state.observers[i];
-            break;
+    }
+    return NULL;
+}
+
+/*
+ * Registers a new observer for a remote address and port.
+ *
+ * remote[in] -- Endpoint of the observer
+ *
+ * return Registered observer, or NULL if no empty slots
+ */
+static sock_udp_ep_t *_add_observer(const sock_udp_ep_t *remote)
+{
+    for (unsigned i = 0; i < CONFIG_GCOAP_OBS_CLIENTS_MAX; i++) {
+        if (_coap_state.observers[i].family == AF_UNSPEC) {
+            memcpy(&_coap_state.observers[i], remote, sizeof(sock_udp_ep_t));
+            _coap_state.observers_memos[i] = 0;
+            _hash_add(_coap_state.observers_hash, _coap_state.observers_next,
+                      CONFIG_GCOAP_OBS_CLIENTS_MAX, _hash_ep(remote), i);
+            return &_coap_state.observers[i];
         }
     }
-    return empty_slot;
+    return NULL;
+}
+
+static uint32_t _obs_memo_hash(const sock_udp_ep_t *observer,
+                               const uint8_t *token, unsigned token_len)
+{
+    return _hash(_hash(HASH_INIT, &observer, sizeof(observer)), token,
+                 token_len);
+}
+
+static uint32_t _obs_memo_res_hash(const coap_resource_t *resource)
+{
+    return _hash(HASH_INIT, &resource, sizeof(resource));
+}
+
+/*
+ * Adds an observe memo to the hash tables for its observer and token, and
+ * for its resource.
+ */
+static void _link_obs_memo(gcoap_observe_memo_t *memo)
+{
+    unsigned pos = memo - _coap_state.observe_memos;
+
+    _hash_add(_coap_state.observe_memos_hash, _coap_state.observe_memos_next,
+              CONFIG_GCOAP_OBS_REGISTRATIONS_MAX,
+              _obs_memo_hash(memo->observer, memo->token, memo->token_len), pos);
+    _hash_add(_coap_state.observe_memos_res_hash,
+              _coap_state.observe_memos_res_next,
+              CONFIG_GCOAP_OBS_REGISTRATIONS_MAX,
+              _obs_memo_res_hash(memo->resource), pos);
+}
+
+/*
+ * Removes an observe memo from the hash tables. Does nothing for a memo not
+ * in the hash tables yet.
+ */
+static void _unlink_obs_memo(gcoap_observe_memo_t *memo)
+{
+    unsigned pos = memo - _coap_state.observe_memos;
+
+    _hash_del(_coap_state.observe_memos_hash, _coap_state.observe_memos_next,
+              CONFIG_GCOAP_OBS_REGISTRATIONS_MAX,
+              _obs_memo_hash(memo->observer, memo->token, memo->token_len), pos);
+    _hash_del(_coap_state.observe_memos_res_hash,
+              _coap_state.observe_memos_res_next,
+              CONFIG_GCOAP_OBS_REGISTRATIONS_MAX,
+              _obs_memo_res_hash(memo->resource), pos);
+}
+
+/*
+ * Clears an observe memo, and its observer if no other memos refer to it.
+ */
+static void _remove_obs_memo(gcoap_observe_memo_t *memo)
+{
+    sock_udp_ep_t *observer = memo->observer;
+    unsigned obs_pos = observer - _coap_state.observers;
+
+    _unlink_obs_memo(memo);
+    memo->observer = NULL;
+    if (--_coap_state.observers_memos[obs_pos] == 0) {
+        _hash_del(_coap_state.observers_hash, _coap_state.observers_next,
+                  CONFIG_GCOAP_OBS_CLIENTS_MAX, _hash_ep(observer), obs_pos);
+        observer->family = AF_UNSPEC;
+    }
 }
 
 /*
@@ -533,7 +1058,7 @@ static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote)
  *
  * memo[out] -- Registered observe memo, or NULL if not found
  * remote[in] -- Endpoint for address to match
- * pdu[in] -- PDU for token to match, or NULL to match only on remote address
+ * pdu[in] -- PDU for token to match
  *
  * return Index of empty slot, suitable for registering new memo; or -1 if no
  *        empty slots. Undefined if memo found.
@@ -541,36 +1066,31 @@ static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote)
 static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu)
 {
-    int empty_slot = -1;
-    *memo          = NULL;
-
-    sock_udp_ep_t *remote_observer = NULL;
-    _find_observer(&remote_observer, remote);
+    sock_udp_ep_t *remote_observer = _find_observer(remote);
+    unsigned cmplen = coap_get_token_len(pdu);
 
+    *memo = NULL;
+    if ((remote_observer != NULL) && cmplen) {
+        uint32_t hash = _obs_memo_hash(remote_observer, pdu->token, cmplen);
+
+        for (gcoap_idx_t i = _coap_state.observe_memos_hash[hash % CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
+             i != 0; i = _coap_state.observe_memos_next[i - 1]) {
+            gcoap_observe_memo_t *tmp = &_coap_state.observe_memos[i - 1];
+
+            if ((tmp->observer == remote_observer)
+                    && (tmp->token_len == cmplen)
+                    && (memcmp(&tmp->token[0], &pdu->token[0], cmplen) == 0)) {
+                *memo = tmp;
+                return -1;
+            }
+        }
+    }
     for (unsigned i = 0; i < CONFIG_GCOAP_OBS_REGISTRATIONS_MAX; i++) {
         if (_coap_state.observe_memos[i].observer == NULL) {
-            empty_slot = i;
-            continue;
-        }
-
-        if (_coap_state.observe_memos[i].observer == remote_observer) {
-            if (pdu == NULL) {
-                *memo = &_coap_state.observe_memos[i];
-                break;
-            }
-
-            if (_coap_state.observe_memos[i].token_len == coap_get_token_len(pdu)) {
-                unsigned cmplen = _coap_state.observe_memos[i].token_len;
-                if (cmplen &&
-                        memcmp(&_coap_state.observe_memos[i].token[0], &pdu->token[0],
-                                                                       cmplen) == 0) {
-                    *memo = &_coap_state.observe_memos[i];
-                    break;
-                }
-            }
+            return i;
         }
     }
-    return empty_slot;
+    return -1;
 }
 
 /*
@@ -582,11 +1102,13 @@ static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
 static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource)
 {
+    uint32_t hash = _obs_memo_res_hash(resource);
+
     *memo = NULL;
-    for (int i = 0; i < CONFIG_GCOAP_OBS_REGISTRATIONS_MAX; i++) {
-        if (_coap_state.observe_memos[i].observer != NULL
-                && _coap_state.observe_memos[i].resource == resource) {
-            *memo = &_coap_state.observe_memos[i];
+    for (gcoap_idx_t i = _coap_state.observe_memos_res_hash[hash % CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
+         i != 0; i = _coap_state.observe_memos_res_next[i - 1]) {
+        if (_coap_state.observe_memos[i - 1].resource == resource) {
+            *memo = &_coap_state.observe_memos[i - 1];
             break;
         }
     }
@@ -610,6 +1132,18 @@ kernel_pid_t gcoap_init(void)
     memset(&_coap_state.observers[0], 0, sizeof(_coap_state.observers));
     memset(&_coap_state.observe_memos[0], 0, sizeof(_coap_state.observe_memos));
     memset(&_coap_state.resend_bufs[0], 0, sizeof(_coap_state.resend_bufs));
+    memset(&_coap_state.open_reqs_hash[0], 0, sizeof(_coap_state.open_reqs_hash));
+    memset(&_coap_state.con_reqs_hash[0], 0, sizeof(_coap_state.con_reqs_hash));
+    memset(&_coap_state.observers_hash[0], 0, sizeof(_coap_state.observers_hash));
+    memset(&_coap_state.observe_memos_hash[0], 0,
+           sizeof(_coap_state.observe_memos_hash));
+    memset(&_coap_state.observe_memos_res_hash[0], 0,
+           sizeof(_coap_state.observe_memos_res_hash));
+    /* all open request memos are available */
+    _coap_state.open_reqs_free = 0;
+    for (unsigned i = CONFIG_GCOAP_REQ_WAITING_MAX; i > 0; i--) {
+        _free_req_memo(&_coap_state.open_reqs[i - 1]);
+    }
     /* randomize initial value */
     atomic_init(&_coap_state.next_message_id, (unsigned)random_uint32());
 
@@ -716,19 +1250,20 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len,
      * response or request is confirmable) */
     if ((resp_handler != NULL) || (msg_type == COAP_TYPE_CON)) {
         mutex_lock(&_coap_state.lock);
-        /* Find empty slot in list of open requests. */
-        for (int i = 0; i < CONFIG_GCOAP_REQ_WAITING_MAX; i++) {
-            if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED) {
-                memo = &_coap_state.open_reqs[i];
-                memo->state = GCOAP_MEMO_WAIT;
-                break;
-            }
+        if ((msg_type == COAP_TYPE_CON) &&
+            (_count_con_memos(remote) >= CONFIG_GCOAP_NSTART)) {
+            mutex_unlock(&_coap_state.lock);
+            DEBUG("gcoap: dropping request; NSTART reached for remote\n");
+            return 0;
         }
+        /* Take empty slot in list of open requests. */
+        memo = _alloc_req_memo();
         if (!memo) {
             mutex_unlock(&_coap_state.lock);
             DEBUG("gcoap: dropping request; no space for response tracking\n");
             return 0;
         }
+        memo->state = GCOAP_MEMO_WAIT;
 
         memo->resp_handler = resp_handler;
         memo->context = context;
@@ -749,10 +1284,11 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len,
             }
             if (memo->msg.data.pdu_buf) {
                 memo->send_limit  = COAP_MAX_RETRANSMIT;
-                timeout           = (uint32_t)COAP_ACK_TIMEOUT * US_PER_SEC;
-#if COAP_RANDOM_FACTOR_1000 > 1000
-                timeout = random_uint32_range(timeout, TIMEOUT_RANGE_END * US_PER_SEC);
+#ifdef MODULE_GCOAP_COCOA
+                memo->rto         = gcoap_cocoa_rto(remote);
+                memo->send_time   = xtimer_now_usec();
 #endif
+                timeout           = _con_timeout(memo);
             }
             else {
                 memo->state = GCOAP_MEMO_UNUSED;
@@ -770,10 +1306,13 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len,
             DEBUG("gcoap: illegal msg type %u\n", msg_type);
             break;
         }
-        mutex_unlock(&_coap_state.lock);
         if (memo->state == GCOAP_MEMO_UNUSED) {
+            _free_req_memo(memo);
+            mutex_unlock(&_coap_state.lock);
             return 0;
         }
+        _link_req_memo(memo);
+        mutex_unlock(&_coap_state.lock);
     }
 
     /* set response timeout; may be zero for non-confirmable */
@@ -792,13 +1331,10 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len,
     ssize_t res = sock_udp_send(&_sock, buf, len, remote);
     if (res <= 0) {
         if (memo != NULL) {
-            if (msg_type == COAP_TYPE_CON) {
-                *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
-            }
             if (timeout > 0) {
                 event_timeout_clear(&memo->resp_evt_tmout);
             }
-            memo->state = GCOAP_MEMO_UNUSED;
+            _release_req_memo(memo);
         }
         DEBUG("gcoap: sock send failed: %d\n", (int)res);
     }
@@ -833,8 +1369,10 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 {
     gcoap_observe_memo_t *memo = NULL;
 
+    mutex_lock(&_coap_state.lock);
     _find_obs_memo_resource(&memo, resource);
     if (memo == NULL) {
+        mutex_unlock(&_coap_state.lock);
         /* Unique return value to specify there is not an observer */
         return GCOAP_OBS_INIT_UNUSED;
     }
@@ -843,6 +1381,7 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
     uint16_t msgid = (uint16_t)atomic_fetch_add(&_coap_state.next_message_id, 1);
     ssize_t hdrlen = coap_build_hdr(pdu->hdr, COAP_TYPE_NON, &memo->token[0],
                                     memo->token_len, COAP_CODE_CONTENT, msgid);
+    mutex_unlock(&_coap_state.lock);
 
     if (hdrlen > 0) {
         coap_pkt_init(pdu, buf, len - CONFIG_GCOAP_OBS_OPTIONS_BUF, hdrlen);
@@ -863,11 +1402,17 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
                       const coap_resource_t *resource)
 {
     gcoap_observe_memo_t *memo = NULL;
+    sock_udp_ep_t observer;
 
+    mutex_lock(&_coap_state.lock);
     _find_obs_memo_resource(&memo, resource);
+    if (memo) {
+        memcpy(&observer, memo->observer, sizeof(observer));
+    }
+    mutex_unlock(&_coap_state.lock);
 
     if (memo) {
-        ssize_t bytes = sock_udp_send(&_sock, buf, len, memo->observer);
+        ssize_t bytes = sock_udp_send(&_sock, buf, len, &observer);
         return (size_t)((bytes > 0) ? bytes : 0);
     }
     else {
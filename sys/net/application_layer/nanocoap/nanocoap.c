@@ -165,14 +165,23 @@ int coap_match_path(const coap_resource_t *resource, uint8_t *uri)
 
 uint8_t *coap_find_option(const coap_pkt_t *pkt, unsigned opt_num)
 {
-    const coap_optpos_t *optpos = pkt->options;
-    unsigned opt_count = pkt->options_len;
+    /* options, and so the entries of pkt->options, are ordered by option
+     * number, so look for the first entry of opt_num with a binary search */
+    unsigned lo = 0;
+    unsigned hi = pkt->options_len;
 
-    while (opt_count--) {
-        if (optpos->opt_num == opt_num) {
-            return (uint8_t*)pkt->hdr + optpos->offset;
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+
+        if (pkt->options[mid].opt_num < opt_num) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
         }
-        optpos++;
+    }
+    if ((lo < pkt->options_len) && (pkt->options[lo].opt_num == opt_num)) {
+        return (uint8_t*)pkt->hdr + pkt->options[lo].offset;
     }
     return NULL;
 }
@@ -312,6 +321,42 @@ ssize_t coap_opt_get_next(const coap_pkt_t *pkt, coap_optpos_t *opt,
     return len;
 }
 
+ssize_t coap_opt_get_next_by_num(const coap_pkt_t *pkt, coap_optpos_t *opt,
+                                 unsigned opt_num, uint8_t **value,
+                                 bool init_opt)
+{
+    uint8_t *start;
+    uint16_t delta;
+    int len;
+
+    if (init_opt) {
+        start = coap_find_option(pkt, opt_num);
+        if (!start) {
+            return -ENOENT;
+        }
+    }
+    else if (opt->opt_num != opt_num) {
+        return -ENOENT;
+    }
+    else {
+        start = (uint8_t*)pkt->hdr + opt->offset;
+    }
+
+    start = _parse_option(pkt, start, &delta, &len);
+    /* a repeated option follows with a delta of zero */
+    if (!start || (!init_opt && delta)) {
+        return -ENOENT;
+    }
+    if (len < 0) {
+        return -EBADMSG;
+    }
+
+    *value = start;
+    opt->opt_num = opt_num;
+    opt->offset = start + len - (uint8_t*)pkt->hdr;
+    return len;
+}
+
 ssize_t coap_opt_get_string(const coap_pkt_t *pkt, uint16_t optnum,
                             uint8_t *target, size_t max_len, char separator)
 {
@@ -374,6 +419,107 @@ int coap_get_blockopt(coap_pkt_t *pkt, uint16_t option, uint32_t *blknum, unsign
     return (blkopt & 0x8) ? 1 : 0;
 }
 
+/* iterates over the bytes of the URI path of a request, in the form
+ * coap_get_uri_path() would assemble it, without copying it */
+typedef struct {
+    uint8_t *opt_pos;           /* next Uri-Path option, NULL after the last */
+    const uint8_t *seg;         /* rest of the current path segment */
+    int seg_len;                /* length of seg */
+    bool first;                 /* opt_pos is the first Uri-Path option */
+} _uri_iter_t;
+
+static void _uri_iter_init(const coap_pkt_t *pkt, _uri_iter_t *it)
+{
+    static const uint8_t root[] = { '/' };
+
+    it->opt_pos = coap_find_option(pkt, COAP_OPT_URI_PATH);
+    it->seg = root;
+    /* the URI path of a request without Uri-Path option is "/" */
+    it->seg_len = (it->opt_pos == NULL) ? 1 : 0;
+    it->first = true;
+}
+
+/* returns the next byte of the URI path or -1 at its end */
+static int _uri_iter_next(const coap_pkt_t *pkt, _uri_iter_t *it)
+{
+    if (it->seg_len > 0) {
+        it->seg_len--;
+        return *it->seg++;
+    }
+    if (it->opt_pos == NULL) {
+        return -1;
+    }
+    it->seg = coap_iterate_option(pkt, &it->opt_pos, &it->seg_len, it->first);
+    it->first = false;
+    if (it->seg == NULL) {
+        return -1;
+    }
+    if (it->seg_len < 0) {
+        /* malformed option */
+        it->opt_pos = NULL;
+        it->seg_len = 0;
+        return -1;
+    }
+    return '/';
+}
+
+/* returns the first index in [lo, hi) whose path has a byte >= c at depth.
+ * All paths in [lo, hi) share their first depth bytes and are not shorter
+ * than depth + 1, so they are sorted by that byte. */
+static size_t _path_bound(const coap_resource_t *resources, size_t lo,
+                          size_t hi, size_t depth, unsigned c)
+{
+    while (lo < hi) {
+        size_t mid = lo + ((hi - lo) / 2);
+
+        if ((uint8_t)resources[mid].path[depth] < c) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int coap_find_resource(coap_pkt_t *pkt, const coap_resource_t *resources,
+                       size_t resources_numof, const coap_resource_t **resource)
+{
+    coap_method_flags_t method_flag = coap_method2flag(coap_get_code_detail(pkt));
+    size_t lo = 0, hi = resources_numof, depth = 0;
+    int res = -ENOENT;
+    _uri_iter_t it;
+
+    assert(resource && (resources || !resources_numof));
+    _uri_iter_init(pkt, &it);
+    /* [lo, hi) are the resources whose path starts with the first depth
+     * bytes of the URI path */
+    while (lo < hi) {
+        int c = _uri_iter_next(pkt, &it);
+        size_t end = lo;
+
+        /* resources with a path of length depth sort first. Their path is a
+         * prefix of the URI path, and equal to it if the URI path ends here */
+        for (; (end < hi) && (resources[end].path[depth] == '\0'); end++) {
+            if ((c >= 0) && !(resources[end].methods & COAP_MATCH_SUBTREE)) {
+                continue;
+            }
+            if (resources[end].methods & method_flag) {
+                *resource = &resources[end];
+                return 0;
+            }
+            res = -EPERM;
+        }
+        if (c <= 0) {
+            break;
+        }
+        lo = _path_bound(resources, end, hi, depth, c);
+        hi = _path_bound(resources, lo, hi, depth, c + 1);
+        depth++;
+    }
+    return res;
+}
+
 ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_len)
 {
     if (coap_get_code_class(pkt) != COAP_REQ) {
@@ -385,30 +531,11 @@ ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_le
         return coap_build_reply(pkt, COAP_CODE_EMPTY, resp_buf, resp_buf_len, 0);
     }
 
-    coap_method_flags_t method_flag = coap_method2flag(coap_get_code_detail(pkt));
+    const coap_resource_t *resource;
 
-    uint8_t uri[NANOCOAP_URI_MAX];
-    if (coap_get_uri_path(pkt, uri) <= 0) {
-        return -EBADMSG;
-    }
-    DEBUG("nanocoap: URI path: \"%s\"\n", uri);
-
-    for (unsigned i = 0; i < coap_resources_numof; i++) {
-        const coap_resource_t *resource = &coap_resources[i];
-        if (!(resource->methods & method_flag)) {
-            continue;
-        }
-
-        int res = coap_match_path(resource, uri);
-        if (res > 0) {
-            continue;
-        }
-        else if (res < 0) {
-            break;
-        }
-        else {
-            return resource->handler(pkt, resp_buf, resp_buf_len, resource->context);
-        }
+    if (coap_find_resource(pkt, coap_resources, coap_resources_numof,
+                           &resource) == 0) {
+        return resource->handler(pkt, resp_buf, resp_buf_len, resource->context);
     }
 
     return coap_build_reply(pkt, COAP_CODE_404, resp_buf, resp_buf_len, 0);
@@ -487,6 +614,104 @@ ssize_t coap_build_hdr(coap_hdr_t *hdr, unsigned type, uint8_t *token, size_t to
     return sizeof(coap_hdr_t) + token_len;
 }
 
+/* RFC 8323, section 3.2: a Len nibble of 13, 14 and 15 announces an
+ * extended length of 1, 2 and 4 bytes, offset by these values */
+#define TCP_LEN_EXT1_OFFSET     (13U)
+#define TCP_LEN_EXT2_OFFSET     (269U)
+#define TCP_LEN_EXT4_OFFSET     (65805UL)
+
+ssize_t coap_tcp_get_len(const uint8_t *buf, size_t len)
+{
+    unsigned nibble, ext;
+    uint64_t msg_len;
+
+    if (len == 0) {
+        return 0;
+    }
+    nibble = buf[0] >> 4;
+    ext = (nibble < 13) ? 0 : (1U << (nibble - 13));
+    if (len < (1 + ext)) {
+        return 0;
+    }
+    switch (ext) {
+        case 0:
+            msg_len = nibble;
+            break;
+        case 1:
+            msg_len = TCP_LEN_EXT1_OFFSET + buf[1];
+            break;
+        case 2:
+            msg_len = TCP_LEN_EXT2_OFFSET + ((buf[1] << 8) | buf[2]);
+            break;
+        default:
+            msg_len = TCP_LEN_EXT4_OFFSET +
+                      (((uint32_t)buf[1] << 24) | ((uint32_t)buf[2] << 16) |
+                       ((uint32_t)buf[3] << 8) | buf[4]);
+            break;
+    }
+    /* add Len/TKL, extended length, code and token */
+    msg_len += 2 + ext + (buf[0] & 0xf);
+    /* keep the result representable as ssize_t */
+    if (msg_len > (SIZE_MAX >> 1)) {
+        return -EMSGSIZE;
+    }
+    return msg_len;
+}
+
+int coap_tcp_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
+{
+    ssize_t msg_len = coap_tcp_get_len(buf, len);
+    unsigned tkl = buf[0] & 0xf;
+    unsigned framing_len;
+    coap_hdr_t *hdr;
+
+    if ((msg_len <= 0) || ((size_t)msg_len != len) || (tkl > 8)) {
+        DEBUG("nanocoap: bad TCP framing\n");
+        return -EBADMSG;
+    }
+    /* Len/TKL, extended length and code */
+    framing_len = ((buf[0] >> 4) < 13) ? 2 : (2 + (1U << ((buf[0] >> 4) - 13)));
+    /* the token stays in place, the header in front of it replaces the
+     * framing */
+    hdr = (coap_hdr_t *)(buf + framing_len - sizeof(coap_hdr_t));
+    hdr->code = buf[framing_len - 1];
+    hdr->ver_t_tkl = (0x1 << 6) | (COAP_TYPE_NON << 4) | tkl;
+    hdr->id = 0;
+    return coap_parse(pkt, (uint8_t *)hdr,
+                      len - framing_len + sizeof(coap_hdr_t));
+}
+
+ssize_t coap_tcp_frame(coap_pkt_t *pkt, size_t len, uint8_t **msg)
+{
+    unsigned tkl = coap_get_token_len(pkt);
+    size_t body_len = len - sizeof(coap_hdr_t) - tkl;
+    uint8_t code = pkt->hdr->code;
+    uint8_t *pos;
+
+    if (body_len < TCP_LEN_EXT1_OFFSET) {
+        pos = (uint8_t *)pkt->hdr + 2;
+        pos[0] = (body_len << 4) | tkl;
+    }
+    else if (body_len < TCP_LEN_EXT2_OFFSET) {
+        pos = (uint8_t *)pkt->hdr + 1;
+        pos[0] = (13 << 4) | tkl;
+        pos[1] = body_len - TCP_LEN_EXT1_OFFSET;
+    }
+    else if (body_len < TCP_LEN_EXT4_OFFSET) {
+        pos = (uint8_t *)pkt->hdr;
+        pos[0] = (14 << 4) | tkl;
+        pos[1] = (body_len - TCP_LEN_EXT2_OFFSET) >> 8;
+        pos[2] = (body_len - TCP_LEN_EXT2_OFFSET) & 0xff;
+    }
+    else {
+        return -EMSGSIZE;
+    }
+    /* code directly precedes the token */
+    ((uint8_t *)pkt->hdr)[sizeof(coap_hdr_t) - 1] = code;
+    *msg = pos;
+    return len - (pos - (uint8_t *)pkt->hdr);
+}
+
 void coap_pkt_init(coap_pkt_t *pkt, uint8_t *buf, size_t len, size_t header_len)
 {
     memset(pkt, 0, sizeof(coap_pkt_t));
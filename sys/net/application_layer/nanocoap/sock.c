@@ -26,10 +26,33 @@
 
 #include "net/nanocoap_sock.h"
 #include "net/sock/udp.h"
+#include "random.h"
+#include "xtimer.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
+/* room for the header and options of a block request or response */
+#define BLOCKWISE_HDR_MAX   (NANOCOAP_URI_MAX + 64U)
+
+/* states of a block in a block-wise transfer */
+enum {
+    BLOCK_FREE = 0,     /* slot can take the next block */
+    BLOCK_SENT,         /* request sent, awaiting response */
+    BLOCK_DONE,         /* response received, awaiting callback */
+    BLOCK_ERR,          /* error response received */
+};
+
+typedef struct {
+    uint32_t num;       /* block number */
+    uint32_t deadline;  /* time of next (re)transmission [in usec] */
+    uint32_t timeout;   /* time between (re)transmissions [in usec] */
+    size_t len;         /* length of payload */
+    int more;           /* Block2 more flag, or error if BLOCK_ERR */
+    uint8_t state;      /* BLOCK_... */
+    uint8_t tries_left; /* transmissions left */
+} _block_t;
+
 ssize_t nanocoap_request(coap_pkt_t *pkt, sock_udp_ep_t *local, sock_udp_ep_t *remote, size_t len)
 {
     ssize_t res;
@@ -154,3 +177,338 @@ int nanocoap_server(sock_udp_ep_t *local, uint8_t *buf, size_t bufsize)
 
     return 0;
 }
+
+static ssize_t _send_block_req(sock_udp_t *sock, uint8_t *buf, const char *path,
+                               uint16_t id, uint32_t num, unsigned szx)
+{
+    uint8_t *pktpos = buf;
+
+    pktpos += coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_CON, NULL, 0,
+                             COAP_METHOD_GET, id);
+    pktpos += coap_opt_put_uri_path(pktpos, 0, path);
+    pktpos += coap_opt_put_uint(pktpos, COAP_OPT_URI_PATH, COAP_OPT_BLOCK2,
+                                (num << 4) | szx);
+    return sock_udp_send(sock, buf, pktpos - buf, NULL);
+}
+
+static _block_t *_find_block(_block_t *blocks, uint32_t num)
+{
+    for (unsigned i = 0; i < NANOCOAP_BLOCKWISE_WINDOW; i++) {
+        if ((blocks[i].state != BLOCK_FREE) && (blocks[i].num == num)) {
+            return &blocks[i];
+        }
+    }
+    return NULL;
+}
+
+/* Sends requests for the blocks in the window and retransmits timed out ones.
+ * Returns the time until the next retransmission, or <0 on error. */
+static int32_t _send_block_reqs(sock_udp_t *sock, uint8_t *buf,
+                                const char *path, _block_t *blocks,
+                                uint16_t id, unsigned szx)
+{
+    uint32_t now = xtimer_now_usec();
+    int32_t res = INT32_MAX;
+
+    for (unsigned i = 0; i < NANOCOAP_BLOCKWISE_WINDOW; i++) {
+        _block_t *block = &blocks[i];
+        int32_t left;
+
+        if (block->state != BLOCK_SENT) {
+            continue;
+        }
+        left = (int32_t)(block->deadline - now);
+        if (left <= 0) {
+            ssize_t bytes;
+
+            if (block->tries_left == 0) {
+                DEBUG("nanocoap: maximum retries reached for block %u\n",
+                      (unsigned)block->num);
+                return -ETIMEDOUT;
+            }
+            block->tries_left--;
+            bytes = _send_block_req(sock, buf, path, id + block->num,
+                                    block->num, szx);
+            if (bytes <= 0) {
+                DEBUG("nanocoap: error sending block request, %d\n",
+                      (int)bytes);
+                return (bytes < 0) ? bytes : -EIO;
+            }
+            left = block->timeout;
+            block->deadline = now + block->timeout;
+            block->timeout *= 2;
+        }
+        if (left < res) {
+            res = left;
+        }
+    }
+    return res;
+}
+
+int nanocoap_get_blockwise(sock_udp_ep_t *remote, const char *path,
+                           coap_blksize_t blksize,
+                           coap_blockwise_cb_t callback, void *arg)
+{
+    const size_t blklen = coap_szx2size(blksize);
+    uint8_t buf[BLOCKWISE_HDR_MAX + blklen];
+    uint8_t data[NANOCOAP_BLOCKWISE_WINDOW][blklen];
+    _block_t blocks[NANOCOAP_BLOCKWISE_WINDOW];
+    /* only the first block is requested until the block size is settled */
+    unsigned window = 1;
+    unsigned szx = blksize;
+    uint32_t next = 0;          /* next block to request */
+    uint32_t deliver = 0;       /* next block to pass to callback */
+    uint32_t last = UINT32_MAX; /* last block, once known */
+    uint16_t id = random_uint32();
+    sock_udp_t sock;
+    int res;
+
+    if (strlen(path) > NANOCOAP_URI_MAX) {
+        return -EINVAL;
+    }
+    if (!remote->port) {
+        remote->port = COAP_PORT;
+    }
+    res = sock_udp_create(&sock, NULL, remote, 0);
+    if (res < 0) {
+        return res;
+    }
+    memset(blocks, 0, sizeof(blocks));
+
+    while (1) {
+        coap_pkt_t pkt;
+        coap_block1_t block2;
+        _block_t *block = NULL;
+        int32_t wait;
+
+        for (unsigned i = 0; (i < NANOCOAP_BLOCKWISE_WINDOW) &&
+                             (next < deliver + window) && (next <= last); i++) {
+            if (blocks[i].state == BLOCK_FREE) {
+                blocks[i].num = next++;
+                blocks[i].state = BLOCK_SENT;
+                blocks[i].tries_left = COAP_MAX_RETRANSMIT + 1;
+                blocks[i].timeout = COAP_ACK_TIMEOUT * US_PER_SEC;
+#if COAP_RANDOM_FACTOR_1000 > 1000
+                blocks[i].timeout = random_uint32_range(
+                    blocks[i].timeout,
+                    (blocks[i].timeout / 1000) * COAP_RANDOM_FACTOR_1000);
+#endif
+                blocks[i].deadline = xtimer_now_usec();
+            }
+        }
+        wait = _send_block_reqs(&sock, buf, path, blocks, id, szx);
+        if (wait < 0) {
+            res = wait;
+            break;
+        }
+
+        res = sock_udp_recv(&sock, buf, sizeof(buf), wait, NULL);
+        if ((res == -ETIMEDOUT) || (res == 0)) {
+            continue;
+        }
+        else if (res < 0) {
+            DEBUG("nanocoap: error receiving coap response, %d\n", res);
+            break;
+        }
+        if (coap_parse(&pkt, buf, res) < 0) {
+            DEBUG("nanocoap: error parsing packet\n");
+            continue;
+        }
+        for (unsigned i = 0; i < NANOCOAP_BLOCKWISE_WINDOW; i++) {
+            if ((blocks[i].state == BLOCK_SENT) &&
+                ((uint16_t)(id + blocks[i].num) == coap_get_id(&pkt))) {
+                block = &blocks[i];
+                break;
+            }
+        }
+        if ((block == NULL) || (coap_get_type(&pkt) != COAP_TYPE_ACK) ||
+            (coap_get_code_raw(&pkt) == COAP_CODE_EMPTY)) {
+            DEBUG("nanocoap: ignoring unexpected message\n");
+            continue;
+        }
+
+        block->state = BLOCK_ERR;
+        if (coap_get_code(&pkt) != 205) {
+            block->more = -coap_get_code(&pkt);
+        }
+        else if (!coap_get_block2(&pkt, &block2) && (block->num != 0)) {
+            DEBUG("nanocoap: server ignored Block2 option\n");
+            block->more = -EBADMSG;
+        }
+        else if ((block2.more >= 0) &&
+                 ((block2.blknum != block->num) || (block2.szx > szx))) {
+            DEBUG("nanocoap: unexpected block %u\n", (unsigned)block2.blknum);
+            block->more = -EBADMSG;
+        }
+        else if (pkt.payload_len > blklen) {
+            block->more = -EBADMSG;
+        }
+        else {
+            if (block2.more >= 0) {
+                /* server may have reduced the block size for the first block */
+                szx = block2.szx;
+            }
+            memcpy(data[block - blocks], pkt.payload, pkt.payload_len);
+            block->len = pkt.payload_len;
+            block->more = block2.more;
+            block->state = BLOCK_DONE;
+            if ((block2.more <= 0) && (block->num < last)) {
+                last = block->num;
+            }
+        }
+
+        /* pass the received blocks to the callback in order */
+        res = 1;
+        while ((res > 0) && ((block = _find_block(blocks, deliver)) != NULL) &&
+               (block->state != BLOCK_SENT)) {
+            if (block->state == BLOCK_ERR) {
+                res = block->more;
+            }
+            else if (callback(arg, (size_t)deliver << (szx + 4),
+                              data[block - blocks], block->len, block->more)) {
+                DEBUG("nanocoap: callback res != 0, aborting\n");
+                res = -ECANCELED;
+            }
+            else if (deliver == last) {
+                res = 0;
+            }
+            else {
+                block->state = BLOCK_FREE;
+                deliver++;
+                window = NANOCOAP_BLOCKWISE_WINDOW;
+            }
+        }
+        if (res <= 0) {
+            break;
+        }
+        /* stop requesting blocks beyond the last one */
+        for (unsigned i = 0; i < NANOCOAP_BLOCKWISE_WINDOW; i++) {
+            if (blocks[i].num > last) {
+                blocks[i].state = BLOCK_FREE;
+            }
+        }
+    }
+
+    sock_udp_close(&sock);
+    return res;
+}
+
+/* sends a request payload block by block, as servers expect the blocks of a
+ * request payload in order */
+static int _send_blockwise(sock_udp_ep_t *remote, const char *path,
+                           unsigned method, coap_blksize_t blksize,
+                           const uint8_t *data, size_t len)
+{
+    uint8_t buf[BLOCKWISE_HDR_MAX + coap_szx2size(blksize)];
+    uint16_t id = random_uint32();
+    unsigned szx = blksize;
+    size_t offset = 0;
+
+    if (strlen(path) > NANOCOAP_URI_MAX) {
+        return -EINVAL;
+    }
+
+    while (1) {
+        size_t blklen = coap_szx2size(szx);
+        int more = (len - offset) > blklen;
+        size_t chunk = more ? blklen : (len - offset);
+        uint8_t *pktpos = buf;
+        coap_block1_t block1;
+        coap_pkt_t pkt;
+        ssize_t res;
+        unsigned code;
+
+        pkt.hdr = (coap_hdr_t *)buf;
+        pktpos += coap_build_hdr(pkt.hdr, COAP_TYPE_CON, NULL, 0, method, id++);
+        pktpos += coap_opt_put_uri_path(pktpos, 0, path);
+        pktpos += coap_put_option_block1(pktpos, COAP_OPT_URI_PATH,
+                                         offset >> (szx + 4), szx, more);
+        if (chunk) {
+            *pktpos++ = 0xFF;
+            memcpy(pktpos, &data[offset], chunk);
+        }
+        pkt.payload = pktpos;
+        pkt.payload_len = chunk;
+
+        res = nanocoap_request(&pkt, NULL, remote, sizeof(buf));
+        if (res < 0) {
+            return res;
+        }
+        code = coap_get_code(&pkt);
+        if (!more) {
+            return (code / 100 == 2) ? 0 : -(int)code;
+        }
+        if (code != 231) {
+            DEBUG("nanocoap: block %u not continued, code %u\n",
+                  (unsigned)(offset >> (szx + 4)), code);
+            return (code / 100 == 2) ? -EBADMSG : -(int)code;
+        }
+        /* the server may ask for smaller blocks (RFC 7959, section 2.5) */
+        if (coap_get_block1(&pkt, &block1) && (block1.szx < szx)) {
+            szx = block1.szx;
+        }
+        offset += chunk;
+    }
+}
+
+int nanocoap_put_blockwise(sock_udp_ep_t *remote, const char *path,
+                           coap_blksize_t blksize, const void *data,
+                           size_t len)
+{
+    return _send_blockwise(remote, path, COAP_METHOD_PUT, blksize, data, len);
+}
+
+int nanocoap_post_blockwise(sock_udp_ep_t *remote, const char *path,
+                            coap_blksize_t blksize, const void *data,
+                            size_t len)
+{
+    return _send_blockwise(remote, path, COAP_METHOD_POST, blksize, data,
+                           len);
+}
+
+ssize_t nanocoap_block1_sink(nanocoap_block1_sink_t *sink, coap_pkt_t *pkt,
+                             uint8_t *buf, size_t len)
+{
+    coap_block1_t block1;
+    unsigned code;
+    int has_block1 = coap_get_block1(pkt, &block1);
+    ssize_t hdr_len;
+
+    if (!has_block1) {
+        block1.more = 0;
+    }
+    if (block1.offset == 0) {
+        /* start of a new payload */
+        sink->offset = 0;
+    }
+    if (block1.offset < sink->offset) {
+        DEBUG("nanocoap: retransmission of block %u\n",
+              (unsigned)block1.blknum);
+        code = block1.more ? COAP_CODE_CONTINUE : COAP_CODE_CHANGED;
+    }
+    else if (block1.offset > sink->offset) {
+        DEBUG("nanocoap: expected offset %u, got %u\n",
+              (unsigned)sink->offset, (unsigned)block1.offset);
+        /* RFC 7959, section 2.9.2: the client starts over */
+        sink->offset = 0;
+        return coap_reply_simple(pkt, COAP_CODE_REQUEST_ENTITY_INCOMPLETE,
+                                 buf, len, 0, NULL, 0);
+    }
+    else if (sink->callback(sink->arg, block1.offset, pkt->payload,
+                            pkt->payload_len, has_block1 ? block1.more : -1)) {
+        sink->offset = 0;
+        return coap_reply_simple(pkt, COAP_CODE_INTERNAL_SERVER_ERROR,
+                                 buf, len, 0, NULL, 0);
+    }
+    else {
+        sink->offset += pkt->payload_len;
+        code = block1.more ? COAP_CODE_CONTINUE : COAP_CODE_CHANGED;
+    }
+
+    hdr_len = coap_build_reply(pkt, code, buf, len, 0);
+    if ((hdr_len > 0) && has_block1) {
+        hdr_len += coap_put_option_block1(buf + hdr_len, 0, block1.blknum,
+                                          block1.szx, block1.more);
+    }
+    return hdr_len;
+}
@@ -23,6 +23,7 @@
 #include "net/gnrc.h"
 #ifdef MODULE_GNRC_IPV6_NIB
 #include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/ipv6/nib/dst_cache.h"
 #include "net/gnrc/ipv6.h"
 #endif /* MODULE_GNRC_IPV6_NIB */
 #ifdef MODULE_NETSTATS
@@ -45,6 +46,12 @@ static void _update_l2addr_from_dev(gnrc_netif_t *netif);
 static void _configure_netdev(netdev_t *dev);
 static void *_gnrc_netif_thread(void *args);
 static void _event_cb(netdev_t *dev, netdev_event_t event);
+#ifdef MODULE_GNRC_NETIF_TX_FEEDBACK
+static void _tx_feedback_dst(gnrc_netif_t *netif, const gnrc_pktsnip_t *pkt);
+static void _tx_feedback(gnrc_netif_t *netif, netdev_event_t event);
+
+static gnrc_netif_tx_feedback_cb_t _tx_feedback_cb;
+#endif
 
 gnrc_netif_t *gnrc_netif_create(char *stack, int stacksize, char priority,
                                 const char *name, netdev_t *netdev,
@@ -619,6 +626,8 @@ int gnrc_netif_ipv6_addr_add_internal(gnrc_netif_t *netif,
     netif->ipv6.addrs_flags[idx] = flags;
     memcpy(&netif->ipv6.addrs[idx], addr, sizeof(netif->ipv6.addrs[idx]));
 #ifdef MODULE_GNRC_IPV6_NIB
+    /* source address selection may now yield a different result */
+    gnrc_ipv6_nib_dst_cache_invalidate();
     if (_get_state(netif, idx) == GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID) {
         void *state = NULL;
         gnrc_ipv6_nib_pl_t ple;
@@ -664,6 +673,9 @@ void gnrc_netif_ipv6_addr_remove_internal(gnrc_netif_t *netif,
         if (ipv6_addr_equal(&netif->ipv6.addrs[i], addr)) {
             netif->ipv6.addrs_flags[i] = 0;
             ipv6_addr_set_unspecified(&netif->ipv6.addrs[i]);
+#ifdef MODULE_GNRC_IPV6_NIB
+            gnrc_ipv6_nib_dst_cache_invalidate();
+#endif
         }
         else {
             ipv6_addr_t tmp;
@@ -1407,10 +1419,20 @@ static void *_gnrc_netif_thread(void *args)
                 break;
             case GNRC_NETAPI_MSG_TYPE_SND:
                 DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_SND received\n");
+#ifdef MODULE_GNRC_NETIF_TX_FEEDBACK
+                /* the device may signal the completion already in send() */
+                _tx_feedback_dst(netif, msg.content.ptr);
+#endif
                 res = netif->ops->send(netif, msg.content.ptr);
                 if (res < 0) {
                     DEBUG("gnrc_netif: error sending packet %p (code: %i)\n",
                           msg.content.ptr, res);
+#ifdef MODULE_GNRC_NETIF_TX_FEEDBACK
+                    /* no completion will be signaled for this frame */
+                    if (netif->tx_feedback.pending > 0) {
+                        netif->tx_feedback.pending--;
+                    }
+#endif
                 }
 #ifdef MODULE_NETSTATS_L2
                 else {
@@ -1482,6 +1504,70 @@ static void _pass_on_packet(gnrc_pktsnip_t *pkt)
     }
 }
 
+#ifdef MODULE_GNRC_NETIF_TX_FEEDBACK
+void gnrc_netif_tx_feedback_set_cb(gnrc_netif_tx_feedback_cb_t cb)
+{
+    _tx_feedback_cb = cb;
+}
+
+/* remembers the destination of a frame handed to the device, as long as its
+ * TX feedback can be attributed to it */
+static void _tx_feedback_dst(gnrc_netif_t *netif, const gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_tx_feedback_t *fb = &netif->tx_feedback;
+    const gnrc_netif_hdr_t *hdr = pkt->data;
+
+    /* while the outcome of an earlier frame is still pending, the next
+     * completion signaled might be for that frame */
+    fb->dst_len = 0;
+    if ((fb->pending++ == 0) && (pkt->type == GNRC_NETTYPE_NETIF) &&
+        !(hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                        GNRC_NETIF_HDR_FLAGS_MULTICAST)) &&
+        (hdr->dst_l2addr_len <= sizeof(fb->dst))) {
+        memcpy(fb->dst, gnrc_netif_hdr_get_dst_addr(hdr), hdr->dst_l2addr_len);
+        fb->dst_len = hdr->dst_l2addr_len;
+    }
+    if (fb->pending == 0) {
+        /* keep counting saturated */
+        fb->pending = UINT8_MAX;
+    }
+}
+
+/* reports the outcome of a unicast transmission */
+static void _tx_feedback(gnrc_netif_t *netif, netdev_event_t event)
+{
+    gnrc_netif_tx_feedback_t *fb = &netif->tx_feedback;
+    gnrc_netif_tx_feedback_cb_t cb = _tx_feedback_cb;
+    bool acked = (event == NETDEV_EVENT_TX_COMPLETE);
+    unsigned num_tx = 1;
+
+    if ((!acked && (event != NETDEV_EVENT_TX_NOACK) &&
+         (event != NETDEV_EVENT_TX_MEDIUM_BUSY)) || (fb->pending == 0)) {
+        return;
+    }
+    if ((--fb->pending > 0) || (fb->dst_len == 0) ||
+        (event == NETDEV_EVENT_TX_MEDIUM_BUSY)) {
+        /* the frame was not sent to a single neighbor, can not be attributed
+         * or did not reach the medium */
+        fb->dst_len = 0;
+        return;
+    }
+    if (acked) {
+        uint8_t retries;
+
+        /* devices without link-layer retransmissions count as one try */
+        if (netif->dev->driver->get(netif->dev, NETOPT_TX_RETRIES_NEEDED,
+                                    &retries, sizeof(retries)) > 0) {
+            num_tx += retries;
+        }
+    }
+    if (cb != NULL) {
+        cb(netif->pid, fb->dst, fb->dst_len, num_tx, acked);
+    }
+    fb->dst_len = 0;
+}
+#endif
+
 static void _event_cb(netdev_t *dev, netdev_event_t event)
 {
     gnrc_netif_t *netif = (gnrc_netif_t *) dev->context;
@@ -1497,6 +1583,9 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
     else {
         DEBUG("gnrc_netif: event triggered -> %i\n", event);
         gnrc_pktsnip_t *pkt = NULL;
+#ifdef MODULE_GNRC_NETIF_TX_FEEDBACK
+        _tx_feedback(netif, event);
+#endif
         switch (event) {
             case NETDEV_EVENT_RX_COMPLETE:
                 pkt = netif->ops->recv(netif);
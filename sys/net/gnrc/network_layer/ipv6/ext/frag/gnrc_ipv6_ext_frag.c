@@ -15,7 +15,10 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
+#include "bitarithm.h"
+#include "bitfield.h"
 #include "byteorder.h"
 #include "net/ipv6/ext/frag.h"
 #include "net/ipv6/addr.h"
@@ -36,8 +39,6 @@
 
 static gnrc_ipv6_ext_frag_send_t _snd_bufs[CONFIG_GNRC_IPV6_EXT_FRAG_SEND_SIZE];
 static gnrc_ipv6_ext_frag_rbuf_t _rbuf[CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE];
-static gnrc_ipv6_ext_frag_limits_t _limits_pool[CONFIG_GNRC_IPV6_EXT_FRAG_LIMITS_POOL_SIZE];
-static clist_node_t _free_limits;
 static xtimer_t _gc_xtimer;
 static msg_t _gc_msg = { .type = GNRC_IPV6_EXT_FRAG_RBUF_GC };
 static gnrc_ipv6_ext_frag_stats_t _stats;
@@ -52,8 +53,11 @@ static uint32_t _last_id;
 typedef enum {
     FRAG_LIMITS_NEW = 0,        /**< limits are not present and do not overlap */
     FRAG_LIMITS_DUPLICATE,      /**< fragment limits are already present */
-    FRAG_LIMITS_OVERLAP,        /**< limits overlap */
-    FRAG_LIMITS_FULL,           /**< no free gnrc_ipv6_ext_frag_limits_t object */
+    FRAG_LIMITS_EMPTY,          /**< fragment carries no data */
+    FRAG_LIMITS_OVERLAP,        /**< limits overlap or are inconsistent with
+                                 *   the end of the datagram */
+    FRAG_LIMITS_TOO_LARGE,      /**< limits exceed
+                                 *   CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_MAX_LEN */
 } _limits_res_t;
 
 void gnrc_ipv6_ext_frag_init(void)
@@ -62,9 +66,6 @@ void gnrc_ipv6_ext_frag_init(void)
     memset(_rbuf, 0, sizeof(_rbuf));
 #endif
     _last_id = random_uint32();
-    for (unsigned i = 0; i < CONFIG_GNRC_IPV6_EXT_FRAG_LIMITS_POOL_SIZE; i++) {
-        clist_rpush(&_free_limits, (clist_node_t *)&_limits_pool[i]);
-    }
 }
 
 /*
@@ -367,16 +368,42 @@ static inline void _init_rbuf(gnrc_ipv6_ext_frag_rbuf_t *rbuf, ipv6_hdr_t *ipv6,
  * @brief   Checks if given fragment limits overlap with fragment limits already
  *          in a given reassembly buffer entry
  *
- * If no overlap exists the new limits are added to @p rbuf.
+ * If no overlap exists the new limits are marked as received in @p rbuf.
  *
  * @param[in, out] rbuf A reassembly buffer entry.
  * @param[in] offset    A fragment offset.
  * @param[in] pkt_len   The length of the packet.
+ * @param[in] last      The fragment is the last fragment of the datagram.
  *
  * @return  see _limits_res_t.
  */
 static _limits_res_t _overlaps(gnrc_ipv6_ext_frag_rbuf_t *rbuf,
-                               unsigned offset, unsigned pkt_len);
+                               unsigned offset, unsigned pkt_len, bool last);
+
+/**
+ * @brief   Checks if @p size bytes for @p rbuf would exceed the reassembly
+ *          buffer quota of its source
+ *
+ * @param[in] rbuf  A reassembly buffer entry.
+ * @param[in] size  The size gnrc_ipv6_ext_frag_rbuf_t::pkt of @p rbuf would
+ *                  have.
+ *
+ * @return  true, if the quota would be exceeded.
+ * @return  false, otherwise.
+ */
+static bool _quota_exceeded(const gnrc_ipv6_ext_frag_rbuf_t *rbuf,
+                            size_t size);
+
+/**
+ * @brief   Removes the least recently used reassembly buffer entry other than
+ *          @p rbuf to free up packet buffer space
+ *
+ * @param[in] rbuf  A reassembly buffer entry that is not to be removed.
+ *
+ * @return  true, if an entry was removed.
+ * @return  false, if there was no entry to remove.
+ */
+static bool _evict_other(const gnrc_ipv6_ext_frag_rbuf_t *rbuf);
 
 /**
  * @brief   Sets the next header field of a header.
@@ -428,18 +455,31 @@ gnrc_pktsnip_t *gnrc_ipv6_ext_frag_reass(gnrc_pktsnip_t *pkt)
                    sched_active_pid);
     nh = fh->nh;
     offset = ipv6_ext_frag_get_offset(fh);
-    switch (_overlaps(rbuf, offset, pkt->size)) {
+    switch (_overlaps(rbuf, offset, pkt->size, !ipv6_ext_frag_more(fh))) {
         case FRAG_LIMITS_NEW:
             break;
         case FRAG_LIMITS_DUPLICATE:
             gnrc_pktbuf_release(pkt);
             return NULL;
+        case FRAG_LIMITS_EMPTY:
+            DEBUG("ipv6_ext_frag: ignoring empty fragment\n");
+            if (rbuf->frags == 0) {
+                /* entry was just created for this fragment and points to its
+                 * IPv6 header */
+                goto error_exit;
+            }
+            gnrc_pktbuf_release(pkt);
+            return NULL;
         case FRAG_LIMITS_OVERLAP:
+            /* RFC 5722: discard the whole datagram */
             DEBUG("ipv6_ext_frag: fragment overlaps with existing fragments\n");
-            /* intentionally falls through */
-        case FRAG_LIMITS_FULL:
+            if (IS_USED(MODULE_GNRC_IPV6_EXT_FRAG_STATS)) {
+                _stats.overlaps++;
+            }
+            goto error_exit;
+        case FRAG_LIMITS_TOO_LARGE:
         default:
-            DEBUG("ipv6_ext_frag: can't store fragment limits\n");
+            DEBUG("ipv6_ext_frag: datagram too large for reassembly buffer\n");
             goto error_exit;
     }
     if (offset > 0) {
@@ -458,22 +498,32 @@ gnrc_pktsnip_t *gnrc_ipv6_ext_frag_reass(gnrc_pktsnip_t *pkt)
             DEBUG("ipv6_ext_frag: fragment length not divisible by 8");
             goto error_exit;
         }
+        if (((rbuf->pkt == NULL) || (rbuf->pkt->size < size_until)) &&
+            _quota_exceeded(rbuf, size_until)) {
+            DEBUG("ipv6_ext_frag: reassembly buffer quota of source "
+                  "exceeded\n");
+            goto error_quota;
+        }
         if (rbuf->pkt == NULL) {
             /* entry did not exist yet */
-            rbuf->pkt = gnrc_pktbuf_add(fh_snip->next, NULL, size_until,
-                                        GNRC_NETTYPE_UNDEF);
-            if (rbuf->pkt == NULL) {
-                DEBUG("ipv6_ext_frag: unable to create space for reassembled "
-                      "packet\n");
-                goto error_exit;
+            while ((rbuf->pkt = gnrc_pktbuf_add(fh_snip->next, NULL,
+                                                size_until,
+                                                GNRC_NETTYPE_UNDEF)) == NULL) {
+                if (!_evict_other(rbuf)) {
+                    DEBUG("ipv6_ext_frag: unable to create space for "
+                          "reassembled packet\n");
+                    goto error_exit;
+                }
             }
         }
         else if (rbuf->pkt->size < size_until) {
             /* entry exists already but doesn't fit full datagram yet */
-            if (gnrc_pktbuf_realloc_data(rbuf->pkt, size_until) != 0) {
-                DEBUG("ipv6_ext_frag: unable to allocate space for reassembled "
-                      "packet\n");
-                goto error_exit;
+            while (gnrc_pktbuf_realloc_data(rbuf->pkt, size_until) != 0) {
+                if (!_evict_other(rbuf)) {
+                    DEBUG("ipv6_ext_frag: unable to allocate space for "
+                          "reassembled packet\n");
+                    goto error_exit;
+                }
             }
         }
         /* copy payload of fragment into reassembled datagram */
@@ -522,6 +572,8 @@ gnrc_pktsnip_t *gnrc_ipv6_ext_frag_reass(gnrc_pktsnip_t *pkt)
         if (rbuf->pkt != NULL) {
             /* first fragment but not first arriving */
             memcpy(rbuf->pkt->data, pkt->data, pkt->size);
+            /* use headers of first fragment from here on */
+            gnrc_pktbuf_release(rbuf->pkt->next);
             rbuf->pkt->next = pkt->next;
             rbuf->pkt->type = pkt->type;
             /* payload was copied to reassembly buffer so remove it */
@@ -529,12 +581,21 @@ gnrc_pktsnip_t *gnrc_ipv6_ext_frag_reass(gnrc_pktsnip_t *pkt)
             rbuf->ipv6 = ipv6;
             return _completed(rbuf);
         }
+        else if (_quota_exceeded(rbuf, pkt->size)) {
+            DEBUG("ipv6_ext_frag: reassembly buffer quota of source "
+                  "exceeded\n");
+            goto error_quota;
+        }
         else {
             /* first fragment but first arriving */
             rbuf->pkt = pkt;
         }
     }
     return NULL;
+error_quota:
+    if (IS_USED(MODULE_GNRC_IPV6_EXT_FRAG_STATS)) {
+        _stats.quota_exceeded++;
+    }
 error_exit:
     gnrc_ipv6_ext_frag_rbuf_del(rbuf);
 error_release:
@@ -542,10 +603,42 @@ error_release:
     return NULL;
 }
 
+/**
+ * @brief   Finds the least recently used reassembly buffer entry
+ *
+ * @param[in] src       Only consider entries of this source. May be NULL to
+ *                      consider entries of all sources.
+ * @param[in] except    Entry not to consider. May be NULL.
+ *
+ * @return  The least recently used entry matching the criteria.
+ * @return  NULL, if there is no such entry.
+ */
+static gnrc_ipv6_ext_frag_rbuf_t *_lru(const ipv6_addr_t *src,
+                                       const gnrc_ipv6_ext_frag_rbuf_t *except)
+{
+    gnrc_ipv6_ext_frag_rbuf_t *res = NULL;
+
+    for (unsigned i = 0; i < CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE; i++) {
+        gnrc_ipv6_ext_frag_rbuf_t *tmp = &_rbuf[i];
+
+        if ((tmp->ipv6 == NULL) || (tmp == except) ||
+            ((src != NULL) && !ipv6_addr_equal(&tmp->ipv6->src, src))) {
+            continue;
+        }
+        if ((res == NULL) ||
+            /* xtimer_now_usec() overflows every ~1.2 hours */
+            ((int32_t)(tmp->arrival - res->arrival) < 0)) {
+            res = tmp;
+        }
+    }
+    return res;
+}
+
 gnrc_ipv6_ext_frag_rbuf_t *gnrc_ipv6_ext_frag_rbuf_get(ipv6_hdr_t *ipv6,
                                                        uint32_t id)
 {
-    gnrc_ipv6_ext_frag_rbuf_t *res = NULL, *oldest = NULL;
+    gnrc_ipv6_ext_frag_rbuf_t *res = NULL;
+
     for (unsigned i = 0; i < CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE; i++) {
         gnrc_ipv6_ext_frag_rbuf_t *tmp = &_rbuf[i];
         if (tmp->ipv6 != NULL) {
@@ -557,39 +650,37 @@ gnrc_ipv6_ext_frag_rbuf_t *gnrc_ipv6_ext_frag_rbuf_get(ipv6_hdr_t *ipv6,
         }
         else if (res == NULL) {
             res = tmp;
-            _init_rbuf(res, ipv6, id);
-        }
-        if ((oldest == NULL) ||
-            /* xtimer_now_usec() overflows every ~1.2 hours */
-            ((tmp->arrival - oldest->arrival) < (UINT32_MAX / 2))) {
-            oldest = tmp;
         }
     }
     if ((res == NULL) &&
         !IS_ACTIVE(CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_DO_NOT_OVERRIDE)) {
-        assert(oldest != NULL); /* reassembly buffer is full, so there needs
-                                 * to be an oldest entry */
-        DEBUG("ipv6_ext_frag: dropping oldest entry\n");
+        /* prefer to drop a datagram of the same source, so a single source
+         * can't push the datagrams of all other sources out */
+        if ((res = _lru(&ipv6->src, NULL)) == NULL) {
+            res = _lru(NULL, NULL);
+        }
+        assert(res != NULL);    /* reassembly buffer is full, so there needs
+                                 * to be a least recently used entry */
+        DEBUG("ipv6_ext_frag: dropping least recently used entry\n");
         if (IS_USED(MODULE_GNRC_IPV6_EXT_FRAG_STATS)) {
             _stats.rbuf_full++;
         }
-        gnrc_ipv6_ext_frag_rbuf_del(oldest);
-        res = oldest;
-        _init_rbuf(res, ipv6, id);
+        gnrc_ipv6_ext_frag_rbuf_del(res);
     }
     else if (IS_USED(MODULE_GNRC_IPV6_EXT_FRAG_STATS) && (res == NULL)) {
         _stats.rbuf_full++;
     }
+    if (res != NULL) {
+        _init_rbuf(res, ipv6, id);
+    }
     return res;
 }
 
 void gnrc_ipv6_ext_frag_rbuf_free(gnrc_ipv6_ext_frag_rbuf_t *rbuf)
 {
     rbuf->ipv6 = NULL;
-    while (rbuf->limits.next != NULL) {
-        clist_node_t *tmp = clist_lpop(&rbuf->limits);
-        clist_rpush(&_free_limits, tmp);
-    }
+    rbuf->received_units = 0;
+    memset(rbuf->received, 0, sizeof(rbuf->received));
 }
 
 void gnrc_ipv6_ext_frag_rbuf_gc(void)
@@ -608,69 +699,131 @@ gnrc_ipv6_ext_frag_stats_t *gnrc_ipv6_ext_frag_stats(void)
     return (IS_USED(MODULE_GNRC_IPV6_EXT_FRAG_STATS)) ? &_stats : NULL;
 }
 
-typedef struct {
-    uint16_t start;
-    uint16_t end;
-} _check_limits_t;
-
 static inline void _init_rbuf(gnrc_ipv6_ext_frag_rbuf_t *rbuf, ipv6_hdr_t *ipv6,
                               uint32_t id)
 {
     rbuf->ipv6 = ipv6;
     rbuf->id = id;
     rbuf->pkt_len = 0;
+    rbuf->received_units = 0;
+    rbuf->total_units = 0;
+    rbuf->frags = 0;
     rbuf->last = 0;
+    memset(rbuf->received, 0, sizeof(rbuf->received));
+}
+
+/**
+ * @brief   Gets the mask for @p n units within a byte of a bitfield starting
+ *          at unit @p bit
+ *
+ * @note    @ref sys_bitfield numbers the bits of a byte MSB first
+ */
+static inline uint8_t _units_mask(unsigned bit, unsigned n)
+{
+    return (uint8_t)((0xffU >> bit) & ~(0xffU >> (bit + n)));
 }
 
-static int _check_overlap(clist_node_t *node, void *arg)
+static unsigned _count_units(const uint8_t *received, unsigned start,
+                             unsigned end)
 {
-    _check_limits_t *limits = arg;
-    gnrc_ipv6_ext_frag_limits_t *cur = (gnrc_ipv6_ext_frag_limits_t *)node;
+    unsigned res = 0;
+
+    while (start < end) {
+        unsigned bit = start & 0x7U;
+        unsigned n = ((end - start) < (8U - bit)) ? (end - start) : (8U - bit);
 
-    return ((cur->start < limits->end) && (limits->start < cur->end));
+        res += bitarithm_bits_set(received[start >> 3U] & _units_mask(bit, n));
+        start += n;
+    }
+    return res;
 }
 
-static int _limits_cmp(clist_node_t *a, clist_node_t *b)
+static void _set_units(uint8_t *received, unsigned start, unsigned end)
 {
-    gnrc_ipv6_ext_frag_limits_t *al = (gnrc_ipv6_ext_frag_limits_t *)a;
-    gnrc_ipv6_ext_frag_limits_t *bl = (gnrc_ipv6_ext_frag_limits_t *)b;
+    while (start < end) {
+        unsigned bit = start & 0x7U;
+        unsigned n = ((end - start) < (8U - bit)) ? (end - start) : (8U - bit);
 
-    return (int)al->start - (int)bl->start;
+        received[start >> 3U] |= _units_mask(bit, n);
+        start += n;
+    }
 }
 
 static _limits_res_t _overlaps(gnrc_ipv6_ext_frag_rbuf_t *rbuf,
-                               unsigned offset, unsigned pkt_len)
+                               unsigned offset, unsigned pkt_len, bool last)
 {
-    _check_limits_t limits = { .start = offset >> 3U,
-                               .end = (offset + pkt_len) >> 3U };
-    gnrc_ipv6_ext_frag_limits_t *res;
-
-    if (limits.start == limits.end) {
-        /* might happen with last fragment */
-        limits.end++;
-    }
-    res = (gnrc_ipv6_ext_frag_limits_t *)clist_foreach(&rbuf->limits,
-                                                       _check_overlap,
-                                                       &limits);
-    if (res == NULL) {
-        res = (gnrc_ipv6_ext_frag_limits_t *)clist_lpop(&_free_limits);
-        if (res != NULL) {
-            res->start = limits.start;
-            res->end = limits.end;
-            clist_rpush(&rbuf->limits, (clist_node_t *)res);
-            clist_sort(&rbuf->limits, _limits_cmp);
-            return FRAG_LIMITS_NEW;
+    /* the last fragment may end within a unit */
+    unsigned start = offset >> 3U, end = (offset + pkt_len + 7U) >> 3U;
+    unsigned received;
+
+    if ((offset + pkt_len) > CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_MAX_LEN) {
+        return FRAG_LIMITS_TOO_LARGE;
+    }
+    if (start == end) {
+        /* empty fragment; nothing to add */
+        return FRAG_LIMITS_EMPTY;
+    }
+    if (rbuf->last) {
+        /* the end of the datagram is already known */
+        if ((end > rbuf->total_units) ||
+            (last && (end != rbuf->total_units))) {
+            return FRAG_LIMITS_OVERLAP;
         }
-        else {
-            return FRAG_LIMITS_FULL;
+    }
+    else if (last &&
+             (_count_units(rbuf->received, end,
+                           GNRC_IPV6_EXT_FRAG_RBUF_UNITS) > 0)) {
+        /* data was already received beyond the end of the datagram */
+        return FRAG_LIMITS_OVERLAP;
+    }
+    received = _count_units(rbuf->received, start, end);
+    if (received == (end - start)) {
+        /* a last fragment only duplicates a fragment already known to be the
+         * last */
+        return (!last || rbuf->last) ? FRAG_LIMITS_DUPLICATE
+                                     : FRAG_LIMITS_OVERLAP;
+    }
+    else if (received > 0) {
+        return FRAG_LIMITS_OVERLAP;
+    }
+    _set_units(rbuf->received, start, end);
+    rbuf->received_units += end - start;
+    rbuf->frags++;
+    if (last) {
+        rbuf->total_units = end;
+    }
+    return FRAG_LIMITS_NEW;
+}
+
+static bool _quota_exceeded(const gnrc_ipv6_ext_frag_rbuf_t *rbuf,
+                            size_t size)
+{
+    for (unsigned i = 0; i < CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE; i++) {
+        const gnrc_ipv6_ext_frag_rbuf_t *tmp = &_rbuf[i];
+
+        if ((tmp != rbuf) && (tmp->ipv6 != NULL) && (tmp->pkt != NULL) &&
+            ipv6_addr_equal(&tmp->ipv6->src, &rbuf->ipv6->src)) {
+            size += tmp->pkt->size;
         }
     }
-    else if ((res->start == limits.start) && (res->end == limits.end)) {
-        return FRAG_LIMITS_DUPLICATE;
+    return (size > CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SRC_QUOTA);
+}
+
+static bool _evict_other(const gnrc_ipv6_ext_frag_rbuf_t *rbuf)
+{
+    gnrc_ipv6_ext_frag_rbuf_t *lru;
+
+    if (IS_ACTIVE(CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_DO_NOT_OVERRIDE) ||
+        ((lru = _lru(NULL, rbuf)) == NULL)) {
+        return false;
     }
-    else {
-        return FRAG_LIMITS_NEW;
+    DEBUG("ipv6_ext_frag: packet buffer full, dropping least recently used "
+          "entry\n");
+    if (IS_USED(MODULE_GNRC_IPV6_EXT_FRAG_STATS)) {
+        _stats.rbuf_full++;
     }
+    gnrc_ipv6_ext_frag_rbuf_del(lru);
+    return true;
 }
 
 static inline void _set_nh(gnrc_pktsnip_t *hdr_snip, uint8_t nh)
@@ -695,30 +848,19 @@ static inline void _set_nh(gnrc_pktsnip_t *hdr_snip, uint8_t nh)
 
 static gnrc_pktsnip_t *_completed(gnrc_ipv6_ext_frag_rbuf_t *rbuf)
 {
-    assert(rbuf->limits.next != NULL);    /* this function is only called when
-                                           * at least one fragment was already
-                                           * added */
-    /* clist: first element is second element ;-) (from next of head) */
-    gnrc_ipv6_ext_frag_limits_t *ptr =
-            (gnrc_ipv6_ext_frag_limits_t *)rbuf->limits.next->next;
-    if (rbuf->last && (ptr->start == 0)) {
-        gnrc_pktsnip_t *res = NULL;
-
-        /* last and first fragment were received, so check if everything
-         * in-between is there */
-        do {
-            gnrc_ipv6_ext_frag_limits_t *next = ptr->next;
-            if (ptr->end < next->start) {
-                return NULL;
-            }
-            ptr = next;
-        } while (((clist_node_t *)ptr) != rbuf->limits.next);
+    assert(rbuf->received_units > 0);   /* this function is only called
+                                         * when at least one fragment was
+                                         * already added */
+    if (rbuf->last && (rbuf->received_units == rbuf->total_units)) {
+        /* last fragment was received and no units are missing before it */
+        gnrc_pktsnip_t *res;
+
         res = rbuf->pkt;
         /* rewrite length */
         rbuf->ipv6->len = byteorder_htons(rbuf->pkt_len);
         rbuf->pkt = NULL;
         if (IS_USED(MODULE_GNRC_IPV6_EXT_FRAG_STATS)) {
-            _stats.fragments += clist_count(&rbuf->limits);
+            _stats.fragments += rbuf->frags;
             _stats.datagrams++;
         }
         gnrc_ipv6_ext_frag_rbuf_free(rbuf);
@@ -28,7 +28,10 @@
 #include "utlist.h"
 
 #include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/ipv6/nib/dst_cache.h"
 #include "net/gnrc/netif/internal.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/gnrc/rpl/srh_cache.h"
 #include "net/gnrc/ipv6/whitelist.h"
 #include "net/gnrc/ipv6/blacklist.h"
 
@@ -291,7 +294,7 @@ static void _send_to_iface(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
     }
 }
 
-static gnrc_pktsnip_t *_create_netif_hdr(uint8_t *dst_l2addr,
+static gnrc_pktsnip_t *_create_netif_hdr(const uint8_t *dst_l2addr,
                                          unsigned dst_l2addr_len,
                                          gnrc_pktsnip_t *pkt,
                                          uint8_t flags)
@@ -481,11 +484,89 @@ static void _send_by_netif_hdr(gnrc_pktsnip_t *pkt)
 }
 #endif  /* MODULE_GNRC_IPV6_EXT_FRAG */
 
+static void _send_unicast_to_next_hop(gnrc_pktsnip_t *pkt, bool prep_hdr,
+                                      gnrc_netif_t *netif,
+                                      const uint8_t *l2addr,
+                                      unsigned l2addr_len,
+                                      uint8_t netif_hdr_flags)
+{
+    DEBUG("ipv6: add interface header to packet\n");
+    if ((pkt = _create_netif_hdr(l2addr, l2addr_len, pkt,
+                                 netif_hdr_flags)) == NULL) {
+        return;
+    }
+    /* prep_hdr => The packet is from me */
+    if (_fragment_pkt_if_needed(pkt, netif, prep_hdr)) {
+        DEBUG("ipv6: packet is fragmented\n");
+        return;
+    }
+    DEBUG("ipv6: send unicast over interface %" PRIkernel_pid "\n",
+          netif->pid);
+    /* and send to interface */
+#ifdef MODULE_NETSTATS_IPV6
+    netif->ipv6.stats.tx_unicast_count++;
+#endif
+    _send_to_iface(netif, pkt);
+}
+
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+static void _dst_cache_put(const gnrc_ipv6_nib_nc_t *nce,
+                           const ipv6_hdr_t *ipv6_hdr, bool src_selected,
+                           unsigned version)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+    unsigned nud_state = gnrc_ipv6_nib_nc_get_nud_state(nce);
+
+    /* the NIB needs to see every use of neighbors in other states for
+     * neighbor unreachability detection */
+    if ((nud_state != GNRC_IPV6_NIB_NC_INFO_NUD_STATE_REACHABLE) &&
+        (nud_state != GNRC_IPV6_NIB_NC_INFO_NUD_STATE_UNMANAGED)) {
+        return;
+    }
+    memcpy(&entry.dst, &ipv6_hdr->dst, sizeof(entry.dst));
+    if (src_selected) {
+        memcpy(&entry.src, &ipv6_hdr->src, sizeof(entry.src));
+    }
+    else {
+        ipv6_addr_set_unspecified(&entry.src);
+    }
+    memcpy(entry.l2addr, nce->l2addr, nce->l2addr_len);
+    entry.l2addr_len = nce->l2addr_len;
+    entry.iface = gnrc_ipv6_nib_nc_get_iface(nce);
+    entry.version = version;
+    gnrc_ipv6_nib_dst_cache_put(&entry);
+}
+
+static void _send_unicast_cached(gnrc_pktsnip_t *pkt, bool prep_hdr,
+                                 ipv6_hdr_t *ipv6_hdr,
+                                 const gnrc_ipv6_nib_dst_cache_t *dce,
+                                 uint8_t netif_hdr_flags)
+{
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(dce->iface);
+
+    DEBUG("ipv6: send unicast via destination cache\n");
+    assert(netif != NULL);
+    if (prep_hdr && ipv6_addr_is_unspecified(&ipv6_hdr->src)) {
+        /* if no source address was cached, _fill_ipv6_hdr() selects one */
+        memcpy(&ipv6_hdr->src, &dce->src, sizeof(ipv6_hdr->src));
+    }
+    if (_safe_fill_ipv6_hdr(netif, pkt, prep_hdr)) {
+        _send_unicast_to_next_hop(pkt, prep_hdr, netif, dce->l2addr,
+                                  dce->l2addr_len, netif_hdr_flags);
+    }
+}
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
+
 static void _send_unicast(gnrc_pktsnip_t *pkt, bool prep_hdr,
                           gnrc_netif_t *netif, ipv6_hdr_t *ipv6_hdr,
                           uint8_t netif_hdr_flags)
 {
     gnrc_ipv6_nib_nc_t nce;
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+    /* get version before the lookup, so NIB changes during it are noticed */
+    unsigned dc_version = gnrc_ipv6_nib_dst_cache_version();
+    bool src_selected = prep_hdr && ipv6_addr_is_unspecified(&ipv6_hdr->src);
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
 
     DEBUG("ipv6: send unicast\n");
     if (gnrc_ipv6_nib_get_next_hop_l2addr(&ipv6_hdr->dst, netif, pkt,
@@ -498,26 +579,61 @@ static void _send_unicast(gnrc_pktsnip_t *pkt, bool prep_hdr,
     netif = gnrc_netif_get_by_pid(gnrc_ipv6_nib_nc_get_iface(&nce));
     assert(netif != NULL);
     if (_safe_fill_ipv6_hdr(netif, pkt, prep_hdr)) {
-        DEBUG("ipv6: add interface header to packet\n");
-        if ((pkt = _create_netif_hdr(nce.l2addr, nce.l2addr_len, pkt,
-                                     netif_hdr_flags)) == NULL) {
-            return;
-        }
-        /* prep_hdr => The packet is from me */
-        if (_fragment_pkt_if_needed(pkt, netif, prep_hdr)) {
-            DEBUG("ipv6: packet is fragmented\n");
-            return;
-        }
-        DEBUG("ipv6: send unicast over interface %" PRIkernel_pid "\n",
-              netif->pid);
-        /* and send to interface */
-#ifdef MODULE_NETSTATS_IPV6
-        netif->ipv6.stats.tx_unicast_count++;
-#endif
-        _send_to_iface(netif, pkt);
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+        _dst_cache_put(&nce, ipv6_hdr, src_selected, dc_version);
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
+        _send_unicast_to_next_hop(pkt, prep_hdr, netif, nce.l2addr,
+                                  nce.l2addr_len, netif_hdr_flags);
     }
 }
 
+#ifdef MODULE_GNRC_RPL_SRH_CACHE
+static void _send_unicast_srh(gnrc_pktsnip_t *pkt, gnrc_netif_t *netif,
+                              ipv6_hdr_t *ipv6_hdr, gnrc_pktsnip_t *srh,
+                              const ipv6_addr_t *first_hop,
+                              uint8_t netif_hdr_flags)
+{
+    gnrc_rpl_srh_t *rh = srh->data;
+    gnrc_pktsnip_t *prev = pkt;
+    uint8_t *nh = &ipv6_hdr->nh;
+    gnrc_ipv6_nib_nc_t nce;
+
+    DEBUG("ipv6: send unicast via source route\n");
+    if (gnrc_ipv6_nib_get_next_hop_l2addr(first_hop, netif, pkt, &nce) < 0) {
+        /* packet is released by NIB */
+        DEBUG("ipv6: no link-layer address or interface for first hop %s\n",
+              ipv6_addr_to_str(addr_str, first_hop, sizeof(addr_str)));
+        gnrc_pktbuf_release(srh);
+        return;
+    }
+    netif = gnrc_netif_get_by_pid(gnrc_ipv6_nib_nc_get_iface(&nce));
+    assert(netif != NULL);
+    /* fill header before inserting the source routing header, so the
+     * checksum is calculated for the final destination (RFC 8200, section
+     * 8.1) */
+    if (!_safe_fill_ipv6_hdr(netif, pkt, true)) {
+        gnrc_pktbuf_release(srh);
+        return;
+    }
+    /* a hop-by-hop options header must stay right after the IPv6 header
+     * (RFC 8200, section 4.1) */
+    if ((ipv6_hdr->nh == PROTNUM_IPV6_EXT_HOPOPT) && (pkt->next != NULL) &&
+        (pkt->next->type == GNRC_NETTYPE_IPV6_EXT)) {
+        prev = pkt->next;
+        nh = &((ipv6_ext_t *)prev->data)->nh;
+    }
+    rh->nh = *nh;
+    *nh = PROTNUM_IPV6_EXT_RH;
+    ipv6_hdr->len = byteorder_htons(byteorder_ntohs(ipv6_hdr->len) +
+                                    srh->size);
+    memcpy(&ipv6_hdr->dst, first_hop, sizeof(ipv6_hdr->dst));
+    srh->next = prev->next;
+    prev->next = srh;
+    _send_unicast_to_next_hop(pkt, true, netif, nce.l2addr, nce.l2addr_len,
+                              netif_hdr_flags);
+}
+#endif  /* MODULE_GNRC_RPL_SRH_CACHE */
+
 static inline void _send_multicast_over_iface(gnrc_pktsnip_t *pkt,
                                               bool prep_hdr,
                                               gnrc_netif_t *netif,
@@ -695,6 +811,31 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
         _send_multicast(pkt, prep_hdr, netif, netif_hdr_flags);
     }
     else {
+#ifdef MODULE_GNRC_RPL_SRH_CACHE
+        if (prep_hdr && gnrc_rpl_srh_cache_is_root()) {
+            ipv6_addr_t first_hop;
+            gnrc_pktsnip_t *srh = gnrc_rpl_srh_cache_get(&ipv6_hdr->dst,
+                                                         &first_hop);
+
+            if (srh != NULL) {
+                _send_unicast_srh(pkt, netif, ipv6_hdr, srh, &first_hop,
+                                  netif_hdr_flags);
+                return;
+            }
+        }
+#endif  /* MODULE_GNRC_RPL_SRH_CACHE */
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+        const gnrc_ipv6_nib_dst_cache_t *dce;
+
+        /* destinations assigned to a local interface are never cached */
+        dce = gnrc_ipv6_nib_dst_cache_get(&ipv6_hdr->dst,
+                                          (netif != NULL) ? netif->pid : 0);
+        if (dce != NULL) {
+            _send_unicast_cached(pkt, prep_hdr, ipv6_hdr, dce,
+                                 netif_hdr_flags);
+            return;
+        }
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
         gnrc_netif_t *tmp_netif = gnrc_netif_get_by_ipv6_addr(&ipv6_hdr->dst);
 
         if (ipv6_addr_is_loopback(&ipv6_hdr->dst) ||    /* dst is loopback address */
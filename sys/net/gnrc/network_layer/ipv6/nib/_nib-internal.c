@@ -265,6 +265,7 @@ void _nib_nc_remove(_nib_onl_entry_t *node)
           ipv6_addr_to_str(addr_str, &node->ipv6, sizeof(addr_str)),
           _nib_onl_get_if(node));
     node->mode &= ~(_NC);
+    gnrc_ipv6_nib_dst_cache_invalidate();
     evtimer_del((evtimer_t *)&_nib_evtimer, &node->snd_na.event);
 #if GNRC_IPV6_NIB_CONF_ARSM
     evtimer_del((evtimer_t *)&_nib_evtimer, &node->nud_timeout.event);
@@ -369,6 +370,7 @@ _nib_dr_entry_t *_nib_drl_add(const ipv6_addr_t *router_addr, unsigned iface)
         }
         _override_node(router_addr, iface, def_router->next_hop);
         def_router->next_hop->mode |= _DRL;
+        gnrc_ipv6_nib_dst_cache_invalidate();
     }
     return def_router;
 }
@@ -379,6 +381,7 @@ void _nib_drl_remove(_nib_dr_entry_t *nib_dr)
         nib_dr->next_hop->mode &= ~(_DRL);
         _nib_onl_clear(nib_dr->next_hop);
         memset(nib_dr, 0, sizeof(_nib_dr_entry_t));
+        gnrc_ipv6_nib_dst_cache_invalidate();
     }
     if (nib_dr == _prime_def_router) {
         _prime_def_router = NULL;
@@ -512,6 +515,7 @@ _nib_offl_entry_t *_nib_offl_alloc(const ipv6_addr_t *next_hop, unsigned iface,
         dst->next_hop->mode |= _DST;
         ipv6_addr_init_prefix(&dst->pfx, pfx, pfx_len);
         dst->pfx_len = pfx_len;
+        gnrc_ipv6_nib_dst_cache_invalidate();
     }
     return dst;
 }
@@ -544,6 +548,7 @@ void _nib_offl_clear(_nib_offl_entry_t *dst)
             _nib_onl_clear(dst->next_hop);
         }
         memset(dst, 0, sizeof(_nib_offl_entry_t));
+        gnrc_ipv6_nib_dst_cache_invalidate();
     }
 }
 
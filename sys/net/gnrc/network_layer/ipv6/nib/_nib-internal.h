@@ -33,6 +33,7 @@
 #ifdef MODULE_GNRC_IPV6
 #include "net/gnrc/ipv6.h"
 #endif
+#include "net/gnrc/ipv6/nib/dst_cache.h"
 #include "net/gnrc/ipv6/nib/ft.h"
 #include "net/gnrc/ipv6/nib/nc.h"
 #include "net/gnrc/ipv6/nib/conf.h"
@@ -321,6 +322,7 @@ static inline bool _nib_onl_clear(_nib_onl_entry_t *node)
 {
     if (node->mode == _EMPTY) {
         memset(node, 0, sizeof(_nib_onl_entry_t));
+        gnrc_ipv6_nib_dst_cache_invalidate();
         return true;
     }
     return false;
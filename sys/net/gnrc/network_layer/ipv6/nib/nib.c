@@ -291,6 +291,9 @@ void gnrc_ipv6_nib_handle_pkt(gnrc_netif_t *netif, const ipv6_hdr_t *ipv6,
     assert(netif != NULL);
     gnrc_netif_acquire(netif);
     _nib_acquire();
+    /* any neighbor discovery message may change neighbor or route
+     * information */
+    gnrc_ipv6_nib_dst_cache_invalidate();
     switch (icmpv6->type) {
 #if GNRC_IPV6_NIB_CONF_ROUTER
         case ICMPV6_RTR_SOL:
@@ -329,6 +332,7 @@ void gnrc_ipv6_nib_handle_timer_event(void *ctx, uint16_t type)
     DEBUG("nib: Handle timer event (ctx = %p, type = 0x%04x, now = %ums)\n",
           ctx, type, (unsigned)xtimer_now_usec() / 1000);
     _nib_acquire();
+    gnrc_ipv6_nib_dst_cache_invalidate();
     switch (type) {
 #if GNRC_IPV6_NIB_CONF_ARSM
         case GNRC_IPV6_NIB_SND_UC_NS:
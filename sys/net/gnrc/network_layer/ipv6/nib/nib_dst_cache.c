@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/netif.h"
+#include "net/gnrc/ipv6/nib/dst_cache.h"
+
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_IPV6_NIB_DST_CACHE_NUMOF & (GNRC_IPV6_NIB_DST_CACHE_NUMOF - 1))
+#error "GNRC_IPV6_NIB_DST_CACHE_NUMOF must be a power of 2"
+#endif
+
+static gnrc_ipv6_nib_dst_cache_t _entries[GNRC_IPV6_NIB_DST_CACHE_NUMOF];
+static gnrc_ipv6_nib_dst_cache_stats_t _stats;
+/* entries are valid only if their version matches this. Starts at 1, so
+ * zero-initialized entries are invalid */
+static volatile unsigned _version = 1U;
+
+static inline unsigned _slot(const ipv6_addr_t *dst)
+{
+    uint32_t hash = dst->u32[0].u32 ^ dst->u32[1].u32 ^
+                    dst->u32[2].u32 ^ dst->u32[3].u32;
+
+    hash ^= (hash >> 16);
+    hash ^= (hash >> 8);
+    return hash & (GNRC_IPV6_NIB_DST_CACHE_NUMOF - 1);
+}
+
+static inline bool _valid(const gnrc_ipv6_nib_dst_cache_t *entry)
+{
+    return (entry->version == _version);
+}
+
+unsigned gnrc_ipv6_nib_dst_cache_version(void)
+{
+    return _version;
+}
+
+const gnrc_ipv6_nib_dst_cache_t *gnrc_ipv6_nib_dst_cache_get(const ipv6_addr_t *dst,
+                                                             unsigned iface)
+{
+    const gnrc_ipv6_nib_dst_cache_t *entry;
+
+    assert(dst != NULL);
+    entry = &_entries[_slot(dst)];
+    if (_valid(entry) && ((iface == 0) || (iface == (unsigned)entry->iface)) &&
+        ipv6_addr_equal(&entry->dst, dst)) {
+        _stats.hits++;
+        return entry;
+    }
+    _stats.misses++;
+    return NULL;
+}
+
+void gnrc_ipv6_nib_dst_cache_put(const gnrc_ipv6_nib_dst_cache_t *entry)
+{
+    assert((entry != NULL) &&
+           (entry->l2addr_len <= GNRC_IPV6_NIB_L2ADDR_MAX_LEN));
+    if (entry->version != _version) {
+        DEBUG("nib: NIB changed since entry was determined, not caching it\n");
+        return;
+    }
+    memcpy(&_entries[_slot(&entry->dst)], entry, sizeof(*entry));
+}
+
+void gnrc_ipv6_nib_dst_cache_invalidate(void)
+{
+    _version++;
+    if (_version == 0) {
+        /* keep zero-initialized entries invalid */
+        _version++;
+    }
+}
+
+bool gnrc_ipv6_nib_dst_cache_iter(void **state,
+                                  gnrc_ipv6_nib_dst_cache_t *entry)
+{
+    gnrc_ipv6_nib_dst_cache_t *ptr = *state;
+
+    assert((state != NULL) && (entry != NULL));
+    for (ptr = (ptr == NULL) ? _entries : (ptr + 1);
+         ptr < (_entries + GNRC_IPV6_NIB_DST_CACHE_NUMOF);
+         ptr++) {
+        if (_valid(ptr)) {
+            memcpy(entry, ptr, sizeof(*entry));
+            *state = ptr;
+            return true;
+        }
+    }
+    *state = NULL;
+    return false;
+}
+
+void gnrc_ipv6_nib_dst_cache_get_stats(gnrc_ipv6_nib_dst_cache_stats_t *stats)
+{
+    assert(stats != NULL);
+    memcpy(stats, &_stats, sizeof(_stats));
+}
+
+void gnrc_ipv6_nib_dst_cache_print(const gnrc_ipv6_nib_dst_cache_t *entry)
+{
+    char addr_str[(IPV6_ADDR_MAX_STR_LEN > (3 * GNRC_IPV6_NIB_L2ADDR_MAX_LEN)) ?
+                   IPV6_ADDR_MAX_STR_LEN : (3 * GNRC_IPV6_NIB_L2ADDR_MAX_LEN)];
+
+    printf("%s ", ipv6_addr_to_str(addr_str, &entry->dst, sizeof(addr_str)));
+    if (!ipv6_addr_is_unspecified(&entry->src)) {
+        printf("src %s ", ipv6_addr_to_str(addr_str, &entry->src,
+                                           sizeof(addr_str)));
+    }
+    printf("dev #%u lladdr %s\n", (unsigned)entry->iface,
+           gnrc_netif_addr_to_str(entry->l2addr, entry->l2addr_len, addr_str));
+}
+#else
+typedef int dont_be_pedantic;
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
+
+/** @} */
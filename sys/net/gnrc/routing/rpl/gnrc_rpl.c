@@ -27,6 +27,7 @@
 #include "gnrc_rpl_internal/globals.h"
 
 #include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/srh_cache.h"
 #ifdef MODULE_GNRC_RPL_P2P
 #include "net/gnrc/rpl/p2p.h"
 #include "net/gnrc/rpl/p2p_dodag.h"
@@ -135,6 +136,10 @@ gnrc_rpl_instance_t *gnrc_rpl_root_init(uint8_t instance_id, ipv6_addr_t *dodag_
 #ifndef GNRC_RPL_WITHOUT_PIO
     dodag->dio_opts |= GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO;
 #endif
+    if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+        /* source routes of a previous DODAG are not valid anymore */
+        gnrc_rpl_srh_cache_route_clear();
+    }
 
     trickle_start(gnrc_rpl_pid, &dodag->trickle, GNRC_RPL_MSG_TYPE_TRICKLE_MSG,
                   (1 << dodag->dio_min), dodag->dio_interval_doubl,
@@ -321,6 +326,15 @@ void _update_lifetime(void)
 
 void gnrc_rpl_delay_dao(gnrc_rpl_dodag_t *dodag)
 {
+    if (dodag->dao_delayed) {
+        /* the scheduled DAO is built when sent, so it already covers this
+         * change. Not rescheduling also keeps a busy parent from postponing
+         * its DAO indefinitely */
+#ifdef MODULE_NETSTATS_RPL
+        gnrc_rpl_netstats.dao_tx_coalesced_count++;
+#endif
+        return;
+    }
     evtimer_del(&gnrc_rpl_evtimer, (evtimer_event_t *)&dodag->dao_event);
     ((evtimer_event_t *)&(dodag->dao_event))->offset = random_uint32_range(
         GNRC_RPL_DAO_DELAY_DEFAULT,
@@ -329,6 +343,8 @@ void gnrc_rpl_delay_dao(gnrc_rpl_dodag_t *dodag)
     evtimer_add_msg(&gnrc_rpl_evtimer, &dodag->dao_event, gnrc_rpl_pid);
     dodag->dao_counter = 0;
     dodag->dao_ack_received = false;
+    dodag->dao_acks_pending = 0;
+    dodag->dao_delayed = true;
 }
 
 void gnrc_rpl_long_delay_dao(gnrc_rpl_dodag_t *dodag)
@@ -341,10 +357,13 @@ void gnrc_rpl_long_delay_dao(gnrc_rpl_dodag_t *dodag)
     evtimer_add_msg(&gnrc_rpl_evtimer, &dodag->dao_event, gnrc_rpl_pid);
     dodag->dao_counter = 0;
     dodag->dao_ack_received = false;
+    dodag->dao_acks_pending = 0;
+    dodag->dao_delayed = false;
 }
 
 void _dao_handle_send(gnrc_rpl_dodag_t *dodag)
 {
+    dodag->dao_delayed = false;
     if (dodag->node_status == GNRC_RPL_ROOT_NODE) {
         return;
     }
@@ -354,13 +373,34 @@ void _dao_handle_send(gnrc_rpl_dodag_t *dodag)
     }
 #endif
     if ((dodag->dao_ack_received == false) && (dodag->dao_counter < GNRC_RPL_DAO_SEND_RETRIES)) {
+        uint32_t ack_delay = GNRC_RPL_DAO_ACK_DELAY;
+
+        /* exponential backoff, jittered so that nodes which lost their
+         * DAO-ACKs at the same time do not retransmit at the same time */
+        for (unsigned i = 0; (i < dodag->dao_counter) &&
+                             (ack_delay < GNRC_RPL_DAO_ACK_DELAY_MAX); i++) {
+            ack_delay <<= 1;
+        }
+        if (ack_delay > GNRC_RPL_DAO_ACK_DELAY_MAX) {
+            ack_delay = GNRC_RPL_DAO_ACK_DELAY_MAX;
+        }
+#ifdef MODULE_NETSTATS_RPL
+        if (dodag->dao_counter > 0) {
+            gnrc_rpl_netstats.dao_tx_retrans_count++;
+        }
+#endif
         dodag->dao_counter++;
         gnrc_rpl_send_DAO(dodag->instance, NULL, dodag->default_lifetime);
         evtimer_del(&gnrc_rpl_evtimer, (evtimer_event_t *)&dodag->dao_event);
-        ((evtimer_event_t *)&(dodag->dao_event))->offset = GNRC_RPL_DAO_ACK_DELAY;
+        ((evtimer_event_t *)&(dodag->dao_event))->offset = random_uint32_range(
+            ack_delay, ack_delay + GNRC_RPL_DAO_DELAY_JITTER
+        );
         evtimer_add_msg(&gnrc_rpl_evtimer, &dodag->dao_event, gnrc_rpl_pid);
     }
     else if (dodag->dao_ack_received == false) {
+#ifdef MODULE_NETSTATS_RPL
+        gnrc_rpl_netstats.dao_tx_drop_count++;
+#endif
         gnrc_rpl_long_delay_dao(dodag);
     }
 }
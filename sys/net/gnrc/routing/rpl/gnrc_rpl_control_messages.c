@@ -33,6 +33,7 @@
 #endif
 
 #include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/srh_cache.h"
 #ifndef GNRC_RPL_WITHOUT_VALIDATION
 #include "gnrc_rpl_internal/validation.h"
 #endif
@@ -55,6 +56,9 @@ static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 #define GNRC_RPL_SHIFTED_MOP_MASK           (0x7)
 #define GNRC_RPL_PRF_MASK                   (0x7)
 #define GNRC_RPL_PREFIX_AUTO_ADDRESS_BIT    (1 << 6)
+#define GNRC_RPL_PREFIX_ROUTER_ADDRESS_BIT  (1 << 5)
+/* number of DAOs of a set that request a DAO-ACK, bits in dao_acks_pending */
+#define GNRC_RPL_DAO_ACK_SET_MAX            (32U)
 
 /**
  * @brief   Checks validity of DIO control messages
@@ -304,6 +308,7 @@ gnrc_pktsnip_t *_dio_prefix_info_build(gnrc_pktsnip_t *pkt, gnrc_rpl_dodag_t *do
     gnrc_ipv6_nib_pl_t ple;
     gnrc_rpl_opt_prefix_info_t *prefix_info;
     gnrc_pktsnip_t *opt_snip;
+    gnrc_netif_t *netif;
 
     if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_opt_prefix_info_t),
                                     GNRC_NETTYPE_UNDEF)) == NULL) {
@@ -338,6 +343,18 @@ gnrc_pktsnip_t *_dio_prefix_info_build(gnrc_pktsnip_t *pkt, gnrc_rpl_dodag_t *do
     memset(&prefix_info->prefix, 0, sizeof(prefix_info->prefix));
     ipv6_addr_init_prefix(&prefix_info->prefix, &dodag->dodag_id,
                           prefix_info->prefix_len);
+    /* advertise the own address in the prefix, so children in non-storing
+     * mode can name this node as their parent in DAOs (RFC 6550, 6.7.10) */
+    if ((netif = gnrc_netif_get_by_pid(dodag->iface)) != NULL) {
+        int idx = gnrc_netif_ipv6_addr_match(netif, &dodag->dodag_id);
+
+        if ((idx >= 0) &&
+            (ipv6_addr_match_prefix(&netif->ipv6.addrs[idx],
+                                    &dodag->dodag_id) >= prefix_info->prefix_len)) {
+            prefix_info->LAR_flags |= GNRC_RPL_PREFIX_ROUTER_ADDRESS_BIT;
+            prefix_info->prefix = netif->ipv6.addrs[idx];
+        }
+    }
     return opt_snip;
 }
 #endif
@@ -496,9 +513,63 @@ static inline uint32_t _sec_to_ms(uint32_t sec)
     }
 }
 
+#ifdef MODULE_GNRC_RPL_SRH_CACHE
+static void _srh_cache_update(gnrc_rpl_dodag_t *dodag, ipv6_addr_t *target,
+                              gnrc_rpl_opt_transit_t *transit)
+{
+    /* in non-storing mode the parent address follows the transit information */
+    ipv6_addr_t *parent = (ipv6_addr_t *)(transit + 1);
+    uint32_t lifetime = GNRC_RPL_SRH_CACHE_LIFETIME_INF;
+
+    if (transit->length < (GNRC_RPL_OPT_TRANSIT_INFO_LEN + sizeof(ipv6_addr_t))) {
+        DEBUG("RPL: RPL TRANSIT INFO DAO option without parent address\n");
+        return;
+    }
+    if (transit->path_lifetime == 0) {
+        DEBUG("RPL: removing source route to %s\n",
+              ipv6_addr_to_str(addr_str, target, sizeof(addr_str)));
+        gnrc_rpl_srh_cache_route_del(target);
+        return;
+    }
+    if (transit->path_lifetime != UINT8_MAX) {
+        lifetime = transit->path_lifetime * dodag->lifetime_unit;
+    }
+    DEBUG("RPL: updating source route to %s/%u\n",
+          ipv6_addr_to_str(addr_str, target, sizeof(addr_str)),
+          (unsigned)lifetime);
+    gnrc_rpl_srh_cache_route_add(target, parent, lifetime);
+}
+#endif
+
+/* checks if a DAO target changes the forwarding table */
+static bool _dao_target_changed(gnrc_rpl_opt_target_t *target, ipv6_addr_t *src)
+{
+    gnrc_ipv6_nib_ft_t fte;
+
+    return (gnrc_ipv6_nib_ft_get(&target->target, NULL, &fte) < 0) ||
+           (fte.dst_len != target->prefix_length) ||
+           !ipv6_addr_equal(&fte.next_hop, src);
+}
+
+/* stores the global address a parent advertised in a PIO */
+static void _parent_set_global_addr(gnrc_rpl_dodag_t *dodag, ipv6_addr_t *src,
+                                    ipv6_addr_t *addr)
+{
+    if (!ipv6_addr_is_global(addr)) {
+        return;
+    }
+    for (gnrc_rpl_parent_t *parent = dodag->parents; parent != NULL;
+         parent = parent->next) {
+        if (ipv6_addr_equal(&parent->addr, src)) {
+            parent->global_addr = *addr;
+            return;
+        }
+    }
+}
+
 /** @todo allow target prefixes in target options to be of variable length */
 bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt, uint16_t len,
-                    ipv6_addr_t *src, uint32_t *included_opts)
+                    ipv6_addr_t *src, uint32_t *included_opts, bool *routes_changed)
 {
     uint16_t l = 0;
     gnrc_rpl_opt_target_t *first_target = NULL;
@@ -534,13 +605,16 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                 dodag->dio_opts |= GNRC_RPL_REQ_DIO_OPT_DODAG_CONF;
                 gnrc_rpl_opt_dodag_conf_t *dc = (gnrc_rpl_opt_dodag_conf_t *) opt;
                 gnrc_rpl_of_t *of = gnrc_rpl_get_of_for_ocp(byteorder_ntohs(dc->ocp));
-                if (of != NULL) {
-                    inst->of = of;
-                }
-                else {
+                if (of == NULL) {
                     DEBUG("RPL: Unsupported OCP 0x%02x\n", byteorder_ntohs(dc->ocp));
-                    inst->of = gnrc_rpl_get_of_for_ocp(GNRC_RPL_DEFAULT_OCP);
+                    of = gnrc_rpl_get_of_for_ocp(GNRC_RPL_DEFAULT_OCP);
                 }
+                if ((inst->of != of) ||
+                    (inst->min_hop_rank_inc != byteorder_ntohs(dc->min_hop_rank_inc))) {
+                    /* parents need to be re-evaluated */
+                    dodag->parents_changed = true;
+                }
+                inst->of = of;
                 dodag->dio_interval_doubl = dc->dio_int_doubl;
                 dodag->dio_min = dc->dio_int_min;
                 dodag->dio_redun = dc->dio_redun;
@@ -560,6 +634,9 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                 dodag->dio_opts |= GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO;
 #endif
                 gnrc_rpl_opt_prefix_info_t *pi = (gnrc_rpl_opt_prefix_info_t *) opt;
+                if (pi->LAR_flags & GNRC_RPL_PREFIX_ROUTER_ADDRESS_BIT) {
+                    _parent_set_global_addr(dodag, src, &pi->prefix);
+                }
                 /* check for the auto address-configuration flag */
                 gnrc_netif_t *netif = gnrc_netif_get_by_pid(dodag->iface);
 
@@ -624,6 +701,9 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                       ipv6_addr_to_str(addr_str, &(target->target), (unsigned)sizeof(addr_str)),
                       target->prefix_length);
 
+                if ((routes_changed != NULL) && _dao_target_changed(target, src)) {
+                    *routes_changed = true;
+                }
                 gnrc_ipv6_nib_ft_del(&(target->target), target->prefix_length);
                 gnrc_ipv6_nib_ft_add(&(target->target), target->prefix_length, src,
                                      dodag->iface,
@@ -647,10 +727,23 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
 
                     gnrc_ipv6_nib_ft_del(&(first_target->target),
                                          first_target->prefix_length);
-                    gnrc_ipv6_nib_ft_add(&(first_target->target),
-                                         first_target->prefix_length, src,
-                                         dodag->iface,
-                                         transit->path_lifetime * dodag->lifetime_unit);
+                    if (transit->path_lifetime > 0) {
+                        gnrc_ipv6_nib_ft_add(&(first_target->target),
+                                             first_target->prefix_length, src,
+                                             dodag->iface,
+                                             transit->path_lifetime * dodag->lifetime_unit);
+                    }
+                    else if (routes_changed != NULL) {
+                        /* No-Path DAO */
+                        *routes_changed = true;
+                    }
+#ifdef MODULE_GNRC_RPL_SRH_CACHE
+                    if ((dodag->node_status == GNRC_RPL_ROOT_NODE) &&
+                        (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE)) {
+                        _srh_cache_update(dodag, &first_target->target,
+                                          transit);
+                    }
+#endif
 
                     first_target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (first_target)) +
                                    sizeof(gnrc_rpl_opt_t) + first_target->length);
@@ -709,7 +802,7 @@ void gnrc_rpl_recv_DIS(gnrc_rpl_dis_t *dis, kernel_pid_t iface, ipv6_addr_t *src
                 uint32_t included_opts = 0;
                 size_t opt_len = len - sizeof(gnrc_rpl_dis_t) - sizeof(icmpv6_hdr_t);
                 if(!_parse_options(GNRC_RPL_ICMPV6_CODE_DIS, &gnrc_rpl_instances[i],
-                                   (gnrc_rpl_opt_t *)(dis + 1), opt_len, src, &included_opts)) {
+                                   (gnrc_rpl_opt_t *)(dis + 1), opt_len, src, &included_opts, NULL)) {
                     DEBUG("RPL: DIS option parsing error - skip processing the DIS\n");
                     continue;
                 }
@@ -783,7 +876,7 @@ void gnrc_rpl_recv_DIO(gnrc_rpl_dio_t *dio, kernel_pid_t iface, ipv6_addr_t *src
 
         uint32_t included_opts = 0;
         if(!_parse_options(GNRC_RPL_ICMPV6_CODE_DIO, inst, (gnrc_rpl_opt_t *)(dio + 1), len,
-                           src, &included_opts)) {
+                           src, &included_opts, NULL)) {
             DEBUG("RPL: Error encountered during DIO option parsing - remove DODAG\n");
             gnrc_rpl_instance_remove(inst);
             return;
@@ -886,7 +979,10 @@ void gnrc_rpl_recv_DIO(gnrc_rpl_dio_t *dio, kernel_pid_t iface, ipv6_addr_t *src
     /* gnrc_rpl_parent_add_by_addr should have set this already */
     assert(parent != NULL);
 
-    parent->rank = byteorder_ntohs(dio->rank);
+    if (parent->rank != byteorder_ntohs(dio->rank)) {
+        parent->rank = byteorder_ntohs(dio->rank);
+        dodag->parents_changed = true;
+    }
 
     gnrc_rpl_parent_update(dodag, parent);
 
@@ -909,7 +1005,7 @@ void gnrc_rpl_recv_DIO(gnrc_rpl_dio_t *dio, kernel_pid_t iface, ipv6_addr_t *src
         dodag->prf = dio->g_mop_prf & GNRC_RPL_PRF_MASK;
         uint32_t included_opts = 0;
         if(!_parse_options(GNRC_RPL_ICMPV6_CODE_DIO, inst, (gnrc_rpl_opt_t *)(dio + 1), len,
-                           src, &included_opts)) {
+                           src, &included_opts, NULL)) {
             DEBUG("RPL: Error encountered during DIO option parsing - remove DODAG\n");
             gnrc_rpl_instance_remove(inst);
             return;
@@ -936,11 +1032,17 @@ gnrc_pktsnip_t *_dao_target_build(gnrc_pktsnip_t *pkt, ipv6_addr_t *addr, uint8_
     return opt_snip;
 }
 
-gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external)
+gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external,
+                                   const ipv6_addr_t *parent)
 {
     gnrc_rpl_opt_transit_t *transit;
     gnrc_pktsnip_t *opt_snip;
-    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_opt_transit_t),
+    size_t size = sizeof(gnrc_rpl_opt_transit_t);
+
+    if (parent != NULL) {
+        size += sizeof(ipv6_addr_t);
+    }
+    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, size,
                                GNRC_NETTYPE_UNDEF)) == NULL) {
         DEBUG("RPL: Send DAO - no space left in packet buffer\n");
         gnrc_pktbuf_release(pkt);
@@ -954,9 +1056,105 @@ gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool e
     transit->path_control = 0;
     transit->path_sequence = 0;
     transit->path_lifetime = lifetime;
+    if (parent != NULL) {
+        /* non-storing mode: the root builds source routes from the parents */
+        transit->length += sizeof(ipv6_addr_t);
+        memcpy(transit + 1, parent, sizeof(ipv6_addr_t));
+    }
     return opt_snip;
 }
 
+static void _dao_send(gnrc_rpl_instance_t *inst, gnrc_pktsnip_t *pkt,
+                      ipv6_addr_t *destination, bool ack_req)
+{
+    gnrc_rpl_dodag_t *dodag = &inst->dodag;
+    gnrc_pktsnip_t *tmp;
+    gnrc_rpl_dao_t *dao;
+    bool local_instance = (inst->id & GNRC_RPL_INSTANCE_ID_MSB) ? true : false;
+
+    if (local_instance) {
+        if ((tmp = gnrc_pktbuf_add(pkt, &dodag->dodag_id, sizeof(ipv6_addr_t),
+                                   GNRC_NETTYPE_UNDEF)) == NULL) {
+            DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        pkt = tmp;
+    }
+
+    if ((tmp = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_dao_t), GNRC_NETTYPE_UNDEF)) == NULL) {
+        DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    pkt = tmp;
+    dao = pkt->data;
+    dao->instance_id = inst->id;
+    if (local_instance) {
+        /* set the D flag to indicate that a DODAG id is present */
+        dao->k_d_flags = GNRC_RPL_DAO_D_BIT;
+    }
+    else {
+        dao->k_d_flags = 0;
+    }
+
+    if (ack_req) {
+        /* set the K flag to indicate that ACKs are required */
+        dao->k_d_flags |= GNRC_RPL_DAO_K_BIT;
+    }
+    dao->dao_sequence = dodag->dao_seq;
+    dao->reserved = 0;
+
+    if ((tmp = gnrc_icmpv6_build(pkt, ICMPV6_RPL_CTRL, GNRC_RPL_ICMPV6_CODE_DAO,
+                                 sizeof(icmpv6_hdr_t))) == NULL) {
+        DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    pkt = tmp;
+
+#ifdef MODULE_NETSTATS_RPL
+    gnrc_rpl_netstats_tx_DAO(&gnrc_rpl_netstats, gnrc_pkt_len(pkt),
+                             (destination && !ipv6_addr_is_multicast(destination)));
+#endif
+
+    gnrc_rpl_send(pkt, dodag->iface, NULL, destination, &dodag->dodag_id);
+
+    dodag->dao_seq = GNRC_RPL_COUNTER_INCREMENT(dodag->dao_seq);
+}
+
+/* sends the frag-th DAO of a set. DAO i of the set has the sequence number
+ * dao_ack_seq + i, so on retransmissions the sequence numbers of the DAOs
+ * that were acknowledged already are skipped */
+static void _dao_send_frag(gnrc_rpl_instance_t *inst, gnrc_pktsnip_t *pkt,
+                           ipv6_addr_t *destination, uint8_t lifetime,
+                           unsigned frag, bool resend)
+{
+    gnrc_rpl_dodag_t *dodag = &inst->dodag;
+    /* a No-Path DAO is not retransmitted, so don't request a DAO-ACK */
+    bool ack_req = (lifetime > 0) && (frag < GNRC_RPL_DAO_ACK_SET_MAX);
+
+    if (resend && (!ack_req || !(dodag->dao_acks_pending & (1UL << frag)))) {
+        gnrc_pktbuf_release(pkt);
+        dodag->dao_seq = GNRC_RPL_COUNTER_INCREMENT(dodag->dao_seq);
+        return;
+    }
+    if (ack_req) {
+        dodag->dao_acks_pending |= (1UL << frag);
+    }
+    _dao_send(inst, pkt, destination, ack_req);
+}
+
+/* sends a full DAO and starts the next one */
+static gnrc_pktsnip_t *_dao_next(gnrc_rpl_instance_t *inst, gnrc_pktsnip_t *pkt,
+                                 ipv6_addr_t *destination, uint8_t lifetime,
+                                 const ipv6_addr_t *parent, unsigned *frag,
+                                 bool resend)
+{
+    _dao_send_frag(inst, pkt, destination, lifetime, (*frag)++, resend);
+    return _dao_transit_build(NULL, lifetime, false, parent);
+}
+
 void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint8_t lifetime)
 {
     gnrc_rpl_dodag_t *dodag;
@@ -984,11 +1182,16 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
             return;
         }
 
-        destination = &(dodag->parents->addr);
+        /* in non-storing mode only the root learns routes */
+        destination = (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) ?
+                      &dodag->dodag_id : &(dodag->parents->addr);
     }
 
-    gnrc_pktsnip_t *pkt = NULL, *tmp = NULL;
-    gnrc_rpl_dao_t *dao;
+    gnrc_pktsnip_t *pkt;
+    unsigned targets = 0, frag = 0;
+    ipv6_addr_t *parent = NULL;
+    /* only a retransmission still has unacknowledged DAOs */
+    bool resend = (lifetime > 0) && (dodag->dao_acks_pending != 0);
 
     /* find my address */
     ipv6_addr_t *me = NULL;
@@ -1002,86 +1205,75 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
     idx = gnrc_netif_ipv6_addr_match(netif, &dodag->dodag_id);
     me = &netif->ipv6.addrs[idx];
 
-    /* add external and RPL FT entries */
-    /* TODO: nib: dropped support for external transit options for now */
-    void *ft_state = NULL;
-    gnrc_ipv6_nib_ft_t fte;
-    while(gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
-        DEBUG("RPL: Send DAO - building transit option\n");
-
-        if ((pkt = _dao_transit_build(pkt, lifetime, false)) == NULL) {
-            DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+    if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+        if (dodag->parents == NULL) {
+            DEBUG("RPL: dodag has no preferred parent\n");
             return;
         }
-        if (ipv6_addr_is_global(&fte.dst) &&
-            !ipv6_addr_is_unspecified(&fte.next_hop)) {
-            DEBUG("RPL: Send DAO - building target %s/%d\n",
-                  ipv6_addr_to_str(addr_str, &fte.dst, sizeof(addr_str)), fte.dst_len);
-
-            if ((pkt = _dao_target_build(pkt, &fte.dst, fte.dst_len)) == NULL) {
-                DEBUG("RPL: Send DAO - no space left in packet buffer\n");
-                return;
-            }
+        /* the root needs a global address of the parent to route to this
+         * node */
+        if (ipv6_addr_is_unspecified(&dodag->parents->global_addr)) {
+            DEBUG("RPL: global address of preferred parent unknown\n");
+            return;
         }
+        parent = &dodag->parents->global_addr;
     }
 
-    /* add own address */
-    DEBUG("RPL: Send DAO - building target %s/128\n",
-          ipv6_addr_to_str(addr_str, me, sizeof(addr_str)));
-    if ((pkt = _dao_target_build(pkt, me, IPV6_ADDR_BIT_LEN)) == NULL) {
-        DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+    if (lifetime > 0) {
+        dodag->dao_ack_seq = dodag->dao_seq;
+    }
+
+    /* all targets of a DAO share a single transit option following them.
+     * Options are prepended, so build it first */
+    DEBUG("RPL: Send DAO - building transit option\n");
+    if ((pkt = _dao_transit_build(NULL, lifetime, false, parent)) == NULL) {
         return;
     }
 
-    bool local_instance = (inst->id & GNRC_RPL_INSTANCE_ID_MSB) ? true : false;
+    /* add external and RPL FT entries. In non-storing mode every node
+     * announces only itself with its own parent */
+    /* TODO: nib: dropped support for external transit options for now */
+    void *ft_state = NULL;
+    gnrc_ipv6_nib_ft_t fte;
+    while((parent == NULL) &&
+          gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
+        if (!ipv6_addr_is_global(&fte.dst) ||
+            ipv6_addr_is_unspecified(&fte.next_hop)) {
+            continue;
+        }
+        if (targets == GNRC_RPL_DAO_TARGETS_NUMOF) {
+            if ((pkt = _dao_next(inst, pkt, destination, lifetime, parent,
+                                 &frag, resend)) == NULL) {
+                return;
+            }
+            targets = 0;
+        }
+        DEBUG("RPL: Send DAO - building target %s/%d\n",
+              ipv6_addr_to_str(addr_str, &fte.dst, sizeof(addr_str)), fte.dst_len);
 
-    if (local_instance) {
-        if ((tmp = gnrc_pktbuf_add(pkt, &dodag->dodag_id, sizeof(ipv6_addr_t),
-                                   GNRC_NETTYPE_UNDEF)) == NULL) {
-            DEBUG("RPL: Send DAO - no space left in packet buffer\n");
-            gnrc_pktbuf_release(pkt);
+        if ((pkt = _dao_target_build(pkt, &fte.dst, fte.dst_len)) == NULL) {
             return;
         }
-        pkt = tmp;
+        targets++;
     }
 
-    if ((tmp = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_dao_t), GNRC_NETTYPE_UNDEF)) == NULL) {
-        DEBUG("RPL: Send DAO - no space left in packet buffer\n");
-        gnrc_pktbuf_release(pkt);
+    /* add own address */
+    if ((targets == GNRC_RPL_DAO_TARGETS_NUMOF) &&
+        ((pkt = _dao_next(inst, pkt, destination, lifetime, parent,
+                          &frag, resend)) == NULL)) {
         return;
     }
-    pkt = tmp;
-    dao = pkt->data;
-    dao->instance_id = inst->id;
-    if (local_instance) {
-        /* set the D flag to indicate that a DODAG id is present */
-        dao->k_d_flags = GNRC_RPL_DAO_D_BIT;
-    }
-    else {
-        dao->k_d_flags = 0;
-    }
-
-    /* set the K flag to indicate that ACKs are required */
-    dao->k_d_flags |= GNRC_RPL_DAO_K_BIT;
-    dao->dao_sequence = dodag->dao_seq;
-    dao->reserved = 0;
-
-    if ((tmp = gnrc_icmpv6_build(pkt, ICMPV6_RPL_CTRL, GNRC_RPL_ICMPV6_CODE_DAO,
-                                 sizeof(icmpv6_hdr_t))) == NULL) {
-        DEBUG("RPL: Send DAO - no space left in packet buffer\n");
-        gnrc_pktbuf_release(pkt);
+    DEBUG("RPL: Send DAO - building target %s/128\n",
+          ipv6_addr_to_str(addr_str, me, sizeof(addr_str)));
+    if ((pkt = _dao_target_build(pkt, me, IPV6_ADDR_BIT_LEN)) == NULL) {
         return;
     }
-    pkt = tmp;
 
-#ifdef MODULE_NETSTATS_RPL
-    gnrc_rpl_netstats_tx_DAO(&gnrc_rpl_netstats, gnrc_pkt_len(pkt),
-                             (destination && !ipv6_addr_is_multicast(destination)));
-#endif
-
-    gnrc_rpl_send(pkt, dodag->iface, NULL, destination, &dodag->dodag_id);
-
-    GNRC_RPL_COUNTER_INCREMENT(dodag->dao_seq);
+    _dao_send_frag(inst, pkt, destination, lifetime, frag, resend);
+    if (resend && (frag < (GNRC_RPL_DAO_ACK_SET_MAX - 1))) {
+        /* the set may have become smaller since the last transmission */
+        dodag->dao_acks_pending &= (2UL << frag) - 1;
+    }
 }
 
 void gnrc_rpl_send_DAO_ACK(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint8_t seq)
@@ -1134,6 +1326,13 @@ void gnrc_rpl_send_DAO_ACK(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination,
     gnrc_rpl_send(pkt, dodag->iface, NULL, destination, &dodag->dodag_id);
 }
 
+static inline void _dao_rx_drop(void)
+{
+#ifdef MODULE_NETSTATS_RPL
+    gnrc_rpl_netstats.dao_rx_drop_count++;
+#endif
+}
+
 void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src, ipv6_addr_t *dst,
                        uint16_t len)
 {
@@ -1149,6 +1348,7 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
 
 #ifndef GNRC_RPL_WITHOUT_VALIDATION
     if (!gnrc_rpl_validation_DAO(dao, len)) {
+        _dao_rx_drop();
         return;
     }
 #endif
@@ -1157,6 +1357,7 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
 
     if ((inst = gnrc_rpl_instance_get(dao->instance_id)) == NULL) {
         DEBUG("RPL: DAO with unknown instance id (%d) received\n", dao->instance_id);
+        _dao_rx_drop();
         return;
     }
 
@@ -1169,6 +1370,7 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
         if (memcmp(&dodag->dodag_id, (ipv6_addr_t *)(dao + 1), sizeof(ipv6_addr_t)) != 0) {
             DEBUG("RPL: DAO with unknown DODAG id (%s)\n", ipv6_addr_to_str(addr_str,
                         (ipv6_addr_t *)(dao + 1), sizeof(addr_str)));
+            _dao_rx_drop();
             return;
         }
         opts = (gnrc_rpl_opt_t *)(((uint8_t *) opts) + sizeof(ipv6_addr_t));
@@ -1187,8 +1389,11 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
 #endif
 
     uint32_t included_opts = 0;
-    if(!_parse_options(GNRC_RPL_ICMPV6_CODE_DAO, inst, opts, len, src, &included_opts)) {
+    bool routes_changed = false;
+    if(!_parse_options(GNRC_RPL_ICMPV6_CODE_DAO, inst, opts, len, src, &included_opts,
+                       &routes_changed)) {
         DEBUG("RPL: Error encountered during DAO option parsing - ignore DAO\n");
+        _dao_rx_drop();
         return;
     }
 
@@ -1197,7 +1402,10 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
         gnrc_rpl_send_DAO_ACK(inst, src, dao->dao_sequence);
     }
 
-    gnrc_rpl_delay_dao(dodag);
+    /* refreshed routes need not be propagated before the next regular DAO */
+    if (routes_changed) {
+        gnrc_rpl_delay_dao(dodag);
+    }
 }
 
 void gnrc_rpl_recv_DAO_ACK(gnrc_rpl_dao_ack_t *dao_ack, kernel_pid_t iface, ipv6_addr_t *src,
@@ -1237,12 +1445,38 @@ void gnrc_rpl_recv_DAO_ACK(gnrc_rpl_dao_ack_t *dao_ack, kernel_pid_t iface, ipv6
         }
     }
 
-    if ((dao_ack->status != 0) && (dao_ack->dao_sequence != dodag->dao_seq)) {
-        DEBUG("RPL: DAO-ACK sequence (%d) does not match expected sequence (%d)\n",
-                dao_ack->dao_sequence, dodag->dao_seq);
+    uint8_t seq = dodag->dao_ack_seq;
+    unsigned frag;
+
+    for (frag = 0; frag < GNRC_RPL_DAO_ACK_SET_MAX; frag++) {
+        if (seq == dao_ack->dao_sequence) {
+            break;
+        }
+        seq = GNRC_RPL_COUNTER_INCREMENT(seq);
+    }
+    if ((frag == GNRC_RPL_DAO_ACK_SET_MAX) ||
+        !(dodag->dao_acks_pending & (1UL << frag))) {
+        DEBUG("RPL: DAO-ACK sequence (%d) does not match any pending DAO\n",
+                dao_ack->dao_sequence);
+        return;
+    }
+
+    if (dodag->dao_delayed) {
+        DEBUG("RPL: DAO-ACK for outdated DAO - wait for next DAO-ACK\n");
         return;
     }
 
+    /* status values of 128 and above reject the DAO (RFC 6550, section 6.5) */
+    if (dao_ack->status >= 128) {
+        DEBUG("RPL: DAO rejected with status %u\n", (unsigned)dao_ack->status);
+        return;
+    }
+
+    dodag->dao_acks_pending &= ~(1UL << frag);
+    if (dodag->dao_acks_pending != 0) {
+        DEBUG("RPL: DAO-ACK received - wait for the rest of the set\n");
+        return;
+    }
     dodag->dao_ack_received = true;
     gnrc_rpl_long_delay_dao(dodag);
 }
@@ -154,6 +154,10 @@ bool gnrc_rpl_dodag_init(gnrc_rpl_instance_t *instance, ipv6_addr_t *dodag_id, k
     dodag->dao_seq = GNRC_RPL_COUNTER_INIT;
     dodag->dtsn = 0;
     dodag->dao_ack_received = false;
+    dodag->dao_acks_pending = 0;
+    dodag->dao_delayed = false;
+    dodag->parents_changed = true;
+    dodag->parent_switches = 0;
     dodag->dao_counter = 0;
     dodag->instance = instance;
     dodag->iface = iface;
@@ -208,6 +212,7 @@ bool gnrc_rpl_parent_add_by_addr(gnrc_rpl_dodag_t *dodag, ipv6_addr_t *addr,
     if (*parent != NULL) {
         (*parent)->dodag = dodag;
         LL_APPEND(dodag->parents, *parent);
+        dodag->parents_changed = true;
         (*parent)->state = GNRC_RPL_PARENT_ACTIVE;
         (*parent)->addr = *addr;
         (*parent)->rank = GNRC_RPL_INFINITE_RANK;
@@ -241,6 +246,7 @@ bool gnrc_rpl_parent_remove(gnrc_rpl_parent_t *parent)
         }
     }
     LL_DELETE(dodag->parents, parent);
+    dodag->parents_changed = true;
     evtimer_del((evtimer_t *)(&gnrc_rpl_evtimer), (evtimer_event_t *)&parent->timeout_event);
     memset(parent, 0, sizeof(gnrc_rpl_parent_t));
     return true;
@@ -302,6 +308,9 @@ void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
 /**
  * @brief   Find the parent with the lowest rank and update the DODAG's preferred parent
  *
+ * The previous selection is kept as long as neither the parent set nor the
+ * parents' metrics changed.
+ *
  * @param[in] dodag     Pointer to the DODAG
  *
  * @return  Pointer to the preferred parent, on success.
@@ -319,14 +328,29 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
         return NULL;
     }
 
+    if (!dodag->parents_changed) {
+        return (old_best->rank == GNRC_RPL_INFINITE_RANK) ? NULL : old_best;
+    }
+    dodag->parents_changed = false;
+
     LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
     new_best = dodag->parents;
 
+    if ((new_best != old_best) && (old_best->rank != GNRC_RPL_INFINITE_RANK) &&
+        (dodag->instance->of->parent_switch != NULL) &&
+        !dodag->instance->of->parent_switch(old_best, new_best)) {
+        /* hysteresis: keep the current preferred parent */
+        LL_DELETE(dodag->parents, old_best);
+        LL_PREPEND(dodag->parents, old_best);
+        new_best = old_best;
+    }
+
     if (new_best->rank == GNRC_RPL_INFINITE_RANK) {
         return NULL;
     }
 
     if (new_best != old_best) {
+        dodag->parent_switches++;
         /* no-path DAOs only for the storing mode */
         if ((dodag->instance->mop == GNRC_RPL_MOP_STORING_MODE_NO_MC) ||
             (dodag->instance->mop == GNRC_RPL_MOP_STORING_MODE_MC)) {
@@ -347,7 +371,10 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
     }
 
     dodag->my_rank = dodag->instance->of->calc_rank(dodag, 0);
-    if (dodag->my_rank != old_rank) {
+    /* only changes of the DAGRank are relevant to children, so don't cause a
+     * DIO storm on every small change of the link metric */
+    if (DAGRANK(dodag->my_rank, dodag->instance->min_hop_rank_inc) !=
+        DAGRANK(old_rank, dodag->instance->min_hop_rank_inc)) {
         trickle_reset_timer(&dodag->trickle);
     }
 
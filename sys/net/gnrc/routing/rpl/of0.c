@@ -36,7 +36,8 @@ static gnrc_rpl_of_t gnrc_rpl_of0 = {
     .reset        = reset,
     .parent_state_callback = NULL,
     .init         = NULL,
-    .process_dio  = NULL
+    .process_dio  = NULL,
+    .parent_switch = NULL,
 };
 
 gnrc_rpl_of_t *gnrc_rpl_get_of0(void)
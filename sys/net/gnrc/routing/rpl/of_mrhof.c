@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl_mrhof
+ * @{
+ * @file
+ * @brief       Minimum Rank with Hysteresis Objective Function.
+ *
+ * Implementation of MRHOF with the ETX metric.
+ * @}
+ */
+
+#include <stdint.h>
+
+#include "irq.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/mrhof.h"
+#include "net/gnrc/rpl/structs.h"
+#include "of_mrhof.h"
+
+#ifdef MODULE_GNRC_RPL_MRHOF
+
+#define INFINITE_PATH_COST  (UINT32_MAX)
+
+static uint16_t calc_rank(gnrc_rpl_dodag_t *, uint16_t);
+static int parent_cmp(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *);
+static gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *, gnrc_rpl_dodag_t *);
+static void reset(gnrc_rpl_dodag_t *);
+static bool parent_switch(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *);
+
+static gnrc_rpl_of_t gnrc_rpl_mrhof = {
+    .ocp          = GNRC_RPL_MRHOF_OCP,
+    .calc_rank    = calc_rank,
+    .parent_cmp   = parent_cmp,
+    .which_dodag  = which_dodag,
+    .reset        = reset,
+    .parent_state_callback = NULL,
+    .init         = NULL,
+    .process_dio  = NULL,
+    .parent_switch = parent_switch,
+};
+
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void)
+{
+    return &gnrc_rpl_mrhof;
+}
+
+/* feeds the outcome of a unicast transmission into the ETX of the parent */
+static void _tx_feedback(kernel_pid_t iface, const uint8_t *dst,
+                         size_t dst_len, unsigned num_tx, bool acked)
+{
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(iface);
+    ipv6_addr_t addr;
+    eui64_t iid;
+
+    if ((netif == NULL) ||
+        (gnrc_netif_ipv6_iid_from_addr(netif, dst, dst_len, &iid) < 0)) {
+        return;
+    }
+    /* RPL parents are addressed by their link-local address */
+    ipv6_addr_set_link_local_prefix(&addr);
+    addr.u64[1] = iid.uint64;
+    gnrc_rpl_mrhof_etx_update(&addr, num_tx, acked);
+}
+
+void gnrc_rpl_of_mrhof_init(void)
+{
+    gnrc_netif_tx_feedback_set_cb(_tx_feedback);
+}
+
+static uint16_t _link_metric(const gnrc_rpl_parent_t *parent)
+{
+    /* link metric may be updated from another thread */
+    unsigned state = irq_disable();
+    uint16_t res = parent->link_metric;
+
+    irq_restore(state);
+    return (res == 0) ? GNRC_RPL_MRHOF_ETX_INIT : res;
+}
+
+static uint32_t _path_cost(const gnrc_rpl_parent_t *parent)
+{
+    uint16_t link_metric = _link_metric(parent);
+    uint32_t res;
+
+    if ((parent->rank == GNRC_RPL_INFINITE_RANK) ||
+        (link_metric > GNRC_RPL_MRHOF_MAX_LINK_METRIC)) {
+        return INFINITE_PATH_COST;
+    }
+    res = (uint32_t)parent->rank + link_metric;
+    return (res > GNRC_RPL_MRHOF_MAX_PATH_COST) ? INFINITE_PATH_COST : res;
+}
+
+void reset(gnrc_rpl_dodag_t *dodag)
+{
+    /* Nothing to do in MRHOF */
+    (void) dodag;
+}
+
+uint16_t calc_rank(gnrc_rpl_dodag_t *dodag, uint16_t base_rank)
+{
+    uint32_t cost, min_rank;
+
+    if (base_rank == 0) {
+        if (dodag->parents == NULL) {
+            return GNRC_RPL_INFINITE_RANK;
+        }
+        base_rank = dodag->parents->rank;
+        cost = _path_cost(dodag->parents);
+    }
+    else {
+        cost = (uint32_t)base_rank + GNRC_RPL_MRHOF_ETX_INIT;
+    }
+
+    if (cost == INFINITE_PATH_COST) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+    /* RFC 6719, section 3.3: rank must increase by at least
+     * MinHopRankIncrease */
+    min_rank = (uint32_t)base_rank + ((dodag->parents != NULL) ?
+                                      dodag->instance->min_hop_rank_inc :
+                                      GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE);
+    if (cost < min_rank) {
+        cost = min_rank;
+    }
+    if (cost >= GNRC_RPL_INFINITE_RANK) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+    return (uint16_t)cost;
+}
+
+int parent_cmp(gnrc_rpl_parent_t *parent1, gnrc_rpl_parent_t *parent2)
+{
+    uint32_t cost1 = _path_cost(parent1);
+    uint32_t cost2 = _path_cost(parent2);
+
+    if (cost1 < cost2) {
+        return -1;
+    }
+    else if (cost1 > cost2) {
+        return 1;
+    }
+    /* prefer the parent closer to the root on equal cost */
+    return (int)parent1->rank - (int)parent2->rank;
+}
+
+bool parent_switch(gnrc_rpl_parent_t *cur, gnrc_rpl_parent_t *best)
+{
+    uint32_t cur_cost = _path_cost(cur);
+
+    if (cur_cost == INFINITE_PATH_COST) {
+        return true;
+    }
+    return (_path_cost(best) + GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD) <
+           cur_cost;
+}
+
+/* Not used yet */
+gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *d1, gnrc_rpl_dodag_t *d2)
+{
+    (void) d2;
+    return d1;
+}
+
+void gnrc_rpl_mrhof_etx_update(const ipv6_addr_t *addr, unsigned num_tx,
+                               bool acked)
+{
+    uint16_t sample = GNRC_RPL_MRHOF_ETX_NOACK_PENALTY;
+
+    if (acked) {
+        if (num_tx > (UINT16_MAX / GNRC_RPL_ETX_DIVISOR)) {
+            num_tx = UINT16_MAX / GNRC_RPL_ETX_DIVISOR;
+        }
+        sample = num_tx * GNRC_RPL_ETX_DIVISOR;
+    }
+    for (uint8_t i = 0; i < GNRC_RPL_PARENTS_NUMOF; ++i) {
+        gnrc_rpl_parent_t *parent = &gnrc_rpl_parents[i];
+        unsigned state = irq_disable();
+
+        if ((parent->state != 0) && ipv6_addr_equal(&parent->addr, addr)) {
+            parent->link_metric = (parent->link_metric == 0) ?
+                sample :
+                (uint16_t)((((uint32_t)parent->link_metric * 7U) + sample) / 8U);
+            parent->dodag->parents_changed = true;
+        }
+        irq_restore(state);
+    }
+}
+#else
+typedef int dont_be_pedantic;
+#endif  /* MODULE_GNRC_RPL_MRHOF */
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl_mrhof
+ * @{
+ * @file
+ * @brief       Minimum Rank with Hysteresis Objective Function.
+ *
+ * Header-file, which defines all functions for the implementation of MRHOF.
+ */
+
+#ifndef OF_MRHOF_H
+#define OF_MRHOF_H
+
+#include "net/gnrc/rpl/structs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Return the address to the MRHOF objective function
+ *
+ * @return  Address of the MRHOF objective function
+ */
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void);
+
+/**
+ * @brief   Subscribes MRHOF to the TX feedback of the network interfaces
+ */
+void gnrc_rpl_of_mrhof_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OF_MRHOF_H */
+/**
+ * @}
+ */
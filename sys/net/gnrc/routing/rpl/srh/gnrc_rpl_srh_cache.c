@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+#include "net/ipv6/ext/rh.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/rpl/dodag.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/gnrc/rpl/srh_cache.h"
+
+#ifdef MODULE_GNRC_RPL_SRH_CACHE
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_RPL_SRH_CACHE_NUMOF & (GNRC_RPL_SRH_CACHE_NUMOF - 1))
+#error "GNRC_RPL_SRH_CACHE_NUMOF must be a power of 2"
+#endif
+
+/* prefix octets elided in a compressed address can at most be 15 */
+#define COMPR_MAX       (15U)
+#define HDR_MAX_LEN     (sizeof(gnrc_rpl_srh_t) + \
+                         (GNRC_RPL_SRH_CACHE_MAX_HOPS * sizeof(ipv6_addr_t)))
+
+typedef struct {
+    ipv6_addr_t target;
+    ipv6_addr_t parent;
+    uint32_t expires;           /* in seconds, LIFETIME_INF for never */
+} _route_t;
+
+typedef struct {
+    ipv6_addr_t dst;
+    ipv6_addr_t first_hop;
+    unsigned version;
+    uint32_t expires;           /* earliest expiry of the routes used */
+    uint16_t len;               /* length of hdr, 0 if no header needed */
+    uint8_t hdr[HDR_MAX_LEN];
+} _entry_t;
+
+static char addr_str[IPV6_ADDR_MAX_STR_LEN];
+static mutex_t _mutex = MUTEX_INIT;
+static _route_t _routes[GNRC_RPL_SRH_CACHE_ROUTES_NUMOF];
+static _entry_t _entries[GNRC_RPL_SRH_CACHE_NUMOF];
+static gnrc_rpl_srh_cache_stats_t _stats;
+/* entries are valid only if their version matches this. Starts at 1, so
+ * zero-initialized entries are invalid */
+static unsigned _version = 1U;
+
+static inline uint32_t _now_sec(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static inline unsigned _slot(const ipv6_addr_t *dst)
+{
+    uint32_t hash = dst->u32[0].u32 ^ dst->u32[1].u32 ^
+                    dst->u32[2].u32 ^ dst->u32[3].u32;
+
+    hash ^= (hash >> 16);
+    hash ^= (hash >> 8);
+    return hash & (GNRC_RPL_SRH_CACHE_NUMOF - 1);
+}
+
+static void _invalidate(void)
+{
+    _version++;
+    if (_version == 0) {
+        /* keep zero-initialized entries invalid */
+        _version++;
+    }
+}
+
+static inline bool _route_expired(const _route_t *route, uint32_t now)
+{
+    return (route->expires != GNRC_RPL_SRH_CACHE_LIFETIME_INF) &&
+           ((int32_t)(route->expires - now) <= 0);
+}
+
+static _route_t *_route_get(const ipv6_addr_t *target, uint32_t now)
+{
+    for (unsigned i = 0; i < GNRC_RPL_SRH_CACHE_ROUTES_NUMOF; i++) {
+        _route_t *route = &_routes[i];
+
+        if (!ipv6_addr_is_unspecified(&route->target) &&
+            ipv6_addr_equal(&route->target, target)) {
+            if (_route_expired(route, now)) {
+                DEBUG("RPL SRH cache: route to %s expired\n",
+                      ipv6_addr_to_str(addr_str, target, sizeof(addr_str)));
+                ipv6_addr_set_unspecified(&route->target);
+                _invalidate();
+                return NULL;
+            }
+            return route;
+        }
+    }
+    return NULL;
+}
+
+static inline uint8_t _common_octets(const ipv6_addr_t *a,
+                                     const ipv6_addr_t *b)
+{
+    uint8_t res = ipv6_addr_match_prefix(a, b) / 8;
+
+    return (res > COMPR_MAX) ? COMPR_MAX : res;
+}
+
+/* builds the compressed header for entry->dst according to RFC 6554,
+ * section 3 */
+static int _build(_entry_t *entry, uint32_t now)
+{
+    const ipv6_addr_t *path[GNRC_RPL_SRH_CACHE_MAX_HOPS + 1];
+    gnrc_rpl_srh_t *rh = (gnrc_rpl_srh_t *)entry->hdr;
+    uint8_t *addr_vec = (uint8_t *)(rh + 1);
+    unsigned hops = 0, len;
+    uint8_t compr_i = COMPR_MAX, compr_e, pad;
+
+    /* collect path from destination up to the child of this node */
+    entry->expires = GNRC_RPL_SRH_CACHE_LIFETIME_INF;
+    path[hops] = &entry->dst;
+    while (1) {
+        _route_t *route = _route_get(path[hops], now);
+
+        if (route == NULL) {
+            DEBUG("RPL SRH cache: no route to %s\n",
+                  ipv6_addr_to_str(addr_str, path[hops], sizeof(addr_str)));
+            entry->expires = GNRC_RPL_SRH_CACHE_LIFETIME_INF;
+            return -ENOENT;
+        }
+        if ((route->expires != GNRC_RPL_SRH_CACHE_LIFETIME_INF) &&
+            ((entry->expires == GNRC_RPL_SRH_CACHE_LIFETIME_INF) ||
+             ((int32_t)(route->expires - entry->expires) < 0))) {
+            entry->expires = route->expires;
+        }
+        if (gnrc_netif_get_by_ipv6_addr(&route->parent) != NULL) {
+            break;
+        }
+        if (++hops > GNRC_RPL_SRH_CACHE_MAX_HOPS) {
+            DEBUG("RPL SRH cache: route too long or loop detected\n");
+            entry->expires = GNRC_RPL_SRH_CACHE_LIFETIME_INF;
+            return -ENOENT;
+        }
+        path[hops] = &route->parent;
+    }
+    memcpy(&entry->first_hop, path[hops], sizeof(entry->first_hop));
+    if (hops == 0) {
+        /* destination is a child of this node */
+        entry->len = 0;
+        return 0;
+    }
+    /* path[hops - 1] ... path[1] are the intermediate hops, path[0] is the
+     * destination. All of them are compared against the first hop, since the
+     * IPv6 destination address changes along the route */
+    for (unsigned i = hops - 1; i > 0; i--) {
+        uint8_t common = _common_octets(&entry->first_hop, path[i]);
+
+        if (common < compr_i) {
+            compr_i = common;
+        }
+    }
+    compr_e = _common_octets(&entry->first_hop, &entry->dst);
+    if ((hops > 1) && (compr_e > compr_i)) {
+        compr_e = compr_i;
+    }
+    if (hops == 1) {
+        compr_i = 0;
+    }
+    len = ((hops - 1) * (sizeof(ipv6_addr_t) - compr_i)) +
+          (sizeof(ipv6_addr_t) - compr_e);
+    pad = (8 - (len & 0x7)) & 0x7;
+    for (unsigned i = hops - 1; i > 0; i--) {
+        memcpy(addr_vec, &path[i]->u8[compr_i], sizeof(ipv6_addr_t) - compr_i);
+        addr_vec += sizeof(ipv6_addr_t) - compr_i;
+    }
+    memcpy(addr_vec, &entry->dst.u8[compr_e], sizeof(ipv6_addr_t) - compr_e);
+    memset(addr_vec + sizeof(ipv6_addr_t) - compr_e, 0, pad);
+    len += pad;
+    rh->nh = PROTNUM_RESERVED;
+    rh->len = len / 8;
+    rh->type = IPV6_EXT_RH_TYPE_RPL_SRH;
+    rh->seg_left = hops;
+    rh->compr = (compr_i << 4) | compr_e;
+    rh->pad_resv = pad << 4;
+    rh->resv = 0;
+    entry->len = sizeof(gnrc_rpl_srh_t) + len;
+    return 0;
+}
+
+int gnrc_rpl_srh_cache_route_add(const ipv6_addr_t *target,
+                                 const ipv6_addr_t *parent,
+                                 uint32_t lifetime)
+{
+    _route_t *route = NULL;
+    uint32_t now = _now_sec();
+
+    assert((target != NULL) && (parent != NULL));
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < GNRC_RPL_SRH_CACHE_ROUTES_NUMOF; i++) {
+        _route_t *tmp = &_routes[i];
+
+        if (ipv6_addr_is_unspecified(&tmp->target)) {
+            if (route == NULL) {
+                route = tmp;
+            }
+        }
+        else if (ipv6_addr_equal(&tmp->target, target)) {
+            route = tmp;
+            break;
+        }
+        else if ((route == NULL) && _route_expired(tmp, now)) {
+            route = tmp;
+        }
+    }
+    if (route == NULL) {
+        mutex_unlock(&_mutex);
+        DEBUG("RPL SRH cache: no space left for route to %s\n",
+              ipv6_addr_to_str(addr_str, target, sizeof(addr_str)));
+        return -ENOMEM;
+    }
+    if (!ipv6_addr_equal(&route->target, target) ||
+        !ipv6_addr_equal(&route->parent, parent)) {
+        /* only new or changed routes change a path, refreshed ones don't */
+        _invalidate();
+    }
+    memcpy(&route->target, target, sizeof(route->target));
+    memcpy(&route->parent, parent, sizeof(route->parent));
+    route->expires = (lifetime == GNRC_RPL_SRH_CACHE_LIFETIME_INF) ?
+                     GNRC_RPL_SRH_CACHE_LIFETIME_INF : (now + lifetime);
+    mutex_unlock(&_mutex);
+    return 0;
+}
+
+void gnrc_rpl_srh_cache_route_del(const ipv6_addr_t *target)
+{
+    assert(target != NULL);
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < GNRC_RPL_SRH_CACHE_ROUTES_NUMOF; i++) {
+        _route_t *route = &_routes[i];
+
+        if (!ipv6_addr_is_unspecified(&route->target) &&
+            ipv6_addr_equal(&route->target, target)) {
+            ipv6_addr_set_unspecified(&route->target);
+            _invalidate();
+            break;
+        }
+    }
+    mutex_unlock(&_mutex);
+}
+
+void gnrc_rpl_srh_cache_route_clear(void)
+{
+    mutex_lock(&_mutex);
+    memset(_routes, 0, sizeof(_routes));
+    _invalidate();
+    mutex_unlock(&_mutex);
+}
+
+bool gnrc_rpl_srh_cache_is_root(void)
+{
+    for (unsigned i = 0; i < GNRC_RPL_INSTANCES_NUMOF; i++) {
+        gnrc_rpl_instance_t *inst = &gnrc_rpl_instances[i];
+
+        if ((inst->state != 0) &&
+            (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) &&
+            (inst->dodag.node_status == GNRC_RPL_ROOT_NODE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+gnrc_pktsnip_t *gnrc_rpl_srh_cache_get(const ipv6_addr_t *dst,
+                                       ipv6_addr_t *first_hop)
+{
+    gnrc_pktsnip_t *res = NULL;
+    _entry_t *entry;
+
+    assert((dst != NULL) && (first_hop != NULL));
+    mutex_lock(&_mutex);
+    entry = &_entries[_slot(dst)];
+    if ((entry->version == _version) && ipv6_addr_equal(&entry->dst, dst) &&
+        ((entry->expires == GNRC_RPL_SRH_CACHE_LIFETIME_INF) ||
+         ((int32_t)(entry->expires - _now_sec()) > 0))) {
+        _stats.hits++;
+    }
+    else {
+        uint32_t now = _now_sec();
+
+        _stats.misses++;
+        memcpy(&entry->dst, dst, sizeof(entry->dst));
+        if (_build(entry, now) < 0) {
+            /* also cache that there is no source route, so packets to
+             * destinations outside the DODAG don't walk the routes again */
+            entry->len = 0;
+        }
+        /* _build() may have invalidated the cache by removing expired
+         * routes, so take the version afterwards */
+        entry->version = _version;
+    }
+    if ((entry->len > 0) &&
+        ((res = gnrc_pktbuf_add(NULL, entry->hdr, entry->len,
+                                GNRC_NETTYPE_IPV6_EXT)) != NULL)) {
+        memcpy(first_hop, &entry->first_hop, sizeof(*first_hop));
+    }
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+void gnrc_rpl_srh_cache_get_stats(gnrc_rpl_srh_cache_stats_t *stats)
+{
+    assert(stats != NULL);
+    mutex_lock(&_mutex);
+    memcpy(stats, &_stats, sizeof(_stats));
+    mutex_unlock(&_mutex);
+}
+#else
+typedef int dont_be_pedantic;
+#endif  /* MODULE_GNRC_RPL_SRH_CACHE */
+
+/** @} */
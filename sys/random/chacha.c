@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+ /**
+ * @ingroup sys_random
+ * @{
+ * @file
+ *
+ * @brief   Buffered ChaCha (CS)PRNG with fast key erasure
+ *
+ * The generator refills a pool of @ref RANDOM_CHACHA_REFILL_BLOCKS keystream
+ * blocks at once and replaces its key by the first 32 bytes of each refill.
+ * Output is wiped from memory as soon as it is handed out, so a leaked state
+ * reveals neither past output nor past keys.
+ *
+ * Every thread owns a small buffer that only the thread itself accesses, so
+ * small requests need no lock. The shared pool is protected by a mutex.
+ *
+ * Interrupt handlers can't take the mutex. They use a second generator
+ * that is keyed from the shared one and protected by disabling interrupts.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "crypto/chacha.h"
+#include "crypto/helper.h"
+#include "irq.h"
+#include "mutex.h"
+#include "random.h"
+#include "thread.h"
+
+#ifdef MODULE_PERIPH_HWRNG
+#include "periph/hwrng.h"
+#endif
+
+#if RANDOM_CHACHA_THREAD_BUF > 255
+#error "RANDOM_CHACHA_THREAD_BUF must not exceed 255"
+#endif
+
+#define KEY_WORDS       (8U)
+#define KEY_SIZE        (KEY_WORDS * sizeof(uint32_t))
+#define POOL_SIZE       (RANDOM_CHACHA_REFILL_BLOCKS * CHACHA_BLOCK_SIZE)
+/* the interrupt pool is refilled with interrupts disabled, keep it short */
+#define ISR_POOL_SIZE   (CHACHA_BLOCK_SIZE)
+#define MIN(a, b)       (((a) < (b)) ? (a) : (b))
+
+#if RANDOM_CHACHA_THREAD_BUF
+typedef struct {
+    uint8_t buf[RANDOM_CHACHA_THREAD_BUF];
+    uint8_t avail;              /**< unused bytes at the start of buf */
+    const volatile thread_t *owner; /**< thread the buffer was filled for */
+    uint32_t gen;               /**< value of _gen when buf was filled */
+} _thread_buf_t;
+
+static _thread_buf_t _thread_bufs[MAXTHREADS];
+#endif
+
+static chacha_ctx _ctx;
+static uint8_t _pool[POOL_SIZE];
+static unsigned _pool_pos = POOL_SIZE;
+#if defined(MODULE_PERIPH_HWRNG) && RANDOM_CHACHA_RESEED_INTERVAL
+static unsigned _refills;
+#endif
+/* incremented by every (re-)initialization to invalidate the thread buffers,
+ * accessed with interrupts disabled as it is not atomic on every MCU */
+static uint32_t _gen;
+static mutex_t _lock = MUTEX_INIT;
+
+/* generator for interrupt context, only accessed with interrupts disabled */
+static chacha_ctx _isr_ctx;
+static uint8_t _isr_pool[ISR_POOL_SIZE];
+static unsigned _isr_pos = ISR_POOL_SIZE;
+
+static void _set_key(chacha_ctx *ctx, const void *key)
+{
+    memcpy(&ctx->state[4], key, KEY_SIZE);
+    ctx->state[12] = 0;
+    ctx->state[13] = 0;
+}
+
+/* replaces the key by the next keystream block and derives a fresh key for
+ * the interrupt generator from the rest of the block */
+static void _erase_key(void)
+{
+    uint32_t block[CHACHA_BLOCK_SIZE / sizeof(uint32_t)];
+
+    chacha_keystream_bytes(&_ctx, block);
+    _set_key(&_ctx, block);
+
+    unsigned state = irq_disable();
+    _set_key(&_isr_ctx, &block[KEY_WORDS]);
+    crypto_secure_wipe(_isr_pool, sizeof(_isr_pool));
+    _isr_pos = sizeof(_isr_pool);
+    irq_restore(state);
+
+    crypto_secure_wipe(block, sizeof(block));
+}
+
+static void _reseed(void)
+{
+#if defined(MODULE_PERIPH_HWRNG) && RANDOM_CHACHA_RESEED_INTERVAL
+    if (++_refills < RANDOM_CHACHA_RESEED_INTERVAL) {
+        return;
+    }
+    _refills = 0;
+
+    uint32_t entropy[KEY_WORDS];
+    hwrng_read(entropy, sizeof(entropy));
+    for (unsigned i = 0; i < KEY_WORDS; i++) {
+        _ctx.state[4 + i] ^= entropy[i];
+    }
+    crypto_secure_wipe(entropy, sizeof(entropy));
+    /* let the interrupt generator benefit from the new entropy as well */
+    _erase_key();
+#endif
+}
+
+static void _refill(void)
+{
+    chacha_keystream_blocks(&_ctx, _pool, RANDOM_CHACHA_REFILL_BLOCKS);
+    _set_key(&_ctx, _pool);
+    crypto_secure_wipe(_pool, KEY_SIZE);
+    _pool_pos = KEY_SIZE;
+    _reseed();
+}
+
+/* must be called with _lock held */
+static void _generate(uint8_t *buf, size_t size)
+{
+    /* whole blocks are generated directly into large buffers */
+    size_t numof = size / CHACHA_BLOCK_SIZE;
+    if (numof) {
+        chacha_keystream_blocks(&_ctx, buf, numof);
+        _erase_key();
+        buf += numof * CHACHA_BLOCK_SIZE;
+        size -= numof * CHACHA_BLOCK_SIZE;
+    }
+
+    while (size) {
+        if (_pool_pos == POOL_SIZE) {
+            _refill();
+        }
+        size_t chunk = MIN(size, POOL_SIZE - _pool_pos);
+        memcpy(buf, &_pool[_pool_pos], chunk);
+        crypto_secure_wipe(&_pool[_pool_pos], chunk);
+        _pool_pos += chunk;
+        buf += chunk;
+        size -= chunk;
+    }
+}
+
+/* serves interrupt handlers, which must not block on the mutex */
+static void _generate_isr(uint8_t *buf, size_t size)
+{
+    unsigned state = irq_disable();
+
+    while (size) {
+        if (_isr_pos == sizeof(_isr_pool)) {
+            chacha_keystream_bytes(&_isr_ctx, _isr_pool);
+            _set_key(&_isr_ctx, _isr_pool);
+            crypto_secure_wipe(_isr_pool, KEY_SIZE);
+            _isr_pos = KEY_SIZE;
+        }
+        size_t chunk = MIN(size, sizeof(_isr_pool) - _isr_pos);
+        memcpy(buf, &_isr_pool[_isr_pos], chunk);
+        crypto_secure_wipe(&_isr_pool[_isr_pos], chunk);
+        _isr_pos += chunk;
+        buf += chunk;
+        size -= chunk;
+    }
+
+    irq_restore(state);
+}
+
+static void _init(const uint32_t *key, unsigned key_words)
+{
+    static const uint8_t nonce[8];
+    uint32_t k[KEY_WORDS] = { 0 };
+
+    /* longer keys are folded into the 256 bit ChaCha key */
+    for (unsigned i = 0; i < key_words; i++) {
+        k[i % KEY_WORDS] ^= key[i];
+    }
+
+    mutex_lock(&_lock);
+    chacha_init(&_ctx, RANDOM_CHACHA_ROUNDS, (const uint8_t *)k, KEY_SIZE,
+                nonce);
+    /* the interrupt generator must not run on the key that is erased */
+    unsigned state = irq_disable();
+    _isr_ctx = _ctx;
+    _erase_key();
+    _gen++;
+    irq_restore(state);
+    crypto_secure_wipe(_pool, sizeof(_pool));
+    _pool_pos = POOL_SIZE;
+    mutex_unlock(&_lock);
+
+    crypto_secure_wipe(k, sizeof(k));
+}
+
+void random_init(uint32_t s)
+{
+    _init(&s, 1);
+}
+
+void random_init_by_array(uint32_t init_key[], int key_length)
+{
+    assert(key_length >= 0);
+    _init(init_key, key_length);
+}
+
+#if RANDOM_CHACHA_THREAD_BUF
+static _thread_buf_t *_thread_buf(void)
+{
+    kernel_pid_t pid = thread_getpid();
+
+    if (!pid_is_valid(pid)) {
+        return NULL;
+    }
+
+    _thread_buf_t *tb = &_thread_bufs[pid - KERNEL_PID_FIRST];
+    const volatile thread_t *self = thread_get(pid);
+    unsigned state = irq_disable();
+    uint32_t gen = _gen;
+    irq_restore(state);
+
+    /* Drop bytes generated before the last random_init() or for a thread
+     * that exited and had the same PID. A thread re-created on the stack of
+     * the exited one can't be told apart, but the bytes it gets were never
+     * handed out to anyone. */
+    if ((tb->owner != self) || (tb->gen != gen)) {
+        crypto_secure_wipe(tb->buf, tb->avail);
+        tb->avail = 0;
+        tb->owner = self;
+        tb->gen = gen;
+    }
+    return tb;
+}
+#endif
+
+void random_bytes(uint8_t *buf, size_t size)
+{
+    if (irq_is_in()) {
+        _generate_isr(buf, size);
+        return;
+    }
+
+#if RANDOM_CHACHA_THREAD_BUF
+    _thread_buf_t *tb = _thread_buf();
+
+    if (tb && (size <= RANDOM_CHACHA_THREAD_BUF)) {
+        while (size) {
+            if (!tb->avail) {
+                mutex_lock(&_lock);
+                _generate(tb->buf, sizeof(tb->buf));
+                mutex_unlock(&_lock);
+                tb->avail = sizeof(tb->buf);
+            }
+            size_t chunk = MIN(size, tb->avail);
+            tb->avail -= chunk;
+            memcpy(buf, &tb->buf[tb->avail], chunk);
+            crypto_secure_wipe(&tb->buf[tb->avail], chunk);
+            buf += chunk;
+            size -= chunk;
+        }
+        return;
+    }
+#endif
+
+    mutex_lock(&_lock);
+    _generate(buf, size);
+    mutex_unlock(&_lock);
+}
+
+uint32_t random_uint32(void)
+{
+    uint32_t r;
+
+    random_bytes((uint8_t *)&r, sizeof(r));
+    return r;
+}
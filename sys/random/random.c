@@ -35,12 +35,23 @@
 #ifdef MODULE_PERIPH_CPUID
 #include "luid.h"
 #endif
+#ifdef MODULE_PRNG_CHACHA
+#include "crypto/helper.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
 void auto_init_random(void)
 {
+#if defined(MODULE_PRNG_CHACHA) && defined(MODULE_PERIPH_HWRNG) && \
+    !defined(MODULE_PUF_SRAM)
+    /* seed the whole 256 bit key of the ChaCha PRNG */
+    uint32_t key[8];
+    hwrng_read(key, sizeof(key));
+    random_init_by_array(key, sizeof(key) / sizeof(key[0]));
+    crypto_secure_wipe(key, sizeof(key));
+#else
     uint32_t seed;
 #ifdef MODULE_PUF_SRAM
     /* TODO: hand state to application? */
@@ -58,8 +69,11 @@ void auto_init_random(void)
 #endif
     DEBUG("random: using seed value %u\n", (unsigned)seed);
     random_init(seed);
+#endif
 }
 
+#ifndef MODULE_PRNG_CHACHA
+/* the ChaCha PRNG generates whole buffers itself */
 void random_bytes(uint8_t *target, size_t n)
 {
     uint32_t random;
@@ -74,6 +88,7 @@ void random_bytes(uint8_t *target, size_t n)
         *target++ = *random_pos++;
     }
 }
+#endif
 
 uint32_t random_uint32_range(uint32_t a, uint32_t b)
 {
@@ -58,9 +58,38 @@ int riotboot_flashwrite_init_raw(riotboot_flashwrite_t *state, int target_slot,
     state->offset = offset;
     state->target_slot = target_slot;
     state->flashpage = flashpage_page((void *)riotboot_slot_get_hdr(target_slot));
+#ifdef MODULE_RIOTBOOT_FLASHWRITE_VERIFY_SHA256
+    sha256_init(&state->sha256);
+#endif
+#ifdef MODULE_RIOTBOOT_FLASHWRITE_VERIFY_PAGES
+    sha256_init(&state->page_sha256);
+#endif
+
+    return 0;
+}
+
+#ifdef MODULE_RIOTBOOT_FLASHWRITE_VERIFY_PAGES
+/* checks the page about to be written against its digest */
+static int _verify_page(riotboot_flashwrite_t *state)
+{
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    /* state->offset already points past the last byte of the page */
+    size_t page = (state->offset - 1) / FLASHPAGE_SIZE;
+
+    sha256_final(&state->page_sha256, digest);
+    sha256_init(&state->page_sha256);
 
+    if (state->page_digests == NULL) {
+        return 0;
+    }
+    if ((page >= state->page_digests_numof) ||
+        (memcmp(digest, &state->page_digests[page * SHA256_DIGEST_LENGTH],
+                SHA256_DIGEST_LENGTH) != 0)) {
+        return -1;
+    }
     return 0;
 }
+#endif
 
 int riotboot_flashwrite_putbytes(riotboot_flashwrite_t *state,
                                  const uint8_t *bytes, size_t len, bool more)
@@ -74,12 +103,27 @@ int riotboot_flashwrite_putbytes(riotboot_flashwrite_t *state,
         size_t to_copy = min(flashpage_avail, len);
 
         memcpy(state->flashpage_buf + flashpage_pos, bytes, to_copy);
+#ifdef MODULE_RIOTBOOT_FLASHWRITE_VERIFY_SHA256
+        /* hash while the data is at hand, so verifying the image does not
+         * need to read it back from flash */
+        sha256_update(&state->sha256, bytes, to_copy);
+#endif
+#ifdef MODULE_RIOTBOOT_FLASHWRITE_VERIFY_PAGES
+        sha256_update(&state->page_sha256, bytes, to_copy);
+#endif
         flashpage_avail -= to_copy;
 
         state->offset += to_copy;
         bytes += to_copy;
         len -= to_copy;
         if ((!flashpage_avail) || (!more)) {
+#ifdef MODULE_RIOTBOOT_FLASHWRITE_VERIFY_PAGES
+            if (_verify_page(state) != 0) {
+                LOG_WARNING(LOG_PREFIX "flashpage %u does not match its digest!\n",
+                            state->flashpage);
+                return -1;
+            }
+#endif
             if (flashpage_write_and_verify(state->flashpage, state->flashpage_buf) != FLASHPAGE_OK) {
                 LOG_WARNING(LOG_PREFIX "error writing flashpage %u!\n", state->flashpage);
                 return -1;
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_riotboot_flashwrite
+ * @{
+ *
+ * @file
+ * @brief       Firmware update per page sha256 verification helper functions
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "hashes/sha256.h"
+#include "log.h"
+#include "riotboot/flashwrite.h"
+
+int riotboot_flashwrite_set_page_digests(riotboot_flashwrite_t *state,
+                                         const uint8_t *digests, size_t numof,
+                                         const uint8_t *root)
+{
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+
+    sha256(digests, numof * SHA256_DIGEST_LENGTH, digest);
+    if (memcmp(root, digest, SHA256_DIGEST_LENGTH) != 0) {
+        LOG_INFO("riotboot: page digests do not match their root\n");
+        return -1;
+    }
+
+    state->page_digests = digests;
+    state->page_digests_numof = numof;
+
+    return 0;
+}
@@ -27,6 +27,8 @@ int _gnrc_ipv6_frag_stats(int argc, char **argv)
         printf("frag full: %u\n", stats->frag_full);
         printf("frags complete: %u\n", stats->fragments);
         printf("dgs complete: %u\n", stats->datagrams);
+        printf("overlaps: %u\n", stats->overlaps);
+        printf("quota exceeded: %u\n", stats->quota_exceeded);
     }
     return 0;
 }
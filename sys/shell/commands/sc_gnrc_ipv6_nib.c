@@ -13,9 +13,11 @@
  * @author  Martine Lenders <m.lenders@fu-berlin.de>
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 
 #include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/ipv6/nib/dst_cache.h"
 #include "net/gnrc/netif.h"
 #include "net/ipv6/addr.h"
 
@@ -26,6 +28,9 @@ static int _nib_route(int argc, char **argv);
 #if GNRC_IPV6_NIB_CONF_MULTIHOP_P6C
 static int _nib_abr(int argc, char **argv);
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+static int _nib_dst_cache(int argc, char **argv);
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
 
 int _gnrc_ipv6_nib(int argc, char **argv)
 {
@@ -49,6 +54,11 @@ int _gnrc_ipv6_nib(int argc, char **argv)
         res = _nib_abr(argc, argv);
     }
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+    else if (strcmp(argv[1], "cache") == 0) {
+        res = _nib_dst_cache(argc, argv);
+    }
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
     else {
         _usage(argv);
     }
@@ -57,11 +67,14 @@ int _gnrc_ipv6_nib(int argc, char **argv)
 
 static void _usage(char **argv)
 {
+    printf("usage: %s {neigh|prefix|route"
 #if GNRC_IPV6_NIB_CONF_MULTIHOP_P6C
-    printf("usage: %s {neigh|prefix|route|abr|help} ...\n", argv[0]);
-#else   /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
-    printf("usage: %s {neigh|prefix|route|help} ...\n", argv[0]);
+           "|abr"
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+           "|cache"
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
+           "|help} ...\n", argv[0]);
 }
 
 static void _usage_nib_neigh(char **argv)
@@ -364,4 +377,33 @@ static int _nib_abr(int argc, char **argv)
 }
 #endif  /* GNRC_IPV6_NIB_CONF_MULTIHOP_P6C */
 
+#ifdef MODULE_GNRC_IPV6_NIB_DST_CACHE
+static void _usage_nib_dst_cache(char **argv)
+{
+    printf("usage: %s %s [show|help]\n", argv[0], argv[1]);
+    printf("       %s %s show\n", argv[0], argv[1]);
+}
+
+static int _nib_dst_cache(int argc, char **argv)
+{
+    if ((argc == 2) || (strcmp(argv[2], "show") == 0)) {
+        gnrc_ipv6_nib_dst_cache_t entry;
+        gnrc_ipv6_nib_dst_cache_stats_t stats;
+        void *state = NULL;
+
+        while (gnrc_ipv6_nib_dst_cache_iter(&state, &entry)) {
+            gnrc_ipv6_nib_dst_cache_print(&entry);
+        }
+        gnrc_ipv6_nib_dst_cache_get_stats(&stats);
+        printf("hits: %" PRIu32 ", misses: %" PRIu32 "\n",
+               stats.hits, stats.misses);
+    }
+    else {
+        _usage_nib_dst_cache(argv);
+        return (strcmp(argv[2], "help") == 0) ? 0 : 1;
+    }
+    return 0;
+}
+#endif  /* MODULE_GNRC_IPV6_NIB_DST_CACHE */
+
 /** @} */
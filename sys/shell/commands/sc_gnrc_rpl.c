@@ -229,6 +229,10 @@ int _stats(void)
     printf("DAO-ACK   #bytes: %10" PRIu32 " / %-10" PRIu32 "  %10" PRIu32 " / %-10" PRIu32 "\n",
            gnrc_rpl_netstats.dao_ack_rx_ucast_bytes, gnrc_rpl_netstats.dao_ack_tx_ucast_bytes,
            gnrc_rpl_netstats.dao_ack_rx_mcast_bytes, gnrc_rpl_netstats.dao_ack_tx_mcast_bytes);
+    printf("DAO retransmitted: %" PRIu32 ", coalesced: %" PRIu32 "\n",
+           gnrc_rpl_netstats.dao_tx_retrans_count, gnrc_rpl_netstats.dao_tx_coalesced_count);
+    printf("DAO dropped  RX / TX: %" PRIu32 " / %" PRIu32 "\n",
+           gnrc_rpl_netstats.dao_rx_drop_count, gnrc_rpl_netstats.dao_tx_drop_count);
     return 0;
 }
 #endif
@@ -298,11 +302,12 @@ int _gnrc_rpl_dodag_show(void)
                          (uint64_t)dodag->trickle.msg_timer.long_start_time << 32 | dodag->trickle.msg_timer.start_time));
         tc = (int64_t) tc < 0 ? 0 : tc / US_PER_SEC;
 
-        printf("\tdodag [%s | R: %d | OP: %s | PIO: %s | "
+        printf("\tdodag [%s | R: %d | OP: %s | PIO: %s | PP changes: %u | "
                "TR(I=[%d,%d], k=%d, c=%d, TC=%" PRIu32 "s)]\n",
                ipv6_addr_to_str(addr_str, &dodag->dodag_id, sizeof(addr_str)),
                dodag->my_rank, (dodag->node_status == GNRC_RPL_LEAF_NODE ? "Leaf" : "Router"),
                ((dodag->dio_opts & GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO) ? "on" : "off"),
+               dodag->parent_switches,
                (1 << dodag->dio_min), dodag->dio_interval_doubl, dodag->trickle.k,
                dodag->trickle.c, (uint32_t) (tc & 0xFFFFFFFF));
 
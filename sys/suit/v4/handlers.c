@@ -259,11 +259,14 @@ static int _dtv_fetch(suit_v4_manifest_t *manifest, int key, nanocbor_value_t *_
     }
 
     /* "digest" points to a 36 byte string that includes the digest type.
-     * riotboot_flashwrite_verify_sha256() is only interested in the 32b digest,
-     * so shift the pointer accordingly.
+     * riotboot_flashwrite_verify_sha256_streamed() is only interested in the
+     * 32b digest, so shift the pointer accordingly.
+     * The digest was computed during the download, so the image is not read
+     * back from flash.
      */
-    res = riotboot_flashwrite_verify_sha256(digest + 4, manifest->components[0].size,
-                                            target_slot);
+    res = riotboot_flashwrite_verify_sha256_streamed(manifest->writer,
+                                                     digest + 4,
+                                                     manifest->components[0].size);
     if (res) {
         LOG_INFO("image verification failed\n");
         return res;
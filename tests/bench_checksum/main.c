@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure throughput of the checksums
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "checksum/crc8.h"
+#include "checksum/crc16_ccitt.h"
+#include "checksum/crc32.h"
+#include "checksum/fletcher16.h"
+#include "checksum/fletcher32.h"
+#include "checksum/ucrc16.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (100UL)
+#endif
+
+#define FRAME_LEN           (127U)
+#define PAGE_LEN            (1024U)
+
+/* fletcher32() works on 16 bit words */
+static uint16_t _buf[PAGE_LEN / sizeof(uint16_t)];
+static volatile uint32_t _sink;
+
+static void _bench(size_t len)
+{
+    const uint8_t *data = (const uint8_t *)_buf;
+
+    printf("\n%u bytes:\n", (unsigned)len);
+    BENCHMARK_FUNC_BYTES("crc8()", BENCH_RUNS, len,
+                         _sink = crc8(data, len, 0x31, 0xff));
+    BENCHMARK_FUNC_BYTES("ucrc16_calc_be()", BENCH_RUNS, len,
+                         _sink = ucrc16_calc_be(data, len,
+                                                UCRC16_CCITT_POLY_BE, 0xffff));
+    BENCHMARK_FUNC_BYTES("crc16_ccitt_calc()", BENCH_RUNS, len,
+                         _sink = crc16_ccitt_calc(data, len));
+    BENCHMARK_FUNC_BYTES("crc32_ieee_calc()", BENCH_RUNS, len,
+                         _sink = crc32_ieee_calc(data, len));
+    BENCHMARK_FUNC_BYTES("fletcher16()", BENCH_RUNS, len,
+                         _sink = fletcher16(data, len));
+    BENCHMARK_FUNC_BYTES("fletcher32()", BENCH_RUNS, len & ~1U,
+                         _sink = fletcher32(_buf, len / sizeof(uint16_t)));
+}
+
+int main(void)
+{
+    for (unsigned i = 0; i < PAGE_LEN; i++) {
+        ((uint8_t *)_buf)[i] = i;
+    }
+
+    printf("Throughput of checksums, CRC16-CCITT slices: %u, "
+           "CRC32 slices: %u\n", CRC16_CCITT_SLICES, CRC32_IEEE_SLICES);
+
+    _bench(FRAME_LEN);
+    _bench(PAGE_LEN);
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
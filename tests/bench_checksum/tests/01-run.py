@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+# The default timeout is not enough for this test on some of the slower boards
+TIMEOUT = 60
+BENCHMARK_REGEXP = r"\s+{func}:\s+\d+ ns/byte"
+
+
+def testfunc(child):
+    child.expect(r'Throughput of checksums, CRC16-CCITT slices: \d, '
+                 r'CRC32 slices: \d')
+    for length in (127, 1024):
+        child.expect_exact('{} bytes:'.format(length))
+        for func in ("crc8", "ucrc16_calc_be", "crc16_ccitt_calc",
+                     "crc32_ieee_calc", "fletcher16", "fletcher32"):
+            child.expect(BENCHMARK_REGEXP.format(func=func + "\\(\\)"),
+                         timeout=TIMEOUT)
+    child.expect_exact('[SUCCESS]')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure runtime of AES-128
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "crypto/aes.h"
+#include "crypto/ciphers.h"
+#include "crypto/modes/ccm.h"
+#include "crypto/modes/ctr.h"
+#include "crypto/modes/gcm.h"
+
+#ifdef MODULE_WOLFCRYPT_AES
+#include <wolfssl/wolfcrypt/aes.h>
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (1000UL)
+#endif
+
+/* an IEEE 802.15.4 frame sized payload */
+#define PAYLOAD_LEN         (96U)
+#define BLOCKS_NUMOF        (PAYLOAD_LEN / AES_BLOCK_SIZE)
+
+static const uint8_t _key[AES_KEY_SIZE] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+/* 13 bytes for CCM, the first 12 bytes for GCM */
+static const uint8_t _nonce[13] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+static const uint8_t _auth_data[8] = { 0x08, 0x07, 0x06, 0x05 };
+
+static cipher_t _cipher;
+static uint8_t _in[PAYLOAD_LEN];
+static uint8_t _out[PAYLOAD_LEN + 16];
+#ifdef MODULE_WOLFCRYPT_AES
+static Aes _wc_aes;
+#endif
+
+static void _encrypt_each(void)
+{
+    for (unsigned i = 0; i < BLOCKS_NUMOF; i++) {
+        cipher_encrypt(&_cipher, &_in[i * AES_BLOCK_SIZE],
+                       &_out[i * AES_BLOCK_SIZE]);
+    }
+}
+
+static void _encrypt_ctr(void)
+{
+    uint8_t ctr[16] = { 0 };
+
+    cipher_encrypt_ctr(&_cipher, ctr, 8, _in, PAYLOAD_LEN, _out);
+}
+
+static void _encrypt_ccm(void)
+{
+    cipher_encrypt_ccm(&_cipher, _auth_data, sizeof(_auth_data), 8, 2,
+                       _nonce, sizeof(_nonce), _in, PAYLOAD_LEN, _out);
+}
+
+static void _encrypt_gcm(void)
+{
+    cipher_encrypt_gcm(&_cipher, _auth_data, sizeof(_auth_data), 16,
+                       _nonce, 12, _in, PAYLOAD_LEN, _out);
+}
+
+static void _decrypt_gcm(void)
+{
+    /* fails the tag verification, but only after all the work is done */
+    cipher_decrypt_gcm(&_cipher, _auth_data, sizeof(_auth_data), 16,
+                       _nonce, 12, _out, PAYLOAD_LEN + 16, _in);
+}
+
+#ifdef MODULE_WOLFCRYPT_AES
+static void _wc_encrypt_gcm(void)
+{
+    wc_AesGcmEncrypt(&_wc_aes, _out, _in, PAYLOAD_LEN, _nonce, 12,
+                     &_out[PAYLOAD_LEN], 16, _auth_data, sizeof(_auth_data));
+}
+#endif
+
+int main(void)
+{
+    puts("Runtime of AES-128\n");
+
+    if (cipher_init(&_cipher, CIPHER_AES_128, _key, AES_KEY_SIZE) < 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+
+    BENCHMARK_FUNC("cipher_encrypt()", BENCH_RUNS,
+                   cipher_encrypt(&_cipher, _in, _out));
+    BENCHMARK_FUNC("cipher_decrypt()", BENCH_RUNS,
+                   cipher_decrypt(&_cipher, _in, _out));
+    puts("");
+    BENCHMARK_FUNC("cipher_encrypt() per block", BENCH_RUNS, _encrypt_each());
+    BENCHMARK_FUNC("cipher_encrypt_blocks()", BENCH_RUNS,
+                   cipher_encrypt_blocks(&_cipher, _in, _out, BLOCKS_NUMOF));
+    BENCHMARK_FUNC("cipher_decrypt_blocks()", BENCH_RUNS,
+                   cipher_decrypt_blocks(&_cipher, _in, _out, BLOCKS_NUMOF));
+    puts("");
+    BENCHMARK_FUNC("cipher_encrypt_ctr()", BENCH_RUNS, _encrypt_ctr());
+    BENCHMARK_FUNC("cipher_encrypt_ccm()", BENCH_RUNS, _encrypt_ccm());
+    BENCHMARK_FUNC("cipher_encrypt_gcm()", BENCH_RUNS, _encrypt_gcm());
+    BENCHMARK_FUNC("cipher_decrypt_gcm()", BENCH_RUNS, _decrypt_gcm());
+#ifdef MODULE_WOLFCRYPT_AES
+    if (wc_AesGcmSetKey(&_wc_aes, _key, AES_KEY_SIZE) != 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+    BENCHMARK_FUNC("wc_AesGcmEncrypt()", BENCH_RUNS, _wc_encrypt_gcm());
+#endif
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
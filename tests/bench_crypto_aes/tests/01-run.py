@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+# The default timeout is not enough for this test on some of the slower boards
+TIMEOUT = 60
+BENCHMARK_REGEXP = r"\s+{func}:\s+\d+us\s+---\s+\d*\.*\d+us per call\s+---\s+\d+ calls per sec"
+
+
+def testfunc(child):
+    child.expect_exact('Runtime of AES-128')
+    for func in ("cipher_encrypt\\(\\)", "cipher_decrypt\\(\\)",
+                 "cipher_encrypt\\(\\) per block",
+                 "cipher_encrypt_blocks\\(\\)", "cipher_decrypt_blocks\\(\\)",
+                 "cipher_encrypt_ctr\\(\\)", "cipher_encrypt_ccm\\(\\)",
+                 "cipher_encrypt_gcm\\(\\)", "cipher_decrypt_gcm\\(\\)"):
+        child.expect(BENCHMARK_REGEXP.format(func=func), timeout=TIMEOUT)
+    child.expect_exact('[SUCCESS]')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
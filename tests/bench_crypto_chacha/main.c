@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure runtime of ChaCha20
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "crypto/chacha.h"
+#include "crypto/chacha20poly1305.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (1000UL)
+#endif
+
+/* a DTLS record sized payload */
+#define PAYLOAD_LEN         (256U)
+#define BLOCKS_NUMOF        (PAYLOAD_LEN / CHACHA_BLOCK_SIZE)
+
+static const uint8_t _key[CHACHA20POLY1305_KEY_BYTES] = {
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+    0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+};
+static const uint8_t _nonce[CHACHA20POLY1305_NONCE_BYTES] = {
+    0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43
+};
+static const uint8_t _auth_data[13] = { 0x50, 0x51, 0x52, 0x53 };
+
+static chacha_ctx _ctx;
+static uint8_t _in[PAYLOAD_LEN];
+static uint8_t _out[PAYLOAD_LEN + CHACHA20POLY1305_TAG_BYTES];
+
+static void _encrypt_each(void)
+{
+    for (unsigned i = 0; i < BLOCKS_NUMOF; i++) {
+        chacha_encrypt_bytes(&_ctx, &_in[i * CHACHA_BLOCK_SIZE],
+                             &_out[i * CHACHA_BLOCK_SIZE]);
+    }
+}
+
+static void _prng_fill(void)
+{
+    for (unsigned i = 0; i < PAYLOAD_LEN / sizeof(uint32_t); i++) {
+        chacha_prng_next();
+    }
+}
+
+int main(void)
+{
+    printf("Runtime of ChaCha20 (CHACHA_VECTORIZE=%u)\n\n", CHACHA_VECTORIZE);
+
+    if (chacha_init(&_ctx, 20, _key, sizeof(_key), _nonce) < 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+
+    BENCHMARK_FUNC("chacha_keystream_bytes()", BENCH_RUNS,
+                   chacha_keystream_bytes(&_ctx, _out));
+    BENCHMARK_FUNC("chacha_keystream_blocks()", BENCH_RUNS,
+                   chacha_keystream_blocks(&_ctx, _out, BLOCKS_NUMOF));
+    puts("");
+    BENCHMARK_FUNC("chacha_encrypt_bytes() per block", BENCH_RUNS,
+                   _encrypt_each());
+    BENCHMARK_FUNC("chacha_encrypt_buf()", BENCH_RUNS,
+                   chacha_encrypt_buf(&_ctx, _in, _out, PAYLOAD_LEN));
+    BENCHMARK_FUNC("chacha20poly1305_encrypt()", BENCH_RUNS,
+                   chacha20poly1305_encrypt(_out, _in, PAYLOAD_LEN,
+                                            _auth_data, sizeof(_auth_data),
+                                            _key, _nonce));
+    BENCHMARK_FUNC("chacha_prng_next() per payload", BENCH_RUNS, _prng_fill());
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+# The default timeout is not enough for this test on some of the slower boards
+TIMEOUT = 60
+BENCHMARK_REGEXP = r"\s+{func}:\s+\d+us\s+---\s+\d*\.*\d+us per call\s+---\s+\d+ calls per sec"
+
+
+def testfunc(child):
+    child.expect(r'Runtime of ChaCha20 \(CHACHA_VECTORIZE=\d\)')
+    for func in ("chacha_keystream_bytes\\(\\)",
+                 "chacha_keystream_blocks\\(\\)",
+                 "chacha_encrypt_bytes\\(\\) per block",
+                 "chacha_encrypt_buf\\(\\)",
+                 "chacha20poly1305_encrypt\\(\\)",
+                 "chacha_prng_next\\(\\) per payload"):
+        child.expect(BENCHMARK_REGEXP.format(func=func), timeout=TIMEOUT)
+    child.expect_exact('[SUCCESS]')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure throughput of SHA-256
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "hashes/sha256.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (100UL)
+#endif
+
+#define BUF_LEN             (1024U)
+#define HMAC_LEN            (64U)
+#define CHAIN_ELEMENTS      (16U)
+
+static uint8_t _buf[2][BUF_LEN];
+static uint8_t _digest[SHA256_DIGEST_LENGTH];
+
+static void _hash_each(void)
+{
+    sha256_context_t c[2];
+
+    for (unsigned i = 0; i < 2; i++) {
+        sha256_init(&c[i]);
+        sha256_update(&c[i], _buf[i], BUF_LEN);
+        sha256_final(&c[i], _digest);
+    }
+}
+
+static void _hash_multi(void)
+{
+    sha256_context_t c[2];
+    sha256_context_t *const ctx[] = { &c[0], &c[1] };
+    const void *const data[] = { _buf[0], _buf[1] };
+
+    sha256_init(&c[0]);
+    sha256_init(&c[1]);
+    sha256_update_multi(ctx, data, 2, BUF_LEN);
+    sha256_final(&c[0], _digest);
+    sha256_final(&c[1], _digest);
+}
+
+int main(void)
+{
+    printf("Throughput of SHA-256, interleaving %s\n\n",
+           SHA256_MULTI_INTERLEAVE ? "enabled" : "disabled");
+
+    BENCHMARK_FUNC_BYTES("sha256()", BENCH_RUNS, BUF_LEN,
+                         sha256(_buf[0], BUF_LEN, _digest));
+    BENCHMARK_FUNC_BYTES("sha256_update() of 2 hashes", BENCH_RUNS,
+                         2 * BUF_LEN, _hash_each());
+    BENCHMARK_FUNC_BYTES("sha256_update_multi()", BENCH_RUNS, 2 * BUF_LEN,
+                         _hash_multi());
+    BENCHMARK_FUNC_BYTES("hmac_sha256()", BENCH_RUNS, HMAC_LEN,
+                         hmac_sha256(_buf[0], HMAC_LEN, _buf[1], HMAC_LEN,
+                                     _digest));
+    BENCHMARK_FUNC_BYTES("sha256_chain()", BENCH_RUNS,
+                         CHAIN_ELEMENTS * SHA256_DIGEST_LENGTH,
+                         sha256_chain(_buf[0], SHA256_DIGEST_LENGTH,
+                                      CHAIN_ELEMENTS, _digest));
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
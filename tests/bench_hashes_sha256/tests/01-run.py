@@ -0,0 +1,28 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+# The default timeout is not enough for this test on some of the slower boards
+TIMEOUT = 60
+BENCHMARK_REGEXP = r"\s+{func}:\s+\d+ ns/byte"
+
+
+def testfunc(child):
+    child.expect(r'Throughput of SHA-256, interleaving (enabled|disabled)')
+    for func in ("sha256\\(\\)", "sha256_update\\(\\) of 2 hashes",
+                 "sha256_update_multi\\(\\)", "hmac_sha256\\(\\)",
+                 "sha256_chain\\(\\)"):
+        child.expect(BENCHMARK_REGEXP.format(func=func), timeout=TIMEOUT)
+    child.expect_exact('[SUCCESS]')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure throughput of SHA-3 and SHAKE
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "hashes/sha3.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (100UL)
+#endif
+
+#define BUF_LEN             (1024U)
+#define PIECE_LEN           (13U)
+
+static uint8_t _buf[BUF_LEN];
+static uint8_t _digest[SHA3_512_DIGEST_LENGTH];
+
+static void _hash_pieces(void)
+{
+    keccak_state_t ctx;
+
+    sha3_256_init(&ctx);
+    for (unsigned pos = 0; pos < BUF_LEN; pos += PIECE_LEN) {
+        unsigned len = (BUF_LEN - pos < PIECE_LEN) ? BUF_LEN - pos : PIECE_LEN;
+        sha3_update(&ctx, &_buf[pos], len);
+    }
+    sha3_256_final(&ctx, _digest);
+}
+
+static void _squeeze_pieces(void)
+{
+    keccak_state_t ctx;
+
+    shake128_init(&ctx);
+    shake_update(&ctx, _digest, SHA3_256_DIGEST_LENGTH);
+    for (unsigned pos = 0; pos < BUF_LEN; pos += PIECE_LEN) {
+        unsigned len = (BUF_LEN - pos < PIECE_LEN) ? BUF_LEN - pos : PIECE_LEN;
+        shake_squeeze(&ctx, &_buf[pos], len);
+    }
+}
+
+int main(void)
+{
+    puts("Throughput of SHA-3\n");
+
+    BENCHMARK_FUNC_BYTES("sha3_256()", BENCH_RUNS, BUF_LEN,
+                         sha3_256(_digest, _buf, BUF_LEN));
+    BENCHMARK_FUNC_BYTES("sha3_512()", BENCH_RUNS, BUF_LEN,
+                         sha3_512(_digest, _buf, BUF_LEN));
+    BENCHMARK_FUNC_BYTES("sha3_update() in pieces", BENCH_RUNS, BUF_LEN,
+                         _hash_pieces());
+    BENCHMARK_FUNC_BYTES("shake128()", BENCH_RUNS, BUF_LEN,
+                         shake128(_digest, SHA3_256_DIGEST_LENGTH, _buf,
+                                  BUF_LEN));
+    BENCHMARK_FUNC_BYTES("shake256()", BENCH_RUNS, BUF_LEN,
+                         shake256(_digest, SHA3_512_DIGEST_LENGTH, _buf,
+                                  BUF_LEN));
+    BENCHMARK_FUNC_BYTES("shake_squeeze() in pieces", BENCH_RUNS, BUF_LEN,
+                         _squeeze_pieces());
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure runtime of the nanocoap parser
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "kernel_defines.h"
+#include "net/nanocoap.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (100UL * 1000UL)
+#endif
+
+const coap_resource_t coap_resources[] = {
+    COAP_WELL_KNOWN_CORE_DEFAULT_HANDLER,
+};
+
+const unsigned coap_resources_numof = ARRAY_SIZE(coap_resources);
+
+static uint8_t _buf[128];
+static size_t _len;
+static coap_pkt_t _pkt;
+static uint8_t _uri[NANOCOAP_URI_MAX];
+static coap_block1_t _block;
+static volatile unsigned _sum;
+
+/* builds a request as a block-wise GET of a sensor resource would look like */
+static void _build_req(void)
+{
+    coap_block1_t block = { .blknum = 2, .szx = 2 };
+
+    _len = coap_build_hdr((coap_hdr_t *)_buf, COAP_TYPE_CON,
+                          (uint8_t *)"\x23\x42\x11\x08", 4, COAP_METHOD_GET,
+                          0x1234);
+    coap_pkt_init(&_pkt, _buf, sizeof(_buf), _len);
+    coap_opt_add_uint(&_pkt, COAP_OPT_OBSERVE, 0);
+    coap_opt_add_string(&_pkt, COAP_OPT_URI_PATH, "/sensors/env/temp", '/');
+    coap_opt_add_uint(&_pkt, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_CBOR);
+    coap_opt_add_string(&_pkt, COAP_OPT_URI_QUERY, "unit=c&res=hi", '&');
+    coap_opt_add_block2_control(&_pkt, &block);
+    _len = coap_opt_finish(&_pkt, COAP_OPT_FINISH_NONE);
+}
+
+static void _parse(void)
+{
+    coap_parse(&_pkt, _buf, _len);
+}
+
+static void _iterate(void)
+{
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t len;
+    bool init = true;
+
+    while ((len = coap_opt_get_next_by_num(&_pkt, &opt, COAP_OPT_URI_PATH,
+                                           &value, init)) >= 0) {
+        _sum += len;
+        init = false;
+    }
+}
+
+int main(void)
+{
+    puts("Runtime of the nanocoap parser\n");
+
+    _build_req();
+    if (coap_parse(&_pkt, _buf, _len) < 0) {
+        puts("[FAILED]");
+        return 1;
+    }
+
+    BENCHMARK_FUNC("coap_parse()", BENCH_RUNS, _parse());
+    puts("");
+    BENCHMARK_FUNC("coap_get_content_type()", BENCH_RUNS,
+                   _sum += coap_get_content_type(&_pkt));
+    BENCHMARK_FUNC("coap_get_block2()", BENCH_RUNS,
+                   coap_get_block2(&_pkt, &_block));
+    BENCHMARK_FUNC("coap_get_uri_path()", BENCH_RUNS,
+                   coap_get_uri_path(&_pkt, _uri));
+    BENCHMARK_FUNC("coap_opt_get_next_by_num()", BENCH_RUNS, _iterate());
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
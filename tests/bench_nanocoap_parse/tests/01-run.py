@@ -0,0 +1,29 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+# The default timeout is not enough for this test on some of the slower boards
+TIMEOUT = 30
+BENCHMARK_REGEXP = r"\s+{func}:\s+\d+us\s+---\s+\d*\.*\d+us per call\s+---\s+\d+ calls per sec"
+
+
+def testfunc(child):
+    child.expect_exact('Runtime of the nanocoap parser')
+    child.expect(BENCHMARK_REGEXP.format(func=r"coap_parse\(\)"), timeout=TIMEOUT)
+    child.expect(BENCHMARK_REGEXP.format(func=r"coap_get_content_type\(\)"), timeout=TIMEOUT)
+    child.expect(BENCHMARK_REGEXP.format(func=r"coap_get_block2\(\)"), timeout=TIMEOUT)
+    child.expect(BENCHMARK_REGEXP.format(func=r"coap_get_uri_path\(\)"), timeout=TIMEOUT)
+    child.expect(BENCHMARK_REGEXP.format(func=r"coap_opt_get_next_by_num\(\)"), timeout=TIMEOUT)
+    child.expect_exact('[SUCCESS]')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
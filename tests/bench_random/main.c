@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure throughput of the selected PRNG
+ *
+ * @}
+ */
+
+#include <stdio.h>
+
+#include "benchmark.h"
+#include "random.h"
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          (1000UL)
+#endif
+
+/* e.g. a CoAP token or a TCP initial sequence number */
+#define SMALL_LEN           (8U)
+/* e.g. DTLS handshake randoms and keys */
+#define LARGE_LEN           (256U)
+
+static uint8_t _buf[LARGE_LEN];
+static volatile uint32_t _sink;
+
+int main(void)
+{
+    puts("Throughput of the PRNG");
+
+    /* the PRNG may lock a mutex, which needs interrupts enabled */
+    BENCHMARK_FUNC_BYTES_BLOCKING("random_uint32()", BENCH_RUNS,
+                                  sizeof(uint32_t), _sink = random_uint32());
+    BENCHMARK_FUNC_BYTES_BLOCKING("random_bytes(8)", BENCH_RUNS, SMALL_LEN,
+                                  random_bytes(_buf, SMALL_LEN));
+    BENCHMARK_FUNC_BYTES_BLOCKING("random_bytes(256)", BENCH_RUNS, LARGE_LEN,
+                                  random_bytes(_buf, LARGE_LEN));
+
+    puts("\n[SUCCESS]");
+    return 0;
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import re
+import sys
+from testrunner import run
+
+
+# The default timeout is not enough for this test on some of the slower boards
+TIMEOUT = 60
+BENCHMARK_REGEXP = r"\s+{func}:\s+\d+ ns/byte"
+
+
+def testfunc(child):
+    child.expect_exact('Throughput of the PRNG')
+    for func in ("random_uint32()", "random_bytes(8)", "random_bytes(256)"):
+        child.expect(BENCHMARK_REGEXP.format(func=re.escape(func)),
+                     timeout=TIMEOUT)
+    child.expect_exact('[SUCCESS]')
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc))
@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the publish window and the topic ID cache of emCute
+ *
+ * The gateway is a socket of this application on the loopback address. Its
+ * thread answers CONNECT, REGISTER and DISCONNECT messages on its own and
+ * forwards the PUBLISH messages it receives to the main thread, which
+ * acknowledges them.
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "embUnit.h"
+#include "msg.h"
+#include "net/emcute.h"
+#include "net/ipv6/addr.h"
+#include "net/mqttsn.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define MAIN_QUEUE_SIZE     (8)
+#define CLI_ID              "emcute pub_async test"
+#define GW_PORT             (20000U)
+#define TOPIC_NAME          "/riot/test"
+/* emCute retransmits after EMCUTE_T_RETRY, so wait a bit longer */
+#define PUB_TIMEOUT         ((EMCUTE_T_RETRY * US_PER_SEC) + \
+                             (500U * US_PER_MS))
+#define DONE_TIMEOUT        ((EMCUTE_N_RETRY + 2) * EMCUTE_T_RETRY * US_PER_SEC)
+#define DONE_POLL           (10U * US_PER_MS)
+#define NUMOF_ARGS          (EMCUTE_PUB_WINDOW + 2)
+/* argument for a callback that connects again on EMCUTE_NOGW */
+#define ARG_RECONNECT       (NUMOF_ARGS - 1)
+#define RES_NONE            (1)
+
+/* PUBLISH message the gateway received */
+typedef struct {
+    uint16_t msg_id;
+    uint8_t flags;
+} pub_t;
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+static char _emcute_stack[THREAD_STACKSIZE_DEFAULT];
+static char _gw_stack[THREAD_STACKSIZE_DEFAULT];
+static sock_udp_t _gw_sock;
+static sock_udp_ep_t _gw_ep = {
+    .family = AF_INET6,
+    .netif = SOCK_ADDR_ANY_NETIF,
+    .port = GW_PORT,
+};
+/* endpoint of emCute as the gateway sees it */
+static sock_udp_ep_t _cli_ep;
+static const char _data[] = "ABCDEFG";
+static emcute_topic_t _topic;
+
+/* gateway state */
+static volatile unsigned _gw_regs;
+static uint16_t _gw_next_tid;
+static volatile bool _gw_reject_con;
+static volatile bool _gw_pub_on_con;
+
+static volatile int _res[NUMOF_ARGS];
+static volatile int _recon_res;
+
+static void _pub_cb(void *arg, int res)
+{
+    unsigned i = (uintptr_t)arg;
+
+    if ((i == ARG_RECONNECT) && (res == EMCUTE_NOGW)) {
+        /* must not wait for a lock the failed connection attempt holds */
+        _gw_reject_con = false;
+        _recon_res = emcute_con(&_gw_ep, true, NULL, NULL, 0, 0);
+    }
+    _res[i] = res;
+}
+
+static void _gw_send(const uint8_t *buf, size_t len)
+{
+    sock_udp_send(&_gw_sock, buf, len, &_cli_ep);
+}
+
+static void _on_connect(void)
+{
+    uint8_t connack[] = { 3, MQTTSN_CONNACK, MQTTSN_ACCEPTED };
+
+    if (_gw_pub_on_con) {
+        /* fill the window while emcute_con() waits for the CONNACK */
+        _gw_pub_on_con = false;
+        emcute_pub_async(&_topic, _data, sizeof(_data), EMCUTE_QOS_1,
+                         _pub_cb, (void *)(uintptr_t)ARG_RECONNECT);
+    }
+    if (_gw_reject_con) {
+        connack[2] = MQTTSN_REJ_CONGESTION;
+    }
+    _gw_send(connack, sizeof(connack));
+}
+
+static void _on_register(const uint8_t *buf)
+{
+    uint8_t regack[] = { 7, MQTTSN_REGACK, 0, 0, buf[4], buf[5],
+                         MQTTSN_ACCEPTED };
+
+    byteorder_htobebufs(&regack[2], ++_gw_next_tid);
+    _gw_regs++;
+    _gw_send(regack, sizeof(regack));
+}
+
+static void *_gw_thread(void *arg)
+{
+    static uint8_t buf[EMCUTE_BUFSIZE];
+
+    (void)arg;
+    while (1) {
+        sock_udp_ep_t remote;
+        ssize_t len = sock_udp_recv(&_gw_sock, buf, sizeof(buf),
+                                    SOCK_NO_TIMEOUT, &remote);
+
+        /* emCute does not use the long length field for these messages */
+        if ((len < 2) || (buf[0] != len)) {
+            continue;
+        }
+        _cli_ep = remote;
+        switch (buf[1]) {
+            case MQTTSN_CONNECT:
+                _on_connect();
+                break;
+            case MQTTSN_REGISTER:
+                _on_register(buf);
+                break;
+            case MQTTSN_DISCONNECT:
+                _gw_send(buf, 2);
+                break;
+            case MQTTSN_PUBLISH: {
+                msg_t msg = { .type = buf[2] };
+
+                msg.content.value = byteorder_bebuftohs(&buf[5]);
+                msg_send(&msg, _main_pid);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+static void *_emcute_thread(void *arg)
+{
+    (void)arg;
+    emcute_run(MQTTSN_DEFAULT_PORT, CLI_ID);
+    return NULL;    /* should never be reached */
+}
+
+static bool _recv_pub(pub_t *pub)
+{
+    msg_t msg;
+
+    if (xtimer_msg_receive_timeout(&msg, PUB_TIMEOUT) < 0) {
+        return false;
+    }
+    pub->flags = msg.type;
+    pub->msg_id = msg.content.value;
+    return true;
+}
+
+static void _puback(uint16_t topic_id, uint16_t msg_id, uint8_t ret)
+{
+    uint8_t puback[] = { 7, MQTTSN_PUBACK, 0, 0, 0, 0, ret };
+
+    byteorder_htobebufs(&puback[2], topic_id);
+    byteorder_htobebufs(&puback[4], msg_id);
+    _gw_send(puback, sizeof(puback));
+}
+
+/* waits until the callback for @p i was called */
+static int _wait_done(unsigned i)
+{
+    for (uint32_t t = 0; (_res[i] == RES_NONE) && (t < DONE_TIMEOUT);
+         t += DONE_POLL) {
+        xtimer_usleep(DONE_POLL);
+    }
+    return _res[i];
+}
+
+static void _publish(unsigned i)
+{
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK,
+                          emcute_pub_async(&_topic, _data, sizeof(_data),
+                                           EMCUTE_QOS_1, _pub_cb,
+                                           (void *)(uintptr_t)i));
+}
+
+static void set_up(void)
+{
+    for (unsigned i = 0; i < NUMOF_ARGS; i++) {
+        _res[i] = RES_NONE;
+    }
+    _recon_res = RES_NONE;
+    _gw_reject_con = false;
+    _gw_pub_on_con = false;
+    _gw_regs = 0;
+    memset(&_topic, 0, sizeof(_topic));
+    _topic.name = TOPIC_NAME;
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK,
+                          emcute_con(&_gw_ep, true, NULL, NULL, 0, 0));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_reg(&_topic));
+}
+
+static void tear_down(void)
+{
+    msg_t msg;
+
+    emcute_discon();
+    while (msg_try_receive(&msg) > 0) {}
+}
+
+static void test_emcute_pub_async__window(void)
+{
+    pub_t pubs[EMCUTE_PUB_WINDOW];
+
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        _publish(i);
+    }
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OVERFLOW,
+                          emcute_pub_async(&_topic, _data, sizeof(_data),
+                                           EMCUTE_QOS_1, _pub_cb, NULL));
+    /* QoS 0 messages do not take a place in the window */
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK,
+                          emcute_pub_async(&_topic, _data, sizeof(_data),
+                                           EMCUTE_QOS_0, _pub_cb, NULL));
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        TEST_ASSERT(_recv_pub(&pubs[i]));
+        TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_1, pubs[i].flags);
+        for (unsigned j = 0; j < i; j++) {
+            TEST_ASSERT(pubs[i].msg_id != pubs[j].msg_id);
+        }
+    }
+    pub_t pub;
+    TEST_ASSERT(_recv_pub(&pub));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_0, pub.flags);
+    /* the PUBACKs are matched by message ID, not by order */
+    for (unsigned i = EMCUTE_PUB_WINDOW; i > 0; i--) {
+        _puback(_topic.id, pubs[i - 1].msg_id, MQTTSN_ACCEPTED);
+        TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _wait_done(i - 1));
+        /* a message acknowledged makes room for another one */
+        if (i == EMCUTE_PUB_WINDOW) {
+            _publish(EMCUTE_PUB_WINDOW);
+            TEST_ASSERT(_recv_pub(&pub));
+        }
+    }
+    _puback(_topic.id, pub.msg_id, MQTTSN_ACCEPTED);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _wait_done(EMCUTE_PUB_WINDOW));
+}
+
+static void test_emcute_pub_async__reject(void)
+{
+    pub_t pub;
+
+    _publish(0);
+    TEST_ASSERT(_recv_pub(&pub));
+    _puback(_topic.id, pub.msg_id, MQTTSN_REJ_CONGESTION);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_REJECT, _wait_done(0));
+}
+
+static void test_emcute_pub_async__retransmit(void)
+{
+    pub_t pub, dup;
+
+    _publish(0);
+    TEST_ASSERT(_recv_pub(&pub));
+    TEST_ASSERT(!(pub.flags & EMCUTE_DUP));
+    TEST_ASSERT(_recv_pub(&dup));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_1 | EMCUTE_DUP, dup.flags);
+    TEST_ASSERT_EQUAL_INT(pub.msg_id, dup.msg_id);
+    TEST_ASSERT_EQUAL_INT(RES_NONE, _res[0]);
+    _puback(_topic.id, dup.msg_id, MQTTSN_ACCEPTED);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _wait_done(0));
+}
+
+static void test_emcute_pub_async__timeout(void)
+{
+    pub_t pub;
+
+    _publish(0);
+    for (unsigned i = 0; i <= EMCUTE_N_RETRY; i++) {
+        TEST_ASSERT(_recv_pub(&pub));
+    }
+    TEST_ASSERT_EQUAL_INT(EMCUTE_TIMEOUT, _wait_done(0));
+}
+
+static void test_emcute_pub_async__discon(void)
+{
+    _publish(0);
+    _publish(1);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_discon());
+    TEST_ASSERT_EQUAL_INT(EMCUTE_NOGW, _wait_done(0));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_NOGW, _wait_done(1));
+    /* the window is empty in the next connection */
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK,
+                          emcute_con(&_gw_ep, true, NULL, NULL, 0, 0));
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        _publish(i);
+    }
+}
+
+static void test_emcute_pub_async__con_failed(void)
+{
+    emcute_discon();
+    _gw_reject_con = true;
+    _gw_pub_on_con = true;
+    TEST_ASSERT_EQUAL_INT(EMCUTE_REJECT,
+                          emcute_con(&_gw_ep, true, NULL, NULL, 0, 0));
+    /* the callback connected again from within emcute_con() */
+    TEST_ASSERT_EQUAL_INT(EMCUTE_NOGW, _res[ARG_RECONNECT]);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _recon_res);
+    /* still connected, so connecting again is refused */
+    TEST_ASSERT_EQUAL_INT(EMCUTE_NOGW,
+                          emcute_con(&_gw_ep, true, NULL, NULL, 0, 0));
+}
+
+static void test_emcute_pub_async__topic_cache(void)
+{
+    emcute_topic_t topic = { .name = TOPIC_NAME };
+    uint16_t id = _topic.id;
+    pub_t pub;
+
+    TEST_ASSERT_EQUAL_INT(1, _gw_regs);
+    /* the topic ID is taken from the cache */
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_reg(&topic));
+    TEST_ASSERT_EQUAL_INT(1, _gw_regs);
+    TEST_ASSERT_EQUAL_INT(id, topic.id);
+    /* the gateway forgot about the topic ID, so it is dropped */
+    _publish(0);
+    TEST_ASSERT(_recv_pub(&pub));
+    _puback(id, pub.msg_id, MQTTSN_REJ_INV_TOPIC_ID);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_REJECT, _wait_done(0));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_reg(&topic));
+    TEST_ASSERT_EQUAL_INT(2, _gw_regs);
+    TEST_ASSERT(topic.id != id);
+    /* topic IDs are only valid within a connection */
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_discon());
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK,
+                          emcute_con(&_gw_ep, true, NULL, NULL, 0, 0));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_reg(&topic));
+    TEST_ASSERT_EQUAL_INT(3, _gw_regs);
+}
+
+static Test *tests_emcute_pub_async(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_emcute_pub_async__window),
+        new_TestFixture(test_emcute_pub_async__reject),
+        new_TestFixture(test_emcute_pub_async__retransmit),
+        new_TestFixture(test_emcute_pub_async__timeout),
+        new_TestFixture(test_emcute_pub_async__discon),
+        new_TestFixture(test_emcute_pub_async__con_failed),
+        new_TestFixture(test_emcute_pub_async__topic_cache),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    _main_pid = thread_getpid();
+    ipv6_addr_set_loopback((ipv6_addr_t *)&_gw_ep.addr.ipv6);
+    if (sock_udp_create(&_gw_sock, &_gw_ep, NULL, 0) < 0) {
+        puts("error creating gateway socket");
+        return 1;
+    }
+    thread_create(_gw_stack, sizeof(_gw_stack), THREAD_PRIORITY_MAIN - 2, 0,
+                  _gw_thread, NULL, "gateway");
+    thread_create(_emcute_stack, sizeof(_emcute_stack),
+                  THREAD_PRIORITY_MAIN - 1, 0, _emcute_thread, NULL, "emcute");
+
+    TESTS_START();
+    TESTS_RUN(tests_emcute_pub_async());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,489 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the hash tables gcoap looks up its request and observe
+ *              memos with
+ *
+ * The peers of gcoap are sockets of this application on the loopback
+ * address. Tokens, ports and resources are picked so their entries share a
+ * hash chain.
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "kernel_defines.h"
+#include "msg.h"
+#include "net/gcoap.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#if CONFIG_GCOAP_TOKENLEN != 2
+#error "tokens of this test are 16 bit wide"
+#endif
+
+#define MAIN_QUEUE_SIZE     (8)
+#define RESP_TIMEOUT        (100U * US_PER_MS)
+#define PEER_PORT           (20000U)
+/* FNV-1a parameters, must be the same as in gcoap */
+#define HASH_INIT           (2166136261U)
+#define HASH_PRIME          (16777619U)
+
+/* request to a peer */
+typedef struct {
+    uint16_t token;
+    uint16_t id;
+} req_t;
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+static uint8_t _buf[CONFIG_GCOAP_PDU_BUF_SIZE];
+static sock_udp_ep_t _gcoap_ep = {
+    .family = AF_INET6,
+    .netif = SOCK_ADDR_ANY_NETIF,
+    .port = CONFIG_GCOAP_PORT,
+};
+/* sockets of the peers and their endpoints as gcoap sees them; the
+ * endpoints of peers 0 and 1 share a chain in all tables hashed by endpoint */
+static sock_udp_t _peers[3];
+static sock_udp_ep_t _peer_eps[ARRAY_SIZE(_peers)];
+static unsigned _ctx[CONFIG_GCOAP_REQ_WAITING_MAX + 2];
+static uint16_t _next_token;
+
+static ssize_t _handler(coap_pkt_t *pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    return gcoap_response(pdu, buf, len, COAP_CODE_CONTENT);
+}
+
+/* gcoap keeps at most one observer per resource, so there are more resources
+ * than observe memos */
+static const coap_resource_t _resources[] = {
+    { "/r0", COAP_GET, _handler, NULL },
+    { "/r1", COAP_GET, _handler, NULL },
+    { "/r2", COAP_GET, _handler, NULL },
+    { "/r3", COAP_GET, _handler, NULL },
+    { "/r4", COAP_GET, _handler, NULL },
+    { "/r5", COAP_GET, _handler, NULL },
+    { "/r6", COAP_GET, _handler, NULL },
+    { "/r7", COAP_GET, _handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    &_resources[0],
+    ARRAY_SIZE(_resources),
+    NULL,
+    NULL
+};
+
+static uint32_t _hash(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *bytes = data;
+
+    while (len--) {
+        hash ^= *bytes++;
+        hash *= HASH_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t _hash_ep(const sock_udp_ep_t *ep)
+{
+    return _hash(_hash(HASH_INIT, &ep->port, sizeof(ep->port)), &ep->addr,
+                 sizeof(ep->addr));
+}
+
+/* picks a new token whose request to remote shares the chain with bucket */
+static uint16_t _token_for_bucket(const sock_udp_ep_t *remote, unsigned bucket)
+{
+    uint16_t token;
+
+    do {
+        token = _next_token++;
+    } while ((_hash(_hash_ep(remote), &token, sizeof(token)) %
+              CONFIG_GCOAP_REQ_WAITING_MAX) != bucket);
+    return token;
+}
+
+static void _resp_handler(const gcoap_request_memo_t *memo, coap_pkt_t *pdu,
+                          const sock_udp_ep_t *remote)
+{
+    msg_t msg;
+
+    (void)pdu;
+    (void)remote;
+    /* timeouts of requests are no responses */
+    if (memo->state == GCOAP_MEMO_RESP) {
+        msg.content.ptr = memo->context;
+        msg_send(&msg, _main_pid);
+    }
+}
+
+/* returns the context of the request gcoap got a response for, or NULL */
+static void *_recv_resp(void)
+{
+    msg_t msg;
+
+    if (xtimer_msg_receive_timeout(&msg, RESP_TIMEOUT) < 0) {
+        return NULL;
+    }
+    return msg.content.ptr;
+}
+
+static size_t _send_req(const sock_udp_ep_t *remote, unsigned type,
+                        uint16_t token, void *ctx, req_t *req)
+{
+    coap_pkt_t pdu;
+    ssize_t len;
+
+    gcoap_req_init(&pdu, _buf, sizeof(_buf), COAP_METHOD_GET, "/test");
+    coap_hdr_set_type(pdu.hdr, type);
+    memcpy(pdu.token, &token, sizeof(token));
+    len = coap_opt_finish(&pdu, COAP_OPT_FINISH_NONE);
+    req->token = token;
+    req->id = coap_get_id(&pdu);
+    return gcoap_req_send(_buf, len, remote, _resp_handler, ctx);
+}
+
+/* answers a request to peer */
+static void _respond(sock_udp_t *peer, const req_t *req, unsigned type)
+{
+    ssize_t len = coap_build_hdr((coap_hdr_t *)_buf, type,
+                                 (uint8_t *)&req->token, sizeof(req->token),
+                                 COAP_CODE_CONTENT, req->id);
+
+    TEST_ASSERT(sock_udp_send(peer, _buf, len, &_gcoap_ep) > 0);
+}
+
+/* drops the requests gcoap sent to peer */
+static void _drain(sock_udp_t *peer)
+{
+    while (sock_udp_recv(peer, _buf, sizeof(_buf), 0, NULL) > 0) {}
+}
+
+/*
+ * Sends a GET with an Observe option for resource from peer.
+ *
+ * return 1 if the response confirms the registration, 0 if it does not,
+ *        -1 without response
+ */
+static int _observe(sock_udp_t *peer, const coap_resource_t *resource,
+                    uint32_t observe, uint16_t token)
+{
+    coap_pkt_t pdu;
+    ssize_t len;
+
+    _drain(peer);
+    gcoap_req_init(&pdu, _buf, sizeof(_buf), COAP_METHOD_GET, NULL);
+    memcpy(pdu.token, &token, sizeof(token));
+    coap_opt_add_uint(&pdu, COAP_OPT_OBSERVE, observe);
+    coap_opt_add_string(&pdu, COAP_OPT_URI_PATH, resource->path, '/');
+    len = coap_opt_finish(&pdu, COAP_OPT_FINISH_NONE);
+    if (sock_udp_send(peer, _buf, len, &_gcoap_ep) <= 0) {
+        return -1;
+    }
+    while ((len = sock_udp_recv(peer, _buf, sizeof(_buf), RESP_TIMEOUT,
+                                NULL)) > 0) {
+        if ((coap_parse(&pdu, _buf, len) == 0) &&
+            (coap_get_code_class(&pdu) == COAP_CLASS_SUCCESS) &&
+            (coap_get_token_len(&pdu) == sizeof(token)) &&
+            (memcmp(pdu.token, &token, sizeof(token)) == 0)) {
+            return coap_has_observe(&pdu);
+        }
+    }
+    return -1;
+}
+
+/* checks if resource is observed with token */
+static bool _observed_with(const coap_resource_t *resource, uint16_t token)
+{
+    coap_pkt_t pdu;
+
+    if (gcoap_obs_init(&pdu, _buf, sizeof(_buf),
+                       resource) != GCOAP_OBS_INIT_OK) {
+        return false;
+    }
+    return (coap_get_token_len(&pdu) == sizeof(token)) &&
+           (memcmp(pdu.token, &token, sizeof(token)) == 0);
+}
+
+static bool _observed(const coap_resource_t *resource)
+{
+    coap_pkt_t pdu;
+
+    return gcoap_obs_init(&pdu, _buf, sizeof(_buf),
+                          resource) != GCOAP_OBS_INIT_UNUSED;
+}
+
+/* picks count resources that share a chain of the observe memos by
+ * resource */
+static void _colliding_resources(const coap_resource_t **res, unsigned count)
+{
+    unsigned bucket;
+
+    for (bucket = 0; bucket < CONFIG_GCOAP_OBS_REGISTRATIONS_MAX; bucket++) {
+        unsigned found = 0;
+
+        for (unsigned i = 0; (i < ARRAY_SIZE(_resources)) && (found < count);
+             i++) {
+            const coap_resource_t *resource = &_resources[i];
+
+            if ((_hash(HASH_INIT, &resource, sizeof(resource)) %
+                 CONFIG_GCOAP_OBS_REGISTRATIONS_MAX) == bucket) {
+                res[found++] = resource;
+            }
+        }
+        if (found == count) {
+            return;
+        }
+    }
+    /* there are more resources than buckets times count */
+    assert(false);
+}
+
+static void set_up(void)
+{
+    msg_t msg;
+
+    for (unsigned i = 0; i < ARRAY_SIZE(_ctx); i++) {
+        _ctx[i] = i;
+    }
+    while (msg_try_receive(&msg) > 0) {}
+}
+
+static void tear_down(void)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(_peers); i++) {
+        _drain(&_peers[i]);
+    }
+}
+
+static void test_gcoap_hash__req_chain(void)
+{
+    const sock_udp_ep_t *remote = &_peer_eps[0];
+    unsigned bucket = _hash_ep(remote) % CONFIG_GCOAP_REQ_WAITING_MAX;
+    req_t reqs[CONFIG_GCOAP_REQ_WAITING_MAX];
+    req_t extra;
+
+    /* all open requests share one chain; the last one sent is its head */
+    for (unsigned i = 0; i < ARRAY_SIZE(reqs); i++) {
+        TEST_ASSERT(_send_req(remote, COAP_TYPE_NON,
+                              _token_for_bucket(remote, bucket), &_ctx[i],
+                              &reqs[i]) > 0);
+    }
+    TEST_ASSERT_EQUAL_INT(CONFIG_GCOAP_REQ_WAITING_MAX, gcoap_op_state());
+    TEST_ASSERT_EQUAL_INT(0, _send_req(remote, COAP_TYPE_NON,
+                                       _next_token++, &_ctx[0], &extra));
+
+    /* unknown token, and right token from the wrong remote */
+    extra.token = _token_for_bucket(remote, bucket);
+    _respond(&_peers[0], &extra, COAP_TYPE_NON);
+    _respond(&_peers[1], &reqs[0], COAP_TYPE_NON);
+    TEST_ASSERT_NULL(_recv_resp());
+
+    /* in the middle of the chain */
+    _respond(&_peers[0], &reqs[1], COAP_TYPE_NON);
+    TEST_ASSERT(_recv_resp() == &_ctx[1]);
+    _respond(&_peers[0], &reqs[1], COAP_TYPE_NON);
+    TEST_ASSERT_NULL(_recv_resp());
+    /* at the head of the chain */
+    _respond(&_peers[0], &reqs[ARRAY_SIZE(reqs) - 1], COAP_TYPE_NON);
+    TEST_ASSERT(_recv_resp() == &_ctx[ARRAY_SIZE(reqs) - 1]);
+    TEST_ASSERT_EQUAL_INT(CONFIG_GCOAP_REQ_WAITING_MAX - 2, gcoap_op_state());
+
+    /* the memos are available again and join the chain at its head */
+    TEST_ASSERT(_send_req(remote, COAP_TYPE_NON,
+                          _token_for_bucket(remote, bucket),
+                          &_ctx[ARRAY_SIZE(reqs)], &extra) > 0);
+    _respond(&_peers[0], &reqs[0], COAP_TYPE_NON);
+    TEST_ASSERT(_recv_resp() == &_ctx[0]);
+    _respond(&_peers[0], &extra, COAP_TYPE_NON);
+    TEST_ASSERT(_recv_resp() == &_ctx[ARRAY_SIZE(reqs)]);
+    for (unsigned i = 2; i < (ARRAY_SIZE(reqs) - 1); i++) {
+        _respond(&_peers[0], &reqs[i], COAP_TYPE_NON);
+        TEST_ASSERT(_recv_resp() == &_ctx[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(0, gcoap_op_state());
+}
+
+static void test_gcoap_hash__con_chain(void)
+{
+    req_t reqs[CONFIG_GCOAP_NSTART];
+    req_t other, extra;
+
+    /* confirmable requests are chained by remote */
+    for (unsigned i = 0; i < ARRAY_SIZE(reqs); i++) {
+        TEST_ASSERT(_send_req(&_peer_eps[0], COAP_TYPE_CON, _next_token++,
+                              &_ctx[i], &reqs[i]) > 0);
+    }
+    TEST_ASSERT_EQUAL_INT(0, _send_req(&_peer_eps[0], COAP_TYPE_CON,
+                                       _next_token++, &_ctx[0], &extra));
+    /* a remote in the same chain is not limited */
+    TEST_ASSERT(_send_req(&_peer_eps[1], COAP_TYPE_CON, _next_token++,
+                          &_ctx[ARRAY_SIZE(reqs)], &other) > 0);
+
+    /* in the middle of the chain */
+    _respond(&_peers[0], &reqs[1], COAP_TYPE_ACK);
+    TEST_ASSERT(_recv_resp() == &_ctx[1]);
+    TEST_ASSERT(_send_req(&_peer_eps[0], COAP_TYPE_CON, _next_token++,
+                          &_ctx[ARRAY_SIZE(reqs) + 1], &extra) > 0);
+    /* at the head of the chain */
+    _respond(&_peers[0], &extra, COAP_TYPE_ACK);
+    TEST_ASSERT(_recv_resp() == &_ctx[ARRAY_SIZE(reqs) + 1]);
+
+    _respond(&_peers[1], &other, COAP_TYPE_ACK);
+    TEST_ASSERT(_recv_resp() == &_ctx[ARRAY_SIZE(reqs)]);
+    _respond(&_peers[0], &reqs[0], COAP_TYPE_ACK);
+    TEST_ASSERT(_recv_resp() == &_ctx[0]);
+    for (unsigned i = 2; i < ARRAY_SIZE(reqs); i++) {
+        _respond(&_peers[0], &reqs[i], COAP_TYPE_ACK);
+        TEST_ASSERT(_recv_resp() == &_ctx[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(0, gcoap_op_state());
+}
+
+static void test_gcoap_hash__obs_resource_chain(void)
+{
+    const coap_resource_t *res[CONFIG_GCOAP_OBS_REGISTRATIONS_MAX];
+
+    _colliding_resources(res, ARRAY_SIZE(res));
+    for (unsigned i = 0; i < ARRAY_SIZE(res); i++) {
+        TEST_ASSERT_EQUAL_INT(1, _observe(&_peers[0], res[i],
+                                          COAP_OBS_REGISTER, 0x100 + i));
+    }
+    for (unsigned i = 0; i < ARRAY_SIZE(res); i++) {
+        TEST_ASSERT(_observed_with(res[i], 0x100 + i));
+    }
+    /* a token can not move to another resource */
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[0], res[0], COAP_OBS_REGISTER,
+                                      0x101));
+    TEST_ASSERT(_observed_with(res[0], 0x100));
+
+    /* in the middle of the chain */
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[0], res[1],
+                                      COAP_OBS_DEREGISTER, 0x101));
+    TEST_ASSERT(!_observed(res[1]));
+    TEST_ASSERT(_observed_with(res[0], 0x100));
+    TEST_ASSERT(_observed_with(res[2], 0x102));
+    /* at the head of the chain */
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[0], res[2],
+                                      COAP_OBS_DEREGISTER, 0x102));
+    TEST_ASSERT(!_observed(res[2]));
+    TEST_ASSERT(_observed_with(res[0], 0x100));
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[0], res[0],
+                                      COAP_OBS_DEREGISTER, 0x100));
+    TEST_ASSERT(!_observed(res[0]));
+}
+
+static void test_gcoap_hash__obs_observer_chain(void)
+{
+    const coap_resource_t *res_a = &_resources[0];
+    const coap_resource_t *res_b = &_resources[1];
+
+    TEST_ASSERT_EQUAL_INT(1, _observe(&_peers[0], res_a, COAP_OBS_REGISTER,
+                                      0x200));
+    TEST_ASSERT_EQUAL_INT(1, _observe(&_peers[1], res_b, COAP_OBS_REGISTER,
+                                      0x201));
+    /* the observer of a resource may change its token, others may not take
+     * the resource over */
+    TEST_ASSERT_EQUAL_INT(1, _observe(&_peers[0], res_a, COAP_OBS_REGISTER,
+                                      0x202));
+    TEST_ASSERT(_observed_with(res_a, 0x202));
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[1], res_a, COAP_OBS_REGISTER,
+                                      0x203));
+    TEST_ASSERT(_observed_with(res_a, 0x202));
+    /* all observers are taken */
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[2], &_resources[2],
+                                      COAP_OBS_REGISTER, 0x204));
+
+    /* the observer of peer 0 is removed with its last registration, the one
+     * of peer 1 is still found in the same chain */
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[0], res_a, COAP_OBS_DEREGISTER,
+                                      0x202));
+    TEST_ASSERT(!_observed(res_a));
+    TEST_ASSERT_EQUAL_INT(1, _observe(&_peers[1], res_b, COAP_OBS_REGISTER,
+                                      0x201));
+    TEST_ASSERT(_observed_with(res_b, 0x201));
+    TEST_ASSERT_EQUAL_INT(1, _observe(&_peers[2], &_resources[2],
+                                      COAP_OBS_REGISTER, 0x204));
+
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[1], res_b, COAP_OBS_DEREGISTER,
+                                      0x201));
+    TEST_ASSERT_EQUAL_INT(0, _observe(&_peers[2], &_resources[2],
+                                      COAP_OBS_DEREGISTER, 0x204));
+    TEST_ASSERT(!_observed(res_b));
+    TEST_ASSERT(!_observed(&_resources[2]));
+}
+
+static Test *tests_gcoap_hash(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gcoap_hash__req_chain),
+        new_TestFixture(test_gcoap_hash__con_chain),
+        new_TestFixture(test_gcoap_hash__obs_resource_chain),
+        new_TestFixture(test_gcoap_hash__obs_observer_chain),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    sock_udp_ep_t local = {
+        .family = AF_INET6,
+        .netif = SOCK_ADDR_ANY_NETIF,
+        .port = PEER_PORT,
+    };
+    /* modulus of which both table sizes are divisors */
+    const unsigned mod = CONFIG_GCOAP_REQ_WAITING_MAX *
+                         CONFIG_GCOAP_OBS_CLIENTS_MAX;
+    unsigned bucket = 0;
+
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    ipv6_addr_set_loopback((ipv6_addr_t *)&_gcoap_ep.addr.ipv6);
+    _main_pid = thread_getpid();
+    gcoap_register_listener(&_listener);
+
+    for (unsigned i = 0; i < ARRAY_SIZE(_peers); i++) {
+        _peer_eps[i] = _gcoap_ep;
+        _peer_eps[i].port = local.port;
+        if (i == 0) {
+            bucket = _hash_ep(&_peer_eps[i]) % mod;
+        }
+        else if (i == 1) {
+            /* find a port whose endpoint shares the chain of peer 0 */
+            while ((_hash_ep(&_peer_eps[i]) % mod) != bucket) {
+                _peer_eps[i].port = ++local.port;
+            }
+        }
+        if (sock_udp_create(&_peers[i], &local, NULL, 0) < 0) {
+            puts("error creating peer sockets");
+            return 1;
+        }
+        local.port++;
+    }
+
+    TESTS_START();
+    TESTS_RUN(tests_gcoap_hash());
+    TESTS_END();
+
+    return 0;
+}
@@ -22,8 +22,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "bitfield.h"
 #include "byteorder.h"
-#include "clist.h"
 #include "embUnit.h"
 #include "net/ipv6/addr.h"
 #include "net/ipv6/ext/frag.h"
@@ -65,6 +65,8 @@
                               0x48, 0x96, 0x34, 0x46, 0xf9, 0xec, 0xbc }
 #define TEST_SRC            { 0x20, 0x01, 0xdb, 0x82, 0xb5, 0xf9, 0xbe, 0x78, \
                               0xb1, 0x4d, 0xcd, 0xe8, 0xa9, 0x53, 0x54, 0xb1 }
+#define TEST_SRC2           { 0x20, 0x01, 0xdb, 0x82, 0xb5, 0xf9, 0xbe, 0x78, \
+                              0x74, 0x5b, 0x01, 0x3c, 0x9d, 0x20, 0xe6, 0x0f }
 #define TEST_DST            { 0x20, 0x01, 0xdb, 0x89, 0xa3, 0x24, 0xfd, 0xab, \
                               0x29, 0x73, 0xde, 0xa4, 0xe4, 0xb1, 0xdb, 0xde }
 #define TEST_ID             (0x52dacb1)
@@ -86,6 +88,7 @@ static char mock_netif_stack[THREAD_STACKSIZE_DEFAULT];
 static char line_buf[SHELL_DEFAULT_BUFSIZE];
 
 static const ipv6_addr_t _src = { .u8 = TEST_SRC };
+static const ipv6_addr_t _src2 = { .u8 = TEST_SRC2 };
 static const ipv6_addr_t _dst = { .u8 = TEST_DST };
 static const uint8_t _exp_payload[] = TEST_PAYLOAD;
 static const uint8_t _test_frag1[] = TEST_FRAG1;
@@ -98,6 +101,62 @@ static void tear_down_tests(void)
     gnrc_pktbuf_init();
 }
 
+/* builds a fragment of len bytes of data (zeroes if NULL) from src to _dst */
+static gnrc_pktsnip_t *_build_frag(const ipv6_addr_t *src, uint32_t id,
+                                   unsigned offset, const void *data,
+                                   size_t len, bool more)
+{
+    gnrc_pktsnip_t *ipv6_snip = gnrc_ipv6_hdr_build(NULL, src, &_dst);
+    gnrc_pktsnip_t *pkt;
+    ipv6_hdr_t *ipv6;
+    ipv6_ext_frag_t *frag;
+
+    if (ipv6_snip == NULL) {
+        return NULL;
+    }
+    pkt = gnrc_pktbuf_add(ipv6_snip, NULL, sizeof(ipv6_ext_frag_t) + len,
+                          GNRC_NETTYPE_UNDEF);
+    if (pkt == NULL) {
+        gnrc_pktbuf_release(ipv6_snip);
+        return NULL;
+    }
+    ipv6 = ipv6_snip->data;
+    frag = pkt->data;
+    ipv6->nh = PROTNUM_IPV6_EXT_FRAG;
+    ipv6->hl = TEST_HL;
+    ipv6->len = byteorder_htons(pkt->size);
+    frag->nh = PROTNUM_UDP;
+    frag->resv = 0U;
+    ipv6_ext_frag_set_offset(frag, offset);
+    if (more) {
+        ipv6_ext_frag_set_more(frag);
+    }
+    frag->id = byteorder_htonl(id);
+    if (data != NULL) {
+        memcpy(frag + 1, data, len);
+    }
+    else {
+        memset(frag + 1, 0, len);
+    }
+    return pkt;
+}
+
+/* checks if the reassembly buffer has an entry for datagram id from src to
+ * _dst. Evicts an entry if the reassembly buffer is full and there is
+ * none, so only check for absent entries with a free entry left. */
+static bool _has_rbuf(const ipv6_addr_t *src, uint32_t id)
+{
+    ipv6_hdr_t ipv6 = { .src = *src, .dst = _dst };
+    gnrc_ipv6_ext_frag_rbuf_t *rbuf = gnrc_ipv6_ext_frag_rbuf_get(&ipv6, id);
+
+    if ((rbuf != NULL) && (rbuf->ipv6 == &ipv6)) {
+        /* entry was only created by the lookup */
+        gnrc_ipv6_ext_frag_rbuf_free(rbuf);
+        return false;
+    }
+    return (rbuf != NULL);
+}
+
 static void test_ipv6_ext_frag_rbuf_get(void)
 {
     static ipv6_hdr_t ipv6 = { .src = { .u8 = TEST_SRC },
@@ -132,7 +191,7 @@ static void test_ipv6_ext_frag_rbuf_free(void)
     rbuf->pkt = pkt;
     gnrc_ipv6_ext_frag_rbuf_free(rbuf);
     TEST_ASSERT_NULL(rbuf->ipv6);
-    TEST_ASSERT_NULL(rbuf->limits.next);
+    TEST_ASSERT_EQUAL_INT(0, rbuf->received_units);
     TEST_ASSERT_EQUAL_INT(1, pkt->users);
     gnrc_pktbuf_release(pkt);
     TEST_ASSERT(gnrc_pktbuf_is_sane());
@@ -152,7 +211,7 @@ static void test_ipv6_ext_frag_rbuf_del(void)
     gnrc_ipv6_ext_frag_rbuf_del(rbuf);
     TEST_ASSERT_NULL(rbuf->pkt);
     TEST_ASSERT_NULL(rbuf->ipv6);
-    TEST_ASSERT_NULL(rbuf->limits.next);
+    TEST_ASSERT_EQUAL_INT(0, rbuf->received_units);
     TEST_ASSERT(gnrc_pktbuf_is_sane());
     TEST_ASSERT(gnrc_pktbuf_is_empty());
 }
@@ -175,7 +234,7 @@ static void test_ipv6_ext_frag_rbuf_gc(void)
     gnrc_ipv6_ext_frag_rbuf_gc();
     TEST_ASSERT_NULL(rbuf->pkt);
     TEST_ASSERT_NULL(rbuf->ipv6);
-    TEST_ASSERT_NULL(rbuf->limits.next);
+    TEST_ASSERT_EQUAL_INT(0, rbuf->received_units);
 }
 
 static void test_ipv6_ext_frag_reass_in_order(void)
@@ -187,7 +246,6 @@ static void test_ipv6_ext_frag_reass_in_order(void)
     ipv6_hdr_t *ipv6 = ipv6_snip->data;
     ipv6_ext_frag_t *frag = pkt->data;
     gnrc_ipv6_ext_frag_rbuf_t *rbuf;
-    gnrc_ipv6_ext_frag_limits_t *ptr;
 
     ipv6->nh = PROTNUM_IPV6_EXT_FRAG;
     ipv6->hl = TEST_HL;
@@ -207,13 +265,10 @@ static void test_ipv6_ext_frag_reass_in_order(void)
     TEST_ASSERT_MESSAGE(ipv6 == rbuf->ipv6, "IPv6 header is not the same");
     TEST_ASSERT_EQUAL_INT(TEST_ID, rbuf->id);
     TEST_ASSERT(!rbuf->last);
-    ptr = (gnrc_ipv6_ext_frag_limits_t *)rbuf->limits.next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    ptr = ptr->next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    TEST_ASSERT_EQUAL_INT(0, ptr->start);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG2_OFFSET / 8, ptr->end);
-    TEST_ASSERT(((clist_node_t *)ptr) == rbuf->limits.next);
+    TEST_ASSERT_EQUAL_INT(TEST_FRAG2_OFFSET / 8, rbuf->received_units);
+    for (unsigned i = 0; i < (TEST_FRAG2_OFFSET / 8); i++) {
+        TEST_ASSERT(bf_isset(rbuf->received, i));
+    }
     TEST_ASSERT(memcmp(_exp_payload, rbuf->pkt->data, rbuf->pkt->size) == 0);
 
     /* prepare 2nd fragment */
@@ -241,18 +296,10 @@ static void test_ipv6_ext_frag_reass_in_order(void)
                           rbuf->pkt->size);
     TEST_ASSERT_EQUAL_INT(TEST_ID, rbuf->id);
     TEST_ASSERT(!rbuf->last);
-    ptr = (gnrc_ipv6_ext_frag_limits_t *)rbuf->limits.next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    ptr = ptr->next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    TEST_ASSERT_EQUAL_INT(0, ptr->start);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG2_OFFSET / 8, ptr->end);
-    TEST_ASSERT_NOT_NULL(ptr->next);
-    ptr = ptr->next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG2_OFFSET / 8, ptr->start);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG3_OFFSET / 8, ptr->end);
-    TEST_ASSERT(((clist_node_t *)ptr) == rbuf->limits.next);
+    TEST_ASSERT_EQUAL_INT(TEST_FRAG3_OFFSET / 8, rbuf->received_units);
+    for (unsigned i = 0; i < (TEST_FRAG3_OFFSET / 8); i++) {
+        TEST_ASSERT(bf_isset(rbuf->received, i));
+    }
     TEST_ASSERT(memcmp(_exp_payload, rbuf->pkt->data, rbuf->pkt->size) == 0);
 
     /* prepare 3rd fragment */
@@ -297,7 +344,6 @@ static void test_ipv6_ext_frag_reass_out_of_order(void)
     ipv6_hdr_t *ipv6 = ipv6_snip->data;
     ipv6_ext_frag_t *frag = pkt->data;
     gnrc_ipv6_ext_frag_rbuf_t *rbuf;
-    gnrc_ipv6_ext_frag_limits_t *ptr;
 
 
     ipv6->nh = PROTNUM_IPV6_EXT_FRAG;
@@ -315,13 +361,14 @@ static void test_ipv6_ext_frag_reass_out_of_order(void)
     TEST_ASSERT_EQUAL_INT(sizeof(_exp_payload), rbuf->pkt->size);
     TEST_ASSERT_EQUAL_INT(TEST_ID, rbuf->id);
     TEST_ASSERT(rbuf->last);
-    ptr = (gnrc_ipv6_ext_frag_limits_t *)rbuf->limits.next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    ptr = ptr->next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG3_OFFSET / 8, ptr->start);
-    TEST_ASSERT_EQUAL_INT(sizeof(_exp_payload) / 8, ptr->end);
-    TEST_ASSERT(((clist_node_t *)ptr) == rbuf->limits.next);
+    /* last fragment ends within a unit */
+    TEST_ASSERT_EQUAL_INT((sizeof(_exp_payload) + 7) / 8, rbuf->total_units);
+    TEST_ASSERT_EQUAL_INT(rbuf->total_units - (TEST_FRAG3_OFFSET / 8),
+                          rbuf->received_units);
+    for (unsigned i = 0; i < rbuf->total_units; i++) {
+        TEST_ASSERT(bf_isset(rbuf->received, i) ==
+                    (i >= (TEST_FRAG3_OFFSET / 8)));
+    }
     TEST_ASSERT(memcmp(&_exp_payload[TEST_FRAG3_OFFSET],
                        (uint8_t *)rbuf->pkt->data + TEST_FRAG3_OFFSET,
                        rbuf->pkt->size - TEST_FRAG3_OFFSET) == 0);
@@ -348,18 +395,12 @@ static void test_ipv6_ext_frag_reass_out_of_order(void)
     TEST_ASSERT_NOT_NULL(rbuf->pkt);
     TEST_ASSERT_EQUAL_INT(sizeof(_exp_payload), rbuf->pkt->size);
     TEST_ASSERT(rbuf->last);
-    ptr = (gnrc_ipv6_ext_frag_limits_t *)rbuf->limits.next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    ptr = ptr->next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG2_OFFSET / 8, ptr->start);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG3_OFFSET / 8, ptr->end);
-    ptr = ptr->next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG3_OFFSET / 8, ptr->start);
-    TEST_ASSERT_EQUAL_INT(sizeof(_exp_payload) / 8, ptr->end);
-    TEST_ASSERT_NOT_NULL(ptr->next);
-    TEST_ASSERT(((clist_node_t *)ptr) == rbuf->limits.next);
+    TEST_ASSERT_EQUAL_INT(rbuf->total_units - (TEST_FRAG2_OFFSET / 8),
+                          rbuf->received_units);
+    for (unsigned i = 0; i < rbuf->total_units; i++) {
+        TEST_ASSERT(bf_isset(rbuf->received, i) ==
+                    (i >= (TEST_FRAG2_OFFSET / 8)));
+    }
     TEST_ASSERT(memcmp(&_exp_payload[TEST_FRAG2_OFFSET],
                        (uint8_t *)rbuf->pkt->data + TEST_FRAG2_OFFSET,
                        rbuf->pkt->size - TEST_FRAG2_OFFSET) == 0);
@@ -406,11 +447,20 @@ static void test_ipv6_ext_frag_reass_out_of_order_rbuf_full(void)
     ipv6_hdr_t *ipv6 = ipv6_snip->data;
     ipv6_ext_frag_t *frag = pkt->data;
     gnrc_ipv6_ext_frag_rbuf_t *rbuf;
-    gnrc_ipv6_ext_frag_limits_t *ptr;
     static const uint32_t foreign_id = TEST_ID + 44U;
 
-
-    TEST_ASSERT_EQUAL_INT(1, CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE);
+    TEST_ASSERT_EQUAL_INT(2, CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE);
+    /* fill all but one entry with other foreign datagrams */
+    for (unsigned i = 1; i < CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE; i++) {
+        gnrc_pktsnip_t *tmp = _build_frag(&_src, foreign_id + i,
+                                          TEST_FRAG3_OFFSET,
+                                          &_test_frag3[sizeof(ipv6_ext_frag_t)],
+                                          sizeof(_test_frag3) -
+                                          sizeof(ipv6_ext_frag_t), false);
+
+        TEST_ASSERT_NOT_NULL(tmp);
+        TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(tmp));
+    }
     /* prepare fragment from a from a foreign datagram */
     ipv6->nh = PROTNUM_IPV6_EXT_FRAG;
     ipv6->hl = TEST_HL;
@@ -428,13 +478,14 @@ static void test_ipv6_ext_frag_reass_out_of_order_rbuf_full(void)
     TEST_ASSERT_EQUAL_INT(sizeof(_exp_payload), rbuf->pkt->size);
     TEST_ASSERT_EQUAL_INT(foreign_id, rbuf->id);
     TEST_ASSERT(rbuf->last);
-    ptr = (gnrc_ipv6_ext_frag_limits_t *)rbuf->limits.next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    ptr = ptr->next;
-    TEST_ASSERT_NOT_NULL(ptr);
-    TEST_ASSERT_EQUAL_INT(TEST_FRAG3_OFFSET / 8, ptr->start);
-    TEST_ASSERT_EQUAL_INT(sizeof(_exp_payload) / 8, ptr->end);
-    TEST_ASSERT(((clist_node_t *)ptr) == rbuf->limits.next);
+    /* last fragment ends within a unit */
+    TEST_ASSERT_EQUAL_INT((sizeof(_exp_payload) + 7) / 8, rbuf->total_units);
+    TEST_ASSERT_EQUAL_INT(rbuf->total_units - (TEST_FRAG3_OFFSET / 8),
+                          rbuf->received_units);
+    for (unsigned i = 0; i < rbuf->total_units; i++) {
+        TEST_ASSERT(bf_isset(rbuf->received, i) ==
+                    (i >= (TEST_FRAG3_OFFSET / 8)));
+    }
     TEST_ASSERT(memcmp(&_exp_payload[TEST_FRAG3_OFFSET],
                        (uint8_t *)rbuf->pkt->data + TEST_FRAG3_OFFSET,
                        rbuf->pkt->size - TEST_FRAG3_OFFSET) == 0);
@@ -478,6 +529,138 @@ static void test_ipv6_ext_frag_reass_one_frag(void)
     gnrc_pktbuf_is_empty();
 }
 
+static void test_ipv6_ext_frag_reass_overlap(void)
+{
+    gnrc_pktsnip_t *ipv6_snip = gnrc_ipv6_hdr_build(NULL, &_src, &_dst);
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(ipv6_snip, _test_frag1,
+                                          sizeof(_test_frag1),
+                                          GNRC_NETTYPE_UNDEF);
+    ipv6_hdr_t *ipv6 = ipv6_snip->data;
+    ipv6_ext_frag_t *frag = pkt->data;
+    gnrc_ipv6_ext_frag_rbuf_t *rbuf;
+
+    ipv6->nh = PROTNUM_IPV6_EXT_FRAG;
+    ipv6->hl = TEST_HL;
+    ipv6->len = byteorder_htons(pkt->size);
+    frag->nh = PROTNUM_UDP;
+    frag->resv = 0U;
+    ipv6_ext_frag_set_offset(frag, TEST_FRAG1_OFFSET);
+    ipv6_ext_frag_set_more(frag);
+    frag->id = byteorder_htonl(TEST_ID);
+
+    /* receive 1st fragment */
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    TEST_ASSERT_NOT_NULL((rbuf = gnrc_ipv6_ext_frag_rbuf_get(ipv6, TEST_ID)));
+    TEST_ASSERT_NOT_NULL(rbuf->pkt);
+    TEST_ASSERT_EQUAL_INT(TEST_FRAG2_OFFSET / 8, rbuf->received_units);
+
+    /* prepare fragment that partly overlaps with 1st fragment */
+    ipv6_snip = gnrc_ipv6_hdr_build(NULL, &_src, &_dst);
+    pkt = gnrc_pktbuf_add(ipv6_snip, _test_frag2,
+                          sizeof(_test_frag2),
+                          GNRC_NETTYPE_UNDEF);
+    ipv6 = ipv6_snip->data;
+    frag = pkt->data;
+
+    ipv6->nh = PROTNUM_IPV6_EXT_FRAG;
+    ipv6->hl = TEST_HL;
+    ipv6->len = byteorder_htons(pkt->size);
+    frag->nh = PROTNUM_UDP;
+    frag->resv = 0U;
+    ipv6_ext_frag_set_offset(frag, TEST_FRAG2_OFFSET - 8);
+    ipv6_ext_frag_set_more(frag);
+    frag->id = byteorder_htonl(TEST_ID);
+
+    /* receive overlapping fragment */
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    /* whole datagram was dropped (RFC 5722) */
+    TEST_ASSERT_NULL(rbuf->ipv6);
+    TEST_ASSERT_NULL(rbuf->pkt);
+    TEST_ASSERT_EQUAL_INT(0, rbuf->received_units);
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_ipv6_ext_frag_reass_empty_first(void)
+{
+    gnrc_pktsnip_t *pkt = _build_frag(&_src, TEST_ID, 0U, NULL, 0U, true);
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    /* the entry created for the empty fragment referenced its released
+     * IPv6 header and must be gone */
+    TEST_ASSERT(!_has_rbuf(&_src, TEST_ID));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_ipv6_ext_frag_reass_empty_subsequent(void)
+{
+    gnrc_pktsnip_t *pkt = _build_frag(&_src, TEST_ID, TEST_FRAG2_OFFSET,
+                                      &_test_frag2[sizeof(ipv6_ext_frag_t)],
+                                      sizeof(_test_frag2) -
+                                      sizeof(ipv6_ext_frag_t), true);
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    pkt = _build_frag(&_src, TEST_ID, TEST_FRAG3_OFFSET, NULL, 0U, true);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    /* the datagram is kept */
+    TEST_ASSERT(_has_rbuf(&_src, TEST_ID));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+}
+
+static void test_ipv6_ext_frag_reass_src_quota(void)
+{
+    /* fill the quota of _src with almost a full datagram */
+    const unsigned offset = 1024U;
+    const size_t len = CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SRC_QUOTA - offset - 8U;
+    gnrc_pktsnip_t *pkt;
+
+    TEST_ASSERT(offset + len <= CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_MAX_LEN);
+    pkt = _build_frag(&_src, TEST_ID, offset, NULL, len, true);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    TEST_ASSERT(_has_rbuf(&_src, TEST_ID));
+    /* another datagram of _src exceeds the quota */
+    pkt = _build_frag(&_src, TEST_ID + 1, TEST_FRAG2_OFFSET, NULL, 16U, true);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    TEST_ASSERT(!_has_rbuf(&_src, TEST_ID + 1));
+    /* the same datagram of another source does not */
+    pkt = _build_frag(&_src2, TEST_ID + 1, TEST_FRAG2_OFFSET, NULL, 16U, true);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    TEST_ASSERT(_has_rbuf(&_src2, TEST_ID + 1));
+    TEST_ASSERT(_has_rbuf(&_src, TEST_ID));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+}
+
+static void test_ipv6_ext_frag_reass_lru_same_src(void)
+{
+    gnrc_pktsnip_t *pkt;
+
+    TEST_ASSERT_EQUAL_INT(2, CONFIG_GNRC_IPV6_EXT_FRAG_RBUF_SIZE);
+    /* oldest entry is from another source */
+    pkt = _build_frag(&_src2, TEST_ID, TEST_FRAG2_OFFSET, NULL, 16U, true);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    xtimer_usleep(1000);
+    pkt = _build_frag(&_src, TEST_ID, TEST_FRAG2_OFFSET, NULL, 16U, true);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    xtimer_usleep(1000);
+    /* reassembly buffer is full: a new datagram of _src replaces the other
+     * datagram of _src, not the older one of _src2 */
+    pkt = _build_frag(&_src, TEST_ID + 1, TEST_FRAG2_OFFSET, NULL, 16U, true);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_frag_reass(pkt));
+    TEST_ASSERT(_has_rbuf(&_src2, TEST_ID));
+    TEST_ASSERT(_has_rbuf(&_src, TEST_ID + 1));
+    TEST_ASSERT(gnrc_pktbuf_is_sane());
+}
+
 static void run_unittests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -489,6 +672,11 @@ static void run_unittests(void)
         new_TestFixture(test_ipv6_ext_frag_reass_out_of_order),
         new_TestFixture(test_ipv6_ext_frag_reass_out_of_order_rbuf_full),
         new_TestFixture(test_ipv6_ext_frag_reass_one_frag),
+        new_TestFixture(test_ipv6_ext_frag_reass_overlap),
+        new_TestFixture(test_ipv6_ext_frag_reass_empty_first),
+        new_TestFixture(test_ipv6_ext_frag_reass_empty_subsequent),
+        new_TestFixture(test_ipv6_ext_frag_reass_src_quota),
+        new_TestFixture(test_ipv6_ext_frag_reass_lru_same_src),
     };
 
     EMB_UNIT_TESTCALLER(ipv6_ext_frag_tests, NULL, tear_down_tests, fixtures);
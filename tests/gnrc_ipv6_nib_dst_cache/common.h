@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    tests_gnrc_ipv6_nib_dst_cache Common header for GNRC's
+ *              destination cache tests
+ * @ingroup     tests
+ * @brief       Common definitions for GNRC's destination cache tests
+ * @{
+ *
+ * @file
+ */
+#ifndef COMMON_H
+#define COMMON_H
+
+#include "net/gnrc.h"
+#include "net/gnrc/netif.h"
+#include "net/netdev_test.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _LL0            (0xce)
+#define _LL1            (0xab)
+#define _LL2            (0xfe)
+#define _LL3            (0xad)
+#define _LL4            (0xf7)
+#define _LL5            (0x26)
+
+extern gnrc_netif_t *_mock_netif;
+
+void _tests_init(netdev_test_send_cb_t send_cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMON_H */
+/** @} */
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the use of the destination cache in GNRC's IPv6 send
+ *              path
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "msg.h"
+#include "net/ethernet/hdr.h"
+#include "net/ethertype.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/ipv6/nib/dst_cache.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netif/internal.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "common.h"
+
+#define MAIN_QUEUE_SIZE     (4)
+#define MSG_TYPE_SENT       (0x3e2c)
+#define SEND_TIMEOUT        (100U * US_PER_MS)
+#define NBR_MAC1            { 0x57, 0x44, 0x33, 0x22, 0x11, 0x00, }
+#define NBR_MAC2            { 0x57, 0x44, 0x33, 0x22, 0x11, 0x01, }
+#define NBR_LINK_LOCAL      { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+                              0x55, 0x44, 0x33, 0xff, 0xfe, 0x22, 0x11, 0x00, }
+#define LOC_LINK_LOCAL      { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+                              _LL0 ^ 0x2, _LL1, _LL2, 0xff, 0xfe, _LL3, _LL4, _LL5 }
+#define LOC_GLOBAL          { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                              _LL0 ^ 0x2, _LL1, _LL2, 0xff, 0xfe, _LL3, _LL4, _LL5 }
+
+static const uint8_t _nbr_mac1[] = NBR_MAC1;
+static const uint8_t _nbr_mac2[] = NBR_MAC2;
+static const ipv6_addr_t _nbr_link_local = { .u8 = NBR_LINK_LOCAL };
+static const ipv6_addr_t _loc_link_local = { .u8 = LOC_LINK_LOCAL };
+static const ipv6_addr_t _loc_global = { .u8 = LOC_GLOBAL };
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+static uint8_t _sent_l2addr[ETHERNET_ADDR_LEN];
+
+static int _send_cb(netdev_t *dev, const iolist_t *iolist)
+{
+    const ethernet_hdr_t *eth = iolist->iol_base;
+    const iolist_t *ipv6 = iolist->iol_next;
+
+    (void)dev;
+    /* only report the packets of the tests, not e.g. router solicitations */
+    if ((byteorder_ntohs(eth->type) == ETHERTYPE_IPV6) && (ipv6 != NULL) &&
+        (ipv6->iol_len >= sizeof(ipv6_hdr_t))) {
+        const ipv6_hdr_t *hdr = ipv6->iol_base;
+
+        if ((hdr->nh == PROTNUM_IPV6_NONXT) &&
+            ipv6_addr_equal(&hdr->dst, &_nbr_link_local)) {
+            msg_t msg = { .type = MSG_TYPE_SENT };
+
+            memcpy(_sent_l2addr, eth->dst, sizeof(_sent_l2addr));
+            msg_try_send(&msg, _main_pid);
+        }
+    }
+    return iolist_size(iolist);
+}
+
+static void _send(const ipv6_addr_t *dst)
+{
+    gnrc_pktsnip_t *pkt, *netif;
+
+    pkt = gnrc_ipv6_hdr_build(NULL, NULL, dst);
+    TEST_ASSERT_NOT_NULL(pkt);
+    netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    TEST_ASSERT_NOT_NULL(netif);
+    gnrc_netif_hdr_set_netif(netif->data, _mock_netif);
+    netif->next = pkt;
+    pkt = netif;
+    TEST_ASSERT(gnrc_netapi_dispatch_send(GNRC_NETTYPE_IPV6,
+                                          GNRC_NETREG_DEMUX_CTX_ALL, pkt) > 0);
+}
+
+/* sends a packet to the neighbor and returns true if it was sent to
+ * link-layer address l2addr */
+static bool _send_to_nbr(const uint8_t *l2addr)
+{
+    msg_t msg;
+
+    memset(_sent_l2addr, 0, sizeof(_sent_l2addr));
+    _send(&_nbr_link_local);
+    if (xtimer_msg_receive_timeout(&msg, SEND_TIMEOUT) < 0) {
+        return false;
+    }
+    return (msg.type == MSG_TYPE_SENT) &&
+           (memcmp(_sent_l2addr, l2addr, sizeof(_sent_l2addr)) == 0);
+}
+
+static bool _get_entry(const ipv6_addr_t *dst,
+                       gnrc_ipv6_nib_dst_cache_t *entry)
+{
+    void *state = NULL;
+
+    while (gnrc_ipv6_nib_dst_cache_iter(&state, entry)) {
+        if (ipv6_addr_equal(&entry->dst, dst)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void set_up(void)
+{
+    gnrc_ipv6_nib_dst_cache_invalidate();
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_nc_set(&_nbr_link_local,
+                                                  _mock_netif->pid,
+                                                  _nbr_mac1,
+                                                  sizeof(_nbr_mac1)));
+}
+
+static void tear_down(void)
+{
+    gnrc_ipv6_nib_nc_del(&_nbr_link_local, _mock_netif->pid);
+}
+
+static void test_dst_cache__miss_then_hit(void)
+{
+    gnrc_ipv6_nib_dst_cache_stats_t before, after;
+    gnrc_ipv6_nib_dst_cache_t entry;
+
+    gnrc_ipv6_nib_dst_cache_get_stats(&before);
+    TEST_ASSERT(_send_to_nbr(_nbr_mac1));
+    gnrc_ipv6_nib_dst_cache_get_stats(&after);
+    TEST_ASSERT_EQUAL_INT(1, after.misses - before.misses);
+    TEST_ASSERT_EQUAL_INT(0, after.hits - before.hits);
+
+    TEST_ASSERT(_get_entry(&_nbr_link_local, &entry));
+    TEST_ASSERT(ipv6_addr_equal(&_loc_link_local, &entry.src));
+    TEST_ASSERT_EQUAL_INT(sizeof(_nbr_mac1), entry.l2addr_len);
+    TEST_ASSERT(memcmp(_nbr_mac1, entry.l2addr, sizeof(_nbr_mac1)) == 0);
+    TEST_ASSERT_EQUAL_INT(_mock_netif->pid, entry.iface);
+
+    TEST_ASSERT(_send_to_nbr(_nbr_mac1));
+    gnrc_ipv6_nib_dst_cache_get_stats(&after);
+    TEST_ASSERT_EQUAL_INT(1, after.misses - before.misses);
+    TEST_ASSERT_EQUAL_INT(1, after.hits - before.hits);
+}
+
+static void test_dst_cache__nc_change(void)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+
+    TEST_ASSERT(_send_to_nbr(_nbr_mac1));
+    TEST_ASSERT(_get_entry(&_nbr_link_local, &entry));
+    /* the neighbor changed its link-layer address */
+    gnrc_ipv6_nib_nc_del(&_nbr_link_local, _mock_netif->pid);
+    TEST_ASSERT(!_get_entry(&_nbr_link_local, &entry));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_nc_set(&_nbr_link_local,
+                                                  _mock_netif->pid,
+                                                  _nbr_mac2,
+                                                  sizeof(_nbr_mac2)));
+    TEST_ASSERT(_send_to_nbr(_nbr_mac2));
+    TEST_ASSERT(_get_entry(&_nbr_link_local, &entry));
+    TEST_ASSERT(memcmp(_nbr_mac2, entry.l2addr, sizeof(_nbr_mac2)) == 0);
+}
+
+static void test_dst_cache__addr_change(void)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+
+    TEST_ASSERT(_send_to_nbr(_nbr_mac1));
+    TEST_ASSERT(_get_entry(&_nbr_link_local, &entry));
+    /* source address selection may choose differently now */
+    TEST_ASSERT(gnrc_netif_ipv6_addr_add_internal(
+            _mock_netif, &_loc_global, 64U,
+            GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID
+        ) >= 0);
+    TEST_ASSERT(!_get_entry(&_nbr_link_local, &entry));
+    TEST_ASSERT(_send_to_nbr(_nbr_mac1));
+    TEST_ASSERT(_get_entry(&_nbr_link_local, &entry));
+    gnrc_netif_ipv6_addr_remove_internal(_mock_netif, &_loc_global);
+    TEST_ASSERT(!_get_entry(&_nbr_link_local, &entry));
+}
+
+static void test_dst_cache__local_dst(void)
+{
+    gnrc_ipv6_nib_dst_cache_stats_t before, after;
+    gnrc_ipv6_nib_dst_cache_t entry;
+
+    gnrc_ipv6_nib_dst_cache_get_stats(&before);
+    _send(&_loc_link_local);
+    /* wait for IPv6 to look the destination up */
+    for (unsigned i = 0; i < 10; i++) {
+        gnrc_ipv6_nib_dst_cache_get_stats(&after);
+        if (after.misses != before.misses) {
+            break;
+        }
+        xtimer_usleep(10U * US_PER_MS);
+    }
+    TEST_ASSERT_EQUAL_INT(1, after.misses - before.misses);
+    TEST_ASSERT(!_get_entry(&_loc_link_local, &entry));
+}
+
+static Test *tests_gnrc_ipv6_nib_dst_cache(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_dst_cache__miss_then_hit),
+        new_TestFixture(test_dst_cache__nc_change),
+        new_TestFixture(test_dst_cache__addr_change),
+        new_TestFixture(test_dst_cache__local_dst),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    _main_pid = thread_getpid();
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    _tests_init(_send_cb);
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_ipv6_nib_dst_cache());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the attribution of link-layer TX feedback to frames
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/ethernet.h"
+#include "net/gnrc.h"
+#include "net/gnrc/netif/ethernet.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netif/tx_feedback.h"
+#include "net/netdev_test.h"
+#include "thread.h"
+
+#define NBR_MAC1            { 0x57, 0x44, 0x33, 0x22, 0x11, 0x00, }
+#define NBR_MAC2            { 0x57, 0x44, 0x33, 0x22, 0x11, 0x01, }
+#define LOC_MAC             { 0xce, 0xab, 0xfe, 0xad, 0xf7, 0x26, }
+
+static const uint8_t _nbr_mac1[] = NBR_MAC1;
+static const uint8_t _nbr_mac2[] = NBR_MAC2;
+
+static netdev_test_t _mock_netdev;
+static char _mock_netif_stack[THREAD_STACKSIZE_DEFAULT];
+static gnrc_netif_t *_mock_netif;
+
+/* event the device signals on its next interrupt */
+static netdev_event_t _tx_event;
+/* the device signals TX completion already in send() */
+static bool _tx_complete_in_send;
+static uint8_t _tx_retries;
+
+static unsigned _reports;
+static kernel_pid_t _report_iface;
+static uint8_t _report_dst[ETHERNET_ADDR_LEN];
+static size_t _report_dst_len;
+static unsigned _report_num_tx;
+static bool _report_acked;
+
+static int _get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = NETDEV_TYPE_ETHERNET;
+    return sizeof(uint16_t);
+}
+
+static int _get_max_packet_size(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = ETHERNET_DATA_LEN;
+    return sizeof(uint16_t);
+}
+
+static int _get_address(netdev_t *dev, void *value, size_t max_len)
+{
+    static const uint8_t addr[] = LOC_MAC;
+
+    (void)dev;
+    assert(max_len >= sizeof(addr));
+    memcpy(value, addr, sizeof(addr));
+    return sizeof(addr);
+}
+
+static int _get_tx_retries_needed(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint8_t));
+    *((uint8_t *)value) = _tx_retries;
+    return sizeof(uint8_t);
+}
+
+static int _send_cb(netdev_t *dev, const iolist_t *iolist)
+{
+    if (_tx_complete_in_send) {
+        dev->event_callback(dev, NETDEV_EVENT_TX_COMPLETE);
+    }
+    return iolist_size(iolist);
+}
+
+static void _isr_cb(netdev_t *dev)
+{
+    dev->event_callback(dev, _tx_event);
+}
+
+static void _tx_feedback_cb(kernel_pid_t iface, const uint8_t *dst,
+                            size_t dst_len, unsigned num_tx, bool acked)
+{
+    _reports++;
+    _report_iface = iface;
+    _report_dst_len = dst_len;
+    if (dst_len <= sizeof(_report_dst)) {
+        memcpy(_report_dst, dst, dst_len);
+    }
+    _report_num_tx = num_tx;
+    _report_acked = acked;
+}
+
+/* the interface's thread has a higher priority, so the frame is handed to
+ * the device when this returns */
+static void _send(const uint8_t *dst, size_t dst_len, uint8_t flags)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, "ABCDEFG", sizeof("ABCDEFG"),
+                                          GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *netif;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    netif = gnrc_netif_hdr_build(NULL, 0, dst, dst_len);
+    TEST_ASSERT_NOT_NULL(netif);
+    ((gnrc_netif_hdr_t *)netif->data)->flags = flags;
+    netif->next = pkt;
+    TEST_ASSERT(gnrc_netif_send(_mock_netif, netif) > 0);
+}
+
+/* signals a TX completion event from the context of the interface's thread */
+static void _signal(netdev_event_t event)
+{
+    _tx_event = event;
+    netdev_trigger_event_isr(&_mock_netdev.netdev);
+}
+
+static void set_up(void)
+{
+    _tx_complete_in_send = false;
+    _tx_retries = 0;
+    _reports = 0;
+    _report_dst_len = 0;
+    memset(_report_dst, 0, sizeof(_report_dst));
+    gnrc_netif_tx_feedback_set_cb(_tx_feedback_cb);
+}
+
+static void tear_down(void)
+{
+    gnrc_netif_tx_feedback_set_cb(NULL);
+    memset(&_mock_netif->tx_feedback, 0, sizeof(_mock_netif->tx_feedback));
+}
+
+static void test_tx_feedback__acked(void)
+{
+    _tx_retries = 2;
+    _send(_nbr_mac1, sizeof(_nbr_mac1), 0);
+    TEST_ASSERT_EQUAL_INT(0, _reports);
+    _signal(NETDEV_EVENT_TX_COMPLETE);
+    TEST_ASSERT_EQUAL_INT(1, _reports);
+    TEST_ASSERT_EQUAL_INT(_mock_netif->pid, _report_iface);
+    TEST_ASSERT_EQUAL_INT(sizeof(_nbr_mac1), _report_dst_len);
+    TEST_ASSERT(memcmp(_nbr_mac1, _report_dst, sizeof(_nbr_mac1)) == 0);
+    TEST_ASSERT_EQUAL_INT(3, _report_num_tx);
+    TEST_ASSERT(_report_acked);
+}
+
+static void test_tx_feedback__noack(void)
+{
+    _send(_nbr_mac2, sizeof(_nbr_mac2), 0);
+    _signal(NETDEV_EVENT_TX_NOACK);
+    TEST_ASSERT_EQUAL_INT(1, _reports);
+    TEST_ASSERT(memcmp(_nbr_mac2, _report_dst, sizeof(_nbr_mac2)) == 0);
+    TEST_ASSERT_EQUAL_INT(1, _report_num_tx);
+    TEST_ASSERT(!_report_acked);
+}
+
+static void test_tx_feedback__completed_in_send(void)
+{
+    _tx_complete_in_send = true;
+    _send(_nbr_mac1, sizeof(_nbr_mac1), 0);
+    TEST_ASSERT_EQUAL_INT(1, _reports);
+    TEST_ASSERT(memcmp(_nbr_mac1, _report_dst, sizeof(_nbr_mac1)) == 0);
+    TEST_ASSERT(_report_acked);
+    TEST_ASSERT_EQUAL_INT(0, _mock_netif->tx_feedback.pending);
+}
+
+static void test_tx_feedback__queued(void)
+{
+    /* the device can not tell which of the queued frames completed */
+    _send(_nbr_mac1, sizeof(_nbr_mac1), 0);
+    _send(_nbr_mac2, sizeof(_nbr_mac2), 0);
+    _signal(NETDEV_EVENT_TX_NOACK);
+    _signal(NETDEV_EVENT_TX_COMPLETE);
+    TEST_ASSERT_EQUAL_INT(0, _reports);
+    /* frames are attributable again after all queued frames completed */
+    _send(_nbr_mac2, sizeof(_nbr_mac2), 0);
+    _signal(NETDEV_EVENT_TX_COMPLETE);
+    TEST_ASSERT_EQUAL_INT(1, _reports);
+    TEST_ASSERT(memcmp(_nbr_mac2, _report_dst, sizeof(_nbr_mac2)) == 0);
+}
+
+static void test_tx_feedback__broadcast(void)
+{
+    _send(NULL, 0, GNRC_NETIF_HDR_FLAGS_BROADCAST);
+    _signal(NETDEV_EVENT_TX_COMPLETE);
+    TEST_ASSERT_EQUAL_INT(0, _reports);
+    TEST_ASSERT_EQUAL_INT(0, _mock_netif->tx_feedback.pending);
+}
+
+static void test_tx_feedback__medium_busy(void)
+{
+    _send(_nbr_mac1, sizeof(_nbr_mac1), 0);
+    _signal(NETDEV_EVENT_TX_MEDIUM_BUSY);
+    TEST_ASSERT_EQUAL_INT(0, _reports);
+    TEST_ASSERT_EQUAL_INT(0, _mock_netif->tx_feedback.pending);
+    _send(_nbr_mac2, sizeof(_nbr_mac2), 0);
+    _signal(NETDEV_EVENT_TX_COMPLETE);
+    TEST_ASSERT_EQUAL_INT(1, _reports);
+    TEST_ASSERT(memcmp(_nbr_mac2, _report_dst, sizeof(_nbr_mac2)) == 0);
+}
+
+static Test *tests_gnrc_netif_tx_feedback(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_tx_feedback__acked),
+        new_TestFixture(test_tx_feedback__noack),
+        new_TestFixture(test_tx_feedback__completed_in_send),
+        new_TestFixture(test_tx_feedback__queued),
+        new_TestFixture(test_tx_feedback__broadcast),
+        new_TestFixture(test_tx_feedback__medium_busy),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    netdev_test_setup(&_mock_netdev, 0);
+    netdev_test_set_get_cb(&_mock_netdev, NETOPT_DEVICE_TYPE,
+                           _get_device_type);
+    netdev_test_set_get_cb(&_mock_netdev, NETOPT_MAX_PDU_SIZE,
+                           _get_max_packet_size);
+    netdev_test_set_get_cb(&_mock_netdev, NETOPT_ADDRESS, _get_address);
+    netdev_test_set_get_cb(&_mock_netdev, NETOPT_TX_RETRIES_NEEDED,
+                           _get_tx_retries_needed);
+    netdev_test_set_send_cb(&_mock_netdev, _send_cb);
+    netdev_test_set_isr_cb(&_mock_netdev, _isr_cb);
+    _mock_netif = gnrc_netif_ethernet_create(
+           _mock_netif_stack, THREAD_STACKSIZE_DEFAULT, GNRC_NETIF_PRIO,
+            "mockup_eth", &_mock_netdev.netdev
+        );
+    assert(_mock_netif != NULL);
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_netif_tx_feedback());
+    TESTS_END();
+
+    return 0;
+}
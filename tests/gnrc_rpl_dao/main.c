@@ -0,0 +1,464 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests aggregation, splitting and retransmission of RPL DAOs
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "kernel_defines.h"
+#include "msg.h"
+#include "net/ethernet.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif/ethernet.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/dodag.h"
+#include "net/gnrc/rpl/of_manager.h"
+#include "net/gnrc/rpl/structs.h"
+#include "net/icmpv6.h"
+#include "net/ipv6/hdr.h"
+#include "net/netdev_test.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define MAIN_QUEUE_SIZE     (8)
+#define DAO_TIMEOUT         (50U * US_PER_MS)
+/* tolerance for the timing of DAOs sent by the RPL thread */
+#define DAO_SLACK_MS        (50U)
+#define MAX_TARGETS         (4U)
+#define TEST_INSTANCE_ID    (GNRC_RPL_DEFAULT_INSTANCE)
+#define TEST_LIFETIME       (GNRC_RPL_DEFAULT_LIFETIME)
+
+#define DODAG_ID            { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                              0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 }
+#define LOC_GLOBAL          { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                              0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 }
+#define PARENT_GLOBAL       { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                              0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 }
+#define PARENT_LINK_LOCAL   { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+                              0x55, 0x44, 0x33, 0xff, 0xfe, 0x22, 0x11, 0x00 }
+#define CHILD_LINK_LOCAL    { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+                              0x55, 0x44, 0x33, 0xff, 0xfe, 0x22, 0x11, 0x01 }
+#define CHILD_GLOBAL(n)     { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, \
+                              0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10 + n }
+#define PARENT_MAC          { 0x57, 0x44, 0x33, 0x22, 0x11, 0x00 }
+#define LOC_MAC             { 0xce, 0xab, 0xfe, 0xad, 0xf7, 0x26 }
+
+typedef struct {
+    ipv6_addr_t dst;
+    uint8_t k_d_flags;
+    uint8_t seq;
+    unsigned transits;
+    bool transit_parent;
+    ipv6_addr_t parent;
+    unsigned targets;
+    ipv6_addr_t target[MAX_TARGETS];
+} dao_t;
+
+static ipv6_addr_t _dodag_id = { .u8 = DODAG_ID };
+static const ipv6_addr_t _loc_global = { .u8 = LOC_GLOBAL };
+static ipv6_addr_t _parent_global = { .u8 = PARENT_GLOBAL };
+static ipv6_addr_t _parent_link_local = { .u8 = PARENT_LINK_LOCAL };
+static const ipv6_addr_t _child_link_local = { .u8 = CHILD_LINK_LOCAL };
+static const ipv6_addr_t _child_global[] = {
+    { .u8 = CHILD_GLOBAL(0) },
+    { .u8 = CHILD_GLOBAL(1) },
+    { .u8 = CHILD_GLOBAL(2) },
+};
+static const uint8_t _parent_mac[] = PARENT_MAC;
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static gnrc_netreg_entry_t _ipv6_reg;
+static netdev_test_t _mock_netdev;
+static char _mock_netif_stack[THREAD_STACKSIZE_DEFAULT];
+static gnrc_netif_t *_mock_netif;
+static gnrc_rpl_instance_t *_inst;
+static uint8_t _buf[256];
+
+static int _get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = NETDEV_TYPE_ETHERNET;
+    return sizeof(uint16_t);
+}
+
+static int _get_max_packet_size(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = ETHERNET_DATA_LEN;
+    return sizeof(uint16_t);
+}
+
+static int _get_address(netdev_t *dev, void *value, size_t max_len)
+{
+    static const uint8_t addr[] = LOC_MAC;
+
+    (void)dev;
+    assert(max_len >= sizeof(addr));
+    memcpy(value, addr, sizeof(addr));
+    return sizeof(addr);
+}
+
+static int _send_cb(netdev_t *dev, const iolist_t *iolist)
+{
+    (void)dev;
+    return iolist_size(iolist);
+}
+
+/* parses the DAO in a packet RPL handed to IPv6, returns false if the packet
+ * is no DAO */
+static bool _parse_dao(gnrc_pktsnip_t *pkt, dao_t *dao)
+{
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+    gnrc_pktsnip_t *icmpv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_ICMPV6);
+    const icmpv6_hdr_t *hdr;
+    const gnrc_rpl_dao_t *dao_hdr;
+    size_t len = 0, pos;
+
+    if ((ipv6 == NULL) || (icmpv6 == NULL)) {
+        return false;
+    }
+    for (gnrc_pktsnip_t *snip = icmpv6; snip != NULL; snip = snip->next) {
+        if ((len + snip->size) > sizeof(_buf)) {
+            return false;
+        }
+        memcpy(&_buf[len], snip->data, snip->size);
+        len += snip->size;
+    }
+    hdr = (icmpv6_hdr_t *)_buf;
+    if ((len < (sizeof(*hdr) + sizeof(*dao_hdr))) ||
+        (hdr->type != ICMPV6_RPL_CTRL) ||
+        (hdr->code != GNRC_RPL_ICMPV6_CODE_DAO)) {
+        return false;
+    }
+    memset(dao, 0, sizeof(*dao));
+    dao->dst = ((ipv6_hdr_t *)ipv6->data)->dst;
+    dao_hdr = (gnrc_rpl_dao_t *)(hdr + 1);
+    dao->k_d_flags = dao_hdr->k_d_flags;
+    dao->seq = dao_hdr->dao_sequence;
+    pos = sizeof(*hdr) + sizeof(*dao_hdr);
+    while ((pos + sizeof(gnrc_rpl_opt_t)) <= len) {
+        gnrc_rpl_opt_t *opt = (gnrc_rpl_opt_t *)&_buf[pos];
+
+        if (opt->type == GNRC_RPL_OPT_TARGET) {
+            gnrc_rpl_opt_target_t *target = (gnrc_rpl_opt_target_t *)opt;
+
+            if (dao->targets < MAX_TARGETS) {
+                dao->target[dao->targets] = target->target;
+            }
+            dao->targets++;
+        }
+        else if (opt->type == GNRC_RPL_OPT_TRANSIT) {
+            gnrc_rpl_opt_transit_t *transit = (gnrc_rpl_opt_transit_t *)opt;
+
+            dao->transits++;
+            if (transit->length > (sizeof(*transit) - sizeof(*opt))) {
+                dao->transit_parent = true;
+                memcpy(&dao->parent, transit + 1, sizeof(dao->parent));
+            }
+        }
+        pos += sizeof(*opt) + opt->length;
+    }
+    return true;
+}
+
+/* waits for the next DAO RPL sends */
+static bool _recv_dao(dao_t *dao, uint32_t timeout)
+{
+    uint32_t start = xtimer_now_usec();
+    msg_t msg;
+
+    while ((xtimer_now_usec() - start) < timeout) {
+        if (xtimer_msg_receive_timeout(&msg, timeout) < 0) {
+            return false;
+        }
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_SND) {
+            bool res = _parse_dao(msg.content.ptr, dao);
+
+            gnrc_pktbuf_release(msg.content.ptr);
+            if (res) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool _has_target(const dao_t *dao, const ipv6_addr_t *addr)
+{
+    for (unsigned i = 0; (i < dao->targets) && (i < MAX_TARGETS); i++) {
+        if (ipv6_addr_equal(&dao->target[i], addr)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _recv_dao_ack(uint8_t seq)
+{
+    gnrc_rpl_dao_ack_t ack = {
+        .instance_id = TEST_INSTANCE_ID,
+        .dao_sequence = seq,
+    };
+    ipv6_addr_t dst = _loc_global;
+
+    gnrc_rpl_recv_DAO_ACK(&ack, _mock_netif->pid, &_parent_link_local, &dst,
+                          sizeof(icmpv6_hdr_t) + sizeof(ack));
+}
+
+static void _add_child_routes(unsigned num)
+{
+    for (unsigned i = 0; i < num; i++) {
+        TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add(&_child_global[i],
+                                                      IPV6_ADDR_BIT_LEN,
+                                                      &_child_link_local,
+                                                      _mock_netif->pid, 0));
+    }
+}
+
+static void set_up(void)
+{
+    gnrc_rpl_parent_t *parent;
+    msg_t msg;
+
+    TEST_ASSERT(gnrc_rpl_instance_add(TEST_INSTANCE_ID, &_inst));
+    _inst->mop = GNRC_RPL_MOP_STORING_MODE_NO_MC;
+    _inst->of = gnrc_rpl_get_of_for_ocp(GNRC_RPL_DEFAULT_OCP);
+    TEST_ASSERT(gnrc_rpl_dodag_init(_inst, &_dodag_id, _mock_netif->pid));
+    TEST_ASSERT(gnrc_rpl_parent_add_by_addr(&_inst->dodag, &_parent_link_local,
+                                            &parent));
+    parent->rank = GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE;
+    _inst->dodag.my_rank = 2 * GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE;
+    /* drop anything sent before */
+    while (msg_try_receive(&msg) > 0) {
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_SND) {
+            gnrc_pktbuf_release(msg.content.ptr);
+        }
+    }
+}
+
+static void tear_down(void)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(_child_global); i++) {
+        gnrc_ipv6_nib_ft_del(&_child_global[i], IPV6_ADDR_BIT_LEN);
+    }
+    gnrc_rpl_instance_remove(_inst);
+}
+
+static void test_dao__aggregated(void)
+{
+    dao_t dao;
+
+    _add_child_routes(1);
+    gnrc_rpl_send_DAO(_inst, NULL, TEST_LIFETIME);
+    TEST_ASSERT(_recv_dao(&dao, DAO_TIMEOUT));
+    TEST_ASSERT(ipv6_addr_equal(&_parent_link_local, &dao.dst));
+    TEST_ASSERT(dao.k_d_flags & GNRC_RPL_DAO_K_BIT);
+    TEST_ASSERT_EQUAL_INT(_inst->dodag.dao_ack_seq, dao.seq);
+    TEST_ASSERT_EQUAL_INT(1, dao.transits);
+    TEST_ASSERT(!dao.transit_parent);
+    TEST_ASSERT_EQUAL_INT(2, dao.targets);
+    TEST_ASSERT(_has_target(&dao, &_child_global[0]));
+    TEST_ASSERT(_has_target(&dao, &_loc_global));
+    TEST_ASSERT(!_recv_dao(&dao, DAO_TIMEOUT));
+    TEST_ASSERT_EQUAL_INT(0x1, _inst->dodag.dao_acks_pending);
+
+    _recv_dao_ack(_inst->dodag.dao_ack_seq);
+    TEST_ASSERT_EQUAL_INT(0, _inst->dodag.dao_acks_pending);
+    TEST_ASSERT(_inst->dodag.dao_ack_received);
+}
+
+static void test_dao__split_and_resend(void)
+{
+    dao_t dao1, dao2;
+    uint8_t seq;
+
+    /* 3 routes + own address with 2 targets per DAO */
+    _add_child_routes(3);
+    gnrc_rpl_send_DAO(_inst, NULL, TEST_LIFETIME);
+    seq = _inst->dodag.dao_ack_seq;
+    TEST_ASSERT(_recv_dao(&dao1, DAO_TIMEOUT));
+    TEST_ASSERT(_recv_dao(&dao2, DAO_TIMEOUT));
+    TEST_ASSERT(!_recv_dao(&dao1, DAO_TIMEOUT));
+    /* every DAO of the set has its own transit option and sequence number
+     * and requests its own DAO-ACK */
+    TEST_ASSERT_EQUAL_INT(seq, dao1.seq);
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_COUNTER_INCREMENT(seq), dao2.seq);
+    TEST_ASSERT(dao1.k_d_flags & GNRC_RPL_DAO_K_BIT);
+    TEST_ASSERT(dao2.k_d_flags & GNRC_RPL_DAO_K_BIT);
+    TEST_ASSERT_EQUAL_INT(1, dao1.transits);
+    TEST_ASSERT_EQUAL_INT(1, dao2.transits);
+    TEST_ASSERT_EQUAL_INT(2, dao1.targets);
+    TEST_ASSERT_EQUAL_INT(2, dao2.targets);
+    TEST_ASSERT(_has_target(&dao1, &_child_global[0]));
+    TEST_ASSERT(_has_target(&dao1, &_child_global[1]));
+    TEST_ASSERT(_has_target(&dao2, &_child_global[2]));
+    TEST_ASSERT(_has_target(&dao2, &_loc_global));
+    TEST_ASSERT_EQUAL_INT(0x3, _inst->dodag.dao_acks_pending);
+
+    /* unknown sequence numbers are ignored */
+    _recv_dao_ack(seq - 1);
+    TEST_ASSERT_EQUAL_INT(0x3, _inst->dodag.dao_acks_pending);
+    /* the DAO-ACK of the first DAO is lost */
+    _recv_dao_ack(dao2.seq);
+    TEST_ASSERT_EQUAL_INT(0x1, _inst->dodag.dao_acks_pending);
+    TEST_ASSERT(!_inst->dodag.dao_ack_received);
+
+    /* only the unacknowledged DAO is retransmitted, with a new sequence
+     * number */
+    gnrc_rpl_send_DAO(_inst, NULL, TEST_LIFETIME);
+    TEST_ASSERT(_recv_dao(&dao1, DAO_TIMEOUT));
+    TEST_ASSERT(!_recv_dao(&dao2, DAO_TIMEOUT));
+    TEST_ASSERT_EQUAL_INT(_inst->dodag.dao_ack_seq, dao1.seq);
+    TEST_ASSERT(dao1.seq != seq);
+    TEST_ASSERT(dao1.seq != dao2.seq);
+    TEST_ASSERT_EQUAL_INT(2, dao1.targets);
+    TEST_ASSERT(_has_target(&dao1, &_child_global[0]));
+    TEST_ASSERT(_has_target(&dao1, &_child_global[1]));
+    TEST_ASSERT_EQUAL_INT(0x1, _inst->dodag.dao_acks_pending);
+
+    /* the DAO-ACK of the original transmission is outdated */
+    _recv_dao_ack(seq);
+    TEST_ASSERT_EQUAL_INT(0x1, _inst->dodag.dao_acks_pending);
+    _recv_dao_ack(dao1.seq);
+    TEST_ASSERT_EQUAL_INT(0, _inst->dodag.dao_acks_pending);
+    TEST_ASSERT(_inst->dodag.dao_ack_received);
+}
+
+static void test_dao__no_path(void)
+{
+    dao_t dao;
+
+    _add_child_routes(3);
+    gnrc_rpl_send_DAO(_inst, NULL, 0);
+    TEST_ASSERT(_recv_dao(&dao, DAO_TIMEOUT));
+    TEST_ASSERT(!(dao.k_d_flags & GNRC_RPL_DAO_K_BIT));
+    TEST_ASSERT(_recv_dao(&dao, DAO_TIMEOUT));
+    TEST_ASSERT(!(dao.k_d_flags & GNRC_RPL_DAO_K_BIT));
+    /* No-Path DAOs are not retransmitted */
+    TEST_ASSERT_EQUAL_INT(0, _inst->dodag.dao_acks_pending);
+}
+
+static void test_dao__non_storing(void)
+{
+    gnrc_rpl_dodag_t *dodag = &_inst->dodag;
+    dao_t dao;
+
+    _inst->mop = GNRC_RPL_MOP_NON_STORING_MODE;
+    _add_child_routes(1);
+    /* the root can not route to this node without the parent's global
+     * address */
+    gnrc_rpl_send_DAO(_inst, NULL, TEST_LIFETIME);
+    TEST_ASSERT(!_recv_dao(&dao, DAO_TIMEOUT));
+
+    dodag->parents->global_addr = _parent_global;
+    gnrc_rpl_send_DAO(_inst, NULL, TEST_LIFETIME);
+    TEST_ASSERT(_recv_dao(&dao, DAO_TIMEOUT));
+    TEST_ASSERT(ipv6_addr_equal(&_dodag_id, &dao.dst));
+    TEST_ASSERT_EQUAL_INT(1, dao.transits);
+    TEST_ASSERT(dao.transit_parent);
+    TEST_ASSERT(ipv6_addr_equal(&_parent_global, &dao.parent));
+    /* only the node itself is announced */
+    TEST_ASSERT_EQUAL_INT(1, dao.targets);
+    TEST_ASSERT(_has_target(&dao, &_loc_global));
+}
+
+static void test_dao__backoff(void)
+{
+    static const uint32_t delays[] = {
+        GNRC_RPL_DAO_ACK_DELAY,
+        2 * GNRC_RPL_DAO_ACK_DELAY,
+        4 * GNRC_RPL_DAO_ACK_DELAY,
+    };
+    uint32_t last;
+    dao_t dao;
+
+    _add_child_routes(1);
+    /* the RPL thread sends the DAO and retransmits it as no DAO-ACK arrives */
+    gnrc_rpl_delay_dao(&_inst->dodag);
+    TEST_ASSERT(_recv_dao(&dao, (GNRC_RPL_DAO_DELAY_DEFAULT +
+                                 GNRC_RPL_DAO_DELAY_JITTER +
+                                 DAO_SLACK_MS) * US_PER_MS));
+    last = xtimer_now_usec() / US_PER_MS;
+    for (unsigned i = 0; i < ARRAY_SIZE(delays); i++) {
+        uint32_t now;
+        uint8_t seq = dao.seq;
+
+        TEST_ASSERT(_recv_dao(&dao, (delays[i] + GNRC_RPL_DAO_DELAY_JITTER +
+                                     DAO_SLACK_MS) * US_PER_MS));
+        now = xtimer_now_usec() / US_PER_MS;
+        TEST_ASSERT((now - last) >= (delays[i] - 1));
+        TEST_ASSERT(dao.seq != seq);
+        last = now;
+    }
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_DAO_SEND_RETRIES, _inst->dodag.dao_counter);
+    /* gives up after GNRC_RPL_DAO_SEND_RETRIES transmissions */
+    TEST_ASSERT(!_recv_dao(&dao, (GNRC_RPL_DAO_ACK_DELAY_MAX +
+                                  GNRC_RPL_DAO_DELAY_JITTER +
+                                  DAO_SLACK_MS) * US_PER_MS));
+}
+
+static Test *tests_gnrc_rpl_dao(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_dao__aggregated),
+        new_TestFixture(test_dao__split_and_resend),
+        new_TestFixture(test_dao__no_path),
+        new_TestFixture(test_dao__non_storing),
+        new_TestFixture(test_dao__backoff),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    netdev_test_setup(&_mock_netdev, 0);
+    netdev_test_set_get_cb(&_mock_netdev, NETOPT_DEVICE_TYPE,
+                           _get_device_type);
+    netdev_test_set_get_cb(&_mock_netdev, NETOPT_MAX_PDU_SIZE,
+                           _get_max_packet_size);
+    netdev_test_set_get_cb(&_mock_netdev, NETOPT_ADDRESS, _get_address);
+    netdev_test_set_send_cb(&_mock_netdev, _send_cb);
+    _mock_netif = gnrc_netif_ethernet_create(
+           _mock_netif_stack, THREAD_STACKSIZE_DEFAULT, GNRC_NETIF_PRIO,
+            "mockup_eth", &_mock_netdev.netdev
+        );
+    assert(_mock_netif != NULL);
+    gnrc_netif_ipv6_addr_add_internal(_mock_netif, &_loc_global, 64U,
+                                      GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID);
+    /* don't resolve the parent's link-layer address */
+    gnrc_ipv6_nib_nc_set(&_parent_link_local, _mock_netif->pid,
+                         _parent_mac, sizeof(_parent_mac));
+    gnrc_rpl_init(_mock_netif->pid);
+    /* receive what RPL hands to IPv6 */
+    gnrc_netreg_entry_init_pid(&_ipv6_reg, GNRC_NETREG_DEMUX_CTX_ALL,
+                               thread_getpid());
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &_ipv6_reg);
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_rpl_dao());
+    TESTS_END();
+
+    return 0;
+}
@@ -31,7 +31,9 @@
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/pktdump.h"
 #include "net/gnrc/netreg.h"
+#include "net/gnrc/netif/internal.h"
 #include "net/gnrc/rpl/srh.h"
+#include "net/gnrc/rpl/srh_cache.h"
 #include "net/gnrc/ipv6/ext/rh.h"
 
 #define IPV6_DST            {{ 0x20, 0x01, 0xab, 0xcd, \
@@ -51,6 +53,23 @@
                                0x00, 0x00, 0x00, 0x00, \
                                0x00, 0x00, 0x00, 0x03 }}
 
+#define IPV6_ROOT           {{ 0x20, 0x01, 0x0d, 0xb8, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x01 }}
+#define IPV6_NODE_A         {{ 0x20, 0x01, 0x0d, 0xb8, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x0a }}
+#define IPV6_NODE_B         {{ 0x20, 0x01, 0x0d, 0xb8, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x0b }}
+#define IPV6_NODE_C         {{ 0x20, 0x01, 0x0d, 0xb8, \
+                               0x00, 0x01, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x0c }}
+
 #define IPV6_ADDR1_ELIDED   { 0x00, 0x00, 0x02 }
 #define IPV6_ADDR2_ELIDED   { 0x00, 0x00, 0x03 }
 #define IPV6_ELIDED_PREFIX  (13)
@@ -199,6 +218,71 @@ static void test_rpl_srh_nexthop_prefix_elided(void)
     TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &expected2));
 }
 
+static void test_rpl_srh_cache(void)
+{
+    static const ipv6_addr_t root = IPV6_ROOT, a = IPV6_NODE_A;
+    static const ipv6_addr_t b = IPV6_NODE_B, c = IPV6_NODE_C;
+    gnrc_netif_t *netif = gnrc_netif_iter(NULL);
+    gnrc_rpl_srh_cache_stats_t stats;
+    gnrc_pktsnip_t *snip;
+    gnrc_rpl_srh_t *srh;
+    ipv6_addr_t first_hop;
+    void *err_ptr = NULL;
+
+    TEST_ASSERT_NOT_NULL(netif);
+    TEST_ASSERT(gnrc_netif_ipv6_addr_add_internal(
+                    netif, &root, 64, GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID
+                ) >= 0);
+    /* root <- a <- b <- c */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_cache_route_add(&a, &root, 60));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_cache_route_add(&b, &a, 60));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_cache_route_add(&c, &b, 60));
+
+    /* children of the root don't need a source routing header */
+    TEST_ASSERT_NULL(gnrc_rpl_srh_cache_get(&a, &first_hop));
+    snip = gnrc_rpl_srh_cache_get(&c, &first_hop);
+    TEST_ASSERT_NOT_NULL(snip);
+    TEST_ASSERT(ipv6_addr_equal(&first_hop, &a));
+    srh = snip->data;
+    TEST_ASSERT_EQUAL_INT(snip->size, sizeof(gnrc_rpl_srh_t) + (srh->len * 8));
+    TEST_ASSERT_EQUAL_INT(2, srh->seg_left);
+    /* b shares 15 octets with a, c only 5 */
+    TEST_ASSERT_EQUAL_INT((15 << 4) | 5, srh->compr);
+    TEST_ASSERT_EQUAL_INT(2, srh->len);
+    /* follow the route */
+    memcpy(&hdr.dst, &first_hop, sizeof(hdr.dst));
+    TEST_ASSERT_EQUAL_INT(GNRC_IPV6_EXT_RH_FORWARDED,
+                          gnrc_rpl_srh_process(&hdr, srh, &err_ptr));
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &b));
+    TEST_ASSERT_EQUAL_INT(GNRC_IPV6_EXT_RH_FORWARDED,
+                          gnrc_rpl_srh_process(&hdr, srh, &err_ptr));
+    TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &c));
+    TEST_ASSERT_EQUAL_INT(0, srh->seg_left);
+    gnrc_pktbuf_release(snip);
+
+    /* second lookup is served from the cache */
+    snip = gnrc_rpl_srh_cache_get(&c, &first_hop);
+    TEST_ASSERT_NOT_NULL(snip);
+    gnrc_pktbuf_release(snip);
+    gnrc_rpl_srh_cache_get_stats(&stats);
+    TEST_ASSERT(stats.hits > 0);
+
+    /* b moves to the root */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_cache_route_add(&b, &root, 60));
+    snip = gnrc_rpl_srh_cache_get(&c, &first_hop);
+    TEST_ASSERT_NOT_NULL(snip);
+    TEST_ASSERT(ipv6_addr_equal(&first_hop, &b));
+    TEST_ASSERT_EQUAL_INT(1, ((gnrc_rpl_srh_t *)snip->data)->seg_left);
+    gnrc_pktbuf_release(snip);
+
+    /* b leaves, c is not reachable anymore */
+    gnrc_rpl_srh_cache_route_del(&b);
+    TEST_ASSERT_NULL(gnrc_rpl_srh_cache_get(&c, &first_hop));
+
+    gnrc_rpl_srh_cache_route_clear();
+    gnrc_netif_ipv6_addr_remove_internal(netif, &root);
+}
+
 /* tools for external interaction */
 static inline void _ipreg_usage(char *cmd)
 {
@@ -242,6 +326,7 @@ static void run_unittests(void)
         new_TestFixture(test_rpl_srh_too_many_seg_left),
         new_TestFixture(test_rpl_srh_nexthop_no_prefix_elided),
         new_TestFixture(test_rpl_srh_nexthop_prefix_elided),
+        new_TestFixture(test_rpl_srh_cache),
     };
 
     EMB_UNIT_TESTCALLER(rpl_srh_tests, set_up_tests, NULL, fixtures);
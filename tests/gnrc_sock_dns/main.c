@@ -18,17 +18,28 @@
  * @}
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 
 #include <arpa/inet.h>
 
+#include "event.h"
 #include "net/sock/dns.h"
 #include "shell.h"
+#include "thread.h"
 
 #define MAIN_QUEUE_SIZE     (8)
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 
+/* asynchronous queries are started and canceled by the thread handling
+ * their event queue */
+static char _async_stack[THREAD_STACKSIZE_DEFAULT];
+static event_queue_t _async_queue;
+static sock_dns_req_t _async_req;
+static char _async_name[SOCK_DNS_MAX_NAME_LEN + 1];
+static uint8_t _async_addr[16];
+
 static int _dns(int argc, char **argv);
 
 static const shell_command_t _shell_commands[] = {
@@ -41,6 +52,8 @@ static void _usage(char *cmd)
 {
     printf("usage: %s server <DNS server addr> <DNS server port>\n", cmd);
     printf("       %s request <name>\n", cmd);
+    printf("       %s async <name>\n", cmd);
+    printf("       %s cancel\n", cmd);
 }
 
 static int _dns_server(int argc, char **argv)
@@ -70,17 +83,64 @@ static int _dns_server(int argc, char **argv)
     return 0;
 }
 
+static void _print_addr(const char *prefix, const char *name,
+                        const uint8_t *addr, int len)
+{
+    char addrstr[INET6_ADDRSTRLEN];
+
+    inet_ntop(len == 4 ? AF_INET : AF_INET6, addr, addrstr, sizeof(addrstr));
+    printf("%s%s resolves to %s\n", prefix, name, addrstr);
+}
+
+static void _async_cb(sock_dns_req_t *req, int res)
+{
+    if (res > 0) {
+        _print_addr("async: ", req->domain_name, req->addr_out, res);
+    }
+    else if (res == -ETIMEDOUT) {
+        printf("async: %s timed out\n", req->domain_name);
+    }
+    else {
+        printf("async: error resolving %s\n", req->domain_name);
+    }
+}
+
+static void _async_start(event_t *event)
+{
+    (void)event;
+    /* one query at a time */
+    sock_dns_query_cancel(&_async_req);
+    if (sock_dns_query_async(&_async_req, &_async_queue, _async_name,
+                             _async_addr, AF_UNSPEC, _async_cb) < 0) {
+        printf("async: error resolving %s\n", _async_name);
+    }
+}
+
+static void _async_cancel(event_t *event)
+{
+    (void)event;
+    sock_dns_query_cancel(&_async_req);
+    puts("async: canceled");
+}
+
+static event_t _async_start_event = { .handler = _async_start };
+static event_t _async_cancel_event = { .handler = _async_cancel };
+
+static void *_async_thread(void *arg)
+{
+    (void)arg;
+    event_queue_init(&_async_queue);
+    event_loop(&_async_queue);
+    return NULL;
+}
+
 static int _dns_request(char **argv)
 {
     uint8_t addr[16] = {0};
     int res = sock_dns_query(argv[2], addr, AF_UNSPEC);
 
     if (res > 0) {
-        char addrstr[INET6_ADDRSTRLEN];
-
-        inet_ntop(res == 4 ? AF_INET : AF_INET6, addr, addrstr,
-                  sizeof(addrstr));
-        printf("%s resolves to %s\n", argv[2], addrstr);
+        _print_addr("", argv[2], addr, res);
     }
     else {
         printf("error resolving %s\n", argv[2]);
@@ -97,6 +157,15 @@ static int _dns(int argc, char **argv)
     else if ((argc > 2) && (strcmp(argv[1], "request") == 0)) {
         return _dns_request(argv);
     }
+    else if ((argc > 2) && (strcmp(argv[1], "async") == 0)) {
+        strncpy(_async_name, argv[2], sizeof(_async_name) - 1);
+        event_post(&_async_queue, &_async_start_event);
+        return 0;
+    }
+    else if ((argc > 1) && (strcmp(argv[1], "cancel") == 0)) {
+        event_post(&_async_queue, &_async_cancel_event);
+        return 0;
+    }
     else {
         _usage(argv[0]);
         return 1;
@@ -108,6 +177,8 @@ int main(void)
     /* we need a message queue for the thread running the shell in order to
      * receive potentially fast incoming networking packets */
     msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    thread_create(_async_stack, sizeof(_async_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _async_thread, NULL, "dns_async");
 
     /* start shell */
     shell_run(_shell_commands, _shell_buffer, sizeof(_shell_buffer));
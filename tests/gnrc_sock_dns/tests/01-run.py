@@ -8,6 +8,7 @@
 
 import base64
 import os
+import pexpect
 import re
 import socket
 import sys
@@ -20,6 +21,8 @@ from testrunner import run
 
 
 SERVER_TIMEOUT = 5
+# SOCK_DNS_RETRIES tries of SOCK_DNS_TIMEOUT each
+QUERY_TIMEOUT = 2
 SERVER_PORT = 5335  # 53 requires root and 5353 is used by e.g. Chrome for MDNS
 
 
@@ -75,11 +78,25 @@ class Server(threading.Thread):
             assert(any(p[DNS].qd[i].qtype == DNS_RR_TYPE_AAAA
                        for i in range(qdcount)))    # one is AAAA
             if self.reply is not None:
+                if isinstance(self.reply, DNS):
+                    # replies must carry the transaction ID of the query
+                    self.reply.id = p[DNS].id
+                time.sleep(self.delay)
                 self.socket.sendto(raw(self.reply), remote)
                 self.reply = None
 
-    def listen(self, reply=None):
+    def listen(self, reply=None, delay=0):
+        # drop queries of earlier tests the server did not wait for, e.g.
+        # retries after a timeout
+        self.socket.setblocking(False)
+        try:
+            while True:
+                self.socket.recvfrom(1500)
+        except BlockingIOError:
+            pass
+        self.socket.setblocking(True)
         self.reply = reply
+        self.delay = delay
         self.enter_loop.set()
 
     def stop(self):
@@ -134,19 +151,23 @@ def successful_dns_request(child, name, exp_addr=None):
     child.sendline("dns request {}".format(name))
     res = child.expect(["error resolving {}".format(name),
                         "{} resolves to {}".format(name, exp_addr)],
-                       timeout=3)
+                       timeout=QUERY_TIMEOUT + 1)
     return ((res > 0) and (exp_addr is not None))
 
 
+def success_reply():
+    return DNS(qr=1, qdcount=TEST_QDCOUNT, ancount=TEST_ANCOUNT,
+               qd=(DNSQR(qname=TEST_NAME, qtype=DNS_RR_TYPE_AAAA) /
+                   DNSQR(qname=TEST_NAME, qtype=DNS_RR_TYPE_A)),
+               an=(DNSRR(rrname=TEST_NAME, type=DNS_RR_TYPE_AAAA,
+                         rdlen=DNS_RR_TYPE_AAAA_DLEN,
+                         rdata=TEST_AAAA_DATA) /
+                   DNSRR(rrname=TEST_NAME, type=DNS_RR_TYPE_A,
+                         rdlen=DNS_RR_TYPE_A_DLEN, rdata=TEST_A_DATA)))
+
+
 def test_success(child):
-    server.listen(DNS(qr=1, qdcount=TEST_QDCOUNT, ancount=TEST_ANCOUNT,
-                      qd=(DNSQR(qname=TEST_NAME, qtype=DNS_RR_TYPE_AAAA) /
-                          DNSQR(qname=TEST_NAME, qtype=DNS_RR_TYPE_A)),
-                      an=(DNSRR(rrname=TEST_NAME, type=DNS_RR_TYPE_AAAA,
-                                rdlen=DNS_RR_TYPE_AAAA_DLEN,
-                                rdata=TEST_AAAA_DATA) /
-                          DNSRR(rrname=TEST_NAME, type=DNS_RR_TYPE_A,
-                                rdlen=DNS_RR_TYPE_A_DLEN, rdata=TEST_A_DATA))))
+    server.listen(success_reply())
     assert(successful_dns_request(child, TEST_NAME, TEST_AAAA_DATA))
 
 
@@ -270,6 +291,34 @@ def test_addrlen_wrong_ip4(child):
     assert(not successful_dns_request(child, TEST_NAME, TEST_AAAA_DATA))
 
 
+def test_async_success(child):
+    server.listen(success_reply())
+    child.sendline("dns async {}".format(TEST_NAME))
+    child.expect_exact("async: {} resolves to {}".format(TEST_NAME,
+                                                         TEST_AAAA_DATA),
+                       timeout=QUERY_TIMEOUT + 1)
+
+
+def test_async_timeout(child):
+    # listen but send no reply
+    server.listen()
+    child.sendline("dns async {}".format(TEST_NAME))
+    child.expect_exact("async: {} timed out".format(TEST_NAME),
+                       timeout=QUERY_TIMEOUT + 1)
+
+
+def test_async_cancel(child):
+    # the reply arrives after the query was canceled
+    server.listen(success_reply(), delay=0.5)
+    child.sendline("dns async {}".format(TEST_NAME))
+    child.sendline("dns cancel")
+    child.expect_exact("async: canceled")
+    res = child.expect([pexpect.TIMEOUT,
+                        r"async: {} ".format(re.escape(TEST_NAME))],
+                       timeout=QUERY_TIMEOUT + 1)
+    assert(res == 0)
+
+
 def testfunc(child):
     global server
     tap = get_bridge(os.environ["TAP"])
@@ -308,6 +357,9 @@ def testfunc(child):
         run(test_addrlen_too_large)
         run(test_addrlen_wrong_ip6)
         run(test_addrlen_wrong_ip4)
+        run(test_async_success)
+        run(test_async_timeout)
+        run(test_async_cancel)
         print("SUCCESS")
     finally:
         if server is not None:
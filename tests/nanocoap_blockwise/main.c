@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests block-wise transfers of nanocoap sock
+ *
+ * Client and server run in the same node and talk over the loopback address.
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/ipv6/addr.h"
+#include "net/nanocoap_sock.h"
+#include "thread.h"
+
+#define BLOB_LEN            (1000U)
+#define SERVER_BUF_SIZE     (256U)
+
+static uint8_t _blob[BLOB_LEN];
+static size_t _blob_len;
+
+static uint8_t _recv[BLOB_LEN];
+static size_t _recv_len;
+static unsigned _recv_calls;
+static int _recv_last_more;
+
+static char _server_stack[THREAD_STACKSIZE_DEFAULT + THREAD_EXTRA_STACKSIZE_PRINTF];
+
+static int _recv_cb(void *arg, size_t offset, uint8_t *buf, size_t len,
+                    int more)
+{
+    (void)arg;
+
+    _recv_calls++;
+    if (offset == 0) {
+        /* start of a new payload */
+        _recv_len = 0;
+    }
+    /* blocks must be delivered in order and without gaps */
+    if ((offset != _recv_len) || (offset + len > sizeof(_recv))) {
+        return -1;
+    }
+    memcpy(&_recv[offset], buf, len);
+    _recv_len += len;
+    _recv_last_more = more;
+    return 0;
+}
+
+static nanocoap_block1_sink_t _sink = { .callback = _recv_cb };
+
+static ssize_t _blob_handler(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                             void *context)
+{
+    (void)context;
+    coap_block_slicer_t slicer;
+    coap_block2_init(pkt, &slicer);
+    uint8_t *payload = buf + coap_get_total_hdr_len(pkt);
+    uint8_t *bufpos = payload;
+
+    bufpos += coap_opt_put_block2(bufpos, 0, &slicer, 1);
+    *bufpos++ = 0xff;
+    bufpos += coap_blockwise_put_bytes(&slicer, bufpos, _blob, _blob_len);
+
+    return coap_block2_build_reply(pkt, COAP_CODE_205, buf, len,
+                                   bufpos - payload, &slicer);
+}
+
+static ssize_t _sink_handler(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                             void *context)
+{
+    return nanocoap_block1_sink(context, pkt, buf, len);
+}
+
+const coap_resource_t coap_resources[] = {
+    { "/blob", COAP_GET, _blob_handler, NULL },
+    { "/sink", COAP_PUT | COAP_POST, _sink_handler, &_sink },
+};
+
+const unsigned coap_resources_numof = ARRAY_SIZE(coap_resources);
+
+static void *_server_thread(void *arg)
+{
+    (void)arg;
+    static uint8_t buf[SERVER_BUF_SIZE];
+    sock_udp_ep_t local = { .port = COAP_PORT, .family = AF_INET6 };
+
+    nanocoap_server(&local, buf, sizeof(buf));
+    return NULL;
+}
+
+static void _remote(sock_udp_ep_t *remote)
+{
+    memset(remote, 0, sizeof(*remote));
+    remote->family = AF_INET6;
+    remote->port = COAP_PORT;
+    memcpy(remote->addr.ipv6, &ipv6_addr_loopback, sizeof(ipv6_addr_t));
+}
+
+static void set_up(void)
+{
+    for (unsigned i = 0; i < sizeof(_blob); i++) {
+        _blob[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+    memset(_recv, 0, sizeof(_recv));
+    _recv_len = 0;
+    _recv_calls = 0;
+    _recv_last_more = -2;
+    _sink.offset = 0;
+}
+
+static void test_get_blockwise(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    /* more blocks than the request window */
+    _blob_len = BLOB_LEN;
+    TEST_ASSERT_EQUAL_INT(0, nanocoap_get_blockwise(&remote, "/blob",
+                                                    COAP_BLOCKSIZE_64,
+                                                    _recv_cb, NULL));
+    TEST_ASSERT_EQUAL_INT(BLOB_LEN, _recv_len);
+    TEST_ASSERT_EQUAL_INT((BLOB_LEN + 63) / 64, _recv_calls);
+    TEST_ASSERT_EQUAL_INT(0, _recv_last_more);
+    TEST_ASSERT(memcmp(_recv, _blob, BLOB_LEN) == 0);
+}
+
+static void test_get_blockwise_exact_multiple(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    _blob_len = 8 * 64;
+    TEST_ASSERT_EQUAL_INT(0, nanocoap_get_blockwise(&remote, "/blob",
+                                                    COAP_BLOCKSIZE_64,
+                                                    _recv_cb, NULL));
+    TEST_ASSERT_EQUAL_INT(8 * 64, _recv_len);
+    TEST_ASSERT_EQUAL_INT(8, _recv_calls);
+    TEST_ASSERT(memcmp(_recv, _blob, 8 * 64) == 0);
+}
+
+static void test_get_blockwise_single(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    _blob_len = 10;
+    TEST_ASSERT_EQUAL_INT(0, nanocoap_get_blockwise(&remote, "/blob",
+                                                    COAP_BLOCKSIZE_32,
+                                                    _recv_cb, NULL));
+    TEST_ASSERT_EQUAL_INT(10, _recv_len);
+    TEST_ASSERT_EQUAL_INT(1, _recv_calls);
+    TEST_ASSERT(memcmp(_recv, _blob, 10) == 0);
+}
+
+static void test_get_blockwise_not_found(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    TEST_ASSERT_EQUAL_INT(-404, nanocoap_get_blockwise(&remote, "/nothing",
+                                                       COAP_BLOCKSIZE_64,
+                                                       _recv_cb, NULL));
+    TEST_ASSERT_EQUAL_INT(0, _recv_calls);
+}
+
+static void test_put_blockwise(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    TEST_ASSERT_EQUAL_INT(0, nanocoap_put_blockwise(&remote, "/sink",
+                                                    COAP_BLOCKSIZE_32,
+                                                    _blob, BLOB_LEN));
+    TEST_ASSERT_EQUAL_INT(BLOB_LEN, _recv_len);
+    TEST_ASSERT_EQUAL_INT((BLOB_LEN + 31) / 32, _recv_calls);
+    TEST_ASSERT_EQUAL_INT(0, _recv_last_more);
+    TEST_ASSERT(memcmp(_recv, _blob, BLOB_LEN) == 0);
+}
+
+static void test_post_blockwise(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    TEST_ASSERT_EQUAL_INT(0, nanocoap_post_blockwise(&remote, "/sink",
+                                                     COAP_BLOCKSIZE_64,
+                                                     _blob, 4 * 64));
+    TEST_ASSERT_EQUAL_INT(4 * 64, _recv_len);
+    TEST_ASSERT_EQUAL_INT(4, _recv_calls);
+    TEST_ASSERT(memcmp(_recv, _blob, 4 * 64) == 0);
+}
+
+/* feeds a single Block1 request to the sink and returns the response code */
+static unsigned _sink_block(uint32_t blknum, int more)
+{
+    uint8_t req[64];
+    uint8_t resp[64];
+    uint8_t *pos = req;
+    coap_pkt_t pkt;
+    ssize_t res;
+
+    pos += coap_build_hdr((coap_hdr_t *)req, COAP_TYPE_CON, NULL, 0,
+                          COAP_METHOD_PUT, 1);
+    pos += coap_put_option_block1(pos, 0, blknum, COAP_BLOCKSIZE_32, more);
+    *pos++ = 0xff;
+    memcpy(pos, &_blob[blknum * 32], 32);
+    pos += 32;
+
+    if (coap_parse(&pkt, req, pos - req) < 0) {
+        return 0;
+    }
+    res = nanocoap_block1_sink(&_sink, &pkt, resp, sizeof(resp));
+    if ((res <= 0) || (coap_parse(&pkt, resp, res) < 0)) {
+        return 0;
+    }
+    return coap_get_code(&pkt);
+}
+
+static void test_block1_sink_gap(void)
+{
+    TEST_ASSERT_EQUAL_INT(231, _sink_block(0, 1));
+    /* block 1 got lost */
+    TEST_ASSERT_EQUAL_INT(408, _sink_block(2, 1));
+    TEST_ASSERT_EQUAL_INT(1, _recv_calls);
+    /* the payload received so far is discarded */
+    TEST_ASSERT_EQUAL_INT(408, _sink_block(1, 1));
+    TEST_ASSERT_EQUAL_INT(1, _recv_calls);
+    /* the client starts over */
+    TEST_ASSERT_EQUAL_INT(231, _sink_block(0, 1));
+    TEST_ASSERT_EQUAL_INT(231, _sink_block(1, 1));
+    TEST_ASSERT_EQUAL_INT(204, _sink_block(2, 0));
+    TEST_ASSERT_EQUAL_INT(4, _recv_calls);
+    TEST_ASSERT_EQUAL_INT(3 * 32, _recv_len);
+    TEST_ASSERT(memcmp(_recv, _blob, 3 * 32) == 0);
+}
+
+static void test_block1_sink_retransmission(void)
+{
+    TEST_ASSERT_EQUAL_INT(231, _sink_block(0, 1));
+    TEST_ASSERT_EQUAL_INT(231, _sink_block(1, 1));
+    /* the response to block 1 got lost, the client sends it again */
+    TEST_ASSERT_EQUAL_INT(231, _sink_block(1, 1));
+    TEST_ASSERT_EQUAL_INT(2, _recv_calls);
+    TEST_ASSERT_EQUAL_INT(204, _sink_block(2, 0));
+    TEST_ASSERT_EQUAL_INT(3, _recv_calls);
+    TEST_ASSERT_EQUAL_INT(3 * 32, _recv_len);
+}
+
+static Test *tests_nanocoap_blockwise(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_get_blockwise),
+        new_TestFixture(test_get_blockwise_exact_multiple),
+        new_TestFixture(test_get_blockwise_single),
+        new_TestFixture(test_get_blockwise_not_found),
+        new_TestFixture(test_put_blockwise),
+        new_TestFixture(test_post_blockwise),
+        new_TestFixture(test_block1_sink_gap),
+        new_TestFixture(test_block1_sink_retransmission),
+    };
+
+    EMB_UNIT_TESTCALLER(nanocoap_blockwise_tests, set_up, NULL, fixtures);
+
+    return (Test *)&nanocoap_blockwise_tests;
+}
+
+int main(void)
+{
+    thread_create(_server_stack, sizeof(_server_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _server_thread, NULL, "coap");
+
+    TESTS_START();
+    TESTS_RUN(tests_nanocoap_blockwise());
+    TESTS_END();
+
+    return 0;
+}
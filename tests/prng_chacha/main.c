@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the ChaCha PRNG of sys/random
+ *
+ * random_init(SEED) keys ChaCha20 with SEED in the first key word, zero
+ * otherwise. The first keystream block of that key becomes the key of the
+ * thread generator (first half) and of the interrupt generator (second half).
+ * Both then erase their key with the first 32 bytes of each refill.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "irq.h"
+#include "mutex.h"
+#include "random.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#if (RANDOM_CHACHA_ROUNDS != 20) || (RANDOM_CHACHA_THREAD_BUF != 16)
+#error "the reference output is for ChaCha20 and 16 byte thread buffers"
+#endif
+
+#define SEED            (1234U)
+#define ISR_DELAY       (1U * US_PER_MS)
+
+/* first keystream block of the thread generator after random_init(SEED),
+ * computed with an independent ChaCha20 implementation. The key takes the
+ * first 32 bytes of every refill, so buffered output starts at byte 32. */
+static const uint8_t _ref[] = {
+    0x97, 0x06, 0x99, 0xc9, 0x9c, 0xe2, 0xea, 0x77,
+    0x44, 0x38, 0x0d, 0x6e, 0x99, 0x30, 0x4f, 0xdf,
+    0xa8, 0xc8, 0xc2, 0xaa, 0x9e, 0x41, 0x17, 0x17,
+    0x46, 0xcc, 0x99, 0x6e, 0x0a, 0x2c, 0xe0, 0x9f,
+    0xb3, 0x13, 0x5b, 0x7f, 0xf5, 0x09, 0xb3, 0x90,
+    0xa3, 0x43, 0x56, 0xff, 0xf2, 0x5f, 0x02, 0x5b,
+    0x98, 0x55, 0xba, 0x75, 0x80, 0xec, 0xcf, 0x61,
+    0xa8, 0xaa, 0x1d, 0xfb, 0x0a, 0xb5, 0x7f, 0x83,
+};
+
+/* bytes 32 to 47 of the first keystream block of the interrupt generator */
+static const uint8_t _ref_isr[] = {
+    0x3f, 0xec, 0x5f, 0x21, 0x20, 0x40, 0x39, 0x5d,
+    0xf4, 0x16, 0x3d, 0x66, 0x86, 0x06, 0x1f, 0x08,
+};
+
+static char _stacks[2][THREAD_STACKSIZE_DEFAULT];
+static uint8_t _out[RANDOM_CHACHA_THREAD_BUF];
+static size_t _out_len;
+static mutex_t _isr_done = MUTEX_INIT_LOCKED;
+static int _in_isr;
+
+static void *_random_thread(void *arg)
+{
+    (void)arg;
+    random_bytes(_out, _out_len);
+    return NULL;
+}
+
+/* runs random_bytes() in a new thread, which exits right after */
+static kernel_pid_t _random_in_thread(unsigned stack, size_t len)
+{
+    _out_len = len;
+    /* the thread runs to completion before thread_create() returns */
+    return thread_create(_stacks[stack], sizeof(_stacks[stack]),
+                         THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                         _random_thread, NULL, "random");
+}
+
+static void _isr_cb(void *arg)
+{
+    (void)arg;
+    _in_isr = irq_is_in();
+    random_bytes(_out, sizeof(_ref_isr));
+    mutex_unlock(&_isr_done);
+}
+
+static void set_up(void)
+{
+    random_init(SEED);
+}
+
+static void test_prng_chacha__reference(void)
+{
+    uint8_t buf[sizeof(_ref)];
+
+    /* whole blocks are generated directly by the thread generator */
+    random_bytes(buf, sizeof(buf));
+    TEST_ASSERT(memcmp(_ref, buf, sizeof(_ref)) == 0);
+}
+
+static void test_prng_chacha__reference_buffered(void)
+{
+    uint8_t buf[RANDOM_CHACHA_THREAD_BUF];
+
+    /* small requests are served from a refill of the pool */
+    random_bytes(buf, sizeof(buf));
+    TEST_ASSERT(memcmp(&_ref[32], buf, sizeof(buf)) == 0);
+}
+
+static void test_prng_chacha__reproducible(void)
+{
+    uint8_t first[100];
+    uint8_t second[sizeof(first)];
+    uint32_t r = random_uint32();
+
+    random_bytes(first, sizeof(first));
+    /* leaves bytes in the thread buffer, which must not be handed out */
+    random_uint32();
+    random_init(SEED);
+    TEST_ASSERT_EQUAL_INT(r, random_uint32());
+    random_bytes(second, sizeof(second));
+    TEST_ASSERT(memcmp(first, second, sizeof(first)) == 0);
+    random_init(SEED + 1);
+    TEST_ASSERT(random_uint32() != r);
+}
+
+static void test_prng_chacha__pid_reuse(void)
+{
+    /* the first thread takes the last 4 bytes of its buffer */
+    kernel_pid_t pid = _random_in_thread(0, 4);
+    TEST_ASSERT(pid_is_valid(pid));
+    TEST_ASSERT(memcmp(&_ref[44], _out, 4) == 0);
+    /* the second thread must not get the 12 bytes left by the first one,
+     * but a buffer refilled from the pool */
+    TEST_ASSERT_EQUAL_INT(pid, _random_in_thread(1, RANDOM_CHACHA_THREAD_BUF));
+    TEST_ASSERT(memcmp(&_ref[48], _out, RANDOM_CHACHA_THREAD_BUF) == 0);
+}
+
+static void test_prng_chacha__isr(void)
+{
+    xtimer_t timer = { .callback = _isr_cb };
+
+    xtimer_set(&timer, ISR_DELAY);
+    mutex_lock(&_isr_done);
+    TEST_ASSERT(_in_isr);
+    TEST_ASSERT(memcmp(_ref_isr, _out, sizeof(_ref_isr)) == 0);
+    /* the thread generator is not affected */
+    test_prng_chacha__reference_buffered();
+}
+
+static Test *tests_prng_chacha(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_prng_chacha__reference),
+        new_TestFixture(test_prng_chacha__reference_buffered),
+        new_TestFixture(test_prng_chacha__reproducible),
+        new_TestFixture(test_prng_chacha__pid_reuse),
+        new_TestFixture(test_prng_chacha__isr),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_prng_chacha());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the SHA-256 verification of riotboot_flashwrite
+ *
+ * The images are written to the slot the application is not running from,
+ * but never finished, so that slot does not become bootable.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "hashes/sha256.h"
+#include "riotboot/flashwrite.h"
+#include "riotboot/slot.h"
+
+/* the last page is only half filled */
+#define IMG_LEN         (2 * FLASHPAGE_SIZE + FLASHPAGE_SIZE / 2)
+#define IMG_PAGES       (3)
+/* bytes passed to riotboot_flashwrite_putbytes() at once */
+#define CHUNK_LEN       (64U)
+/* no byte is corrupted */
+#define NO_CORRUPT      (IMG_LEN)
+
+static riotboot_flashwrite_t _state;
+static uint8_t _chunk[CHUNK_LEN];
+static uint8_t _page_digests[IMG_PAGES * SHA256_DIGEST_LENGTH];
+static uint8_t _root[SHA256_DIGEST_LENGTH];
+/* digest of the image with and without the magic number */
+static uint8_t _digest[SHA256_DIGEST_LENGTH];
+static uint8_t _digest_nomagic[SHA256_DIGEST_LENGTH];
+
+static uint8_t _img_byte(size_t pos)
+{
+    return (uint8_t)((pos * 13) + (pos >> 8));
+}
+
+/* fills _chunk with the image bytes starting at @p pos */
+static size_t _fill_chunk(size_t pos, size_t end)
+{
+    size_t len = (end - pos < CHUNK_LEN) ? end - pos : CHUNK_LEN;
+
+    for (size_t i = 0; i < len; i++) {
+        _chunk[i] = _img_byte(pos + i);
+    }
+    return len;
+}
+
+static void _hash_img(sha256_context_t *ctx, size_t start, size_t end)
+{
+    while (start < end) {
+        size_t len = _fill_chunk(start, end);
+
+        sha256_update(ctx, _chunk, len);
+        start += len;
+    }
+}
+
+/* writes the image after the magic number, with the byte at @p corrupt
+ * flipped, and returns the result of the first failing
+ * riotboot_flashwrite_putbytes() call */
+static int _write(size_t corrupt)
+{
+    size_t pos = RIOTBOOT_FLASHWRITE_SKIPLEN;
+
+    while (pos < IMG_LEN) {
+        size_t len = _fill_chunk(pos, IMG_LEN);
+
+        if ((corrupt >= pos) && (corrupt < pos + len)) {
+            _chunk[corrupt - pos] ^= 0x01;
+        }
+        int res = riotboot_flashwrite_putbytes(&_state, _chunk, len,
+                                               (pos + len) < IMG_LEN);
+        if (res != 0) {
+            return res;
+        }
+        pos += len;
+    }
+    return 0;
+}
+
+/* checks the slot holds the image in [start, end) */
+static int _flash_matches(size_t start, size_t end)
+{
+    const uint8_t *slot = (const uint8_t *)riotboot_slot_get_hdr(
+                                                riotboot_slot_other());
+
+    for (size_t pos = start; pos < end; pos++) {
+        if (slot[pos] != _img_byte(pos)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void set_up(void)
+{
+    riotboot_flashwrite_init(&_state, riotboot_slot_other());
+}
+
+static void test_flashwrite__streamed(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _write(NO_CORRUPT));
+    TEST_ASSERT_EQUAL_INT(0, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest, IMG_LEN));
+    TEST_ASSERT(_flash_matches(RIOTBOOT_FLASHWRITE_SKIPLEN, IMG_LEN));
+}
+
+static void test_flashwrite__streamed_mismatch(void)
+{
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+
+    memcpy(digest, _digest, sizeof(digest));
+    digest[SHA256_DIGEST_LENGTH - 1] ^= 0x80;
+    TEST_ASSERT_EQUAL_INT(0, _write(NO_CORRUPT));
+    TEST_ASSERT_EQUAL_INT(1, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, digest, IMG_LEN));
+}
+
+static void test_flashwrite__streamed_corrupted(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _write(FLASHPAGE_SIZE + 10));
+    TEST_ASSERT_EQUAL_INT(1, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest, IMG_LEN));
+}
+
+static void test_flashwrite__streamed_len(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _write(NO_CORRUPT));
+    TEST_ASSERT_EQUAL_INT(-1, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest, IMG_LEN - 1));
+    TEST_ASSERT_EQUAL_INT(-1, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest, IMG_LEN + 1));
+    /* the digest is only consumed once the length matches */
+    TEST_ASSERT_EQUAL_INT(0, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest, IMG_LEN));
+}
+
+static void test_flashwrite__magic(void)
+{
+    /* riotboot_flashwrite_init() hashes the magic number */
+    TEST_ASSERT_EQUAL_INT(0, _write(NO_CORRUPT));
+    TEST_ASSERT_EQUAL_INT(1, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest_nomagic, IMG_LEN));
+    /* riotboot_flashwrite_init_raw() only hashes the bytes put */
+    riotboot_flashwrite_init_raw(&_state, riotboot_slot_other(),
+                                 RIOTBOOT_FLASHWRITE_SKIPLEN);
+    TEST_ASSERT_EQUAL_INT(0, _write(NO_CORRUPT));
+    TEST_ASSERT_EQUAL_INT(0, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest_nomagic, IMG_LEN));
+}
+
+static void test_flashwrite__page_digests_root(void)
+{
+    uint8_t root[SHA256_DIGEST_LENGTH];
+
+    memcpy(root, _root, sizeof(root));
+    root[0] ^= 0x01;
+    TEST_ASSERT_EQUAL_INT(-1, riotboot_flashwrite_set_page_digests(
+                                &_state, _page_digests, IMG_PAGES, root));
+    TEST_ASSERT_NULL(_state.page_digests);
+    /* a list missing a page does not match the root either */
+    TEST_ASSERT_EQUAL_INT(-1, riotboot_flashwrite_set_page_digests(
+                                &_state, _page_digests, IMG_PAGES - 1, _root));
+    TEST_ASSERT_NULL(_state.page_digests);
+    TEST_ASSERT_EQUAL_INT(0, riotboot_flashwrite_set_page_digests(
+                                &_state, _page_digests, IMG_PAGES, _root));
+    TEST_ASSERT(_state.page_digests == _page_digests);
+}
+
+static void test_flashwrite__pages(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, riotboot_flashwrite_set_page_digests(
+                                &_state, _page_digests, IMG_PAGES, _root));
+    TEST_ASSERT_EQUAL_INT(0, _write(NO_CORRUPT));
+    TEST_ASSERT_EQUAL_INT(0, riotboot_flashwrite_verify_sha256_streamed(
+                                &_state, _digest, IMG_LEN));
+    TEST_ASSERT(_flash_matches(RIOTBOOT_FLASHWRITE_SKIPLEN, IMG_LEN));
+}
+
+static void test_flashwrite__pages_corrupted(void)
+{
+    unsigned first = _state.flashpage;
+
+    /* the good image is in flash before */
+    TEST_ASSERT_EQUAL_INT(0, _write(NO_CORRUPT));
+    riotboot_flashwrite_init(&_state, riotboot_slot_other());
+    TEST_ASSERT_EQUAL_INT(0, riotboot_flashwrite_set_page_digests(
+                                &_state, _page_digests, IMG_PAGES, _root));
+    TEST_ASSERT_EQUAL_INT(-1, _write(FLASHPAGE_SIZE + 10));
+    /* the update stopped at the corrupted page without writing it */
+    TEST_ASSERT_EQUAL_INT(first + 1, _state.flashpage);
+    TEST_ASSERT(_flash_matches(FLASHPAGE_SIZE, 2 * FLASHPAGE_SIZE));
+}
+
+static Test *tests_riotboot_flashwrite(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_flashwrite__streamed),
+        new_TestFixture(test_flashwrite__streamed_mismatch),
+        new_TestFixture(test_flashwrite__streamed_corrupted),
+        new_TestFixture(test_flashwrite__streamed_len),
+        new_TestFixture(test_flashwrite__magic),
+        new_TestFixture(test_flashwrite__page_digests_root),
+        new_TestFixture(test_flashwrite__pages),
+        new_TestFixture(test_flashwrite__pages_corrupted),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    sha256_context_t ctx;
+
+    for (unsigned page = 0; page < IMG_PAGES; page++) {
+        size_t start = page * FLASHPAGE_SIZE;
+        size_t end = start + FLASHPAGE_SIZE;
+
+        /* the first page is put without the magic number */
+        if (start < RIOTBOOT_FLASHWRITE_SKIPLEN) {
+            start = RIOTBOOT_FLASHWRITE_SKIPLEN;
+        }
+        if (end > IMG_LEN) {
+            end = IMG_LEN;
+        }
+        sha256_init(&ctx);
+        _hash_img(&ctx, start, end);
+        sha256_final(&ctx, &_page_digests[page * SHA256_DIGEST_LENGTH]);
+    }
+    sha256(_page_digests, sizeof(_page_digests), _root);
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, "RIOT", RIOTBOOT_FLASHWRITE_SKIPLEN);
+    _hash_img(&ctx, RIOTBOOT_FLASHWRITE_SKIPLEN, IMG_LEN);
+    sha256_final(&ctx, _digest);
+
+    sha256_init(&ctx);
+    _hash_img(&ctx, RIOTBOOT_FLASHWRITE_SKIPLEN, IMG_LEN);
+    sha256_final(&ctx, _digest_nomagic);
+
+    TESTS_START();
+    TESTS_RUN(tests_riotboot_flashwrite());
+    TESTS_END();
+
+    return 0;
+}
@@ -23,6 +23,7 @@ int main(void)
     TESTS_RUN(tests_crypto_modes_ecb_tests());
     TESTS_RUN(tests_crypto_modes_cbc_tests());
     TESTS_RUN(tests_crypto_modes_ctr_tests());
+    TESTS_RUN(tests_crypto_modes_gcm_tests());
     TESTS_END();
     return 0;
 }
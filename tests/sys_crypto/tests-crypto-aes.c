@@ -86,6 +86,38 @@ static void test_crypto_aes_decrypt(void)
                                      AES_BLOCK_SIZE), "wrong plaintext");
 }
 
+static void test_crypto_aes_encrypt_blocks(void)
+{
+    cipher_context_t ctx;
+    int err;
+    /* more blocks than any implementation processes at once */
+    uint8_t data[5 * AES_BLOCK_SIZE];
+
+    for (unsigned i = 0; i < 5; i++) {
+        memcpy(&data[i * AES_BLOCK_SIZE], (i % 2) ? TEST_0_ENC : TEST_0_INP,
+               AES_BLOCK_SIZE);
+    }
+
+    err = aes_init(&ctx, TEST_0_KEY, sizeof(TEST_0_KEY));
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    /* encrypt in place, blocks 1 and 3 are decrypted afterwards */
+    err = aes_encrypt_blocks(&ctx, data, data, 5);
+    TEST_ASSERT_EQUAL_INT(1, err);
+    for (unsigned i = 0; i < 5; i += 2) {
+        TEST_ASSERT_MESSAGE(1 == compare(TEST_0_ENC, &data[i * AES_BLOCK_SIZE],
+                                         AES_BLOCK_SIZE), "wrong ciphertext");
+    }
+
+    err = aes_decrypt_blocks(&ctx, data, data, 5);
+    TEST_ASSERT_EQUAL_INT(1, err);
+    for (unsigned i = 0; i < 5; i++) {
+        TEST_ASSERT_MESSAGE(1 == compare((i % 2) ? TEST_0_ENC : TEST_0_INP,
+                                         &data[i * AES_BLOCK_SIZE],
+                                         AES_BLOCK_SIZE), "wrong plaintext");
+    }
+}
+
 static void test_crypto_aes_init_key_length(void)
 {
     cipher_context_t ctx;
@@ -119,6 +151,7 @@ Test *tests_crypto_aes_tests(void)
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_crypto_aes_encrypt),
         new_TestFixture(test_crypto_aes_decrypt),
+        new_TestFixture(test_crypto_aes_encrypt_blocks),
         new_TestFixture(test_crypto_aes_init_key_length),
     };
 
@@ -131,12 +131,71 @@ static void test_crypto_chacha20_tc8(void)
                         TC8_CHACHA20_BLOCK0, TC8_CHACHA20_BLOCK1);
 }
 
+static void test_crypto_chacha_keystream_blocks(void)
+{
+    chacha_ctx ctx, ref;
+    uint8_t blocks[1 + 7 * CHACHA_BLOCK_SIZE];
+    uint8_t block[CHACHA_BLOCK_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(0, chacha_init(&ctx, 20, TC8_KEY, 16, TC8_IV));
+    chacha_keystream_blocks(&ctx, blocks, 2);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(blocks, TC8_CHACHA20_BLOCK0, 64));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&blocks[64], TC8_CHACHA20_BLOCK1, 64));
+
+    /* the block counter overflows into the high word within the blocks,
+     * which are written to an unaligned buffer */
+    ctx.state[12] = 0xfffffffd;
+    ref = ctx;
+    chacha_keystream_blocks(&ctx, &blocks[1], 7);
+    for (unsigned i = 0; i < 7; i++) {
+        chacha_keystream_bytes(&ref, block);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(&blocks[1 + i * CHACHA_BLOCK_SIZE],
+                                        block, CHACHA_BLOCK_SIZE));
+    }
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&ctx, &ref, sizeof(ctx)));
+    TEST_ASSERT_EQUAL_INT(0x00000004, ctx.state[12]);
+    TEST_ASSERT_EQUAL_INT(0x00000001, ctx.state[13]);
+}
+
+static void test_crypto_chacha_encrypt_buf(void)
+{
+    chacha_ctx ctx, ref;
+    uint8_t data[5 * CHACHA_BLOCK_SIZE + 13];
+    uint8_t block[CHACHA_BLOCK_SIZE];
+
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+    TEST_ASSERT_EQUAL_INT(0, chacha_init(&ctx, 12, TC8_KEY, 32, TC8_IV));
+    ref = ctx;
+
+    /* in place */
+    chacha_encrypt_buf(&ctx, data, data, sizeof(data));
+    for (unsigned i = 0; i < sizeof(data); i += CHACHA_BLOCK_SIZE) {
+        chacha_keystream_bytes(&ref, block);
+        for (unsigned j = 0; (j < CHACHA_BLOCK_SIZE) && (i + j < sizeof(data));
+             j++) {
+            TEST_ASSERT_EQUAL_INT((uint8_t)(i + j) ^ block[j], data[i + j]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&ctx, &ref, sizeof(ctx)));
+
+    /* decrypting with a reset counter restores the input */
+    ctx.state[12] = 0;
+    chacha_decrypt_buf(&ctx, data, data, sizeof(data));
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        TEST_ASSERT_EQUAL_INT((uint8_t)i, data[i]);
+    }
+}
+
 Test *tests_crypto_chacha_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_crypto_chacha8_tc8),
         new_TestFixture(test_crypto_chacha12_tc8),
         new_TestFixture(test_crypto_chacha20_tc8),
+        new_TestFixture(test_crypto_chacha_keystream_blocks),
+        new_TestFixture(test_crypto_chacha_encrypt_buf),
     };
     EMB_UNIT_TESTCALLER(crypto_chacha_tests, NULL, NULL, fixtures);
     return (Test *)&crypto_chacha_tests;
@@ -113,12 +113,30 @@ static void test_crypto_modes_cbc_decrypt(void)
                     TEST_1_CIPHER_LEN, TEST_1_PLAIN, TEST_1_PLAIN_LEN);
 }
 
+static void test_crypto_modes_cbc_decrypt_in_place(void)
+{
+    cipher_t cipher;
+    int len, err, cmp;
+    uint8_t data[64];
+
+    memcpy(data, TEST_1_CIPHER, TEST_1_CIPHER_LEN);
+    err = cipher_init(&cipher, CIPHER_AES_128, TEST_1_KEY, TEST_1_KEY_LEN);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    len = cipher_decrypt_cbc(&cipher, TEST_1_IV, data, TEST_1_CIPHER_LEN,
+                             data);
+    TEST_ASSERT_EQUAL_INT(TEST_1_PLAIN_LEN, len);
+    cmp = compare(TEST_1_PLAIN, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp, "wrong plaintext");
+}
+
 
 Test *tests_crypto_modes_cbc_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_crypto_modes_cbc_encrypt),
-        new_TestFixture(test_crypto_modes_cbc_decrypt)
+        new_TestFixture(test_crypto_modes_cbc_decrypt),
+        new_TestFixture(test_crypto_modes_cbc_decrypt_in_place)
     };
 
     EMB_UNIT_TESTCALLER(crypto_modes_cbc_tests, NULL, NULL, fixtures);
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "crypto/ciphers.h"
+#include "crypto/modes/gcm.h"
+#include "tests-crypto.h"
+
+/* Test vectors from "The Galois/Counter Mode of Operation (GCM)" by McGrew and
+ * Viega, Appendix B, test cases 1 to 6. Test case 6 uses the 60 byte nonce. */
+
+static uint8_t TEST_ZERO_KEY[16];
+
+static uint8_t TEST_KEY[] = {
+    0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C,
+    0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08
+};
+static uint8_t TEST_KEY_LEN = 16;
+
+static uint8_t TEST_ZERO_NONCE[12];
+
+static uint8_t TEST_NONCE[] = {
+    0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD,
+    0xDE, 0xCA, 0xF8, 0x88
+};
+
+static uint8_t TEST_LONG_NONCE[] = {
+    0x93, 0x13, 0x22, 0x5D, 0xF8, 0x84, 0x06, 0xE5,
+    0x55, 0x90, 0x9C, 0x5A, 0xFF, 0x52, 0x69, 0xAA,
+    0x6A, 0x7A, 0x95, 0x38, 0x53, 0x4F, 0x7D, 0xA1,
+    0xE4, 0xC3, 0x03, 0xD2, 0xA3, 0x18, 0xA7, 0x28,
+    0xC3, 0xC0, 0xC9, 0x51, 0x56, 0x80, 0x95, 0x39,
+    0xFC, 0xF0, 0xE2, 0x42, 0x9A, 0x6B, 0x52, 0x54,
+    0x16, 0xAE, 0xDB, 0xF5, 0xA0, 0xDE, 0x6A, 0x57,
+    0xA6, 0x37, 0xB3, 0x9B
+};
+
+static uint8_t TEST_ZERO_INPUT[16];
+
+static uint8_t TEST_INPUT[] = {
+    0xD9, 0x31, 0x32, 0x25, 0xF8, 0x84, 0x06, 0xE5,
+    0xA5, 0x59, 0x09, 0xC5, 0xAF, 0xF5, 0x26, 0x9A,
+    0x86, 0xA7, 0xA9, 0x53, 0x15, 0x34, 0xF7, 0xDA,
+    0x2E, 0x4C, 0x30, 0x3D, 0x8A, 0x31, 0x8A, 0x72,
+    0x1C, 0x3C, 0x0C, 0x95, 0x95, 0x68, 0x09, 0x53,
+    0x2F, 0xCF, 0x0E, 0x24, 0x49, 0xA6, 0xB5, 0x25,
+    0xB1, 0x6A, 0xED, 0xF5, 0xAA, 0x0D, 0xE6, 0x57,
+    0xBA, 0x63, 0x7B, 0x39, 0x1A, 0xAF, 0xD2, 0x55
+};
+
+static uint8_t TEST_ADATA[] = {
+    0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+    0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+    0xAB, 0xAD, 0xDA, 0xD2
+};
+
+/* Test case 1: K = 0, N = 0, A and P empty */
+static uint8_t *TEST_1_KEY = TEST_ZERO_KEY;
+static uint8_t *TEST_1_NONCE = TEST_ZERO_NONCE;
+static size_t TEST_1_NONCE_LEN = sizeof(TEST_ZERO_NONCE);
+static uint8_t *TEST_1_ADATA;
+static size_t TEST_1_ADATA_LEN = 0;
+static uint8_t *TEST_1_INPUT;
+static size_t TEST_1_INPUT_LEN = 0;
+static uint8_t TEST_1_EXPECTED[] = {
+    0x58, 0xE2, 0xFC, 0xCE, 0xFA, 0x7E, 0x30, 0x61,
+    0x36, 0x7F, 0x1D, 0x57, 0xA4, 0xE7, 0x45, 0x5A
+};
+static size_t TEST_1_EXPECTED_LEN = sizeof(TEST_1_EXPECTED);
+
+/* Test case 2: K = 0, N = 0, A empty, P = 0 */
+static uint8_t *TEST_2_KEY = TEST_ZERO_KEY;
+static uint8_t *TEST_2_NONCE = TEST_ZERO_NONCE;
+static size_t TEST_2_NONCE_LEN = sizeof(TEST_ZERO_NONCE);
+static uint8_t *TEST_2_ADATA;
+static size_t TEST_2_ADATA_LEN = 0;
+static uint8_t *TEST_2_INPUT = TEST_ZERO_INPUT;
+static size_t TEST_2_INPUT_LEN = sizeof(TEST_ZERO_INPUT);
+static uint8_t TEST_2_EXPECTED[] = {
+    0x03, 0x88, 0xDA, 0xCE, 0x60, 0xB6, 0xA3, 0x92,
+    0xF3, 0x28, 0xC2, 0xB9, 0x71, 0xB2, 0xFE, 0x78,
+    0xAB, 0x6E, 0x47, 0xD4, 0x2C, 0xEC, 0x13, 0xBD,
+    0xF5, 0x3A, 0x67, 0xB2, 0x12, 0x57, 0xBD, 0xDF
+};
+static size_t TEST_2_EXPECTED_LEN = sizeof(TEST_2_EXPECTED);
+
+/* Test case 3: A empty, 64 bytes of P */
+static uint8_t *TEST_3_KEY = TEST_KEY;
+static uint8_t *TEST_3_NONCE = TEST_NONCE;
+static size_t TEST_3_NONCE_LEN = sizeof(TEST_NONCE);
+static uint8_t *TEST_3_ADATA;
+static size_t TEST_3_ADATA_LEN = 0;
+static uint8_t *TEST_3_INPUT = TEST_INPUT;
+static size_t TEST_3_INPUT_LEN = sizeof(TEST_INPUT);
+static uint8_t TEST_3_EXPECTED[] = {
+    0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24,
+    0x4B, 0x72, 0x21, 0xB7, 0x84, 0xD0, 0xD4, 0x9C,
+    0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0,
+    0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E,
+    0x21, 0xD5, 0x14, 0xB2, 0x54, 0x66, 0x93, 0x1C,
+    0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+    0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97,
+    0x3D, 0x58, 0xE0, 0x91, 0x47, 0x3F, 0x59, 0x85,
+    0x4D, 0x5C, 0x2A, 0xF3, 0x27, 0xCD, 0x64, 0xA6,
+    0x2C, 0xF3, 0x5A, 0xBD, 0x2B, 0xA6, 0xFA, 0xB4
+};
+static size_t TEST_3_EXPECTED_LEN = sizeof(TEST_3_EXPECTED);
+
+/* Test case 4: 20 bytes of A, 60 bytes of P */
+static uint8_t *TEST_4_KEY = TEST_KEY;
+static uint8_t *TEST_4_NONCE = TEST_NONCE;
+static size_t TEST_4_NONCE_LEN = sizeof(TEST_NONCE);
+static uint8_t *TEST_4_ADATA = TEST_ADATA;
+static size_t TEST_4_ADATA_LEN = sizeof(TEST_ADATA);
+static uint8_t *TEST_4_INPUT = TEST_INPUT;
+static size_t TEST_4_INPUT_LEN = 60;
+static uint8_t TEST_4_EXPECTED[] = {
+    0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24,
+    0x4B, 0x72, 0x21, 0xB7, 0x84, 0xD0, 0xD4, 0x9C,
+    0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0,
+    0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E,
+    0x21, 0xD5, 0x14, 0xB2, 0x54, 0x66, 0x93, 0x1C,
+    0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+    0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97,
+    0x3D, 0x58, 0xE0, 0x91,
+    0x5B, 0xC9, 0x4F, 0xBC, 0x32, 0x21, 0xA5, 0xDB,
+    0x94, 0xFA, 0xE9, 0x5A, 0xE7, 0x12, 0x1A, 0x47
+};
+static size_t TEST_4_EXPECTED_LEN = sizeof(TEST_4_EXPECTED);
+
+/* Test case 5: as test case 4, but with an 8 byte nonce */
+static uint8_t *TEST_5_KEY = TEST_KEY;
+static uint8_t *TEST_5_NONCE = TEST_NONCE;
+static size_t TEST_5_NONCE_LEN = 8;
+static uint8_t *TEST_5_ADATA = TEST_ADATA;
+static size_t TEST_5_ADATA_LEN = sizeof(TEST_ADATA);
+static uint8_t *TEST_5_INPUT = TEST_INPUT;
+static size_t TEST_5_INPUT_LEN = 60;
+static uint8_t TEST_5_EXPECTED[] = {
+    0x61, 0x35, 0x3B, 0x4C, 0x28, 0x06, 0x93, 0x4A,
+    0x77, 0x7F, 0xF5, 0x1F, 0xA2, 0x2A, 0x47, 0x55,
+    0x69, 0x9B, 0x2A, 0x71, 0x4F, 0xCD, 0xC6, 0xF8,
+    0x37, 0x66, 0xE5, 0xF9, 0x7B, 0x6C, 0x74, 0x23,
+    0x73, 0x80, 0x69, 0x00, 0xE4, 0x9F, 0x24, 0xB2,
+    0x2B, 0x09, 0x75, 0x44, 0xD4, 0x89, 0x6B, 0x42,
+    0x49, 0x89, 0xB5, 0xE1, 0xEB, 0xAC, 0x0F, 0x07,
+    0xC2, 0x3F, 0x45, 0x98,
+    0x36, 0x12, 0xD2, 0xE7, 0x9E, 0x3B, 0x07, 0x85,
+    0x56, 0x1B, 0xE1, 0x4A, 0xAC, 0xA2, 0xFC, 0xCB
+};
+static size_t TEST_5_EXPECTED_LEN = sizeof(TEST_5_EXPECTED);
+
+/* Test case 6: as test case 4, but with a 60 byte nonce */
+static uint8_t *TEST_6_KEY = TEST_KEY;
+static uint8_t *TEST_6_NONCE = TEST_LONG_NONCE;
+static size_t TEST_6_NONCE_LEN = sizeof(TEST_LONG_NONCE);
+static uint8_t *TEST_6_ADATA = TEST_ADATA;
+static size_t TEST_6_ADATA_LEN = sizeof(TEST_ADATA);
+static uint8_t *TEST_6_INPUT = TEST_INPUT;
+static size_t TEST_6_INPUT_LEN = 60;
+static uint8_t TEST_6_EXPECTED[] = {
+    0x8C, 0xE2, 0x49, 0x98, 0x62, 0x56, 0x15, 0xB6,
+    0x03, 0xA0, 0x33, 0xAC, 0xA1, 0x3F, 0xB8, 0x94,
+    0xBE, 0x91, 0x12, 0xA5, 0xC3, 0xA2, 0x11, 0xA8,
+    0xBA, 0x26, 0x2A, 0x3C, 0xCA, 0x7E, 0x2C, 0xA7,
+    0x01, 0xE4, 0xA9, 0xA4, 0xFB, 0xA4, 0x3C, 0x90,
+    0xCC, 0xDC, 0xB2, 0x81, 0xD4, 0x8C, 0x7C, 0x6F,
+    0xD6, 0x28, 0x75, 0xD2, 0xAC, 0xA4, 0x17, 0x03,
+    0x4C, 0x34, 0xAE, 0xE5,
+    0x61, 0x9C, 0xC5, 0xAE, 0xFF, 0xFE, 0x0B, 0xFA,
+    0x46, 0x2A, 0xF4, 0x3C, 0x16, 0x99, 0xD0, 0x50
+};
+static size_t TEST_6_EXPECTED_LEN = sizeof(TEST_6_EXPECTED);
+
+static uint8_t TEST_TAG_LEN = 16;
+
+/* Share test buffer output */
+static uint8_t data[80];
+
+static void test_encrypt_op(uint8_t *key, uint8_t key_len,
+                            uint8_t *adata, size_t adata_len,
+                            uint8_t *nonce, size_t nonce_len,
+                            uint8_t *plain, size_t plain_len,
+                            uint8_t *output_expected,
+                            size_t output_expected_len)
+{
+    cipher_t cipher;
+    int len, err, cmp;
+
+    TEST_ASSERT_MESSAGE(sizeof(data) >= output_expected_len,
+                        "Output buffer too small");
+
+    err = cipher_init(&cipher, CIPHER_AES_128, key, key_len);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    len = cipher_encrypt_gcm(&cipher, adata, adata_len, TEST_TAG_LEN,
+                             nonce, nonce_len, plain, plain_len, data);
+    TEST_ASSERT_EQUAL_INT(output_expected_len, len);
+    cmp = compare(output_expected, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp, "wrong ciphertext");
+
+    /* a truncated tag is the prefix of the full tag */
+    len = cipher_encrypt_gcm(&cipher, adata, adata_len, 12,
+                             nonce, nonce_len, plain, plain_len, data);
+    TEST_ASSERT_EQUAL_INT(output_expected_len - 4, len);
+    cmp = compare(output_expected, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp, "wrong truncated tag");
+
+    /* in place, plain is NULL for the empty plaintext */
+    if (plain_len > 0) {
+        memcpy(data, plain, plain_len);
+    }
+    len = cipher_encrypt_gcm(&cipher, adata, adata_len, TEST_TAG_LEN,
+                             nonce, nonce_len, data, plain_len, data);
+    TEST_ASSERT_EQUAL_INT(output_expected_len, len);
+    cmp = compare(output_expected, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp, "wrong ciphertext in place");
+}
+
+#define do_test_encrypt_op(name) do { \
+        test_encrypt_op(TEST_ ## name ## _KEY, TEST_KEY_LEN, \
+                        TEST_ ## name ## _ADATA, TEST_ ## name ## _ADATA_LEN, \
+                        TEST_ ## name ## _NONCE, TEST_ ## name ## _NONCE_LEN, \
+                        TEST_ ## name ## _INPUT, TEST_ ## name ## _INPUT_LEN, \
+                        TEST_ ## name ## _EXPECTED, \
+                        TEST_ ## name ## _EXPECTED_LEN); \
+} while (0)
+
+static void test_crypto_modes_gcm_encrypt(void)
+{
+    do_test_encrypt_op(1);
+    do_test_encrypt_op(2);
+    do_test_encrypt_op(3);
+    do_test_encrypt_op(4);
+    do_test_encrypt_op(5);
+    do_test_encrypt_op(6);
+}
+
+static void test_decrypt_op(uint8_t *key, uint8_t key_len,
+                            uint8_t *adata, size_t adata_len,
+                            uint8_t *nonce, size_t nonce_len,
+                            uint8_t *encrypted, size_t encrypted_len,
+                            uint8_t *output_expected,
+                            size_t output_expected_len)
+{
+    cipher_t cipher;
+    int len, err, cmp;
+
+    TEST_ASSERT_MESSAGE(sizeof(data) >= encrypted_len,
+                        "Output buffer too small");
+
+    err = cipher_init(&cipher, CIPHER_AES_128, key, key_len);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    len = cipher_decrypt_gcm(&cipher, adata, adata_len, TEST_TAG_LEN,
+                             nonce, nonce_len, encrypted, encrypted_len, data);
+    TEST_ASSERT_EQUAL_INT(output_expected_len, len);
+    cmp = compare(output_expected, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp, "wrong plaintext");
+
+    /* in place */
+    memcpy(data, encrypted, encrypted_len);
+    len = cipher_decrypt_gcm(&cipher, adata, adata_len, TEST_TAG_LEN,
+                             nonce, nonce_len, data, encrypted_len, data);
+    TEST_ASSERT_EQUAL_INT(output_expected_len, len);
+    cmp = compare(output_expected, data, len);
+    TEST_ASSERT_MESSAGE(1 == cmp, "wrong plaintext in place");
+
+    /* do some negative tests for the tag verification */
+    if (adata_len > 0) {
+        /* Drop one byte of auth data */
+        len = cipher_decrypt_gcm(&cipher, adata, adata_len - 1, TEST_TAG_LEN,
+                                 nonce, nonce_len, encrypted, encrypted_len,
+                                 data);
+        TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG, len);
+    }
+    /* Alter one byte of the nonce */
+    nonce[0] = nonce[0] ^ 0x01;
+    len = cipher_decrypt_gcm(&cipher, adata, adata_len, TEST_TAG_LEN,
+                             nonce, nonce_len, encrypted, encrypted_len, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG, len);
+    nonce[0] = nonce[0] ^ 0x01;
+    /* Alter one byte of the tag */
+    encrypted[encrypted_len - 1] = encrypted[encrypted_len - 1] ^ 0x01;
+    len = cipher_decrypt_gcm(&cipher, adata, adata_len, TEST_TAG_LEN,
+                             nonce, nonce_len, encrypted, encrypted_len, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG, len);
+    encrypted[encrypted_len - 1] = encrypted[encrypted_len - 1] ^ 0x01;
+    if (output_expected_len > 0) {
+        /* Alter one byte of the ciphertext, the plaintext must be wiped */
+        encrypted[0] = encrypted[0] ^ 0x01;
+        len = cipher_decrypt_gcm(&cipher, adata, adata_len, TEST_TAG_LEN,
+                                 nonce, nonce_len, encrypted, encrypted_len,
+                                 data);
+        TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG, len);
+        encrypted[0] = encrypted[0] ^ 0x01;
+        for (size_t i = 0; i < output_expected_len; ++i) {
+            TEST_ASSERT_EQUAL_INT(0, data[i]);
+        }
+    }
+}
+
+#define do_test_decrypt_op(name) do { \
+        test_decrypt_op(TEST_ ## name ## _KEY, TEST_KEY_LEN, \
+                        TEST_ ## name ## _ADATA, TEST_ ## name ## _ADATA_LEN, \
+                        TEST_ ## name ## _NONCE, TEST_ ## name ## _NONCE_LEN, \
+                        TEST_ ## name ## _EXPECTED, \
+                        TEST_ ## name ## _EXPECTED_LEN, \
+                        TEST_ ## name ## _INPUT, TEST_ ## name ## _INPUT_LEN); \
+} while (0)
+
+static void test_crypto_modes_gcm_decrypt(void)
+{
+    do_test_decrypt_op(1);
+    do_test_decrypt_op(2);
+    do_test_decrypt_op(3);
+    do_test_decrypt_op(4);
+    do_test_decrypt_op(5);
+    do_test_decrypt_op(6);
+}
+
+static void test_crypto_modes_gcm_bad_params(void)
+{
+    cipher_t cipher;
+    int len, err;
+
+    err = cipher_init(&cipher, CIPHER_AES_128, TEST_KEY, TEST_KEY_LEN);
+    TEST_ASSERT_EQUAL_INT(1, err);
+
+    len = cipher_encrypt_gcm(&cipher, NULL, 0, 10, TEST_NONCE,
+                             sizeof(TEST_NONCE), TEST_INPUT, 16, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG_LENGTH, len);
+    len = cipher_encrypt_gcm(&cipher, NULL, 0, 17, TEST_NONCE,
+                             sizeof(TEST_NONCE), TEST_INPUT, 16, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_TAG_LENGTH, len);
+    len = cipher_encrypt_gcm(&cipher, NULL, 0, TEST_TAG_LEN, TEST_NONCE, 0,
+                             TEST_INPUT, 16, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_NONCE_LENGTH, len);
+    len = cipher_decrypt_gcm(&cipher, NULL, 0, TEST_TAG_LEN, TEST_NONCE,
+                             sizeof(TEST_NONCE), TEST_INPUT, 8, data);
+    TEST_ASSERT_EQUAL_INT(GCM_ERR_INVALID_DATA_LENGTH, len);
+}
+
+Test *tests_crypto_modes_gcm_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_crypto_modes_gcm_encrypt),
+        new_TestFixture(test_crypto_modes_gcm_decrypt),
+        new_TestFixture(test_crypto_modes_gcm_bad_params),
+    };
+
+    EMB_UNIT_TESTCALLER(crypto_modes_gcm_tests, NULL, NULL, fixtures);
+
+    return (Test *)&crypto_modes_gcm_tests;
+}
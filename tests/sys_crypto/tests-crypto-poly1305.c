@@ -215,9 +215,23 @@ static void _test_poly1305(const uint8_t *key, const uint8_t *msg, size_t msglen
     uint8_t gen_tag[16];
 
     poly1305_auth(gen_tag, msg, msglen, key);
-    for (unsigned i = 0; i < sizeof(tag); i++) {
+    for (unsigned i = 0; i < sizeof(gen_tag); i++) {
         TEST_ASSERT_EQUAL_INT(gen_tag[i], tag[i]);
     }
+
+    /* the same in chunks of different sizes, which may or may not complete
+     * a buffered block */
+    for (size_t chunk = 1; chunk < 2 * POLY1305_BLOCK_SIZE; chunk += 3) {
+        poly1305_ctx_t ctx;
+
+        poly1305_init(&ctx, key);
+        for (size_t pos = 0; pos < msglen; pos += chunk) {
+            poly1305_update(&ctx, &msg[pos],
+                            (msglen - pos < chunk) ? msglen - pos : chunk);
+        }
+        poly1305_finish(&ctx, gen_tag);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(gen_tag, tag, sizeof(gen_tag)));
+    }
 }
 
 static void test_crypto_poly1305_1(void)
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the dispatch of crypto operations to the mock
+ *              accelerator
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "crypto/accel.h"
+#include "crypto/aes.h"
+#include "crypto/ciphers.h"
+#include "crypto_accel_mock.h"
+#include "embUnit.h"
+#include "hashes/sha256.h"
+
+static const uint8_t aes_key[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t aes_plain[] = {
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+};
+static const uint8_t aes_cipher[] = {
+    0x37, 0x29, 0xa3, 0x6c, 0xaf, 0xe9, 0x84, 0xff,
+    0x46, 0x22, 0x70, 0x42, 0xee, 0x24, 0x83, 0xf6
+};
+
+/* sha256("abc") */
+static const uint8_t sha256_abc[] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+    0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+    0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+/* hmac_sha256("key", "The quick brown fox jumps over the lazy dog") */
+static const char hmac_msg[] = "The quick brown fox jumps over the lazy dog";
+static const uint8_t hmac_fox[] = {
+    0xf7, 0xbc, 0x83, 0xf4, 0x30, 0x53, 0x84, 0x24,
+    0xb1, 0x32, 0x98, 0xe6, 0xaa, 0x6f, 0xb1, 0x43,
+    0xef, 0x4d, 0x59, 0xa1, 0x49, 0x46, 0x17, 0x59,
+    0x97, 0x47, 0x9d, 0xbc, 0x2d, 0x1a, 0x3c, 0xd8
+};
+
+static void test_crypto_accel_cipher(void)
+{
+    cipher_t cipher;
+    uint8_t data[4 * AES_BLOCK_SIZE], out[4 * AES_BLOCK_SIZE];
+    crypto_accel_mock_calls_t calls = crypto_accel_mock_calls;
+
+    TEST_ASSERT_EQUAL_INT(1, cipher_init(&cipher, CIPHER_AES_128, aes_key,
+                                         sizeof(aes_key)));
+    TEST_ASSERT(cipher.interface == crypto_accel_mock.aes_128);
+    TEST_ASSERT_EQUAL_INT(calls.aes_128_init + 1,
+                          crypto_accel_mock_calls.aes_128_init);
+
+    TEST_ASSERT_EQUAL_INT(1, cipher_encrypt(&cipher, aes_plain, out));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, aes_cipher, sizeof(aes_cipher)));
+
+    for (unsigned i = 0; i < 4; i++) {
+        memcpy(&data[i * AES_BLOCK_SIZE], aes_plain, AES_BLOCK_SIZE);
+    }
+    TEST_ASSERT_EQUAL_INT(1, cipher_encrypt_blocks(&cipher, data, out, 4));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&out[3 * AES_BLOCK_SIZE], aes_cipher,
+                                    sizeof(aes_cipher)));
+    TEST_ASSERT_EQUAL_INT(1, cipher_decrypt_blocks(&cipher, out, out, 4));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(calls.aes_128_blocks + 9,
+                          crypto_accel_mock_calls.aes_128_blocks);
+}
+
+static void test_crypto_accel_cipher_not_accelerated(void)
+{
+    static const cipher_interface_t other = { 0 };
+
+    TEST_ASSERT(crypto_accel_cipher(&other) == &other);
+}
+
+static void test_crypto_accel_sha256(void)
+{
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    crypto_accel_mock_calls_t calls = crypto_accel_mock_calls;
+
+    sha256("abc", 3, digest);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(digest, sha256_abc, sizeof(digest)));
+    TEST_ASSERT_EQUAL_INT(calls.sha256_blocks + 1,
+                          crypto_accel_mock_calls.sha256_blocks);
+
+    /* two blocks for the inner and the outer hash each */
+    hmac_sha256("key", 3, hmac_msg, sizeof(hmac_msg) - 1, digest);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(digest, hmac_fox, sizeof(digest)));
+    TEST_ASSERT_EQUAL_INT(calls.sha256_blocks + 5,
+                          crypto_accel_mock_calls.sha256_blocks);
+}
+
+static void test_crypto_accel_priority(void)
+{
+    static const crypto_accel_t lower = {
+        .name = "lower",
+        .priority = CRYPTO_ACCEL_MOCK_PRIORITY - 1,
+        .sha256 = sha256_blocks_sw,
+    };
+
+    crypto_accel_register(&lower);
+    TEST_ASSERT(crypto_accel_sha256() == crypto_accel_mock.sha256);
+}
+
+static Test *tests_crypto_accel_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_crypto_accel_cipher),
+        new_TestFixture(test_crypto_accel_cipher_not_accelerated),
+        new_TestFixture(test_crypto_accel_sha256),
+        new_TestFixture(test_crypto_accel_priority),
+    };
+
+    EMB_UNIT_TESTCALLER(crypto_accel_tests, NULL, NULL, fixtures);
+
+    return (Test *)&crypto_accel_tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_crypto_accel_tests());
+    TESTS_END();
+    return 0;
+}
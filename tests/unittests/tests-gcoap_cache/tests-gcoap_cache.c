@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/coap.h"
+#include "net/gcoap.h"
+#include "net/nanocoap.h"
+#include "cache.h"
+
+#include "tests-gcoap_cache.h"
+
+#define NO_MAX_AGE      (-1)
+#define BUF_SIZE        (256U)
+
+static const uint8_t _etag[] = { 0x12, 0x34 };
+static uint8_t _token[] = { 0xab, 0xcd };
+
+static uint8_t _buf[BUF_SIZE];
+static coap_pkt_t _pdu;
+static uint16_t _msg_id;
+
+/* passes a request to the cache like gcoap does, returns the length of the
+ * cached response in _buf */
+static ssize_t _request(unsigned method, const char *path, bool etag,
+                        bool observe)
+{
+    uint8_t *pos = _buf;
+    uint16_t lastonum = 0;
+
+    pos += coap_build_hdr((coap_hdr_t *)_buf, COAP_TYPE_CON, _token,
+                          sizeof(_token), method, ++_msg_id);
+    if (etag) {
+        pos += coap_put_option(pos, lastonum, COAP_OPT_ETAG, _etag,
+                               sizeof(_etag));
+        lastonum = COAP_OPT_ETAG;
+    }
+    if (observe) {
+        pos += coap_put_option(pos, lastonum, COAP_OPT_OBSERVE, NULL, 0);
+        lastonum = COAP_OPT_OBSERVE;
+    }
+    pos += coap_opt_put_uri_path(pos, lastonum, path);
+
+    if (coap_parse(&_pdu, _buf, pos - _buf) < 0) {
+        return -1;
+    }
+    return gcoap_cache_get(&_pdu, _buf, sizeof(_buf));
+}
+
+/* passes the response of a resource handler to the cache */
+static void _respond(unsigned code, int max_age, const char *payload)
+{
+    uint8_t *pos = _buf;
+    uint8_t value = max_age;
+
+    pos += coap_build_hdr((coap_hdr_t *)_buf, COAP_TYPE_ACK, _token,
+                          sizeof(_token), code, _msg_id);
+    pos += coap_put_option(pos, 0, COAP_OPT_ETAG, _etag, sizeof(_etag));
+    if (max_age != NO_MAX_AGE) {
+        pos += coap_put_option(pos, COAP_OPT_ETAG, COAP_OPT_MAX_AGE, &value,
+                               max_age ? 1 : 0);
+    }
+    if (payload) {
+        *pos++ = 0xff;
+        memcpy(pos, payload, strlen(payload));
+        pos += strlen(payload);
+    }
+    gcoap_cache_put(_buf, pos - _buf);
+}
+
+/* requests and caches a resource */
+static void _cache(const char *path, const char *payload)
+{
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_GET, path, false, false));
+    _respond(COAP_CODE_CONTENT, 30, payload);
+}
+
+static bool _cached(const char *path)
+{
+    return _request(COAP_METHOD_GET, path, false, false) > 0;
+}
+
+static void test_gcoap_cache__hit(void)
+{
+    coap_pkt_t resp;
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t res;
+
+    _cache("/hit", "hello");
+    res = _request(COAP_METHOD_GET, "/hit", false, false);
+    TEST_ASSERT(res > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&resp, _buf, res));
+    TEST_ASSERT_EQUAL_INT(205, coap_get_code(&resp));
+    TEST_ASSERT_EQUAL_INT(COAP_TYPE_ACK, coap_get_type(&resp));
+    TEST_ASSERT_EQUAL_INT(_msg_id, coap_get_id(&resp));
+    TEST_ASSERT_EQUAL_INT(sizeof(_token), coap_get_token_len(&resp));
+    TEST_ASSERT_EQUAL_INT(5, resp.payload_len);
+    TEST_ASSERT(memcmp(resp.payload, "hello", 5) == 0);
+    /* Max-Age counts down the remaining freshness */
+    TEST_ASSERT_EQUAL_INT(1, coap_opt_get_next_by_num(&resp, &opt,
+                                                      COAP_OPT_MAX_AGE,
+                                                      &value, true));
+    TEST_ASSERT(value[0] <= 30);
+}
+
+static void test_gcoap_cache__no_max_age(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_GET, "/nma", false, false));
+    _respond(COAP_CODE_CONTENT, NO_MAX_AGE, "hello");
+    TEST_ASSERT(!_cached("/nma"));
+}
+
+static void test_gcoap_cache__max_age_zero(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_GET, "/ma0", false, false));
+    _respond(COAP_CODE_CONTENT, 0, "hello");
+    TEST_ASSERT(!_cached("/ma0"));
+}
+
+static void test_gcoap_cache__error_response(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_GET, "/err", false, false));
+    _respond(COAP_CODE_INTERNAL_SERVER_ERROR, 30, NULL);
+    TEST_ASSERT(!_cached("/err"));
+}
+
+static void test_gcoap_cache__etag_valid(void)
+{
+    coap_pkt_t resp;
+    ssize_t res;
+
+    _cache("/etag", "hello");
+    res = _request(COAP_METHOD_GET, "/etag", true, false);
+    TEST_ASSERT(res > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&resp, _buf, res));
+    TEST_ASSERT_EQUAL_INT(203, coap_get_code(&resp));
+    TEST_ASSERT_EQUAL_INT(0, resp.payload_len);
+}
+
+static void test_gcoap_cache__observe(void)
+{
+    _cache("/obs", "hello");
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_GET, "/obs", false, true));
+    TEST_ASSERT(_cached("/obs"));
+}
+
+static void test_gcoap_cache__invalidate(void)
+{
+    _cache("/inv", "hello");
+    _cache("/keep", "hello");
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_PUT, "/inv", false, false));
+    _respond(COAP_CODE_CHANGED, NO_MAX_AGE, NULL);
+    TEST_ASSERT(!_cached("/inv"));
+    TEST_ASSERT(_cached("/keep"));
+}
+
+static void test_gcoap_cache__invalidate_failed(void)
+{
+    _cache("/fail", "hello");
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_POST, "/fail", false,
+                                      false));
+    _respond(COAP_CODE_BAD_REQUEST, NO_MAX_AGE, NULL);
+    TEST_ASSERT(_cached("/fail"));
+}
+
+static void test_gcoap_cache__flush(void)
+{
+    char path[CONFIG_GCOAP_CACHE_ENTRY_SIZE + 1];
+
+    _cache("/flush1", "hello");
+    _cache("/flush2", "hello");
+    /* a request whose URI doesn't fit the cache key */
+    memset(path, 'a', sizeof(path) - 1);
+    path[0] = '/';
+    path[sizeof(path) - 1] = '\0';
+    TEST_ASSERT_EQUAL_INT(0, _request(COAP_METHOD_DELETE, path, false, false));
+    _respond(COAP_CODE_DELETED, NO_MAX_AGE, NULL);
+    TEST_ASSERT(!_cached("/flush1"));
+    TEST_ASSERT(!_cached("/flush2"));
+}
+
+static Test *tests_gcoap_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gcoap_cache__hit),
+        new_TestFixture(test_gcoap_cache__no_max_age),
+        new_TestFixture(test_gcoap_cache__max_age_zero),
+        new_TestFixture(test_gcoap_cache__error_response),
+        new_TestFixture(test_gcoap_cache__etag_valid),
+        new_TestFixture(test_gcoap_cache__observe),
+        new_TestFixture(test_gcoap_cache__invalidate),
+        new_TestFixture(test_gcoap_cache__invalidate_failed),
+        new_TestFixture(test_gcoap_cache__flush),
+    };
+
+    EMB_UNIT_TESTCALLER(gcoap_cache_tests, NULL, NULL, fixtures);
+
+    return (Test *)&gcoap_cache_tests;
+}
+
+void tests_gcoap_cache(void)
+{
+    TESTS_RUN(tests_gcoap_cache_tests());
+}
+/** @} */
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/coap.h"
+#include "net/sock/udp.h"
+#include "timex.h"
+#include "cocoa.h"
+
+#include "tests-gcoap_cocoa.h"
+
+#define RTO_INIT    (COAP_ACK_TIMEOUT * US_PER_SEC)
+#define RTO_MAX     (60U * US_PER_SEC)
+
+/* every test uses its own remote, so estimates of other tests don't count */
+static uint16_t _port = 5683;
+
+static void _remote(sock_udp_ep_t *remote)
+{
+    memset(remote, 0, sizeof(*remote));
+    remote->family = AF_INET6;
+    remote->addr.ipv6[0] = 0xfe;
+    remote->addr.ipv6[1] = 0x80;
+    remote->addr.ipv6[15] = 0x01;
+    remote->port = _port++;
+}
+
+static void test_gcoap_cocoa__rto_unknown_remote(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    TEST_ASSERT_EQUAL_INT(RTO_INIT, gcoap_cocoa_rto(&remote));
+}
+
+static void test_gcoap_cocoa__backoff_no_retrans(void)
+{
+    TEST_ASSERT_EQUAL_INT(2 * US_PER_SEC,
+                          gcoap_cocoa_backoff(2 * US_PER_SEC, 0));
+}
+
+static void test_gcoap_cocoa__backoff_vbf(void)
+{
+    /* RTO < 1s: factor 3 */
+    TEST_ASSERT_EQUAL_INT(1500 * US_PER_MS,
+                          gcoap_cocoa_backoff(500 * US_PER_MS, 1));
+    /* 1s <= RTO <= 3s: factor 2 */
+    TEST_ASSERT_EQUAL_INT(4 * US_PER_SEC,
+                          gcoap_cocoa_backoff(2 * US_PER_SEC, 1));
+    TEST_ASSERT_EQUAL_INT(8 * US_PER_SEC,
+                          gcoap_cocoa_backoff(2 * US_PER_SEC, 2));
+    /* RTO > 3s: factor 1.5 */
+    TEST_ASSERT_EQUAL_INT(6 * US_PER_SEC,
+                          gcoap_cocoa_backoff(4 * US_PER_SEC, 1));
+}
+
+static void test_gcoap_cocoa__backoff_max(void)
+{
+    TEST_ASSERT_EQUAL_INT(RTO_MAX, gcoap_cocoa_backoff(40 * US_PER_SEC, 1));
+    TEST_ASSERT_EQUAL_INT(RTO_MAX, gcoap_cocoa_backoff(2 * US_PER_SEC, 10));
+}
+
+static void test_gcoap_cocoa__update_strong(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    /* SRTT = 1s, RTTVAR = 0.5s => RTO_strong = 1s + 4 * 0.5s = 3s,
+     * RTO = (3s + 2s) / 2 */
+    gcoap_cocoa_update(&remote, US_PER_SEC, 1);
+    TEST_ASSERT_EQUAL_INT(2500 * US_PER_MS, gcoap_cocoa_rto(&remote));
+    /* SRTT = 1s, RTTVAR = 0.375s => RTO_strong = 2.5s,
+     * RTO = (2.5s + 2.5s) / 2 */
+    gcoap_cocoa_update(&remote, US_PER_SEC, 1);
+    TEST_ASSERT_EQUAL_INT(2500 * US_PER_MS, gcoap_cocoa_rto(&remote));
+}
+
+static void test_gcoap_cocoa__update_weak(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    /* SRTT = 1s, RTTVAR = 0.5s => RTO_weak = 1s + 0.5s = 1.5s,
+     * RTO = (1.5s + 3 * 2s) / 4 */
+    gcoap_cocoa_update(&remote, US_PER_SEC, 2);
+    TEST_ASSERT_EQUAL_INT(1875 * US_PER_MS, gcoap_cocoa_rto(&remote));
+}
+
+static void test_gcoap_cocoa__update_ambiguous(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    /* samples after more than 3 transmissions are ignored */
+    gcoap_cocoa_update(&remote, US_PER_SEC, 4);
+    TEST_ASSERT_EQUAL_INT(RTO_INIT, gcoap_cocoa_rto(&remote));
+}
+
+static void test_gcoap_cocoa__update_max(void)
+{
+    sock_udp_ep_t remote;
+
+    _remote(&remote);
+    gcoap_cocoa_update(&remote, 100 * US_PER_SEC, 1);
+    TEST_ASSERT_EQUAL_INT(RTO_MAX, gcoap_cocoa_rto(&remote));
+}
+
+static Test *tests_gcoap_cocoa_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gcoap_cocoa__rto_unknown_remote),
+        new_TestFixture(test_gcoap_cocoa__backoff_no_retrans),
+        new_TestFixture(test_gcoap_cocoa__backoff_vbf),
+        new_TestFixture(test_gcoap_cocoa__backoff_max),
+        new_TestFixture(test_gcoap_cocoa__update_strong),
+        new_TestFixture(test_gcoap_cocoa__update_weak),
+        new_TestFixture(test_gcoap_cocoa__update_ambiguous),
+        new_TestFixture(test_gcoap_cocoa__update_max),
+    };
+
+    EMB_UNIT_TESTCALLER(gcoap_cocoa_tests, NULL, NULL, fixtures);
+
+    return (Test *)&gcoap_cocoa_tests;
+}
+
+void tests_gcoap_cocoa(void)
+{
+    TESTS_RUN(tests_gcoap_cocoa_tests());
+}
+/** @} */
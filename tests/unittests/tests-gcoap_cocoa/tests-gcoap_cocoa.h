@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  unittests
+ * @{
+ *
+ * @file
+ * @brief       Unittests for the ``gcoap_cocoa`` module
+ */
+#ifndef TESTS_GCOAP_COCOA_H
+#define TESTS_GCOAP_COCOA_H
+
+#include "embUnit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   The entry point of this test suite.
+ */
+void tests_gcoap_cocoa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_GCOAP_COCOA_H */
+/** @} */
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "net/ipv6/addr.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/ipv6/nib/dst_cache.h"
+
+#include "_nib-internal.h"
+
+#include "unittests-constants.h"
+
+#include "tests-gnrc_ipv6_nib.h"
+
+#define LINK_LOCAL_PREFIX   { 0xfe, 0x80, 0, 0, 0, 0, 0, 0 }
+#define GLOBAL_PREFIX       { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0 }
+#define L2ADDR              { 0x90, 0xd5, 0x8e, 0x8c, 0x92, 0x43, 0x73, 0x5c }
+#define IFACE               (6)
+
+static void set_up(void)
+{
+    evtimer_event_t *tmp;
+
+    for (evtimer_event_t *ptr = _nib_evtimer.events;
+         (ptr != NULL) && (tmp = (ptr->next), 1);
+         ptr = tmp) {
+        evtimer_del((evtimer_t *)(&_nib_evtimer), ptr);
+    }
+    _nib_init();
+    gnrc_ipv6_nib_dst_cache_invalidate();
+}
+
+static void _init_entry(gnrc_ipv6_nib_dst_cache_t *entry)
+{
+    static const ipv6_addr_t dst = { .u64 = { { .u8 = GLOBAL_PREFIX },
+                                              { .u64 = TEST_UINT64 } } };
+    static const uint8_t l2addr[] = L2ADDR;
+
+    memset(entry, 0, sizeof(*entry));
+    memcpy(&entry->dst, &dst, sizeof(dst));
+    memcpy(entry->l2addr, l2addr, sizeof(l2addr));
+    entry->l2addr_len = sizeof(l2addr);
+    entry->iface = IFACE;
+    entry->version = gnrc_ipv6_nib_dst_cache_version();
+}
+
+/*
+ * Looks up a destination in an empty cache
+ * Expected result: gnrc_ipv6_nib_dst_cache_get() returns NULL and a miss is
+ * counted
+ */
+static void test_nib_dst_cache_get__empty(void)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+    gnrc_ipv6_nib_dst_cache_stats_t before, after;
+
+    _init_entry(&entry);
+    gnrc_ipv6_nib_dst_cache_get_stats(&before);
+    TEST_ASSERT_NULL(gnrc_ipv6_nib_dst_cache_get(&entry.dst, 0));
+    gnrc_ipv6_nib_dst_cache_get_stats(&after);
+    TEST_ASSERT_EQUAL_INT(before.hits, after.hits);
+    TEST_ASSERT_EQUAL_INT(before.misses + 1, after.misses);
+}
+
+/*
+ * Stores an entry and looks it up with any and with its interface
+ * Expected result: both lookups return the stored entry and are counted as
+ * hits
+ */
+static void test_nib_dst_cache_get__success(void)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+    const gnrc_ipv6_nib_dst_cache_t *res;
+    gnrc_ipv6_nib_dst_cache_stats_t before, after;
+
+    _init_entry(&entry);
+    gnrc_ipv6_nib_dst_cache_put(&entry);
+    gnrc_ipv6_nib_dst_cache_get_stats(&before);
+    TEST_ASSERT_NOT_NULL((res = gnrc_ipv6_nib_dst_cache_get(&entry.dst, 0)));
+    TEST_ASSERT(ipv6_addr_equal(&entry.dst, &res->dst));
+    TEST_ASSERT_EQUAL_INT(entry.l2addr_len, res->l2addr_len);
+    TEST_ASSERT_MESSAGE(memcmp(entry.l2addr, res->l2addr,
+                               entry.l2addr_len) == 0,
+                        "entry.l2addr != res->l2addr");
+    TEST_ASSERT_EQUAL_INT(IFACE, res->iface);
+    TEST_ASSERT_NOT_NULL(gnrc_ipv6_nib_dst_cache_get(&entry.dst, IFACE));
+    gnrc_ipv6_nib_dst_cache_get_stats(&after);
+    TEST_ASSERT_EQUAL_INT(before.hits + 2, after.hits);
+    TEST_ASSERT_EQUAL_INT(before.misses, after.misses);
+}
+
+/*
+ * Stores an entry and looks it up with another interface
+ * Expected result: gnrc_ipv6_nib_dst_cache_get() returns NULL
+ */
+static void test_nib_dst_cache_get__wrong_iface(void)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+
+    _init_entry(&entry);
+    gnrc_ipv6_nib_dst_cache_put(&entry);
+    TEST_ASSERT_NULL(gnrc_ipv6_nib_dst_cache_get(&entry.dst, IFACE + 1));
+}
+
+/*
+ * Stores an entry determined before the NIB changed
+ * Expected result: the entry is not stored
+ */
+static void test_nib_dst_cache_put__outdated(void)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+
+    _init_entry(&entry);
+    gnrc_ipv6_nib_dst_cache_invalidate();
+    gnrc_ipv6_nib_dst_cache_put(&entry);
+    TEST_ASSERT_NULL(gnrc_ipv6_nib_dst_cache_get(&entry.dst, 0));
+}
+
+/*
+ * Stores an entry and then adds a route to the NIB
+ * Expected result: the entry is not found anymore
+ */
+static void test_nib_dst_cache_get__invalidated_by_nib(void)
+{
+    gnrc_ipv6_nib_dst_cache_t entry;
+    void *iter_state = NULL;
+    static const ipv6_addr_t next_hop = { .u64 = { { .u8 = LINK_LOCAL_PREFIX },
+                                                   { .u64 = TEST_UINT64 } } };
+
+    _init_entry(&entry);
+    gnrc_ipv6_nib_dst_cache_put(&entry);
+    TEST_ASSERT(gnrc_ipv6_nib_dst_cache_iter(&iter_state, &entry));
+    TEST_ASSERT(!gnrc_ipv6_nib_dst_cache_iter(&iter_state, &entry));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add(&entry.dst, 64, &next_hop,
+                                                  IFACE, 0));
+    TEST_ASSERT_NULL(gnrc_ipv6_nib_dst_cache_get(&entry.dst, 0));
+    TEST_ASSERT(!gnrc_ipv6_nib_dst_cache_iter(&iter_state, &entry));
+}
+
+Test *tests_gnrc_ipv6_nib_dst_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_nib_dst_cache_get__empty),
+        new_TestFixture(test_nib_dst_cache_get__success),
+        new_TestFixture(test_nib_dst_cache_get__wrong_iface),
+        new_TestFixture(test_nib_dst_cache_put__outdated),
+        new_TestFixture(test_nib_dst_cache_get__invalidated_by_nib),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL,
+                        fixtures);
+
+    return (Test *)&tests;
+}
@@ -19,6 +19,7 @@ void tests_gnrc_ipv6_nib(void)
 {
     TESTS_RUN(tests_gnrc_ipv6_nib_internal_tests());
     TESTS_RUN(tests_gnrc_ipv6_nib_abr_tests());
+    TESTS_RUN(tests_gnrc_ipv6_nib_dst_cache_tests());
     TESTS_RUN(tests_gnrc_ipv6_nib_ft_tests());
     TESTS_RUN(tests_gnrc_ipv6_nib_nc_tests());
     TESTS_RUN(tests_gnrc_ipv6_nib_pl_tests());
@@ -43,6 +43,13 @@ Test *tests_gnrc_ipv6_nib_internal_tests(void);
  */
 Test *tests_gnrc_ipv6_nib_abr_tests(void);
 
+/**
+ * @brief   Generates tests for send-path destination cache
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_gnrc_ipv6_nib_dst_cache_tests(void);
+
 /**
  * @brief   Generates tests for forwarding table view
  *
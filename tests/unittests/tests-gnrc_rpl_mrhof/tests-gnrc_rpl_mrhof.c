@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/dodag.h"
+#include "net/gnrc/rpl/mrhof.h"
+#include "net/gnrc/rpl/structs.h"
+#include "of_mrhof.h"
+
+#include "tests-gnrc_rpl_mrhof.h"
+
+#define MIN_HOP_RANK_INC    (256U)
+#define ROOT_RANK           (256U)
+
+static const ipv6_addr_t _addr1 = { {
+    0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01
+} };
+static const ipv6_addr_t _addr2 = { {
+    0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x02
+} };
+
+static gnrc_rpl_of_t *_of;
+static gnrc_rpl_dodag_t *_dodag;
+static gnrc_rpl_parent_t *_p1, *_p2;
+
+static void set_up(void)
+{
+    memset(gnrc_rpl_instances, 0, sizeof(gnrc_rpl_instances));
+    memset(gnrc_rpl_parents, 0, sizeof(gnrc_rpl_parents));
+    _of = gnrc_rpl_get_of_mrhof();
+    gnrc_rpl_instances[0].state = 1;
+    gnrc_rpl_instances[0].min_hop_rank_inc = MIN_HOP_RANK_INC;
+    gnrc_rpl_instances[0].of = _of;
+    _dodag = &gnrc_rpl_instances[0].dodag;
+    _dodag->instance = &gnrc_rpl_instances[0];
+    _p1 = &gnrc_rpl_parents[0];
+    _p2 = &gnrc_rpl_parents[1];
+    _p1->state = 1;
+    _p1->addr = _addr1;
+    _p1->dodag = _dodag;
+    _p1->rank = ROOT_RANK;
+    _p2->state = 1;
+    _p2->addr = _addr2;
+    _p2->dodag = _dodag;
+    _p2->rank = ROOT_RANK;
+    _dodag->parents = _p1;
+    _p1->next = _p2;
+}
+
+static void test_mrhof__calc_rank_no_parent(void)
+{
+    _dodag->parents = NULL;
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, _of->calc_rank(_dodag, 0));
+}
+
+static void test_mrhof__calc_rank_default_etx(void)
+{
+    /* link metric not determined yet => GNRC_RPL_MRHOF_ETX_INIT is assumed */
+    TEST_ASSERT_EQUAL_INT(ROOT_RANK + GNRC_RPL_MRHOF_ETX_INIT,
+                          _of->calc_rank(_dodag, 0));
+}
+
+static void test_mrhof__calc_rank_min_hop_rank_inc(void)
+{
+    /* ETX 1 would increase the rank by less than MinHopRankIncrease */
+    _p1->link_metric = GNRC_RPL_ETX_DIVISOR;
+    TEST_ASSERT_EQUAL_INT(ROOT_RANK + MIN_HOP_RANK_INC,
+                          _of->calc_rank(_dodag, 0));
+}
+
+static void test_mrhof__calc_rank_max_link_metric(void)
+{
+    _p1->link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC + 1;
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, _of->calc_rank(_dodag, 0));
+}
+
+static void test_mrhof__calc_rank_max_path_cost(void)
+{
+    _p1->rank = GNRC_RPL_MRHOF_MAX_PATH_COST;
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, _of->calc_rank(_dodag, 0));
+}
+
+static void test_mrhof__calc_rank_base_rank(void)
+{
+    TEST_ASSERT_EQUAL_INT(ROOT_RANK + GNRC_RPL_MRHOF_ETX_INIT,
+                          _of->calc_rank(_dodag, ROOT_RANK));
+}
+
+static void test_mrhof__parent_cmp(void)
+{
+    _p1->link_metric = 3 * GNRC_RPL_ETX_DIVISOR;
+    _p2->link_metric = GNRC_RPL_ETX_DIVISOR;
+    TEST_ASSERT(_of->parent_cmp(_p1, _p2) > 0);
+    TEST_ASSERT(_of->parent_cmp(_p2, _p1) < 0);
+}
+
+static void test_mrhof__parent_cmp_equal_cost(void)
+{
+    /* same path cost, the parent closer to the root is preferred */
+    _p1->rank = ROOT_RANK + GNRC_RPL_ETX_DIVISOR;
+    _p1->link_metric = GNRC_RPL_ETX_DIVISOR;
+    _p2->link_metric = 2 * GNRC_RPL_ETX_DIVISOR;
+    TEST_ASSERT(_of->parent_cmp(_p1, _p2) > 0);
+    TEST_ASSERT(_of->parent_cmp(_p2, _p1) < 0);
+}
+
+static void test_mrhof__parent_switch_below_threshold(void)
+{
+    _p1->link_metric = GNRC_RPL_ETX_DIVISOR + GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD;
+    _p2->link_metric = GNRC_RPL_ETX_DIVISOR;
+    /* p2 is better, but not by more than the threshold */
+    TEST_ASSERT(_of->parent_cmp(_p2, _p1) < 0);
+    TEST_ASSERT(!_of->parent_switch(_p1, _p2));
+}
+
+static void test_mrhof__parent_switch_above_threshold(void)
+{
+    _p1->link_metric = GNRC_RPL_ETX_DIVISOR + GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD + 1;
+    _p2->link_metric = GNRC_RPL_ETX_DIVISOR;
+    TEST_ASSERT(_of->parent_switch(_p1, _p2));
+}
+
+static void test_mrhof__parent_switch_infinite(void)
+{
+    /* always switch away from a parent that became unusable */
+    _p1->link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC + 1;
+    _p2->link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC;
+    TEST_ASSERT(_of->parent_switch(_p1, _p2));
+}
+
+static void test_mrhof__etx_update_first_sample(void)
+{
+    gnrc_rpl_mrhof_etx_update(&_addr1, 3, true);
+    TEST_ASSERT_EQUAL_INT(3 * GNRC_RPL_ETX_DIVISOR, _p1->link_metric);
+    TEST_ASSERT_EQUAL_INT(0, _p2->link_metric);
+    TEST_ASSERT(_dodag->parents_changed);
+}
+
+static void test_mrhof__etx_update_ewma(void)
+{
+    _p1->link_metric = 2 * GNRC_RPL_ETX_DIVISOR;
+    gnrc_rpl_mrhof_etx_update(&_addr1, 1, true);
+    TEST_ASSERT_EQUAL_INT(((7 * 2 + 1) * GNRC_RPL_ETX_DIVISOR) / 8,
+                          _p1->link_metric);
+}
+
+static void test_mrhof__etx_update_noack(void)
+{
+    _p1->link_metric = GNRC_RPL_ETX_DIVISOR;
+    gnrc_rpl_mrhof_etx_update(&_addr1, 4, false);
+    TEST_ASSERT_EQUAL_INT((7 * GNRC_RPL_ETX_DIVISOR +
+                           GNRC_RPL_MRHOF_ETX_NOACK_PENALTY) / 8,
+                          _p1->link_metric);
+}
+
+static void test_mrhof__etx_update_unknown_neighbor(void)
+{
+    static const ipv6_addr_t addr = { {
+        0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x03
+    } };
+
+    gnrc_rpl_mrhof_etx_update(&addr, 1, true);
+    TEST_ASSERT_EQUAL_INT(0, _p1->link_metric);
+    TEST_ASSERT_EQUAL_INT(0, _p2->link_metric);
+    TEST_ASSERT(!_dodag->parents_changed);
+}
+
+static Test *tests_gnrc_rpl_mrhof_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mrhof__calc_rank_no_parent),
+        new_TestFixture(test_mrhof__calc_rank_default_etx),
+        new_TestFixture(test_mrhof__calc_rank_min_hop_rank_inc),
+        new_TestFixture(test_mrhof__calc_rank_max_link_metric),
+        new_TestFixture(test_mrhof__calc_rank_max_path_cost),
+        new_TestFixture(test_mrhof__calc_rank_base_rank),
+        new_TestFixture(test_mrhof__parent_cmp),
+        new_TestFixture(test_mrhof__parent_cmp_equal_cost),
+        new_TestFixture(test_mrhof__parent_switch_below_threshold),
+        new_TestFixture(test_mrhof__parent_switch_above_threshold),
+        new_TestFixture(test_mrhof__parent_switch_infinite),
+        new_TestFixture(test_mrhof__etx_update_first_sample),
+        new_TestFixture(test_mrhof__etx_update_ewma),
+        new_TestFixture(test_mrhof__etx_update_noack),
+        new_TestFixture(test_mrhof__etx_update_unknown_neighbor),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_rpl_mrhof_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_rpl_mrhof_tests;
+}
+
+void tests_gnrc_rpl_mrhof(void)
+{
+    TESTS_RUN(tests_gnrc_rpl_mrhof_tests());
+}
+/** @} */
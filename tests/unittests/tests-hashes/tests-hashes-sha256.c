@@ -212,6 +212,41 @@ static void test_hashes_sha256_hash_long_sequence(void)
                     hlong_sequence));
 }
 
+static void test_hashes_sha256_update_multi(void)
+{
+    static unsigned char buf[3][150];
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    unsigned char expected[SHA256_DIGEST_LENGTH];
+    sha256_context_t c[3];
+    sha256_context_t *const ctx[] = { &c[0], &c[1], &c[2] };
+    sha256_context_t *const pair[] = { &c[0], &c[2] };
+    const void *data[3];
+
+    for (unsigned i = 0; i < 3; i++) {
+        memset(buf[i], 'a' + i, sizeof(buf[i]));
+        sha256_init(&c[i]);
+    }
+
+    /* c[0] and c[1] are at different offsets in their block */
+    sha256_update(&c[1], buf[1], 10);
+    data[0] = buf[0];
+    data[1] = &buf[1][10];
+    data[2] = buf[2];
+    sha256_update_multi(ctx, data, 3, 5);
+
+    /* c[0] and c[2] are at the same offset, over several blocks */
+    data[0] = &buf[0][5];
+    data[1] = &buf[2][5];
+    sha256_update_multi(pair, data, 2, sizeof(buf[0]) - 5);
+    sha256_update(&c[1], &buf[1][15], sizeof(buf[1]) - 15);
+
+    for (unsigned i = 0; i < 3; i++) {
+        sha256_final(&c[i], hash);
+        sha256(buf[i], sizeof(buf[i]), expected);
+        TEST_ASSERT(memcmp(expected, hash, SHA256_DIGEST_LENGTH) == 0);
+    }
+}
+
 Test *tests_hashes_sha256_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -227,6 +262,7 @@ Test *tests_hashes_sha256_tests(void)
         new_TestFixture(test_hashes_sha256_hash_sequence_failing_compare),
 
         new_TestFixture(test_hashes_sha256_hash_long_sequence),
+        new_TestFixture(test_hashes_sha256_update_multi),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha256_tests, NULL, NULL,
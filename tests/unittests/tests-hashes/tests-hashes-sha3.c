@@ -412,6 +412,86 @@ static void test_hashes_sha3_hash_sequence_failing_compare(void)
 }
 
 
+/**
+ * @brief expected SHAKE outputs, computed with Python's hashlib:
+ *
+ *  hashlib.shake_128(b'').digest(32)
+ *  hashlib.shake_256(b'abc').digest(64)
+ *  hashlib.shake_128(bytes(range(200))).digest(512)[496:]
+ *  hashlib.shake_256(bytes(range(200))).digest(512)[496:]
+ */
+static const uint8_t shake128_empty[] = {
+    0x7f, 0x9c, 0x2b, 0xa4, 0xe8, 0x8f, 0x82, 0x7d,
+    0x61, 0x60, 0x45, 0x50, 0x76, 0x05, 0x85, 0x3e,
+    0xd7, 0x3b, 0x80, 0x93, 0xf6, 0xef, 0xbc, 0x88,
+    0xeb, 0x1a, 0x6e, 0xac, 0xfa, 0x66, 0xef, 0x26
+};
+static const uint8_t shake256_abc[] = {
+    0x48, 0x33, 0x66, 0x60, 0x13, 0x60, 0xa8, 0x77,
+    0x1c, 0x68, 0x63, 0x08, 0x0c, 0xc4, 0x11, 0x4d,
+    0x8d, 0xb4, 0x45, 0x30, 0xf8, 0xf1, 0xe1, 0xee,
+    0x4f, 0x94, 0xea, 0x37, 0xe7, 0x8b, 0x57, 0x39,
+    0xd5, 0xa1, 0x5b, 0xef, 0x18, 0x6a, 0x53, 0x86,
+    0xc7, 0x57, 0x44, 0xc0, 0x52, 0x7e, 0x1f, 0xaa,
+    0x9f, 0x87, 0x26, 0xe4, 0x62, 0xa1, 0x2a, 0x4f,
+    0xeb, 0x06, 0xbd, 0x88, 0x01, 0xe7, 0x51, 0xe4
+};
+static const uint8_t shake128_long_tail[] = {
+    0xcf, 0xf1, 0x75, 0x12, 0xe2, 0xdc, 0xa9, 0x4f,
+    0xfc, 0x4c, 0x30, 0x60, 0x55, 0x46, 0x8b, 0xd7
+};
+static const uint8_t shake256_long_tail[] = {
+    0xb2, 0x36, 0xc1, 0x02, 0x04, 0xf7, 0x3a, 0x5f,
+    0xb4, 0x6b, 0x3a, 0x19, 0xe6, 0xa6, 0xcb, 0x34
+};
+
+static void test_hashes_shake_oneshot(void)
+{
+    uint8_t out[64];
+
+    shake128(out, sizeof(shake128_empty), NULL, 0);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, shake128_empty, sizeof(shake128_empty)));
+    shake256(out, sizeof(shake256_abc), "abc", 3);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, shake256_abc, sizeof(shake256_abc)));
+}
+
+/* absorbs and squeezes in odd sized pieces across the rate boundaries and
+ * compares with the one-shot output */
+static int calc_steps_and_compare_shake(void (*init)(keccak_state_t *),
+                                        void (*oneshot)(void *, size_t,
+                                                        const void *, size_t),
+                                        const uint8_t *tail)
+{
+    static uint8_t msg[200], expected[512], out[512];
+    keccak_state_t ctx;
+
+    for (unsigned i = 0; i < sizeof(msg); i++) {
+        msg[i] = i;
+    }
+    oneshot(expected, sizeof(expected), msg, sizeof(msg));
+
+    init(&ctx);
+    for (size_t pos = 0, step = 1; pos < sizeof(msg); pos += step, step += 6) {
+        size_t n = (sizeof(msg) - pos < step) ? sizeof(msg) - pos : step;
+        shake_update(&ctx, &msg[pos], n);
+    }
+    for (size_t pos = 0, step = 1; pos < sizeof(out); pos += step, step += 11) {
+        size_t n = (sizeof(out) - pos < step) ? sizeof(out) - pos : step;
+        shake_squeeze(&ctx, &out[pos], n);
+    }
+
+    return (memcmp(out, expected, sizeof(out)) == 0) &&
+           (memcmp(&out[sizeof(out) - 16], tail, 16) == 0);
+}
+
+static void test_hashes_shake_streaming(void)
+{
+    TEST_ASSERT(calc_steps_and_compare_shake(shake128_init, shake128,
+                                             shake128_long_tail));
+    TEST_ASSERT(calc_steps_and_compare_shake(shake256_init, shake256,
+                                             shake256_long_tail));
+}
+
 Test *tests_hashes_sha3_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -420,6 +500,8 @@ Test *tests_hashes_sha3_tests(void)
         new_TestFixture(test_hashes_sha3_hash_sequence_03),
         new_TestFixture(test_hashes_sha3_hash_sequence_04),
         new_TestFixture(test_hashes_sha3_hash_sequence_failing_compare),
+        new_TestFixture(test_hashes_shake_oneshot),
+        new_TestFixture(test_hashes_shake_streaming),
     };
 
     EMB_UNIT_TESTCALLER(hashes_sha3_tests, NULL, NULL,
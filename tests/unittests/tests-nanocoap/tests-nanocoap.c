@@ -625,6 +625,79 @@ static void test_nanocoap__options_iterate(void)
     }
 }
 
+/*
+ * Tests use of coap_opt_get_next_by_num() to iterate over the instances of
+ * an option, for a received and for a locally built packet.
+ */
+static void test_nanocoap__options_iterate_by_num(void)
+{
+    uint8_t buf[_BUF_SIZE];
+    coap_pkt_t pkt;
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t optlen;
+    const char *segs[] = { "a", "bc", "def" };
+
+    for (int omit_payload = 0; omit_payload < 2; omit_payload++) {
+        TEST_ASSERT_EQUAL_INT(0, _read_rd_post_req(&pkt, omit_payload));
+
+        optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_URI_QUERY,
+                                          &value, true);
+        TEST_ASSERT_EQUAL_INT(24, optlen);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(value, "ep=RIOT-0C49232323232323", 24));
+        optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_URI_QUERY,
+                                          &value, false);
+        TEST_ASSERT_EQUAL_INT(5, optlen);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(value, "lt=60", 5));
+        optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_URI_QUERY,
+                                          &value, false);
+        TEST_ASSERT_EQUAL_INT(-ENOENT, optlen);
+
+        /* Uri-Path is followed by another option */
+        optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_URI_PATH,
+                                          &value, true);
+        TEST_ASSERT_EQUAL_INT(17, optlen);
+        optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_URI_PATH,
+                                          &value, false);
+        TEST_ASSERT_EQUAL_INT(-ENOENT, optlen);
+
+        optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_LOCATION_PATH,
+                                          &value, true);
+        TEST_ASSERT_EQUAL_INT(-ENOENT, optlen);
+    }
+
+    size_t len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON, NULL, 0,
+                                COAP_METHOD_GET, 1);
+    coap_pkt_init(&pkt, &buf[0], sizeof(buf), len);
+    coap_opt_add_uint(&pkt, COAP_OPT_OBSERVE, 0);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, "/a/bc/def", '/');
+    coap_opt_add_uint(&pkt, COAP_OPT_CONTENT_FORMAT, COAP_FORMAT_CBOR);
+    len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, &buf[0], len));
+
+    for (unsigned i = 0; i <= ARRAY_SIZE(segs); i++) {
+        optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_URI_PATH,
+                                          &value, !i);
+        if (i == ARRAY_SIZE(segs)) {
+            TEST_ASSERT_EQUAL_INT(-ENOENT, optlen);
+        }
+        else {
+            TEST_ASSERT_EQUAL_INT(strlen(segs[i]), optlen);
+            TEST_ASSERT_EQUAL_INT(0, memcmp(value, segs[i], optlen));
+        }
+    }
+    optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_OBSERVE, &value,
+                                      true);
+    TEST_ASSERT_EQUAL_INT(0, optlen);
+    optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_CONTENT_FORMAT,
+                                      &value, true);
+    TEST_ASSERT_EQUAL_INT(1, optlen);
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_CBOR, *value);
+    optlen = coap_opt_get_next_by_num(&pkt, &opt, COAP_OPT_BLOCK2, &value,
+                                      true);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, optlen);
+}
+
 /*
  * Tests use of coap_opt_get_opaque() to find an option as a byte array, and
  * coap_opt_get_next() to find a second option with the same option number.
@@ -650,6 +723,164 @@ static void test_nanocoap__options_get_opaque(void)
     TEST_ASSERT_EQUAL_INT(-ENOENT, optlen);
 }
 
+static ssize_t _dummy_handler(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                              void *ctx)
+{
+    (void)pkt;
+    (void)buf;
+    (void)len;
+    (void)ctx;
+    return 0;
+}
+
+static const coap_resource_t _find_resources[] = {
+    { "/", COAP_GET, _dummy_handler, NULL },
+    { "/echo/", COAP_GET | COAP_MATCH_SUBTREE, _dummy_handler, NULL },
+    { "/riot", COAP_GET, _dummy_handler, NULL },
+    { "/riot-os", COAP_GET, _dummy_handler, NULL },
+    { "/riot/board", COAP_GET, _dummy_handler, NULL },
+    { "/riot/value", COAP_GET, _dummy_handler, NULL },
+    { "/riot/value", COAP_PUT, _dummy_handler, NULL },
+    { "/sensor", COAP_GET | COAP_MATCH_SUBTREE, _dummy_handler, NULL },
+};
+
+/*
+ * Helper for coap_find_resource() test below. Returns the index of the found
+ * resource or the error.
+ */
+static int _find_resource(unsigned method, char *path)
+{
+    uint8_t buf[_BUF_SIZE];
+    coap_pkt_t pkt;
+    const coap_resource_t *resource = NULL;
+
+    size_t len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON, NULL, 0,
+                                method, 1);
+    coap_pkt_init(&pkt, &buf[0], sizeof(buf), len);
+    if (path != NULL) {
+        coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, path, '/');
+    }
+    len = coap_opt_finish(&pkt, COAP_OPT_FINISH_NONE);
+    if (coap_parse(&pkt, &buf[0], len) < 0) {
+        return -EBADMSG;
+    }
+
+    int res = coap_find_resource(&pkt, _find_resources,
+                                 ARRAY_SIZE(_find_resources), &resource);
+    if (res < 0) {
+        return res;
+    }
+    return resource - _find_resources;
+}
+
+/*
+ * Tests resource lookup by the Uri-Path options of a request.
+ */
+static void test_nanocoap__find_resource(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _find_resource(COAP_METHOD_GET, NULL));
+    TEST_ASSERT_EQUAL_INT(2, _find_resource(COAP_METHOD_GET, "/riot"));
+    TEST_ASSERT_EQUAL_INT(3, _find_resource(COAP_METHOD_GET, "/riot-os"));
+    TEST_ASSERT_EQUAL_INT(4, _find_resource(COAP_METHOD_GET, "/riot/board"));
+    TEST_ASSERT_EQUAL_INT(5, _find_resource(COAP_METHOD_GET, "/riot/value"));
+    TEST_ASSERT_EQUAL_INT(6, _find_resource(COAP_METHOD_PUT, "/riot/value"));
+    TEST_ASSERT_EQUAL_INT(-EPERM, _find_resource(COAP_METHOD_POST,
+                                                 "/riot/value"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_GET,
+                                                  "/riot/valu"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_GET,
+                                                  "/riot/value/x"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_GET, "/zzz"));
+
+    /* subtree matching */
+    TEST_ASSERT_EQUAL_INT(1, _find_resource(COAP_METHOD_GET, "/echo/foo/bar"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, _find_resource(COAP_METHOD_GET, "/echo"));
+    TEST_ASSERT_EQUAL_INT(7, _find_resource(COAP_METHOD_GET, "/sensor"));
+    TEST_ASSERT_EQUAL_INT(7, _find_resource(COAP_METHOD_GET, "/sensors"));
+    TEST_ASSERT_EQUAL_INT(7, _find_resource(COAP_METHOD_GET, "/sensor/temp"));
+    TEST_ASSERT_EQUAL_INT(-EPERM, _find_resource(COAP_METHOD_PUT,
+                                                 "/sensor/temp"));
+}
+
+/*
+ * Converts a request with a payload of payload_len bytes to CoAP over TCP
+ * framing and parses it back.
+ */
+static void _tcp_round_trip(size_t payload_len, size_t framing_len)
+{
+    uint8_t buf[_BUF_SIZE + 320];
+    uint8_t token[2] = {0xDA, 0xEC};
+    coap_pkt_t pkt;
+    uint8_t *msg;
+    size_t len;
+    ssize_t msg_len;
+    char path[] = "/riot/value";
+    char uri[NANOCOAP_URI_MAX] = {0};
+
+    len = coap_build_hdr((coap_hdr_t *)&buf[0], COAP_TYPE_NON, &token[0], 2,
+                         COAP_METHOD_PUT, 1);
+    coap_pkt_init(&pkt, &buf[0], sizeof(buf), len);
+    coap_opt_add_string(&pkt, COAP_OPT_URI_PATH, &path[0], '/');
+    len = coap_opt_finish(&pkt, payload_len ? COAP_OPT_FINISH_PAYLOAD
+                                            : COAP_OPT_FINISH_NONE);
+    memset(pkt.payload, 0xAA, payload_len);
+    len += payload_len;
+
+    msg_len = coap_tcp_frame(&pkt, len, &msg);
+    TEST_ASSERT_EQUAL_INT(len - sizeof(coap_hdr_t) + framing_len, msg_len);
+    TEST_ASSERT_EQUAL_INT(2, msg[0] & 0xf);
+    TEST_ASSERT_EQUAL_INT(COAP_METHOD_PUT, msg[framing_len - 1]);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&msg[framing_len], &token[0], 2));
+
+    /* message length is known once the extended length is available */
+    TEST_ASSERT_EQUAL_INT(0, coap_tcp_get_len(msg, 0));
+    TEST_ASSERT_EQUAL_INT(0, coap_tcp_get_len(msg, framing_len - 2));
+    TEST_ASSERT_EQUAL_INT(msg_len, coap_tcp_get_len(msg, framing_len - 1));
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, coap_tcp_parse(&pkt, msg, msg_len - 1));
+
+    TEST_ASSERT_EQUAL_INT(0, coap_tcp_parse(&pkt, msg, msg_len));
+    TEST_ASSERT_EQUAL_INT(COAP_METHOD_PUT, coap_get_code(&pkt));
+    TEST_ASSERT_EQUAL_INT(2, coap_get_token_len(&pkt));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(pkt.token, &token[0], 2));
+    coap_get_uri_path(&pkt, (uint8_t *)&uri[0]);
+    TEST_ASSERT_EQUAL_STRING((char *)path, (char *)uri);
+    TEST_ASSERT_EQUAL_INT(payload_len, pkt.payload_len);
+}
+
+/*
+ * Tests CoAP over TCP framing with the different lengths of the Len field.
+ */
+static void test_nanocoap__tcp_frame(void)
+{
+    /* Len in the first nibble */
+    _tcp_round_trip(0, 2);
+    /* 8-bit extended length */
+    _tcp_round_trip(20, 3);
+    /* 16-bit extended length */
+    _tcp_round_trip(300, 4);
+}
+
+/*
+ * Tests rejection of malformed CoAP over TCP messages.
+ */
+static void test_nanocoap__tcp_parse_bad(void)
+{
+    /* headroom, Len 0 / TKL 9, code, token */
+    uint8_t buf[] = { 0, 0, 0x09, COAP_CODE_CSM, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    coap_pkt_t pkt;
+
+    TEST_ASSERT_EQUAL_INT(sizeof(buf) - 2, coap_tcp_get_len(&buf[2], 2));
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, coap_tcp_parse(&pkt, &buf[2],
+                                                   sizeof(buf) - 2));
+    /* TKL 0 announces a shorter message */
+    buf[2] = 0x00;
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, coap_tcp_parse(&pkt, &buf[2],
+                                                   sizeof(buf) - 2));
+    TEST_ASSERT_EQUAL_INT(0, coap_tcp_parse(&pkt, &buf[2], 2));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CSM, coap_get_code_raw(&pkt));
+    TEST_ASSERT_EQUAL_INT(COAP_CLASS_SIGNAL, coap_get_code_class(&pkt));
+}
+
 Test *tests_nanocoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -666,6 +897,10 @@ Test *tests_nanocoap_tests(void)
         new_TestFixture(test_nanocoap__option_add_buffer_max),
         new_TestFixture(test_nanocoap__options_get_opaque),
         new_TestFixture(test_nanocoap__options_iterate),
+        new_TestFixture(test_nanocoap__options_iterate_by_num),
+        new_TestFixture(test_nanocoap__find_resource),
+        new_TestFixture(test_nanocoap__tcp_frame),
+        new_TestFixture(test_nanocoap__tcp_parse_bad),
         new_TestFixture(test_nanocoap__server_get_req),
         new_TestFixture(test_nanocoap__server_reply_simple),
         new_TestFixture(test_nanocoap__server_get_req_con),
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/af.h"
+#include "net/sock/dns.h"
+#include "dns_cache.h"
+
+#include "tests-sock_dns_cache.h"
+
+#define NAME        "example.org"
+#define TTL         (60U)
+
+static const uint8_t _addr6[16] = {
+    0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01
+};
+static const uint8_t _addr4[4] = { 192, 0, 2, 1 };
+static uint8_t _out[16];
+
+static void set_up(void)
+{
+    sock_dns_cache_flush();
+    memset(_out, 0, sizeof(_out));
+}
+
+static void test_sock_dns_cache__miss(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(NAME, _out, AF_INET6));
+}
+
+static void test_sock_dns_cache__hit(void)
+{
+    dns_cache_put(NAME, AF_INET6, _addr6, sizeof(_addr6), TTL);
+    TEST_ASSERT_EQUAL_INT(16, dns_cache_get(NAME, _out, AF_INET6));
+    TEST_ASSERT(memcmp(_out, _addr6, sizeof(_addr6)) == 0);
+    /* AF_UNSPEC prefers IPv6 addresses */
+    TEST_ASSERT_EQUAL_INT(16, dns_cache_get(NAME, _out, AF_UNSPEC));
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(NAME, _out, AF_INET));
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get("example.com", _out, AF_INET6));
+}
+
+static void test_sock_dns_cache__unspec_ipv4(void)
+{
+    /* an IPv4 address found with AF_UNSPEC: the name has no IPv6 address */
+    dns_cache_put(NAME, AF_UNSPEC, _addr4, sizeof(_addr4), TTL);
+    TEST_ASSERT_EQUAL_INT(4, dns_cache_get(NAME, _out, AF_UNSPEC));
+    TEST_ASSERT_EQUAL_INT(4, dns_cache_get(NAME, _out, AF_INET));
+    TEST_ASSERT(memcmp(_out, _addr4, sizeof(_addr4)) == 0);
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(NAME, _out, AF_INET6));
+}
+
+static void test_sock_dns_cache__nxdomain(void)
+{
+    dns_cache_put(NAME, AF_UNSPEC, NULL, 0, TTL);
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, dns_cache_get(NAME, _out, AF_INET));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, dns_cache_get(NAME, _out, AF_INET6));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, dns_cache_get(NAME, _out, AF_UNSPEC));
+}
+
+static void test_sock_dns_cache__nodata(void)
+{
+    dns_cache_put(NAME, AF_INET, NULL, 0, TTL);
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, dns_cache_get(NAME, _out, AF_INET));
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(NAME, _out, AF_INET6));
+}
+
+static void test_sock_dns_cache__replace_negative(void)
+{
+    dns_cache_put(NAME, AF_UNSPEC, NULL, 0, TTL);
+    dns_cache_put(NAME, AF_INET6, _addr6, sizeof(_addr6), TTL);
+    TEST_ASSERT_EQUAL_INT(16, dns_cache_get(NAME, _out, AF_INET6));
+    /* the name exists now, but nothing is known about IPv4 */
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(NAME, _out, AF_INET));
+}
+
+static void test_sock_dns_cache__replace_positive(void)
+{
+    dns_cache_put(NAME, AF_INET6, _addr6, sizeof(_addr6), TTL);
+    dns_cache_put(NAME, AF_INET, _addr4, sizeof(_addr4), TTL);
+    dns_cache_put(NAME, AF_UNSPEC, NULL, 0, TTL);
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, dns_cache_get(NAME, _out, AF_INET6));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, dns_cache_get(NAME, _out, AF_INET));
+}
+
+static void test_sock_dns_cache__replace_nodata(void)
+{
+    dns_cache_put(NAME, AF_INET6, _addr6, sizeof(_addr6), TTL);
+    dns_cache_put(NAME, AF_INET, _addr4, sizeof(_addr4), TTL);
+    dns_cache_put(NAME, AF_INET6, NULL, 0, TTL);
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, dns_cache_get(NAME, _out, AF_INET6));
+    /* the IPv4 address stays valid */
+    TEST_ASSERT_EQUAL_INT(4, dns_cache_get(NAME, _out, AF_INET));
+}
+
+static void test_sock_dns_cache__not_cached(void)
+{
+    static const char long_name[] = "a-name-that-is-too-long-for-the-cache.org";
+
+    /* TTL 0 means the answer must not be cached */
+    dns_cache_put(NAME, AF_INET6, _addr6, sizeof(_addr6), 0);
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(NAME, _out, AF_INET6));
+    TEST_ASSERT(strlen(long_name) > SOCK_DNS_CACHE_NAME_LEN);
+    dns_cache_put(long_name, AF_INET6, _addr6, sizeof(_addr6), TTL);
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(long_name, _out, AF_INET6));
+}
+
+static void test_sock_dns_cache__full(void)
+{
+    char name[] = "0.example.org";
+
+    for (unsigned i = 0; i <= SOCK_DNS_CACHE_SIZE; i++) {
+        name[0] = '0' + i;
+        /* the first one expires first */
+        dns_cache_put(name, AF_INET6, _addr6, sizeof(_addr6), TTL + i);
+    }
+    name[0] = '0';
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(name, _out, AF_INET6));
+    for (unsigned i = 1; i <= SOCK_DNS_CACHE_SIZE; i++) {
+        name[0] = '0' + i;
+        TEST_ASSERT_EQUAL_INT(16, dns_cache_get(name, _out, AF_INET6));
+    }
+}
+
+static void test_sock_dns_cache__flush(void)
+{
+    dns_cache_put(NAME, AF_INET6, _addr6, sizeof(_addr6), TTL);
+    sock_dns_cache_flush();
+    TEST_ASSERT_EQUAL_INT(0, dns_cache_get(NAME, _out, AF_INET6));
+}
+
+static void test_sock_dns_cache__stats(void)
+{
+    sock_dns_cache_stats_t before, after;
+
+    sock_dns_cache_stats(&before);
+    dns_cache_put(NAME, AF_INET6, _addr6, sizeof(_addr6), TTL);
+    dns_cache_put(NAME, AF_INET, NULL, 0, TTL);
+    dns_cache_get(NAME, _out, AF_INET6);
+    dns_cache_get(NAME, _out, AF_INET);
+    dns_cache_get("example.com", _out, AF_INET);
+    sock_dns_cache_stats(&after);
+    TEST_ASSERT_EQUAL_INT(1, after.hits - before.hits);
+    TEST_ASSERT_EQUAL_INT(1, after.neg_hits - before.neg_hits);
+    TEST_ASSERT_EQUAL_INT(1, after.misses - before.misses);
+}
+
+static Test *tests_sock_dns_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sock_dns_cache__miss),
+        new_TestFixture(test_sock_dns_cache__hit),
+        new_TestFixture(test_sock_dns_cache__unspec_ipv4),
+        new_TestFixture(test_sock_dns_cache__nxdomain),
+        new_TestFixture(test_sock_dns_cache__nodata),
+        new_TestFixture(test_sock_dns_cache__replace_negative),
+        new_TestFixture(test_sock_dns_cache__replace_positive),
+        new_TestFixture(test_sock_dns_cache__replace_nodata),
+        new_TestFixture(test_sock_dns_cache__not_cached),
+        new_TestFixture(test_sock_dns_cache__full),
+        new_TestFixture(test_sock_dns_cache__flush),
+        new_TestFixture(test_sock_dns_cache__stats),
+    };
+
+    EMB_UNIT_TESTCALLER(sock_dns_cache_tests, set_up, NULL, fixtures);
+
+    return (Test *)&sock_dns_cache_tests;
+}
+
+void tests_sock_dns_cache(void)
+{
+    TESTS_RUN(tests_sock_dns_cache_tests());
+}
+/** @} */